@@ -40,9 +40,11 @@ static const char *TAG = "can";
 #include "canlog.h"
 #include <algorithm>
 #include <ctype.h>
+#include <stdio.h>
 #include <string.h>
 #include "ovms_command.h"
 #include "metrics_standard.h"
+#include "ovms_profiler.h"
 
 can MyCan __attribute__ ((init_priority (4500)));
 
@@ -161,7 +163,9 @@ void can_rx(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const
     {
     frame.data.u8[k] = strtol(argv[k+1],NULL,16);
     }
-  MyCan.IncomingFrame(&frame);
+  frame.timestamp = CAN_Timestamp();
+  if (!MyCan.InjectFrame(&frame, pdMS_TO_TICKS(100)))
+    writer->puts("Error: CAN RX queue full");
   }
 
 
@@ -323,6 +327,8 @@ void can_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, c
   writer->printf("Rx pkt:    %20d\n",sbus->m_status.packets_rx);
   writer->printf("Rx err:    %20d\n",sbus->m_status.errors_rx);
   writer->printf("Rx ovrflw: %20d\n",sbus->m_status.rxbuf_overflow);
+  writer->printf("Rx ringovr:%20d\n",sbus->m_status.rxring_overflow);
+  writer->printf("Rx lstnovr:%20d\n",sbus->m_status.listener_overflow);
   writer->printf("Tx pkt:    %20d\n",sbus->m_status.packets_tx);
   writer->printf("Tx delays: %20d\n",sbus->m_status.txbuf_delay);
   writer->printf("Tx err:    %20d\n",sbus->m_status.errors_tx);
@@ -333,6 +339,7 @@ void can_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, c
     writer->printf("Wdg Timer: %20d sec(s)\n",monotonictime-sbus->m_watchdog_timer);
     }
   writer->printf("Err flags: 0x%08x\n",sbus->m_status.error_flags);
+  sbus->ShowStatus(verbosity, writer);
   }
 
 void can_clearstatus(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
@@ -358,6 +365,7 @@ static void CAN_rxtask(void *pvParameters)
     {
     if (xQueueReceive(me->m_rxqueue,&msg, (portTickType)portMAX_DELAY)==pdTRUE)
       {
+      if (me->m_rxqueue_profile) me->m_rxqueue_profile->Sample(1);
       switch(msg.type)
         {
         case CAN_frame:
@@ -427,6 +435,7 @@ can::can()
   cmd_canlog->RegisterCommand("status", "Logging status", can_log, "", 0, 0, true);
 
   m_rxqueue = xQueueCreate(CONFIG_OVMS_HW_CAN_RX_QUEUE_SIZE,sizeof(CAN_msg_t));
+  m_rxqueue_profile = MyProfiler.RegisterQueue("CanRx", m_rxqueue);
   xTaskCreatePinnedToCore(CAN_rxtask, "OVMS CanRx", 2048, (void*)this, 23, &m_rxtask, 0);
   m_logger = NULL;
   }
@@ -445,6 +454,26 @@ void can::IncomingFrame(CAN_frame_t* p_frame)
   NotifyListeners(p_frame, false);
   }
 
+/**
+ * InjectFrame: process a frame as received by its origin bus
+ *  The frame is queued to the CAN RX task, so it takes the same path as
+ *  frames received by the drivers. Call this instead of IncomingFrame()
+ *  from any other task. Returns false if the queue is full (counted as
+ *  an RX buffer overflow of the origin bus).
+ */
+bool can::InjectFrame(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*=0*/)
+  {
+  CAN_msg_t msg;
+  msg.type = CAN_frame;
+  msg.body.frame = *p_frame;
+  if (xQueueSend(m_rxqueue, &msg, maxqueuewait) != pdTRUE)
+    {
+    p_frame->origin->m_status.rxbuf_overflow++;
+    return false;
+    }
+  return true;
+  }
+
 void can::RegisterListener(QueueHandle_t queue, bool txfeedback)
   {
   m_listeners[queue] = txfeedback;
@@ -457,6 +486,22 @@ void can::DeregisterListener(QueueHandle_t queue)
     m_listeners.erase(it);
   }
 
+/**
+ * RegisterListener (ring): the task is notified (xTaskNotifyGive) when
+ *  frames are available, see CanListenerRing
+ */
+void can::RegisterListener(CanListenerRing* ring, TaskHandle_t task)
+  {
+  m_listenerrings[ring] = task;
+  }
+
+void can::DeregisterListener(CanListenerRing* ring)
+  {
+  auto it = m_listenerrings.find(ring);
+  if (it != m_listenerrings.end())
+    m_listenerrings.erase(it);
+  }
+
 void can::NotifyListeners(const CAN_frame_t* frame, bool tx)
   {
   for (CanListenerMap_t::iterator it = m_listeners.begin(); it != m_listeners.end(); ++it)
@@ -464,14 +509,48 @@ void can::NotifyListeners(const CAN_frame_t* frame, bool tx)
     if (!tx || (tx && it->second))
       xQueueSend(it->first,frame,0);
     }
+  if (tx)
+    return;
+  bool wakeup;
+  for (CanListenerRingMap_t::iterator it = m_listenerrings.begin(); it != m_listenerrings.end(); ++it)
+    {
+    if (!it->first->Push(*frame, &wakeup))
+      frame->origin->m_status.listener_overflow++;
+    else if (wakeup)
+      xTaskNotifyGive(it->second);
+    }
+  }
+
+/**
+ * GetListenerQueueSpace: free space of the fullest listener queue
+ *  (used by frame sources that can throttle, i.e. the replay bus)
+ */
+UBaseType_t can::GetListenerQueueSpace()
+  {
+  UBaseType_t space = CONFIG_OVMS_HW_CAN_RX_QUEUE_SIZE;
+  for (CanListenerMap_t::iterator it = m_listeners.begin(); it != m_listeners.end(); ++it)
+    {
+    UBaseType_t free = uxQueueSpacesAvailable(it->first);
+    if (free < space)
+      space = free;
+    }
+  for (CanListenerRingMap_t::iterator it = m_listenerrings.begin(); it != m_listenerrings.end(); ++it)
+    {
+    UBaseType_t free = it->first->FreeSpace();
+    if (free < space)
+      space = free;
+    }
+  return space;
   }
 
 void can::RegisterCallback(const char* caller, CanFrameCallback callback, bool txfeedback)
   {
+  CanFrameCallbackEntry* entry = new CanFrameCallbackEntry(caller, callback);
+  entry->m_profile = MyProfiler.GetEntry(txfeedback ? "can.tx" : "can.rx", caller, "");
   if (txfeedback)
-    m_txcallbacks.push_back(new CanFrameCallbackEntry(caller, callback));
+    m_txcallbacks.push_back(entry);
   else
-    m_rxcallbacks.push_back(new CanFrameCallbackEntry(caller, callback));
+    m_rxcallbacks.push_back(entry);
   }
 
 void can::DeregisterCallback(const char* caller)
@@ -485,12 +564,18 @@ void can::ExecuteCallbacks(const CAN_frame_t* frame, bool tx)
   if (tx)
     {
     for (auto entry : m_txcallbacks)
+      {
+      OvmsProfileTimer pt(entry->m_profile);
       entry->m_callback(frame);
+      }
     }
   else
     {
     for (auto entry : m_rxcallbacks)
+      {
+      OvmsProfileTimer pt(entry->m_profile);
       entry->m_callback(frame);
+      }
     }
   }
 
@@ -502,13 +587,19 @@ canbus::canbus(const char* name)
   m_speed = CAN_SPEED_1000KBPS;
   ClearStatus();
 
+  // per instance event caller name (buses may share a name, see canreplay):
+  char caller[32];
+  snprintf(caller, sizeof(caller), "%s.%p", TAG, this);
+  m_eventcaller = caller;
+
   using std::placeholders::_1;
   using std::placeholders::_2;
-  MyEvents.RegisterEvent(TAG, "ticker.10", std::bind(&canbus::BusTicker10, this, _1, _2));
+  MyEvents.RegisterEvent(m_eventcaller, "ticker.10", std::bind(&canbus::BusTicker10, this, _1, _2));
   }
 
 canbus::~canbus()
   {
+  MyEvents.DeregisterEvent(m_eventcaller);
   vQueueDelete(m_txqueue);
   }
 
@@ -578,10 +669,13 @@ esp_err_t canbus::Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*=0
   {
   m_status.packets_tx++;
 
-  LogFrame(CAN_LogFrame_TX, p_frame);
+  CAN_frame_t frame = *p_frame;
+  frame.timestamp = CAN_Timestamp();
+
+  LogFrame(CAN_LogFrame_TX, &frame);
 
-  MyCan.ExecuteCallbacks(p_frame, true);
-  MyCan.NotifyListeners(p_frame, true);
+  MyCan.ExecuteCallbacks(&frame, true);
+  MyCan.NotifyListeners(&frame, true);
 
   return ESP_OK;
   }
@@ -664,6 +758,33 @@ esp_err_t CAN_frame_t::Write(canbus* bus /*=NULL*/, TickType_t maxqueuewait /*=0
   }
 
 
+/**
+ * CAN_TimestampExtend: get the full esp_timer time of a frame timestamp
+ *  (timestamp must not be older than ~71 minutes)
+ */
+int64_t CAN_TimestampExtend(uint32_t timestamp)
+  {
+  int64_t now = esp_timer_get_time();
+  return now - (uint32_t)((uint32_t)now - timestamp);
+  }
+
+/**
+ * CAN_TimestampToTimeval: get the system (wall clock) time of a frame timestamp
+ */
+void CAN_TimestampToTimeval(uint32_t timestamp, struct timeval* tv)
+  {
+  gettimeofday(tv, NULL);
+  uint32_t age = CAN_Timestamp() - timestamp;
+  tv->tv_sec -= age / 1000000;
+  tv->tv_usec -= age % 1000000;
+  if (tv->tv_usec < 0)
+    {
+    tv->tv_sec--;
+    tv->tv_usec += 1000000;
+    }
+  }
+
+
 /**
  * Tracing/logging
  */
@@ -710,7 +831,7 @@ bool canbus::StatusChanged()
   // simple checksum to prevent log flooding:
   uint32_t chksum = m_status.packets_rx + m_status.packets_tx + m_status.errors_rx + m_status.errors_tx
     + m_status.rxbuf_overflow + m_status.txbuf_overflow + m_status.error_flags + m_status.txbuf_delay
-    + m_status.watchdog_resets;
+    + m_status.watchdog_resets + m_status.rxring_overflow + m_status.listener_overflow;
   if (chksum != m_status_chksum)
     {
     m_status_chksum = chksum;
@@ -44,7 +44,10 @@
 #include <list>
 #include "pcp.h"
 #include <esp_err.h>
+#include <esp_timer.h>
+#include <sys/time.h>
 #include "ovms_events.h"
+#include "canring.h"
 
 #ifndef ESP_QUEUED
 #define ESP_QUEUED           1    // frame has been queued for later processing
@@ -110,11 +113,28 @@ struct CAN_frame_t
     uint8_t   u8[8];                    // Payload byte access
     uint32_t  u32[2];                   // Payload u32 access (Att: little endian!)
     } data;
+  uint32_t    timestamp;                // RX/TX time [us], see CAN_Timestamp()
 
   esp_err_t Write(canbus* bus=NULL, TickType_t maxqueuewait=0);  // bus: NULL=origin
   };
 
 
+/**
+ * CAN frame timestamps: esp_timer microseconds truncated to 32 bit (wrapping
+ *  every ~71 minutes), taken by the drivers on reception (in the ISR where
+ *  possible) and by canbus::Write() on transmission.
+ *  Differences between timestamps are valid as long as they are < 71 minutes,
+ *  use CAN_TimestampExtend() / CAN_TimestampToTimeval() for absolute times.
+ *  Note: CAN_Timestamp() may be used from IRAM ISRs.
+ */
+inline __attribute__((always_inline)) uint32_t CAN_Timestamp()
+  {
+  return (uint32_t) esp_timer_get_time();
+  }
+int64_t CAN_TimestampExtend(uint32_t timestamp);
+void CAN_TimestampToTimeval(uint32_t timestamp, struct timeval* tv);
+
+
 /**
  * canbitset<StoreType>: CAN data packed bit extraction utility
  *  Usage examples:
@@ -190,6 +210,8 @@ typedef struct
   uint16_t errors_rx;               // RX error counter
   uint16_t errors_tx;               // TX error counter
   uint16_t watchdog_resets;         // Watchdog reset counter
+  uint16_t rxring_overflow;         // frames lost due to driver RX ring full
+  uint16_t listener_overflow;       // frames lost due to a listener ring full
   } CAN_status_t;
 
 // Log entry types:
@@ -209,7 +231,7 @@ typedef enum
 // Log message:
 typedef struct
   {
-  uint32_t timestamp;
+  int64_t timestamp;          // esp_timer time [us]
   canbus* bus;
   CAN_LogEntry_t type;
   union
@@ -221,6 +243,9 @@ typedef struct
   } CAN_LogMsg_t;
 
 class canlog;
+class OvmsWriter;
+class OvmsProfileEntry;
+class OvmsProfileQueue;
 
 class canbus : public pcp, public InternalRamAllocated
   {
@@ -232,6 +257,7 @@ class canbus : public pcp, public InternalRamAllocated
     virtual esp_err_t Start(CAN_mode_t mode, CAN_speed_t speed);
     virtual esp_err_t Stop();
     virtual void ClearStatus();
+    virtual void ShowStatus(int verbosity, OvmsWriter* writer) {}   // driver specific status
 
   public:
     virtual esp_err_t Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait=0);
@@ -257,10 +283,28 @@ class canbus : public pcp, public InternalRamAllocated
     uint32_t m_status_chksum;
     uint32_t m_watchdog_timer;
     QueueHandle_t m_txqueue;
+
+  protected:
+    std::string m_eventcaller;
   };
 
 typedef std::map<QueueHandle_t, bool> CanListenerMap_t;
 
+/**
+ * CanListenerRing: frame ring for listeners (alternative to a listener queue)
+ *  The CAN RX task is the single producer, so ring listeners get RX frames
+ *  only (no TX feedback). Frames received by other tasks (simulations,
+ *  shell commands) must pass the CAN RX task, see can::InjectFrame(). The consumer task is woken by a task notification
+ *  once per burst:
+ *    while (1)
+ *      {
+ *      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+ *      while (ring->Pop(&frame)) … process frame …
+ *      }
+ */
+typedef canring<CAN_frame_t, CONFIG_OVMS_HW_CAN_LISTENER_RING_SIZE> CanListenerRing;
+typedef std::map<CanListenerRing*, TaskHandle_t> CanListenerRingMap_t;
+
 typedef std::function<void(const CAN_frame_t*)> CanFrameCallback;
 class CanFrameCallbackEntry
   {
@@ -269,11 +313,13 @@ class CanFrameCallbackEntry
       {
       m_caller = caller;
       m_callback = callback;
+      m_profile = NULL;
       }
     ~CanFrameCallbackEntry() {}
   public:
     const char *m_caller;
     CanFrameCallback m_callback;
+    OvmsProfileEntry* m_profile;
   };
 typedef std::list<CanFrameCallbackEntry*> CanFrameCallbackList_t;
 
@@ -284,15 +330,20 @@ class can : public InternalRamAllocated
      ~can();
 
   public:
-    void IncomingFrame(CAN_frame_t* p_frame);
+    void IncomingFrame(CAN_frame_t* p_frame);   // CAN RX task only
+    bool InjectFrame(const CAN_frame_t* p_frame, TickType_t maxqueuewait=0);
 
   public:
     QueueHandle_t m_rxqueue;
+    OvmsProfileQueue* m_rxqueue_profile;
 
   public:
     void RegisterListener(QueueHandle_t queue, bool txfeedback=false);
     void DeregisterListener(QueueHandle_t queue);
+    void RegisterListener(CanListenerRing* ring, TaskHandle_t task);
+    void DeregisterListener(CanListenerRing* ring);
     void NotifyListeners(const CAN_frame_t* frame, bool tx);
+    UBaseType_t GetListenerQueueSpace();
 
   public:
     void RegisterCallback(const char* caller, CanFrameCallback callback, bool txfeedback=false);
@@ -309,6 +360,7 @@ class can : public InternalRamAllocated
 
   private:
     CanListenerMap_t m_listeners;
+    CanListenerRingMap_t m_listenerrings;
     CanFrameCallbackList_t m_rxcallbacks;
     CanFrameCallbackList_t m_txcallbacks;
     TaskHandle_t m_rxtask;            // Task to handle reception
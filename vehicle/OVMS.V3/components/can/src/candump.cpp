@@ -31,6 +31,10 @@
 
 candump::candump()
   {
+  m_puttime.tv_sec = 0;
+  m_puttime.tv_usec = 0;
+  m_puttx = false;
+  m_decodetx = false;
   }
 
 candump::~candump()
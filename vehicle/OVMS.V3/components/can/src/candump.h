@@ -45,6 +45,11 @@ class candump
     virtual std::string get(struct timeval *time, CAN_frame_t *frame);
     virtual std::string getheader(struct timeval *time);
     virtual size_t put(CAN_frame_t *frame, uint8_t *buffer, size_t len);
+
+  public:
+    struct timeval m_puttime;     // put(): recorded time of the frame decoded (if the format has one)
+    bool m_puttx;                 // put(): frame decoded was recorded as transmitted
+    bool m_decodetx;              // put(): also decode transmitted frames (default: received only)
   };
 
 #endif // __CANDUMP_H__
@@ -118,6 +118,25 @@ size_t candump_crtd::put(CAN_frame_t *frame, uint8_t *buffer, size_t len)
   // We look for something like
   // 1524311386.811100 1R11 100 01 02 03
   if (!isdigit(b[0])) return k+1;
+  char *p;
+  m_puttime.tv_sec = strtol(b,&p,10);
+  m_puttime.tv_usec = 0;
+  if (*p == '.')
+    {
+    // fraction may have less than 6 digits:
+    int digits = 0;
+    for (p++; isdigit(*p); p++)
+      {
+      if (digits < 6)
+        {
+        m_puttime.tv_usec = m_puttime.tv_usec*10 + (*p - '0');
+        digits++;
+        }
+      }
+    for (; digits < 6; digits++)
+      m_puttime.tv_usec *= 10;
+    }
+  b = p;
   for (;((*b != 0)&&(*b != ' '));b++) {}
   if (*b == 0) return k+1;
   b++;
@@ -128,23 +147,26 @@ size_t candump_crtd::put(CAN_frame_t *frame, uint8_t *buffer, size_t len)
     b++;
     }
 
-  if ((b[0]=='R')&&(b[1]=='1')&&(b[2]=='1'))
+  if ((b[0]!='R')&&((b[0]!='T')||(!m_decodetx)))
+    return k+1;
+  m_puttx = (b[0]=='T');
+
+  if ((b[1]=='1')&&(b[2]=='1'))
     {
-    // R11 incoming CAN frame
+    // R11/T11 CAN frame
     frame->FIR.B.FF = CAN_frame_std;
     }
-  else if ((b[0]=='R')&&(b[1]=='2')&&(b[2]=='9'))
+  else if ((b[1]=='2')&&(b[2]=='9'))
     {
-    // R29 incoming CAN frame
+    // R29/T29 CAN frame
     frame->FIR.B.FF = CAN_frame_ext;
     }
   else
-    return k+2;
+    return k+1;
 
   if (b[3] != ' ') return k+1;
   b += 4;
 
-  char *p;
   errno = 0;
   frame->MsgID = (uint32_t)strtol(b,&p,16);
   if ((frame->MsgID == 0)&&(errno != 0)) return k+1;
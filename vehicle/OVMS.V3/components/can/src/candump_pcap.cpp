@@ -173,6 +173,9 @@ size_t candump_pcap::put(CAN_frame_t *frame, uint8_t *buffer, size_t len)
   frame->FIR.B.RTR = (idf & CANDUMP_PCAP_FL_RTR)?CAN_RTR:CAN_no_RTR;
   frame->FIR.B.FF = (idf & CANDUMP_PCAP_FL_EXT)?CAN_frame_ext:CAN_frame_std;
   frame->MsgID = idf & CANDUMP_PCAP_FL_MASK;
+  m_puttime.tv_sec = be32toh(m->hdr.ts_sec);
+  m_puttime.tv_usec = be32toh(m->hdr.ts_usec);
+  m_puttx = false;
   frame->origin = (canbus*)MyPcpApp.FindDeviceByName("can1");
   frame->FIR.B.DLC = m->phdr.len;
   memcpy(frame->data.u8, m->data, m->phdr.len);
@@ -276,7 +276,11 @@ void canlog::LogFrame(canbus* bus, CAN_LogEntry_t type, const CAN_frame_t* frame
   if (CheckFilter(bus, type, frame))
     {
     CAN_LogMsg_t msg;
-    msg.timestamp = esp_log_timestamp();
+    // RX & TX frames carry the time of reception / transmission:
+    if (type == CAN_LogFrame_RX || type == CAN_LogFrame_TX)
+      msg.timestamp = CAN_TimestampExtend(frame->timestamp);
+    else
+      msg.timestamp = esp_timer_get_time();
     msg.bus = bus;
     msg.type = type;
     msg.frame = *frame;
@@ -293,7 +297,7 @@ void canlog::LogStatus(canbus* bus, CAN_LogEntry_t type, const CAN_status_t* sta
   if (CheckFilter(bus, type))
     {
     CAN_LogMsg_t msg;
-    msg.timestamp = esp_log_timestamp();
+    msg.timestamp = esp_timer_get_time();
     msg.bus = bus;
     msg.type = type;
     msg.status = *status;
@@ -310,7 +314,7 @@ void canlog::LogInfo(canbus* bus, CAN_LogEntry_t type, const char* text)
   if (CheckFilter(bus, type))
     {
     CAN_LogMsg_t msg;
-    msg.timestamp = esp_log_timestamp();
+    msg.timestamp = esp_timer_get_time();
     msg.bus = bus;
     msg.type = type;
     msg.text = strdup(text);
@@ -340,14 +344,14 @@ void canlog_trace::OutputMsg(CAN_LogMsg_t& msg)
         GetLogEntryTypeName(msg.type), msg.bus->GetName(),
         (msg.frame.FIR.B.FF == CAN_frame_std) ? 3 : 8, msg.frame.MsgID, msg.frame.FIR.B.DLC);
       FormatHexDump(&hexdump, (const char*)msg.frame.data.u8, msg.frame.FIR.B.DLC, 8);
-      esp_log_write(ESP_LOG_VERBOSE, TAG, LOG_FORMAT(V, "%s"), msg.timestamp, TAG, buffer);
+      esp_log_write(ESP_LOG_VERBOSE, TAG, LOG_FORMAT(V, "%s"), (uint32_t)(msg.timestamp / 1000), TAG, buffer);
       }
       break;
 
     case CAN_LogStatus_Error:
       esp_log_write(ESP_LOG_ERROR, TAG,
         LOG_FORMAT(E, "%s %s intr=%d rxpkt=%d txpkt=%d errflags=%#x rxerr=%d txerr=%d rxovr=%d txovr=%d txdelay=%d wdgreset=%d"),
-        msg.timestamp, TAG,
+        (uint32_t)(msg.timestamp / 1000), TAG,
         GetLogEntryTypeName(msg.type), msg.bus->GetName(),
         msg.status.interrupts,
         msg.status.packets_rx, msg.status.packets_tx,
@@ -358,7 +362,7 @@ void canlog_trace::OutputMsg(CAN_LogMsg_t& msg)
     case CAN_LogStatus_Statistics:
       esp_log_write(ESP_LOG_DEBUG, TAG,
         LOG_FORMAT(D, "%s %s intr=%d rxpkt=%d txpkt=%d errflags=%#x rxerr=%d txerr=%d rxovr=%d txovr=%d txdelay=%d wdgreset=%d"),
-        msg.timestamp, TAG,
+        (uint32_t)(msg.timestamp / 1000), TAG,
         GetLogEntryTypeName(msg.type), msg.bus->GetName(),
         msg.status.interrupts,
         msg.status.packets_rx, msg.status.packets_tx,
@@ -372,7 +376,7 @@ void canlog_trace::OutputMsg(CAN_LogMsg_t& msg)
     case CAN_LogInfo_Event:
       esp_log_write(ESP_LOG_DEBUG, TAG,
         LOG_FORMAT(D, "canlog %s %s %s"),
-        msg.timestamp, TAG,
+        (uint32_t)(msg.timestamp / 1000), TAG,
         GetLogEntryTypeName(msg.type), msg.bus ? msg.bus->GetName() : "*", msg.text);
       break;
 
@@ -411,8 +415,8 @@ void canlog_crtd::OutputMsg(CAN_LogMsg_t& msg)
     {
     case CAN_LogFrame_RX:
     case CAN_LogFrame_TX:
-      fprintf(m_file, "%d.%03d %s%c%s %0*X",
-        msg.timestamp / 1000, msg.timestamp % 1000, msg.bus->GetName()+3,
+      fprintf(m_file, "%u.%06u %s%c%s %0*X",
+        (uint32_t)(msg.timestamp / 1000000), (uint32_t)(msg.timestamp % 1000000), msg.bus->GetName()+3,
         (msg.type == CAN_LogFrame_RX) ? 'R' : 'T', (msg.frame.FIR.B.FF == CAN_frame_std) ? "11" : "29",
         (msg.frame.FIR.B.FF == CAN_frame_std) ? 3 : 8, msg.frame.MsgID);
       for (int i=0; i<msg.frame.FIR.B.DLC; i++)
@@ -422,8 +426,8 @@ void canlog_crtd::OutputMsg(CAN_LogMsg_t& msg)
 
     case CAN_LogFrame_TX_Queue:
     case CAN_LogFrame_TX_Fail:
-      fprintf(m_file, "%d.%03d %sCEV %s %c%s %0*X",
-        msg.timestamp / 1000, msg.timestamp % 1000, msg.bus->GetName()+3,
+      fprintf(m_file, "%u.%06u %sCEV %s %c%s %0*X",
+        (uint32_t)(msg.timestamp / 1000000), (uint32_t)(msg.timestamp % 1000000), msg.bus->GetName()+3,
         GetLogEntryTypeName(msg.type),
         (msg.type == CAN_LogFrame_RX) ? 'R' : 'T', (msg.frame.FIR.B.FF == CAN_frame_std) ? "11" : "29",
         (msg.frame.FIR.B.FF == CAN_frame_std) ? 3 : 8, msg.frame.MsgID);
@@ -434,8 +438,8 @@ void canlog_crtd::OutputMsg(CAN_LogMsg_t& msg)
 
     case CAN_LogStatus_Error:
     case CAN_LogStatus_Statistics:
-      fprintf(m_file, "%d.%03d %s%s %s intr=%d rxpkt=%d txpkt=%d errflags=%#x rxerr=%d txerr=%d rxovr=%d txovr=%d txdelay=%d wdgreset=%d\n",
-        msg.timestamp / 1000, msg.timestamp % 1000, msg.bus->GetName()+3,
+      fprintf(m_file, "%u.%06u %s%s %s intr=%d rxpkt=%d txpkt=%d errflags=%#x rxerr=%d txerr=%d rxovr=%d txovr=%d txdelay=%d wdgreset=%d\n",
+        (uint32_t)(msg.timestamp / 1000000), (uint32_t)(msg.timestamp % 1000000), msg.bus->GetName()+3,
         (msg.type == CAN_LogStatus_Error) ? "CEV" : "CXX",
         GetLogEntryTypeName(msg.type), msg.status.interrupts,
         msg.status.packets_rx, msg.status.packets_tx, msg.status.error_flags,
@@ -447,8 +451,8 @@ void canlog_crtd::OutputMsg(CAN_LogMsg_t& msg)
     case CAN_LogInfo_Comment:
     case CAN_LogInfo_Config:
     case CAN_LogInfo_Event:
-      fprintf(m_file, "%d.%03d %s%s %s %s\n",
-        msg.timestamp / 1000, msg.timestamp % 1000, msg.bus ? msg.bus->GetName()+3 : "",
+      fprintf(m_file, "%u.%06u %s%s %s %s\n",
+        (uint32_t)(msg.timestamp / 1000000), (uint32_t)(msg.timestamp % 1000000), msg.bus ? msg.bus->GetName()+3 : "",
         (msg.type == CAN_LogInfo_Event) ? "CEV" : "CXX",
         GetLogEntryTypeName(msg.type), msg.text);
       break;
@@ -0,0 +1,167 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN lock-free single producer / single consumer ring
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __CANRING_H__
+#define __CANRING_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+#ifndef CANRING_ALIGN
+#define CANRING_ALIGN         32    // distance of producer & consumer state (cache line size)
+#endif
+
+/**
+ * canring<ItemType,Size>: lock-free single producer / single consumer ring
+ *
+ *  Used to pass frames from a driver ISR to the CAN RX task without a kernel
+ *  call per frame. The producer only writes m_head, the consumer only writes
+ *  m_tail, so no locking is needed as long as there is exactly one of each.
+ *
+ *  Producer (i.e. ISR):
+ *    CAN_frame_t* frame = ring.Reserve();  -- NULL = ring full (count overflow)
+ *    … fill *frame …
+ *    if (ring.Commit()) … wake up consumer (i.e. queue a CAN_rxcallback) …
+ *    … if the wakeup could not be delivered: ring.WakeupFailed()
+ *   or by copy:
+ *    if (!ring.Push(frame, &wakeup)) … count overflow …
+ *
+ *  Consumer:
+ *    while (ring.Pop(&frame)) … process frame …
+ *   or zero copy:
+ *    while ((frame = ring.Front()) != NULL) { … process *frame …; ring.Release(); }
+ *
+ *  Commit() only requests a wakeup for the first frame after the consumer ran
+ *  dry, so a burst of frames costs a single wakeup. The consumer re-arms the
+ *  wakeup when it finds the ring empty.
+ *
+ *  Size must be a power of 2. Items are copied by assignment, use POD types.
+ *  Producer methods are forced inline so they can be used from IRAM ISRs.
+ */
+template <typename ItemType, uint32_t Size>
+class canring
+  {
+  static_assert(Size >= 2 && (Size & (Size-1)) == 0, "canring Size must be a power of 2");
+
+  public:
+    canring()
+      : m_head(0), m_wakeup(false), m_tail(0)
+      {
+      }
+
+  public:
+    // Producer API:
+
+    inline __attribute__((always_inline)) ItemType* Reserve()
+      {
+      uint32_t head = m_head.load(std::memory_order_relaxed);
+      if (head - m_tail.load(std::memory_order_acquire) >= Size)
+        return NULL;
+      return &m_items[head & (Size-1)];
+      }
+
+    // Commit: publish the reserved item, returns true if the consumer needs a wakeup
+    inline __attribute__((always_inline)) bool Commit()
+      {
+      m_head.store(m_head.load(std::memory_order_relaxed) + 1);
+      if (m_wakeup.load())
+        return false;
+      m_wakeup.store(true);
+      return true;
+      }
+
+    // Push: copy & commit an item, returns false if the ring is full;
+    //  *wakeup is set if the consumer needs a wakeup
+    inline __attribute__((always_inline)) bool Push(const ItemType& item, bool* wakeup)
+      {
+      ItemType* slot = Reserve();
+      if (!slot)
+        return false;
+      *slot = item;
+      *wakeup = Commit();
+      return true;
+      }
+
+    // WakeupFailed: the wakeup requested by Commit() could not be delivered, retry on next Commit()
+    inline __attribute__((always_inline)) void WakeupFailed()
+      {
+      m_wakeup.store(false);
+      }
+
+  public:
+    // Consumer API:
+
+    ItemType* Front()
+      {
+      uint32_t tail = m_tail.load(std::memory_order_relaxed);
+      if (m_head.load() == tail)
+        {
+        // ring empty: re-arm wakeup, then check again for a concurrent Commit()
+        m_wakeup.store(false);
+        if (m_head.load() == tail)
+          return NULL;
+        }
+      return &m_items[tail & (Size-1)];
+      }
+
+    void Release()
+      {
+      m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+      }
+
+    bool Pop(ItemType* item)
+      {
+      ItemType* slot = Front();
+      if (!slot)
+        return false;
+      *item = *slot;
+      Release();
+      return true;
+      }
+
+  public:
+    // Status (approximate if called concurrently):
+    uint32_t GetSize() { return Size; }
+    uint32_t UsedSpace() { return m_head.load() - m_tail.load(); }
+    uint32_t FreeSpace() { return Size - UsedSpace(); }
+
+  protected:
+    // Producer & consumer state are kept CANRING_ALIGN bytes apart by padding,
+    // so they never share a cache line. (Not by alignas: rings are allocated
+    // by new, which does not honor over-alignment before C++17.)
+    // producer state:
+    std::atomic<uint32_t> m_head;
+    std::atomic<bool> m_wakeup;
+    uint8_t m_pad_producer[CANRING_ALIGN];
+    // consumer state:
+    std::atomic<uint32_t> m_tail;
+    uint8_t m_pad_consumer[CANRING_ALIGN];
+    // storage:
+    ItemType m_items[Size];
+  };
+
+#endif //#ifndef __CANRING_H__
@@ -0,0 +1,157 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN signal extraction
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __CANSIGNAL_H__
+#define __CANSIGNAL_H__
+
+#include <stdint.h>
+#include "can.h"
+
+// Signal byte order, values match the DBC "@0" / "@1" notation:
+typedef enum
+  {
+  CAN_SIG_MOTOROLA = 0,     // big endian, start bit = MSB (DBC sawtooth numbering)
+  CAN_SIG_INTEL = 1         // little endian, start bit = LSB
+  } cansignal_order_t;
+
+/**
+ * cansignal: CAN signal descriptor
+ *
+ *  Describes a signal of 1…32 bits within an 8 byte CAN payload using the DBC
+ *  conventions (start bit, length, byte order, signedness, factor & offset).
+ *  The constructor is constexpr and precomputes the bit shift, so descriptors
+ *  declared as "static constexpr" compile down to a single shift & mask on
+ *  extraction:
+ *
+ *    // SG_ BatteryCurrent : 16|16@1- (0.1,0) [..] "A"
+ *    static constexpr cansignal sig_current(16, 16, CAN_SIG_INTEL, true, 0.1);
+ *    // SG_ SOC : 7|10@0+ (0.1,0) [..] "%"
+ *    static constexpr cansignal sig_soc(7, 10, CAN_SIG_MOTOROLA, false, 0.1);
+ *
+ *  Descriptors can also be built at runtime (i.e. by the DBC decoder).
+ */
+struct cansignal
+  {
+  uint8_t   order;          // cansignal_order_t
+  uint8_t   length;         // bit length 1…32
+  uint8_t   shift;          // LSB position within the 64 bit payload word of the byte order
+  bool      is_signed;      // two's complement
+  float     factor;
+  float     offset;
+
+  constexpr cansignal()
+    : order(CAN_SIG_INTEL), length(0), shift(0), is_signed(false), factor(1), offset(0)
+    {
+    }
+
+  constexpr cansignal(int startbit, int bitlength, cansignal_order_t byteorder=CAN_SIG_INTEL,
+                      bool valuesigned=false, float scale=1, float add=0)
+    : order(byteorder), length(bitlength)
+    , shift((byteorder == CAN_SIG_INTEL)
+        ? startbit
+        : ((7 - (startbit >> 3)) << 3) + (startbit & 7) - bitlength + 1)
+    , is_signed(valuesigned), factor(scale), offset(add)
+    {
+    }
+
+  constexpr uint32_t mask() const
+    {
+    return (length >= 32) ? 0xffffffffU : ((1U << length) - 1);
+    }
+  };
+
+/**
+ * canpayload: CAN payload loaded for signal extraction
+ *
+ *  Loads the 8 payload bytes once in both byte orders, so any number of
+ *  signals can be extracted from a single frame load:
+ *
+ *    canpayload payload(p_frame);
+ *    float current = payload.Get(sig_current);
+ *    float soc = payload.Get(sig_soc);
+ *
+ *  This replaces canbitset<> for new code: canbitset reloads and shifts the
+ *  whole store per field and has no notion of byte order or signedness.
+ *  Note: no sanity checks, the payload is always read as 8 bytes.
+ */
+class canpayload
+  {
+  public:
+    canpayload()
+      {
+      }
+    canpayload(const uint8_t* data)
+      {
+      Load(data);
+      }
+    canpayload(const CAN_frame_t* frame)
+      {
+      Load(frame->data.u8);
+      }
+
+  public:
+    inline void Load(const uint8_t* d)
+      {
+      m_intel[0] = (uint32_t)d[0] | ((uint32_t)d[1] << 8) | ((uint32_t)d[2] << 16) | ((uint32_t)d[3] << 24);
+      m_intel[1] = (uint32_t)d[4] | ((uint32_t)d[5] << 8) | ((uint32_t)d[6] << 16) | ((uint32_t)d[7] << 24);
+      m_motorola[0] = __builtin_bswap32(m_intel[1]);
+      m_motorola[1] = __builtin_bswap32(m_intel[0]);
+      }
+
+    // unsigned raw value:
+    inline __attribute__((always_inline)) uint32_t GetRaw(const cansignal& sig) const
+      {
+      const uint32_t* w = (sig.order == CAN_SIG_INTEL) ? m_intel : m_motorola;
+      if (sig.shift >= 32)
+        return (w[1] >> (sig.shift - 32)) & sig.mask();
+      else if (sig.shift + sig.length <= 32)
+        return (w[0] >> sig.shift) & sig.mask();
+      else
+        return ((w[0] >> sig.shift) | (w[1] << (32 - sig.shift))) & sig.mask();
+      }
+
+    // raw value, sign extended if the signal is signed:
+    inline __attribute__((always_inline)) int32_t GetInt(const cansignal& sig) const
+      {
+      uint32_t raw = GetRaw(sig);
+      if (sig.is_signed && sig.length < 32)
+        return ((int32_t)(raw << (32 - sig.length))) >> (32 - sig.length);
+      return (int32_t)raw;
+      }
+
+    // physical value (raw * factor + offset):
+    inline __attribute__((always_inline)) float Get(const cansignal& sig) const
+      {
+      float raw = sig.is_signed ? (float)GetInt(sig) : (float)GetRaw(sig);
+      return raw * sig.factor + sig.offset;
+      }
+
+  public:
+    uint32_t m_intel[2];      // little endian 64 bit payload, [0]=low word
+    uint32_t m_motorola[2];   // big endian 64 bit payload, [0]=low word
+  };
+
+#endif //#ifndef __CANSIGNAL_H__
@@ -0,0 +1,516 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN replay bus
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "canreplay";
+
+#include <stdlib.h>
+#include <algorithm>
+#include <string.h>
+#include "canreplay.h"
+#include "candump_crtd.h"
+#include "candump_pcap.h"
+#include "ovms_command.h"
+#include "vehicle.h"
+
+canreplay* MyCanReplay = NULL;
+
+static void CanReplayTask(void *pvParameters)
+  {
+  canreplay* me = (canreplay*)pvParameters;
+  me->Task();
+  }
+
+canreplay::canreplay(canbus* bus)
+  : canbus(bus->GetName())
+  {
+  m_bus = bus;
+  m_timescale = 1;
+  m_file = NULL;
+  m_dump = NULL;
+  m_busfilter = true;
+  m_task = NULL;
+  m_stop = false;
+  m_rec_start = -1;
+  m_start = 0;
+  m_finish = 0;
+  m_rec_service = 0;
+  m_rec_time = 0;
+  m_rec_remain = 0;
+  m_answer = NULL;
+  m_frames_read = 0;
+  m_frames_replayed = 0;
+  m_frames_learned = 0;
+  m_stalls = 0;
+  m_polls_answered = 0;
+  m_polls_unanswered = 0;
+  }
+
+canreplay::~canreplay()
+  {
+  Close();
+  }
+
+/**
+ * Instance: get the replay bus for a physical bus
+ *  - created on first use, kept for the next replays (see class notes)
+ */
+canreplay* canreplay::Instance(canbus* bus)
+  {
+  static std::map<canbus*, canreplay*> instances;
+  canreplay*& replay = instances[bus];
+  if (!replay)
+    replay = new canreplay(bus);
+  return replay;
+  }
+
+esp_err_t canreplay::Start(CAN_mode_t mode, CAN_speed_t speed)
+  {
+  m_mode = mode;
+  m_speed = speed;
+  return ESP_OK;
+  }
+
+esp_err_t canreplay::Stop()
+  {
+  m_mode = CAN_MODE_OFF;
+  return ESP_OK;
+  }
+
+/**
+ * Open: prepare a replay of the capture at path
+ *  - resets the statistics & responses learned from a previous replay
+ *  - takes over the name & configuration of the physical bus
+ */
+bool canreplay::Open(const char* path, float timescale)
+  {
+  Close();
+  m_file = fopen(path, "r");
+  if (!m_file)
+    return false;
+  m_path = path;
+  m_timescale = timescale;
+
+  // PCAP files start with the magic number, CRTD lines with the time:
+  int c = fgetc(m_file);
+  rewind(m_file);
+  if (c == 0xa1 || c == 0xd4 || c == 0x4d)
+    {
+    m_dump = new candump_pcap();
+    m_busfilter = false;
+    }
+  else
+    {
+    m_dump = new candump_crtd();
+    m_busfilter = true;
+    }
+  m_dump->m_decodetx = true;
+
+  m_stop = false;
+  m_rec_start = -1;
+  m_start = m_finish = esp_timer_get_time();
+  m_rec_request.clear();
+  m_rec_response.clear();
+  m_rec_remain = 0;
+  m_frames_read = 0;
+  m_frames_replayed = 0;
+  m_frames_learned = 0;
+  m_stalls = 0;
+  m_polls_answered = 0;
+  m_polls_unanswered = 0;
+  m_responsemutex.Lock();
+  m_responses.clear();
+  m_answer = NULL;
+  m_responsemutex.Unlock();
+  ClearStatus();
+
+  m_mode = m_bus->m_mode;
+  m_speed = m_bus->m_speed;
+  MyPcpApp.m_map[m_name] = this;
+  return true;
+  }
+
+void canreplay::Play()
+  {
+  xTaskCreatePinnedToCore(CanReplayTask, "OVMS CanReplay", 4096, (void*)this, 4, &m_task, 1);
+  }
+
+/**
+ * Close: stop the replay task & close the capture
+ *  - returns the bus name to the physical bus
+ */
+void canreplay::Close()
+  {
+  m_stop = true;
+  while (m_task != NULL)
+    vTaskDelay(pdMS_TO_TICKS(10));
+  m_mode = CAN_MODE_OFF;
+
+  if (m_file)
+    {
+    fclose(m_file);
+    m_file = NULL;
+    }
+  if (m_dump)
+    {
+    delete m_dump;
+    m_dump = NULL;
+    }
+  if (MyPcpApp.FindDeviceByName(m_name) == this)
+    MyPcpApp.m_map[m_name] = m_bus;
+  }
+
+void canreplay::Task()
+  {
+  uint8_t buf[512];
+  size_t len;
+  CAN_frame_t frame;
+
+  m_start = esp_timer_get_time();
+  while (!m_stop && (len = fread(buf, 1, sizeof(buf), m_file)) > 0)
+    {
+    uint8_t* bp = buf;
+    while (!m_stop && len > 0)
+      {
+      size_t used = m_dump->put(&frame, bp, len);
+      if (used == 0 || used > len)
+        break;
+      bp += used;
+      len -= used;
+      if (frame.origin != NULL)
+        ReplayFrame(&frame);
+      }
+    }
+  m_finish = esp_timer_get_time();
+
+  double secs = (m_finish - m_start) / 1000000.0;
+  ESP_LOGI(TAG, "%s: replay %s: %u frames in %.3f sec = %.1f frames/s", m_name,
+    m_stop ? "stopped" : "finished", m_frames_replayed, secs, (secs > 0) ? m_frames_replayed / secs : 0);
+
+  m_task = NULL;
+  vTaskDelete(NULL);
+  }
+
+void canreplay::ReplayFrame(CAN_frame_t* frame)
+  {
+  if (frame->origin != this)
+    {
+    if (m_busfilter)
+      return; // recorded on another bus
+    frame->origin = this;
+    }
+  m_frames_read++;
+
+  int64_t rectime = (int64_t)m_dump->m_puttime.tv_sec * 1000000 + m_dump->m_puttime.tv_usec;
+  if (LearnResponse(frame, rectime) || m_dump->m_puttx)
+    return;
+
+  if (m_rec_start < 0)
+    {
+    m_rec_start = rectime;
+    m_start = esp_timer_get_time();
+    }
+  else if (m_timescale > 0)
+    {
+    // wait for the (scaled) recorded time, at tick resolution:
+    int64_t due = m_start + (int64_t)((rectime - m_rec_start) / m_timescale);
+    int64_t wait;
+    while (!m_stop && (wait = due - esp_timer_get_time()) >= portTICK_PERIOD_MS*1000)
+      vTaskDelay(std::min(wait / (portTICK_PERIOD_MS*1000), (int64_t)pdMS_TO_TICKS(100)));
+    }
+
+  // don't overrun the listeners (i.e. the vehicle RX queue),
+  // they need room for all frames pending in the CAN RX queue:
+  if (MyCan.GetListenerQueueSpace() <= uxQueueMessagesWaiting(MyCan.m_rxqueue))
+    {
+    m_stalls++;
+    while (!m_stop && MyCan.GetListenerQueueSpace() <= uxQueueMessagesWaiting(MyCan.m_rxqueue))
+      vTaskDelay(1);
+    }
+
+  if (InjectFrame(frame, portMAX_DELAY))
+    m_frames_replayed++;
+  }
+
+/**
+ * LearnResponse: record poll responses from the capture
+ *  - a transmitted ISO-TP single frame is taken as a request
+ *  - the next positive/negative response single frame resp. first frame
+ *    with consecutive frames following is stored as its answer
+ *  - returns true if the frame has been taken as part of a response
+ */
+bool canreplay::LearnResponse(CAN_frame_t* frame, int64_t rectime)
+  {
+  uint8_t type = frame->data.u8[0] >> 4;
+
+  if (m_dump->m_puttx)
+    {
+    if (type == 0 && frame->FIR.B.DLC >= 2)
+      {
+      m_rec_request = RequestKey(frame);
+      m_rec_service = frame->data.u8[1];
+      m_rec_time = rectime;
+      m_rec_response.clear();
+      }
+    return false;
+    }
+
+  if (m_rec_request.empty())
+    return false;
+  if (rectime - m_rec_time > 1000000)
+    {
+    // no (complete) response within 1 second:
+    m_rec_request.clear();
+    return false;
+    }
+
+  if (m_rec_response.empty())
+    {
+    if (type == 0 &&
+        ((frame->data.u8[1] == m_rec_service + 0x40) ||
+         (frame->data.u8[1] == 0x7f && frame->data.u8[2] == m_rec_service)))
+      {
+      m_rec_remain = 0;
+      }
+    else if (type == 1 && frame->data.u8[2] == m_rec_service + 0x40)
+      {
+      m_rec_remain = (((frame->data.u8[0] & 0x0f) << 8) | frame->data.u8[1]) - 6;
+      }
+    else
+      {
+      return false;
+      }
+    }
+  else if (type != 2 || frame->MsgID != m_rec_response.front().MsgID)
+    {
+    return false;
+    }
+  else
+    {
+    m_rec_remain -= 7;
+    }
+
+  m_rec_response.push_back(*frame);
+  m_frames_learned++;
+  if (m_rec_remain <= 0)
+    {
+    OvmsMutexLock lock(&m_responsemutex);
+    m_responses[m_rec_request] = m_rec_response;
+    m_rec_request.clear();
+    }
+  return true;
+  }
+
+/**
+ * RequestKey: ID & ISO-TP single frame payload (without padding)
+ */
+std::string canreplay::RequestKey(const CAN_frame_t* frame)
+  {
+  int len = (frame->data.u8[0] & 0x0f) + 1;
+  if (len > frame->FIR.B.DLC)
+    len = frame->FIR.B.DLC;
+  std::string key((const char*)&frame->MsgID, sizeof(frame->MsgID));
+  key.append((const char*)frame->data.u8, len);
+  return key;
+  }
+
+bool canreplay::InjectFrame(const CAN_frame_t* frame, TickType_t maxqueuewait)
+  {
+  CAN_frame_t rxframe = *frame;
+  rxframe.origin = this;
+  rxframe.timestamp = CAN_Timestamp();
+  return MyCan.InjectFrame(&rxframe, maxqueuewait);
+  }
+
+/**
+ * Write: frames sent are logged & passed to the TX listeners like on a real
+ *  bus; ISO-TP requests are answered by their recorded responses, multi frame
+ *  responses continue on the flow control frame.
+ */
+esp_err_t canreplay::Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*=0*/)
+  {
+  if (m_mode != CAN_MODE_ACTIVE)
+    {
+    ESP_LOGW(TAG,"Cannot write %s when not in ACTIVE mode",m_name);
+    return ESP_OK;
+    }
+
+  canbus::Write(p_frame, maxqueuewait);
+
+  // Note: answers are sent without waiting, as we may be called by a
+  //  listener of the RX queue (i.e. the vehicle poller)
+  uint8_t type = p_frame->data.u8[0] >> 4;
+  OvmsMutexLock lock(&m_responsemutex);
+  if (type == 0 && p_frame->FIR.B.DLC >= 2)
+    {
+    m_answer = NULL;
+    auto it = m_responses.find(RequestKey(p_frame));
+    if (it == m_responses.end())
+      {
+      m_polls_unanswered++;
+      return ESP_OK;
+      }
+    m_polls_answered++;
+    InjectFrame(&it->second.front(), 0);
+    if (it->second.size() > 1)
+      m_answer = &it->second;
+    }
+  else if (type == 3 && m_answer)
+    {
+    for (auto it = m_answer->begin()+1; it != m_answer->end(); it++)
+      InjectFrame(&*it, 0);
+    m_answer = NULL;
+    }
+
+  return ESP_OK;
+  }
+
+void canreplay::ShowStatus(int verbosity, OvmsWriter* writer)
+  {
+  int64_t end = IsRunning() ? esp_timer_get_time() : m_finish;
+  double secs = (end - m_start) / 1000000.0;
+
+  writer->printf("Replay:    %s (%s, %s)\n", m_path.c_str(),
+    m_dump ? m_dump->formatname() : "-", IsRunning() ? "running" : "finished");
+  if (m_timescale > 0)
+    writer->printf("Timescale: %.1fx\n", m_timescale);
+  else
+    writer->puts("Timescale: max");
+  writer->printf("Read:      %20u\n", m_frames_read);
+  writer->printf("Replayed:  %20u\n", m_frames_replayed);
+  writer->printf("Learned:   %20u\n", m_frames_learned);
+  writer->printf("Stalls:    %20u\n", m_stalls);
+  writer->printf("Poll ans:  %20u\n", m_polls_answered);
+  writer->printf("Poll miss: %20u\n", m_polls_unanswered);
+  writer->printf("Duration:  %20.3f sec\n", secs);
+  writer->printf("Frames/s:  %20.1f\n", (secs > 0) ? m_frames_replayed / secs : 0);
+  }
+
+
+/**
+ * Shell commands:
+ *    can replay start <bus> <path> [<timescale>]
+ *    can replay stop
+ *    can replay status
+ *
+ * The vehicle module (if any) is reloaded on start and stop to bind to the
+ *  replay resp. the physical bus.
+ */
+
+static void can_replay_reload_vehicle(OvmsWriter* writer, std::string vehicletype)
+  {
+  if (vehicletype.empty())
+    return;
+  MyVehicleFactory.SetVehicle(vehicletype.c_str());
+  writer->printf("Vehicle module %s reloaded\n", vehicletype.c_str());
+  }
+
+void can_replay_start(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (MyCanReplay)
+    {
+    writer->printf("Error: replay on %s still active, please stop first\n", MyCanReplay->GetName());
+    return;
+    }
+
+  canbus* bus = (canbus*)MyPcpApp.FindDeviceByName(argv[0]);
+  if (bus == NULL || strncmp(argv[0], "can", 3) != 0)
+    {
+    writer->puts("Error: Cannot find named CAN bus");
+    return;
+    }
+
+  float timescale = (argc > 2) ? atof(argv[2]) : 1;
+  if (timescale < 0)
+    {
+    writer->puts("Error: invalid timescale");
+    return;
+    }
+
+  canreplay* replay = canreplay::Instance(bus);
+  if (!replay->Open(argv[1], timescale))
+    {
+    writer->printf("Error: cannot open '%s'\n", argv[1]);
+    return;
+    }
+  MyCanReplay = replay;
+
+  can_replay_reload_vehicle(writer, MyVehicleFactory.ActiveVehicleType());
+
+  replay->Play();
+  writer->printf("CAN replay on %s started: %s\n", replay->GetName(), argv[1]);
+  }
+
+void can_replay_stop(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (!MyCanReplay)
+    {
+    writer->puts("CAN replay inactive.");
+    return;
+    }
+
+  std::string vehicletype = MyVehicleFactory.ActiveVehicleType();
+  if (!vehicletype.empty())
+    MyVehicleFactory.ClearVehicle();
+
+  canreplay* replay = MyCanReplay;
+  MyCanReplay = NULL;
+  replay->ShowStatus(verbosity, writer);
+  replay->Close();
+
+  can_replay_reload_vehicle(writer, vehicletype);
+  writer->puts("CAN replay stopped.");
+  }
+
+void can_replay_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (!MyCanReplay)
+    {
+    writer->puts("CAN replay inactive.");
+    return;
+    }
+  writer->printf("CAN:       %s\n", MyCanReplay->GetName());
+  MyCanReplay->ShowStatus(verbosity, writer);
+  }
+
+class CanReplayInit
+  {
+  public:
+    CanReplayInit();
+  } CanReplayInit __attribute__ ((init_priority (4520)));
+
+CanReplayInit::CanReplayInit()
+  {
+  ESP_LOGI(TAG, "Initialising CAN replay (4520)");
+
+  OvmsCommand* cmd_can = MyCommandApp.RegisterCommand("can","CAN framework",NULL, "", 0, 0, true);
+  OvmsCommand* cmd_replay = cmd_can->RegisterCommand("replay","CAN replay framework",NULL, "", 0, 0, true);
+  cmd_replay->RegisterCommand("start","Replay CRTD/PCAP log on CAN bus",can_replay_start,
+    "<bus> <path> [<timescale>]\n"
+    "Timescale: 1 = original timing (default), 10 = 10 times faster, 0 = as fast as possible", 2, 3, true);
+  cmd_replay->RegisterCommand("stop","Stop replay",can_replay_stop,"",0,0,true);
+  cmd_replay->RegisterCommand("status","Show replay status",can_replay_status,"",0,0,true);
+  }
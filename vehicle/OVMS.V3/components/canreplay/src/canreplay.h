@@ -0,0 +1,122 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        CAN replay bus
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __CANREPLAY_H__
+#define __CANREPLAY_H__
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "can.h"
+#include "candump.h"
+#include "ovms_mutex.h"
+
+/**
+ * canreplay: canbus replaying a CRTD or PCAP capture
+ *
+ *  The replay bus takes over the name of a physical bus (e.g. "can1") until
+ *  stopped, so vehicle modules bind to it like to the real bus. Recorded
+ *  frames of that bus are fed into the normal CAN RX path with original,
+ *  scaled or no timing (timescale 1 / >1 / 0).
+ *
+ *  Poll requests written to the bus are answered from the recorded responses,
+ *  if the capture includes the transmitted requests (as written by "can log crtd").
+ *  Responses are learned while reading the capture and not replayed as such.
+ *
+ *  Replay buses are not deleted: there is one per physical bus, reused by the
+ *  next replay on it. Frames replayed may still be queued in the CAN RX path,
+ *  listener queues and CAN loggers after the replay has been stopped, and
+ *  these refer to their origin bus.
+ */
+
+typedef std::vector<CAN_frame_t> canreplay_response_t;
+typedef std::map<std::string, canreplay_response_t> canreplay_responsemap_t;
+
+class canreplay : public canbus
+  {
+  public:
+    canreplay(canbus* bus);
+    ~canreplay();
+    static canreplay* Instance(canbus* bus);
+
+  public:
+    esp_err_t Start(CAN_mode_t mode, CAN_speed_t speed);
+    esp_err_t Stop();
+    esp_err_t Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait=0);
+    virtual void ShowStatus(int verbosity, OvmsWriter* writer);
+
+  public:
+    bool Open(const char* path, float timescale);
+    void Play();
+    void Close();
+    void Task();
+    bool IsRunning() { return m_task != NULL; }
+    canbus* GetBus() { return m_bus; }
+
+  protected:
+    void ReplayFrame(CAN_frame_t* frame);
+    bool LearnResponse(CAN_frame_t* frame, int64_t rectime);
+    bool InjectFrame(const CAN_frame_t* frame, TickType_t maxqueuewait);
+    static std::string RequestKey(const CAN_frame_t* frame);
+
+  protected:
+    canbus* m_bus;                      // physical bus taken over
+    std::string m_path;
+    float m_timescale;                  // 0 = as fast as possible
+    FILE* m_file;
+    candump* m_dump;
+    bool m_busfilter;                   // capture identifies buses (crtd)
+    TaskHandle_t m_task;
+    volatile bool m_stop;
+
+    int64_t m_rec_start;                // recorded time of first frame [us]
+    int64_t m_start;                    // replay start [us]
+    int64_t m_finish;                   // replay end [us]
+
+    OvmsMutex m_responsemutex;
+    canreplay_responsemap_t m_responses;
+    std::string m_rec_request;          // recorded request awaiting the response
+    uint8_t m_rec_service;
+    int64_t m_rec_time;
+    canreplay_response_t m_rec_response;
+    int m_rec_remain;                   // response bytes outstanding
+    const canreplay_response_t* m_answer;   // multi frame answer awaiting flow control
+
+  public:
+    uint32_t m_frames_read;
+    uint32_t m_frames_replayed;
+    uint32_t m_frames_learned;
+    uint32_t m_stalls;                  // waits for listener queues
+    uint32_t m_polls_answered;
+    uint32_t m_polls_unanswered;
+  };
+
+extern canreplay* MyCanReplay;
+
+#endif //#ifndef __CANREPLAY_H__
@@ -91,7 +91,7 @@ std::string base64encode(const std::string inputData)
   uint8_t in[4];
   uint8_t out[4];
   int len = 0;
-  int k;
+  size_t k;
   std::string outputData;
   outputData.reserve(howmany(inputData.size(), 3) * 4);
   for (k=0;k<inputData.size();k++)
@@ -182,7 +182,7 @@ std::string base64decode(const std::string inputData)
   
   std::string outputData;
   outputData.reserve(howmany(inputData.size(), 4) * 3);
-  int ipos = 0;
+  size_t ipos = 0;
 
   while( c != 0 )
     {
@@ -634,12 +634,18 @@ dbcSignal::dbcSignal()
   {
   m_start_bit = 0;
   m_signal_size = 0;
+  m_byte_order = DBC_BYTEORDER_LITTLE_ENDIAN;
+  m_value_type = DBC_VALUETYPE_UNSIGNED;
   m_metric = NULL;
   }
 
 dbcSignal::dbcSignal(std::string name)
   {
   m_name = name;
+  m_start_bit = 0;
+  m_signal_size = 0;
+  m_byte_order = DBC_BYTEORDER_LITTLE_ENDIAN;
+  m_value_type = DBC_VALUETYPE_UNSIGNED;
   m_metric = MyMetrics.Find(name.c_str());
   }
 
@@ -812,28 +818,33 @@ void dbcSignal::SetStartSize(const int startbit, const int size)
   {
   m_start_bit = startbit;
   m_signal_size = size;
+  UpdateCanSignal();
   }
 
 void dbcSignal::SetByteOrder(const dbcByteOrder_t order)
   {
   m_byte_order = order;
+  UpdateCanSignal();
   }
 
 void dbcSignal::SetValueType(const dbcValueType_t type)
   {
   m_value_type = type;
+  UpdateCanSignal();
   }
 
 void dbcSignal::SetFactorOffset(const dbcNumber factor, const dbcNumber offset)
   {
   m_factor = factor;
   m_offset = offset;
+  UpdateCanSignal();
   }
 
 void dbcSignal::SetFactorOffset(const double factor, const double offset)
   {
   m_factor = factor;
   m_offset = offset;
+  UpdateCanSignal();
   }
 
 void dbcSignal::SetMinMax(const dbcNumber minimum, const dbcNumber maximum)
@@ -870,8 +881,42 @@ void dbcSignal::Encode(dbcNumber& source, struct CAN_frame_t* msg)
 
 dbcNumber dbcSignal::Decode(struct CAN_frame_t& msg)
   {
-  // TODO: An efficient decoding of the signal
-  return dbcNumber();
+  canpayload payload(&msg);
+  return Decode(payload);
+  }
+
+/**
+ * Decode: extract signal from a preloaded payload
+ *  - use this to decode multiple signals of a message from a single load
+ *  - signals longer than 32 bits are not supported (result undefined)
+ */
+dbcNumber dbcSignal::Decode(const canpayload& payload)
+  {
+  dbcNumber result;
+  if (m_signal_size < 1 || m_signal_size > 32)
+    return result;
+  double value = (m_value_type == DBC_VALUETYPE_SIGNED)
+    ? (double)payload.GetInt(m_cansignal)
+    : (double)payload.GetRaw(m_cansignal);
+  if (m_factor.IsDefined())
+    value *= m_factor.GetDouble();
+  if (m_offset.IsDefined())
+    value += m_offset.GetDouble();
+  result.Set(value);
+  return result;
+  }
+
+const cansignal& dbcSignal::GetCanSignal()
+  {
+  return m_cansignal;
+  }
+
+void dbcSignal::UpdateCanSignal()
+  {
+  m_cansignal = cansignal(m_start_bit, m_signal_size, (cansignal_order_t)m_byte_order,
+    (m_value_type == DBC_VALUETYPE_SIGNED),
+    m_factor.IsDefined() ? m_factor.GetDouble() : 1,
+    m_offset.IsDefined() ? m_offset.GetDouble() : 0);
   }
 
 void dbcSignal::DecodeMetric()
@@ -914,7 +959,7 @@ void dbcSignal::WriteFile(dbcOutputCallback callback, void* param)
   ss << '|';
   ss << m_signal_size;
   ss << '@';
-  ss << ((m_byte_order == DBC_BYTEORDER_BIG_ENDIAN)?"1":"0");
+  ss << ((m_byte_order == DBC_BYTEORDER_LITTLE_ENDIAN)?"1":"0");
   ss << ((m_value_type == DBC_VALUETYPE_SIGNED)?"- ":"+ ");
   ss << '(';
   ss << m_factor;
@@ -37,6 +37,7 @@
 #include <functional>
 #include <iostream>
 #include "can.h"
+#include "cansignal.h"
 #include "ovms_metrics.h"
 
 #define DBC_MAX_LINELENGTH 2048
@@ -56,10 +57,11 @@ struct dbcMultiplexor_t
   uint32_t switchvalue;
   };
 
+// Byte order values as in the DBC signal definition ("@0" / "@1"):
 typedef enum
   {
-  DBC_BYTEORDER_LITTLE_ENDIAN=0,
-  DBC_BYTEORDER_BIG_ENDIAN=1
+  DBC_BYTEORDER_BIG_ENDIAN=CAN_SIG_MOTOROLA,
+  DBC_BYTEORDER_LITTLE_ENDIAN=CAN_SIG_INTEL
   } dbcByteOrder_t;
 
 typedef enum
@@ -334,7 +336,12 @@ class dbcSignal
   public:
     void Encode(dbcNumber& source, struct CAN_frame_t* msg);
     dbcNumber Decode(struct CAN_frame_t& msg);
+    dbcNumber Decode(const canpayload& payload);
     void DecodeMetric();
+    const cansignal& GetCanSignal();
+
+  protected:
+    void UpdateCanSignal();
 
   public:
     void AssignMetric(OvmsMetric* metric);
@@ -363,6 +370,7 @@ class dbcSignal
     dbcNumber m_maximum;
     std::string m_unit;
     OvmsMetric* m_metric;
+    cansignal m_cansignal;
   };
 
 typedef std::list<dbcSignal*> dbcSignalList_t;
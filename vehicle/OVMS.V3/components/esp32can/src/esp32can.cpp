@@ -45,42 +45,63 @@ esp32can* MyESP32can = NULL;
 
 static IRAM_ATTR void ESP32CAN_rxframe(esp32can *me)
   {
-  CAN_msg_t msg;
+  CAN_frame_t* frame;
+  bool wakeup = false;
 
   while (MODULE_ESP32CAN->SR.B.RBS)
     {
-    // Record the origin
-    memset(&msg,0,sizeof(msg));
-    msg.type = CAN_frame;
-    msg.body.frame.origin = me;
-
-    //get FIR
-    msg.body.frame.FIR.U = MODULE_ESP32CAN->MBX_CTRL.FCTRL.FIR.U;
-
-    //check if this is a standard or extended CAN frame
-    if (msg.body.frame.FIR.B.FF==CAN_frame_std)
-      { // Standard frame
-      //Get Message ID
-      msg.body.frame.MsgID = ESP32CAN_GET_STD_ID;
-      //deep copy data bytes
-      for (int k=0 ; k<msg.body.frame.FIR.B.DLC ; k++)
-      	msg.body.frame.data.u8[k] = MODULE_ESP32CAN->MBX_CTRL.FCTRL.TX_RX.STD.data[k];
+    // Get next free RX ring slot:
+    frame = me->m_rxring.Reserve();
+    if (frame == NULL)
+      {
+      // RX ring full, frame lost:
+      me->m_status.rxring_overflow++;
       }
     else
-      { // Extended frame
-      //Get Message ID
-      msg.body.frame.MsgID = ESP32CAN_GET_EXT_ID;
-      //deep copy data bytes
-      for (int k=0 ; k<msg.body.frame.FIR.B.DLC ; k++)
-      	msg.body.frame.data.u8[k] = MODULE_ESP32CAN->MBX_CTRL.FCTRL.TX_RX.EXT.data[k];
+      {
+      // Record the origin & time of reception
+      memset(frame,0,sizeof(*frame));
+      frame->origin = me;
+      frame->timestamp = CAN_Timestamp();
+
+      //get FIR
+      frame->FIR.U = MODULE_ESP32CAN->MBX_CTRL.FCTRL.FIR.U;
+
+      //check if this is a standard or extended CAN frame
+      if (frame->FIR.B.FF==CAN_frame_std)
+        { // Standard frame
+        //Get Message ID
+        frame->MsgID = ESP32CAN_GET_STD_ID;
+        //deep copy data bytes
+        for (int k=0 ; k<frame->FIR.B.DLC ; k++)
+          frame->data.u8[k] = MODULE_ESP32CAN->MBX_CTRL.FCTRL.TX_RX.STD.data[k];
+        }
+      else
+        { // Extended frame
+        //Get Message ID
+        frame->MsgID = ESP32CAN_GET_EXT_ID;
+        //deep copy data bytes
+        for (int k=0 ; k<frame->FIR.B.DLC ; k++)
+          frame->data.u8[k] = MODULE_ESP32CAN->MBX_CTRL.FCTRL.TX_RX.EXT.data[k];
+        }
+
+      //publish frame to main CAN processor task
+      wakeup |= me->m_rxring.Commit();
       }
 
-    //send frame to main CAN processor task
-    xQueueSendFromISR(MyCan.m_rxqueue,&msg,0);
-
     //Let the hardware know the frame has been read.
     MODULE_ESP32CAN->CMR.B.RRB=1;
     }
+
+  if (wakeup)
+    {
+    // Request RxCallback to drain the ring (once per burst):
+    CAN_msg_t msg;
+    msg.type = CAN_rxcallback;
+    msg.body.bus = me;
+    if (xQueueSendFromISR(MyCan.m_rxqueue, &msg, 0) != pdTRUE)
+      me->m_rxring.WakeupFailed();
+    }
   }
 
 static IRAM_ATTR void ESP32CAN_isr(void *pvParameters)
@@ -318,6 +339,12 @@ esp_err_t esp32can::Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*
   return ESP_OK;
   }
 
+bool esp32can::RxCallback(CAN_frame_t* frame)
+  {
+  // Fetch next frame from the ISR RX ring:
+  return m_rxring.Pop(frame);
+  }
+
 void esp32can::TxCallback()
   {
   // TX buffer has become available; send next queued frame (if any):
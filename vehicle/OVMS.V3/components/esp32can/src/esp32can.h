@@ -38,6 +38,7 @@
 
 #include <stdint.h>
 #include "can.h"
+#include "canring.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
@@ -59,6 +60,7 @@ class esp32can : public canbus
 
   public:
     esp_err_t Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait=0);
+    bool RxCallback(CAN_frame_t* frame);
     void TxCallback();
 
   public:
@@ -67,6 +69,7 @@ class esp32can : public canbus
   public:
     gpio_num_t m_txpin;               // TX pin
     gpio_num_t m_rxpin;               // RX pin
+    canring<CAN_frame_t, CONFIG_OVMS_HW_CAN_RX_RING_SIZE> m_rxring;   // ISR → CAN RX task
   };
 
 #endif //#ifndef __ESP32CAN_H__
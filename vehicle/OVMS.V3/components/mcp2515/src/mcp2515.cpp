@@ -31,8 +31,10 @@
 #include "ovms_log.h"
 static const char *TAG = "mcp2515";
 
+#include <assert.h>
 #include <string.h>
 #include "mcp2515.h"
+#include "ovms_command.h"
 #include "soc/gpio_struct.h"
 #include "driver/gpio.h"
 #include "esp_intr.h"
@@ -44,6 +46,10 @@ static void MCP2515_isr(void *pvParameters)
 
   me->m_status.interrupts++;
 
+  // remember the interrupt time for the frame being signalled:
+  me->m_rxtimestamp = CAN_Timestamp();
+  me->m_rxtimestamp_valid = true;
+
   // we don't know the IRQ source and querying by SPI is too slow for an ISR,
   // so we let RxCallback() figure out what to do
 
@@ -63,6 +69,13 @@ mcp2515::mcp2515(const char* name, spi* spibus, spi_nodma_host_device_t host, in
   m_clockspeed = clockspeed;
   m_cspin = cspin;
   m_intpin = intpin;
+  m_rxtimestamp = 0;
+  m_rxtimestamp_valid = false;
+  m_rxframe_pending = false;
+  m_errstate = 0;
+  m_rx_spicmds = 0;
+  m_rx_batches = 0;
+  m_rx_dualreads = 0;
 
   memset(&m_devcfg, 0, sizeof(spi_nodma_device_interface_config_t));
   m_devcfg.clock_speed_hz=m_clockspeed;     // Clock speed (in hz)
@@ -96,6 +109,8 @@ esp_err_t mcp2515::Start(CAN_mode_t mode, CAN_speed_t speed)
 
   m_mode = mode;
   m_speed = speed;
+  m_rxframe_pending = false;
+  m_errstate = 0;
 
   // RESET commmand
   m_spibus->spi_cmd(m_spi, buf, 0, 1, CMD_RESET);
@@ -230,124 +245,205 @@ esp_err_t mcp2515::Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*=
   return ESP_OK;
   }
 
-bool mcp2515::RxCallback(CAN_frame_t* frame)
+/**
+ * ReadRxBuffer: read a frame from RX buffer 0/1
+ *  The READ RX BUFFER instruction clears the buffer's RXnIF interrupt flag,
+ *  so this is a single SPI transaction.
+ */
+void mcp2515::ReadRxBuffer(int rxbuf, CAN_frame_t* frame, uint32_t timestamp)
   {
   uint8_t buf[16];
 
-  // read interrupts (CANINTF 0x2c) and errors (EFLG 0x2d):
-  uint8_t *p = m_spibus->spi_cmd(m_spi, buf, 2, 2, CMD_READ, 0x2c);
-  uint8_t intstat = p[0];
-  uint8_t errflag = p[1];
+  memset(frame,0,sizeof(*frame));
+  frame->origin = this;
+  frame->timestamp = timestamp;
 
-  // handle RX buffers and other interrupts sequentially:
-  int intflag;
-  if (intstat & 0x01)
-    {
-    // RX buffer 0 is full, handle it
-    intflag = 0x01;
-    }
-  else if (intstat & 0x02)
+  // read RX buffer and clear interrupt flag:
+  uint8_t *p = m_spibus->spi_cmd(m_spi, buf, 13, 1, CMD_READ_RXBUF + ((rxbuf==0) ? 0 : 4));
+  m_rx_spicmds++;
+
+  if (p[1] & 0x08) //check for extended mode=1, or std mode=0
     {
-    // RX buffer 1 is full, handle it
-    intflag = 0x02;
+    frame->FIR.B.FF = CAN_frame_ext;           // Extended mode
+    frame->MsgID = ((uint32_t)p[0]<<21)
+                  + (((uint32_t)p[1]&0xe0)<<13)
+                  + (((uint32_t)p[1]&0x03)<<16)
+                  + ((uint32_t)p[2]<<8)
+                  + ((uint32_t)p[3]);
     }
   else
     {
-    // other interrupts:
-    intflag = intstat & 0b11111100;
+    frame->FIR.B.FF = CAN_frame_std;
+    frame->MsgID = ((uint32_t)p[0] << 3) + (p[1] >> 5);  // Standard mode
     }
 
-  if (intflag == 0)
+  frame->FIR.B.DLC = p[4] & 0x0f;
+
+  memcpy(&frame->data,p+5,8);
+  }
+
+/**
+ * RxCallback: called by the CAN task on interrupt until returning false
+ *  Reads the interrupt & error flags once, then drains both RX buffers
+ *  (the second frame is returned on the next call without SPI access).
+ *  TX and error interrupts are handled after the RX buffers have been
+ *  read. The INT line level tells if more flags are pending, so a single
+ *  frame needs 2 SPI transactions, back-to-back frames ~1.5 per frame.
+ */
+bool mcp2515::RxCallback(CAN_frame_t* frame)
+  {
+  uint8_t buf[16];
+
+  // deliver second frame of last batch:
+  if (m_rxframe_pending)
     {
-    // all interrupts handled
-    return false;
+    *frame = m_rxframe;
+    m_rxframe_pending = false;
+    return true;
     }
 
-  m_status.error_flags = (intstat << 24) | (errflag << 16) | intflag;
-
-  if (intflag <= 2)
+  // Loop until a frame has been read or all interrupts have been handled.
+  // Note: we must not return false with interrupt flags still set, as the
+  //  interrupt line would then stay asserted without raising a new edge.
+  for (int loop = 0; loop < 3; loop++)
     {
-    // The indicated RX buffer has a message to be read
-    memset(frame,0,sizeof(*frame));
-    frame->origin = this;
+    // INT line inactive = no interrupt flags set, skip the SPI status read:
+    if (gpio_get_level((gpio_num_t)m_intpin) != 0)
+      {
+      m_rxtimestamp_valid = false;
+      return false;
+      }
 
-    // read RX buffer and clear interrupt flag:
-    uint8_t *p = m_spibus->spi_cmd(m_spi, buf, 13, 1, CMD_READ_RXBUF + ((intflag==1) ? 0 : 4));
+    // read interrupts (CANINTF 0x2c) and errors (EFLG 0x2d):
+    uint8_t *p = m_spibus->spi_cmd(m_spi, buf, 2, 2, CMD_READ, 0x2c);
+    m_rx_spicmds++;
+    uint8_t intstat = p[0];
+    uint8_t errflag = p[1];
 
-    if (p[1] & 0x08) //check for extended mode=1, or std mode=0
+    if (intstat == 0 && (errflag & 0b11000000) == 0)
       {
-      frame->FIR.B.FF = CAN_frame_ext;           // Extended mode
-      frame->MsgID = ((uint32_t)p[0]<<21)
-                    + (((uint32_t)p[1]&0xe0)<<13)
-                    + (((uint32_t)p[1]&0x03)<<16)
-                    + ((uint32_t)p[2]<<8)
-                    + ((uint32_t)p[3]);
+      // all interrupts handled
+      m_rxtimestamp_valid = false;
+      return false;
       }
-    else
+
+    m_status.error_flags = (intstat << 24) | (errflag << 16) | (intstat & 0b11111100);
+    m_rx_batches++;
+
+    // drain both RX buffers:
+    int rxcnt = 0;
+    if (intstat & 0b00000011)
       {
-      frame->FIR.B.FF = CAN_frame_std;
-      frame->MsgID = ((uint32_t)p[0] << 3) + (p[1] >> 5);  // Standard mode
+      // RX time: the interrupt time for the first frame, else now
+      // (frames received while the previous one was being read):
+      uint32_t timestamp = (m_rxtimestamp_valid) ? (uint32_t)m_rxtimestamp : CAN_Timestamp();
+      m_rxtimestamp_valid = false;
+      // RX buffer order: with rollover, buffer 1 only receives while buffer 0
+      // is full, so if both are full, buffer 0 holds the older frame. Buffer 1
+      // is read first only if it is full alone, i.e. buffer 0 was read since.
+      // Note: if buffer 1 fills while buffer 0 is read and buffer 0 refills
+      // before the next flag read, the flags cannot tell the order (needs two
+      // frames within two SPI transactions), buffer 0 is read first then.
+      int first = ((intstat & 0b00000011) == 0b00000010) ? 1 : 0;
+      ReadRxBuffer(first, frame, timestamp);
+      rxcnt++;
+      if ((intstat & 0b00000011) == 0b00000011)
+        {
+        ReadRxBuffer(1-first, &m_rxframe, CAN_Timestamp());
+        m_rxframe_pending = true;
+        m_rx_dualreads++;
+        rxcnt++;
+        }
       }
 
-    frame->FIR.B.DLC = p[4] & 0x0f;
+    // handle other interrupts that came in at the same time:
 
-    memcpy(&frame->data,p+5,8);
-    }
+    if (intstat & 0b00011100)
+      {
+      // some TX buffers have become available; clear IRQs and fill up:
+      m_spibus->spi_cmd(m_spi, buf, 0, 4, CMD_BITMODIFY, 0x2c, intstat & 0b00011100, 0x00);
+      m_status.error_flags |= 0x0100;
 
-  // handle other interrupts that came in at the same time:
+      CAN_frame_t txframe;
+      if(xQueueReceive(m_txqueue, (void*)&txframe, 0) == pdTRUE)  // if any queued for later?
+        Write(&txframe, 0);  // if so, send one
+      }
 
-  if (intstat & 0b00011100)
-    {
-    // some TX buffers have become available; clear IRQs and fill up:
-    m_spibus->spi_cmd(m_spi, buf, 0, 4, CMD_BITMODIFY, 0x2c, intstat & 0b00011100, 0x00);
-    m_status.error_flags |= 0x0100;
+    if (intstat & 0b11100000)
+      {
+      // Error interrupts:
+      //  MERRF 0x80 = message tx/rx error
+      //  ERRIF 0x20 = overflow / error state change
+      if (errflag & 0b10000000) // RXB1 overflow
+        {
+        m_status.rxbuf_overflow++;
+        m_status.error_flags |= 0x0200;
+        ESP_LOGW(TAG, "CAN Bus 2/3 receive overflow; Frame lost.");
+        }
+      if (errflag & 0b01000000) // RXB0 overflow.  No data lost in this case (it went into RXB1)
+        {
+        m_status.error_flags |= 0x0400;
+        }
+      // read error counters on message errors & error state changes
+      // (not on RX overflows, to keep the SPI bus free for the RX buffers):
+      if ((intstat & 0b10000000) || (errflag & 0b00111111) != m_errstate)
+        {
+        m_errstate = errflag & 0b00111111;
+        uint8_t *p = m_spibus->spi_cmd(m_spi, buf, 2, 2, CMD_READ, 0x1c);
+        m_status.errors_tx = p[0];
+        m_status.errors_rx = p[1];
+        }
 
-    if(xQueueReceive(m_txqueue, (void*)frame, 0) == pdTRUE)  // if any queued for later?
-      Write(frame, 0);  // if so, send one
-    }
+      // log:
+      LogStatus(CAN_LogStatus_Error);
+      }
 
-  if (intstat & 0b11100000)
-    {
-    // Error interrupts:
-    //  MERRF 0x80 = message tx/rx error
-    //  ERRIF 0x20 = overflow / error state change
-    if (errflag & 0b10000000) // RXB1 overflow
+    // clear RX buffer overflow flags:
+    if (errflag & 0b11000000)
       {
-      m_status.rxbuf_overflow++;
-      m_status.error_flags |= 0x0200;
-      ESP_LOGW(TAG, "CAN Bus 2/3 receive overflow; Frame lost.");
+      m_status.error_flags |= 0x0800;
+      m_spibus->spi_cmd(m_spi, buf, 0, 4, CMD_BITMODIFY, 0x2d, errflag & 0b11000000, 0x00);
       }
-    if (errflag & 0b01000000) // RXB0 overflow.  No data lost in this case (it went into RXB1)
+
+    // clear error & wakeup interrupts:
+    if (intstat & 0b11100000)
       {
-      m_status.error_flags |= 0x0400;
+      m_status.error_flags |= 0x1000;
+      m_spibus->spi_cmd(m_spi, buf, 0, 4, CMD_BITMODIFY, 0x2c, intstat & 0b11100000, 0x00);
       }
-    // read error counters:
-    uint8_t *p = m_spibus->spi_cmd(m_spi, buf, 2, 2, CMD_READ, 0x1c);
-    m_status.errors_tx = p[0];
-    m_status.errors_rx = p[1];
 
-    // log:
-    LogStatus(CAN_LogStatus_Error);
+    if (rxcnt)   //  did we receive anything?
+      return true;
     }
 
-  // clear RX buffer overflow flags:
-  if (errflag & 0b11000000)
+  // flags still pending (i.e. continuous TX completions), come back later:
+  if (gpio_get_level((gpio_num_t)m_intpin) == 0)
     {
-    m_status.error_flags |= 0x0800;
-    m_spibus->spi_cmd(m_spi, buf, 0, 4, CMD_BITMODIFY, 0x2d, errflag & 0b11000000, 0x00);
+    CAN_msg_t msg;
+    msg.type = CAN_rxcallback;
+    msg.body.bus = this;
+    xQueueSend(MyCan.m_rxqueue, &msg, 0);
     }
+  return false;
+  }
+
+void mcp2515::ClearStatus()
+  {
+  canbus::ClearStatus();
+  m_rx_spicmds = 0;
+  m_rx_batches = 0;
+  m_rx_dualreads = 0;
+  }
 
-  // clear error & wakeup interrupts:
-  if (intstat & 0b11100000)
+void mcp2515::ShowStatus(int verbosity, OvmsWriter* writer)
+  {
+  writer->printf("Rx SPI cmd:%20u\n", m_rx_spicmds);
+  writer->printf("Rx batches:%20u\n", m_rx_batches);
+  writer->printf("Rx dualbuf:%20u\n", m_rx_dualreads);
+  if (m_status.packets_rx)
     {
-    m_status.error_flags |= 0x1000;
-    m_spibus->spi_cmd(m_spi, buf, 0, 4, CMD_BITMODIFY, 0x2c, intstat & 0b11100000, 0x00);
+    writer->printf("Rx SPI/pkt:%20.2f\n", (float)m_rx_spicmds / m_status.packets_rx);
     }
-
-  if(intflag & 0b00000011)   //  did we receive anything?
-    return true;
-  else
-    return false;
   }
 
 void mcp2515::SetPowerMode(PowerMode powermode)
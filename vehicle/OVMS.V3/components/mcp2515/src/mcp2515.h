@@ -60,6 +60,11 @@ class mcp2515 : public canbus
   public:
     esp_err_t Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait=0);
     virtual bool RxCallback(CAN_frame_t* frame);
+    virtual void ClearStatus();
+    virtual void ShowStatus(int verbosity, OvmsWriter* writer);
+
+  protected:
+    void ReadRxBuffer(int rxbuf, CAN_frame_t* frame, uint32_t timestamp);
 
   public:
     virtual void SetPowerMode(PowerMode powermode);
@@ -67,6 +72,14 @@ class mcp2515 : public canbus
   public:
     spi* m_spibus;
     spi_nodma_device_handle_t m_spi;
+    volatile uint32_t m_rxtimestamp;          // time of last RX interrupt (see CAN_Timestamp())
+    volatile bool m_rxtimestamp_valid;        // m_rxtimestamp not yet assigned to a frame
+    CAN_frame_t m_rxframe;                    // second frame read in an RX batch
+    bool m_rxframe_pending;                   // … not yet delivered
+    uint8_t m_errstate;                       // last error state flags seen (EFLG)
+    uint32_t m_rx_spicmds;                    // SPI transactions for flag & RX buffer reads
+    uint32_t m_rx_batches;                    // interrupt flag reads with interrupts pending
+    uint32_t m_rx_dualreads;                  // batches with both RX buffers full
 
   protected:
     spi_nodma_device_interface_config_t m_devcfg;
@@ -34,7 +34,10 @@ static const char *TAG = "obd2ecu";
 
 #include <string.h>
 #include <dirent.h>
+#include <sys/param.h>
+#include "rom/ets_sys.h"
 #include "obd2ecu.h"
+#include "ovms.h"
 #include "ovms_script.h"
 #include "ovms_config.h"
 #include "ovms_command.h"
@@ -47,6 +50,12 @@ obd2pid::obd2pid(int pid, pid_t type, OvmsMetric* metric)
   m_pid = pid;
   m_type = type;
   m_script = NULL;
+  m_value = 0;
+  m_pending = false;
+  m_lastrequest = 0;
+  m_requests = 0;
+  m_latency_sum = 0;
+  m_latency_max = 0;
   m_metric = metric;
   }
 
@@ -54,6 +63,7 @@ obd2pid::~obd2pid()
   {
   if (m_script)
     {
+    DiscardScript();
     free(m_script);
     m_script = NULL;
     }
@@ -107,6 +117,7 @@ void obd2pid::LoadScript(std::string path)
 
   if (m_script)
     {
+    DiscardScript();
     free(m_script);
     m_script = NULL;
     }
@@ -115,6 +126,56 @@ void obd2pid::LoadScript(std::string path)
   m_script[fsz] = 0;
 
   fclose(f);
+
+  // Refresh the new script for a while even without requests:
+  m_value = 0;
+  m_lastrequest = monotonictime;
+  }
+
+void obd2pid::RefreshScript()
+  {
+  // Queue a script execution, the compiled script will update m_value.
+  // Scripts of PIDs not requested recently are not run.
+#ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+  if (m_type != Script || m_script == NULL || m_pending)
+    return;
+  if (monotonictime - m_lastrequest > SCRIPT_IDLE_TIME)
+    return;
+  if (!MyScripts.DuktapeCallFloatResultAsync(this, m_script, &m_value, &m_pending))
+    ESP_LOGW(TAG, "Script queue full, pid #%d (0x%02x) not refreshed",m_pid,m_pid);
+#endif // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+  }
+
+void obd2pid::DiscardScript()
+  {
+  // Remove the compiled script; this waits for a pending refresh to finish
+#ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+  MyScripts.DuktapeDiscardFunction(this);
+#endif // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+  }
+
+void obd2pid::RecordRequest(uint32_t latency)
+  {
+  m_lastrequest = monotonictime;
+  m_requests++;
+  m_latency_sum += latency;
+  if (latency > m_latency_max)
+    m_latency_max = latency;
+  }
+
+uint32_t obd2pid::GetRequests()
+  {
+  return m_requests;
+  }
+
+uint32_t obd2pid::GetLatencyAvg()
+  {
+  return (m_requests) ? m_latency_sum / m_requests : 0;
+  }
+
+uint32_t obd2pid::GetLatencyMax()
+  {
+  return m_latency_max;
   }
 
 float obd2pid::Execute()
@@ -129,14 +190,8 @@ float obd2pid::Execute()
         return m_metric->AsFloat();
       else
         return 0.0;
-    case Script:
-#ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
-      {
-      return MyScripts.DuktapeEvalFloatResult(m_script);
-      }
-#else // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
-      return 0;
-#endif // #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+    case Script:          // Last result of the script, see RefreshScript()
+      return m_value;
     default:
       return 0;
     }
@@ -158,6 +213,12 @@ static void OBD2ECU_task(void *pvParameters)
     }
   }
 
+static void OBD2ECU_script_timer(TimerHandle_t timer)
+  {
+  obd2ecu *me = (obd2ecu*)pvTimerGetTimerID(timer);
+  me->RefreshScripts();
+  }
+
 obd2ecu::obd2ecu(const char* name, canbus* can)
   : pcp(name)
   {
@@ -168,6 +229,11 @@ obd2ecu::obd2ecu(const char* name, canbus* can)
   m_rxqueue = xQueueCreate(20,sizeof(CAN_frame_t));
 
   m_starttime = time(NULL);
+  m_cache_time = 0;
+  m_cache_flush = false;
+  m_tx_length = 0;
+  m_tx_pos = 0;
+  m_script_timer = xTimerCreate("OBDII ECU scripts", pdMS_TO_TICKS(SCRIPT_REFRESH_MS), pdTRUE, this, OBD2ECU_script_timer);
   LoadMap();
 
   xTaskCreatePinnedToCore(OBD2ECU_task, "OVMS OBDII ECU", 6144, (void*)this, 5, &m_task, 1);
@@ -180,10 +246,11 @@ obd2ecu::~obd2ecu()
   m_can->SetPowerMode(Off);
   MyCan.DeregisterListener(m_rxqueue);
 
-  vQueueDelete(m_rxqueue);
   vTaskDelete(m_task);
+  vQueueDelete(m_rxqueue);
 
   ClearMap();
+  xTimerDelete(m_script_timer, portMAX_DELAY);
   }
 
 void obd2ecu::SetPowerMode(PowerMode powermode)
@@ -254,6 +321,30 @@ void obd2ecu_list(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc,
     }
   }
 
+void obd2ecu_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (MyPeripherals->m_obd2ecu == NULL)
+    {
+    writer->puts("Need to start ecu process first");
+    return;
+    }
+
+  writer->printf("%-7s %14s %10s %12s %12s\n","  PID","Type","Requests","Avg.Lat(us)","Max.Lat(us)");
+
+  for (PidMap::iterator it=MyPeripherals->m_obd2ecu->m_pidmap.begin(); it!=MyPeripherals->m_obd2ecu->m_pidmap.end(); ++it)
+    {
+    if ((argc==0)||(it->second->GetPid() == atoi(argv[0])))
+      {
+      writer->printf("%-3d (0x%02x) %14s %10u %12u %12u\n",
+        it->first, it->first,
+        it->second->GetTypeString(),
+        it->second->GetRequests(),
+        it->second->GetLatencyAvg(),
+        it->second->GetLatencyMax());
+      }
+    }
+  }
+
 void obd2ecu_reload(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   if (MyPeripherals->m_obd2ecu == NULL)
@@ -291,7 +382,7 @@ static uint8_t pid_format[] =
 {10,  // 00 PIDs supported
  10,  // 01 Monitor status since DTCs cleared (bit vector)
   0,  // 02 Freeze DTC
- 10,  // 03 Fuel System Status
+  5,  // 03 Fuel System Status (A: system 1, B: system 2)
   2,  // 04 Engine load
   4,  // 05 Coolant Temperature
   9,  // 06 short term fuel trim bank 1
@@ -306,7 +397,7 @@ static uint8_t pid_format[] =
   4,  // 15 Intake air Temperature
   6,  // 16 MAF Air flow rate
   2,  // 17 Throttle position
- 10,  // 18 Commanded secondary air status
+  1,  // 18 Commanded secondary air status
  99,  // 19 O2 sensors present (huh?)
  99,  // 20 O2 sensor 1
  99,  // 21 O2 sensor 2
@@ -316,7 +407,7 @@ static uint8_t pid_format[] =
  99,  // 25 O2 sensor 6
  99,  // 26 O2 sensor 7  (PIDs 40 and above not supported)
  99,  // 27 O2 sensor 8
- 10,  // 28 OBD standards
+  1,  // 28 OBD standards
  99,  // 29 O2 sensors present (huh?)
  99,  // 30 PTO status
   5,  // 31 Run time since engine start
@@ -355,10 +446,82 @@ static uint8_t pid_format[] =
  10   // 64 PIDs supported
 };
 
+/* Number of data bytes per PID (SAE J1979), index this table by PID */
+
+static const uint8_t pid_length[] =
+{ 4,  // 00 PIDs supported
+  4,  // 01 Monitor status since DTCs cleared (bit vector)
+  2,  // 02 Freeze DTC
+  2,  // 03 Fuel System Status
+  1,  // 04 Engine load
+  1,  // 05 Coolant Temperature
+  1,  // 06 short term fuel trim bank 1
+  1,  // 07 long term fuel trim bank 1
+  1,  // 08 short term fuel trim bank 2
+  1,  // 09 long term fuel trim bank 2
+  1,  // 10 Fuel pressure
+  1,  // 11 Intake manifold pressure
+  2,  // 12 Engine RPM
+  1,  // 13 vehicle speed
+  1,  // 14 Timing Advance
+  1,  // 15 Intake air Temperature
+  2,  // 16 MAF Air flow rate
+  1,  // 17 Throttle position
+  1,  // 18 Commanded secondary air status
+  1,  // 19 O2 sensors present
+  2,  // 20 O2 sensor 1
+  2,  // 21 O2 sensor 2
+  2,  // 22 O2 sensor 3
+  2,  // 23 O2 sensor 4
+  2,  // 24 O2 sensor 5
+  2,  // 25 O2 sensor 6
+  2,  // 26 O2 sensor 7
+  2,  // 27 O2 sensor 8
+  1,  // 28 OBD standards
+  1,  // 29 O2 sensors present
+  1,  // 30 PTO status
+  2,  // 31 Run time since engine start
+  4,  // 32 PIDs supported
+  2,  // 33 Distance traveled with check engine light on
+  2,  // 34
+  2,  // 35
+  4,  // 36
+  4,  // 37
+  4,  // 38
+  4,  // 39
+  4,  // 40
+  4,  // 41
+  4,  // 42
+  4,  // 43
+  1,  // 44
+  1,  // 45
+  1,  // 46
+  1,  // 47 Fuel tank level
+  1,  // 48
+  2,  // 49
+  2,  // 50
+  1,  // 51 Barometric pressure
+  4,  // 52
+  4,  // 53
+  4,  // 54
+  4,  // 55
+  4,  // 56
+  4,  // 57
+  4,  // 58
+  4,  // 59
+  2,  // 60
+  2,  // 61
+  2,  // 62
+  2,  // 63
+  4   // 64 PIDs supported
+};
+
+static_assert(sizeof(pid_length) == sizeof(pid_format), "pid_length needs one entry per PID of pid_format");
+
 //
-// Fill Mode 1 frames with data based on format specified
+// Fill 4 Mode 1 PID data bytes based on format specified, see pid_length for the used size
 //
-void obd2ecu::FillFrame(CAN_frame_t *frame,int reply,uint8_t pid,float data,uint8_t format)
+void obd2ecu::FillPid(uint8_t *buf,float data,uint8_t format)
   {
   uint8_t a,b,c,d;
   int i;
@@ -443,293 +606,360 @@ void obd2ecu::FillFrame(CAN_frame_t *frame,int reply,uint8_t pid,float data,uint
       break;
     }
 
-  frame->origin = NULL;
-  frame->FIR.U = 0;
-  frame->FIR.B.DLC = 8;
-  frame->FIR.B.FF = CAN_frame_format_t (reply != RESPONSE_PID);
-  frame->MsgID = reply;
-
-  frame->data.u8[0] = 6;		/* # additional bytes (ok to have extra) */
-  frame->data.u8[1] = 0x41;   /* Mode 1 + 0x40 indicating a reply */
-  frame->data.u8[2] = pid;
-  frame->data.u8[3] = a;
-  frame->data.u8[4] = b;
-  frame->data.u8[5] = c;
-  frame->data.u8[6] = d;
-  frame->data.u8[7] = 0x55;   /* pad 0x55 */
-
-  return;
+  buf[0] = a;
+  buf[1] = b;
+  buf[2] = c;
+  buf[3] = d;
   }
 
-
-void obd2ecu::IncomingFrame(CAN_frame_t* p_frame)
+//
+// Mode 1 data for one PID: PID byte + data bytes, returns length (0 = no answer)
+//
+int obd2ecu::Mode1Response(uint8_t pid, uint8_t* buf)
   {
-  CAN_frame_t r_frame;  /* build the response frame here */
-  uint32_t reply;
   int jitter;
-  uint8_t mapped_pid;
   float metric;
-  char rtn_string[21];
-
-  uint8_t *p_d = p_frame->data.u8;  /* Incoming frame data from HUD / Dongle */
-  uint8_t *r_d = r_frame.data.u8;  /* Response frame data being sent back to HUD / Dongle */
+  obd2pid* p_pid = NULL;
 
-  ESP_LOGD(TAG, "Rcv %x: %x (%x %x %x %x %x %x %x %x)",
-                      p_frame->MsgID,
-                      p_frame->FIR.B.DLC,
-                      p_d[0],p_d[1],p_d[2],p_d[3],p_d[4],p_d[5],p_d[6],p_d[7]);
+  if(pid >= sizeof(pid_format))
+  { ESP_LOGI(TAG, "unknown capability requested %x",pid);
+    return 0;
+  }
 
-  /* handle both standard and extended frame types - return like for like */
-  if (p_frame->MsgID == REQUEST_PID) reply = RESPONSE_PID;
-  else if (p_frame->MsgID == REQUEST_EXT_PID) reply = RESPONSE_EXT_PID;
-       else
-       { /* check for flow control frames - they're received on the response MsgID minus 8 */
-         if ((p_frame->MsgID == FLOWCONTROL_PID || p_frame->MsgID == FLOWCONTROL_EXT_PID) && p_frame->data.u8[0] == 0x30)
-         {  ESP_LOGD(TAG, "flow control frame - ignored");
-           return;  /* ignore it.  We just sleep for a bit instead */
-         }
-         /* if none of the above, no idea what it is.  Ignore */
-         ESP_LOGD(TAG, "unknown MsgID %x",p_frame->MsgID);
-         return;
-       }
+  PidMap::iterator it = m_pidmap.find(pid);
+  if (it != m_pidmap.end()) // contains the obd2pid object to work with
+  { p_pid = it->second;
+    metric = p_pid->Execute();
+  }
+  else
+  { if (MyConfig.GetParamValueBool("obd2ecu","autocreate"))
+      m_pidmap[pid] = new obd2pid(pid); // Creates it as Unimplemented, if enabled
+      // note: don't 'Addpid' the PID to the supported vectors.  Only done when support set by config.
+    metric = 0.0;
+  }
 
   jitter = time(NULL)&0xf;  /* 0-15 range for simulation purposes */
 
-  switch(p_d[1])  /* switch on the incoming frame mode */
+  buf[0] = pid;
+  switch (pid)  /* switch on the what the requested PID was (before mapping!) */
     {
-    case 1:  /* Mode 1 (main real-time PIDs are here */
-
-      mapped_pid = p_d[2];
-      if (m_pidmap.find(mapped_pid) != m_pidmap.end()) // m_pidmap[pid] contains the obd2pid object to work with
-      { metric = m_pidmap[mapped_pid]->Execute();
-      }
-      else
-      { if (MyConfig.GetParamValueBool("obd2ecu","autocreate"))
-          m_pidmap[mapped_pid] = new obd2pid(mapped_pid); // Creates it as Unimplemented, if enabled
-          // note: don't 'Addpid' the PID to the supported vectors.  Only done when support set by config.
-        metric = 0.0;
+    case 0:  /* request capabilities PIDs 01-0x20 */
+      buf[1] = (m_supported_01_20 >> 24) & 0xff;
+      buf[2] = (m_supported_01_20 >> 16) & 0xff;
+      buf[3] = (m_supported_01_20 >> 8) & 0xff;
+      buf[4] =  m_supported_01_20 & 0xff;
+      return 5;
+
+    case 1: /* request status since DTC Cleared */
+      /* Note: Even setting [7]=0xff and DTC count=0, the dongle still requests DTC stuff. */
+      buf[1] = 0x00;  /* report all clear, no tests */
+      buf[2] = 0x00;
+      buf[3] = 0x00;
+      buf[4] = 0xff;  /* nothing ready yet (or ever) */
+      return 5;
+
+    case 0x0c:	/* Engine RPM */
+      /* This item (only) needs to vary to prevent SyncUp Drive dongle from going to sleep */
+      /* Also a Minimum "idle" RPM, but only if not moving, for HUD device */
+
+      // Test if metric is from a script; if so, don't do the dongle workarounds (script will do this if needed)
+      if(!p_pid || p_pid->GetType() != obd2pid::Script)
+      { metric = metric+jitter;
+        if(StandardMetrics.ms_v_pos_speed->AsFloat() < 1.0) metric = 500+jitter;
       }
-
-      switch (mapped_pid)  /* switch on the what the requested PID was (before mapping!) */
-        {
-        case 0:  /* request capabilities PIDs 01-0x20 */
-
-          r_frame.origin = NULL;
-          r_frame.FIR.U = 0;
-          r_frame.FIR.B.DLC = 8;
-          r_frame.FIR.B.FF = p_frame->FIR.B.FF;
-          r_frame.MsgID = reply;
-          r_d[0] = 6;		/* # additional bytes (ok to have extra) */
-          r_d[1] = 0x41;  /* Mode 1 + 0x40 indicating a reply */
-          r_d[2] = 0x00;
-          r_d[3] = (m_supported_01_20 >> 24) & 0xff;
-          r_d[4] = (m_supported_01_20 >> 16) & 0xff;
-          r_d[5] = (m_supported_01_20 >> 8) & 0xff;
-          r_d[6] =  m_supported_01_20 & 0xff;
-          r_d[7] = 0x55;  /* pad 0x55 */
-          m_can->Write(&r_frame);
-          break;
-
-        case 1: /* request status since DTC Cleared */
-          /* Note: Even setting [7]=0xff and DTC count=0, the dongle still requests DTC stuff. */
-          r_frame.origin = NULL;
-          r_frame.FIR.U = 0;
-          r_frame.FIR.B.DLC = 8;
-          r_frame.FIR.B.FF = CAN_frame_format_t (reply != RESPONSE_PID);
-          r_frame.MsgID = reply;
-          r_d[0] = 6;		/* # additional bytes (ok to have extra) */
-          r_d[1] = 0x41;  /* Mode 1 + 0x40 indicating a reply */
-          r_d[2] = 0x01;
-          r_d[3] = 0x00;  /* report all clear, no tests */
-          r_d[4] = 0x00;
-          r_d[5] = 0x00;
-          r_d[6] = 0x00;
-          r_d[7] = 0xff;  /* nothing ready yet (or ever) */
-          m_can->Write(&r_frame);
-          break;
-
-        case 0x0c:	/* Engine RPM */
-          /* This item (only) needs to vary to prevent SyncUp Drive dongle from going to sleep */
-          /* Also a Minimum "idle" RPM, but only if not moving, for HUD device */
-
-          // Test if metric is from a script; if so, don't do the dongle workarounds (script will do this if needed)
-          if(m_pidmap[mapped_pid]->GetType() != obd2pid::Script)
-          { metric = metric+jitter;
-            if(StandardMetrics.ms_v_pos_speed->AsFloat() < 1.0) metric = 500+jitter;
-          }
-
-          FillFrame(&r_frame,reply,mapped_pid,metric,pid_format[mapped_pid]);
-          m_can->Write(&r_frame);
-          break;
-
-        case 0x10:	/* MAF (Mass Air flow) rate - Map to SoC */
-          /* For some reason, the HUD uses this param as a proxy for fuel rate */
-          /* HUD devices seem to have a display range of 0-19.9 */
-          /* Scaling provides a 1:1 metric pass-through, so be aware of limmits of the display device */
-          /* Use with display set to L/hr (not L/km).  Note: scripting this metric is not pre-scaled. */
-
-          if(m_pidmap[mapped_pid]->GetType() != obd2pid::Script) metric = metric*3.0;
-          FillFrame(&r_frame,reply,mapped_pid,metric,pid_format[mapped_pid]);
-          m_can->Write(&r_frame);
-          break;
-
-        case 0x20:  /* request more capabilities, PIDs 0x21 - 0x40 */
-          r_frame.origin = NULL;
-          r_frame.FIR.U = 0;
-          r_frame.FIR.B.DLC = 8;
-          r_frame.FIR.B.FF = CAN_frame_format_t (reply != RESPONSE_PID);
-          r_frame.MsgID = reply;
-          r_d[0] = 6;		/* # additional bytes (ok to have extra) */
-          r_d[1] = 0x41;  /* Mode 1 + 0x40 indicating a reply */
-          r_d[2] = 0x20;
-          r_d[3] = (m_supported_21_40 >> 24) & 0xff;
-          r_d[4] = (m_supported_21_40 >> 16) & 0xff;
-          r_d[5] = (m_supported_21_40 >> 8) & 0xff;
-          r_d[6] =  m_supported_21_40 & 0xff;
-          r_d[7] = 0x55;  /* pad 0x55 */
-          m_can->Write(&r_frame);
-          break;
-
-        case 0x40:  /* request more capabilities: none
-            (would need to expand the pid_format table to do so) */
-          r_frame.origin = NULL;
-          r_frame.FIR.U = 0;
-          r_frame.FIR.B.DLC = 8;
-          r_frame.FIR.B.FF = CAN_frame_format_t (reply != RESPONSE_PID);
-          r_frame.MsgID = reply;
-          r_d[0] = 6;		/* # additional bytes (ok to have extra) */
-          r_d[1] = 0x41;  /* Mode 1 + 0x40 indicating a reply */
-          r_d[2] = 0x40;
-          r_d[3] = 0x00;
-          r_d[4] = 0x00;
-          r_d[5] = 0x00;
-          r_d[6] = 0x00;
-          r_d[7] = 0x55;  /* pad 0x55 */
-          m_can->Write(&r_frame);
-          break;
-
-        default:  /* most PIDs get processed here */
-          if(mapped_pid > sizeof(pid_format))
-          { ESP_LOGI(TAG, "unknown capability requested %x",r_frame.data.u8[2]);
-            break;
-          }
-
-          FillFrame(&r_frame,reply,mapped_pid,metric,pid_format[mapped_pid]);
-          m_can->Write(&r_frame);
-
-	}
       break;
 
-    case 9:
-      switch (p_frame->data.u8[2])
-        {
-        case 2:
-          ESP_LOGD(TAG, "Requested VIN");
+    case 0x10:	/* MAF (Mass Air flow) rate - Map to SoC */
+      /* For some reason, the HUD uses this param as a proxy for fuel rate */
+      /* HUD devices seem to have a display range of 0-19.9 */
+      /* Scaling provides a 1:1 metric pass-through, so be aware of limmits of the display device */
+      /* Use with display set to L/hr (not L/km).  Note: scripting this metric is not pre-scaled. */
 
-          if(MyConfig.GetParamValueBool("obd2ecu","private"))   /* ignore request for privacy's sake. Doesn't seem to matter to Dongle. */
-          { ESP_LOGD(TAG, "VIN request ignored");
-            break;
-          }
+      if(!p_pid || p_pid->GetType() != obd2pid::Script) metric = metric*3.0;
+      break;
 
-          memcpy(rtn_string,StandardMetrics.ms_v_vin->AsString().c_str(),17);
-          rtn_string[17] = '\0';  /* force null termination, just because */
+    case 0x20:  /* request more capabilities, PIDs 0x21 - 0x40 */
+      buf[1] = (m_supported_21_40 >> 24) & 0xff;
+      buf[2] = (m_supported_21_40 >> 16) & 0xff;
+      buf[3] = (m_supported_21_40 >> 8) & 0xff;
+      buf[4] =  m_supported_21_40 & 0xff;
+      return 5;
+
+    case 0x40:  /* request more capabilities: none
+        (would need to expand the pid_format table to do so) */
+      buf[1] = 0x00;
+      buf[2] = 0x00;
+      buf[3] = 0x00;
+      buf[4] = 0x00;
+      return 5;
+
+    default:  /* most PIDs get processed here */
+      break;
+    }
 
-          r_frame.origin = NULL;
-          r_frame.FIR.U = 0;
-          r_frame.FIR.B.DLC = 8;
-          r_frame.FIR.B.FF = CAN_frame_format_t (reply != RESPONSE_PID);
-          r_frame.MsgID = reply;
-          r_d[0] = 0x10;  /* not sure what this is for */
-          r_d[1] = 0x14;  /* overall length, starting with next byte, not including pad */
-          r_d[2] = 0x49;  /* Mode 9 reply */
-          r_d[3] = 0x02;  /* PID */
-          r_d[4] = 0x01;  /* not sure what this is for */
-          memcpy(&r_d[5],rtn_string,3);  /* grab the first 3 bytes of VIN */
+  FillPid(&buf[1],metric,pid_format[pid]);
+  return 1 + pid_length[pid];
+  }
 
-          m_can->Write(&r_frame);
+//
+// Mode 9 data for one PID, returns length (0 = no answer)
+//
+int obd2ecu::Mode9Response(uint8_t pid, uint8_t* buf)
+  {
+  std::string value;
 
-          vTaskDelay(10 / portTICK_PERIOD_MS);  /* let the flow control frame pass */
+  switch (pid)
+    {
+    case 2:
+      ESP_LOGD(TAG, "Requested VIN");
 
-          r_d[0] = 0x21;
-          memcpy(&r_d[1],rtn_string+3,7);  /* grab the next 7 bytes of VIN */
+      if(MyConfig.GetParamValueBool("obd2ecu","private"))   /* ignore request for privacy's sake. Doesn't seem to matter to Dongle. */
+      { ESP_LOGD(TAG, "VIN request ignored");
+        return 0;
+      }
 
-          m_can->Write(&r_frame);
+      value = StandardMetrics.ms_v_vin->AsString();
+      buf[0] = 0x02;  /* PID */
+      buf[1] = 0x01;  /* number of data items */
+      memset(&buf[2],0,17);
+      memcpy(&buf[2],value.c_str(),MIN(value.size(),17));
+      return 19;
 
-          r_d[0] = 0x22;
-          memcpy(&r_d[1],rtn_string+10,7);  /* grab the last 7 bytes of VIN */
+    case 0x0a: /* ECU Name */
+      ESP_LOGD(TAG, "ECU Name requested");
+      /* Perhaps a good place for arbitrary text, e.g. fleet asset #?  20 char avail. */
 
-          m_can->Write(&r_frame);
+      value = MyConfig.GetParamValue("vehicle","id","");
+      buf[0] = 0x0a;  /* PID */
+      buf[1] = 0x01;  /* number of data items */
+      memset(&buf[2],0,20);  // zero pad string, per spec
+      memcpy(&buf[2],value.c_str(),MIN(value.size(),20));
+      return 22;
 
-          break;
+    default:
+      ESP_LOGD(TAG, "unknown ID=9 frame %x",pid);
+      return 0;
+    }
+  }
 
-        case 0x0a: /* ECU Name */
-          ESP_LOGD(TAG, "ECU Name requested");
-          /* Perhaps a good place for arbitrary text, e.g. fleet asset #?  20 char avail. */
+//
+// Build the response to a request (mode + PIDs), returns length (0 = no answer)
+//
+int obd2ecu::BuildResponse(uint8_t mode, const uint8_t* pids, int npids, uint8_t* buf)
+  {
+  int length = 0;
 
-          memcpy(rtn_string,MyConfig.GetParamValue("vehicle","id","").c_str(),20);
-          rtn_string[20] = '\0';
+  buf[0] = mode + 0x40;  /* Mode + 0x40 indicating a reply */
 
-          for(int i=strlen(rtn_string);i<20;i++) rtn_string[i] = '\0';  // zero pad string, per spec
+  switch(mode)
+    {
+    case 1:  /* Mode 1 (main real-time PIDs are here), up to 6 PIDs per request */
+      for (int i=0; i<npids; i++)
+        length += Mode1Response(pids[i], &buf[1+length]);
+      break;
 
-          r_frame.origin = NULL;
-          r_frame.FIR.U = 0;
-          r_frame.FIR.B.DLC = 8;
-          r_frame.FIR.B.FF = CAN_frame_format_t (reply != RESPONSE_PID);
-          r_frame.MsgID = reply;
-          r_d[0] = 0x10;  /* not sure what this is for */
-          r_d[1] = 0x17;  /* overall length, starting with next byte, not including pad */
-          r_d[2] = 0x49;  /* Mode 9 reply */
-          r_d[3] = 0x0a;  /* PID */
-          r_d[4] = 0x01;  /* not sure what this is for */
-          memcpy(&r_d[5],rtn_string,3);  /* grab the first 3 bytes of Vehicle ID */
+    case 9:  /* Mode 9 (vehicle information), one PID per request */
+      if (npids == 1)
+        length = Mode9Response(pids[0], &buf[1]);
+      break;
 
-          m_can->Write(&r_frame);
+    case 0x03:  /* request DTCs */
+      ESP_LOGD(TAG, "Request DTCs; ignored");
+      break;
 
-          vTaskDelay(10 / portTICK_PERIOD_MS);  /* let the flow control frame pass */
+    case 0x07: /* pending DTCs */
+      ESP_LOGD(TAG, "Pending DTCs; ignored");
+      break;
 
-          r_d[0] = 0x21;
-          memcpy(&r_d[1],rtn_string+3,7);  /* grab the next 7 bytes of Vehicle ID */
+    case 0x0a:  /* permanent / cleared DTCs */
+      ESP_LOGD(TAG, "permanent / cleared DTCs; ignored");
+      break;
 
-          m_can->Write(&r_frame);
+    default:
+      ESP_LOGD(TAG, "Unknown Mode %x",mode);
+    }
 
-          r_d[0] = 0x22;
-          memcpy(&r_d[1],rtn_string+10,7);  /* grab next 7 bytes of Vehicle ID */
+  return (length) ? 1 + length : 0;
+  }
 
-          m_can->Write(&r_frame);
+//
+// Send a response: single frame, or ISO-TP first frame (rest sent on flow control)
+//
+void obd2ecu::SendResponse(uint32_t reply, const uint8_t* data, int length)
+  {
+  CAN_frame_t r_frame;  /* build the response frame here */
+  uint8_t *r_d = r_frame.data.u8;
 
-          r_d[0] = 0x23;
-          memcpy(&r_d[1],rtn_string+17,3);  /* grab last 3 bytes of Vehicle ID */
+  r_frame.origin = NULL;
+  r_frame.FIR.U = 0;
+  r_frame.FIR.B.DLC = 8;
+  r_frame.FIR.B.FF = CAN_frame_format_t (reply != RESPONSE_PID);
+  r_frame.MsgID = reply;
+  memset(r_d, 0x55, 8);  /* pad 0x55 */
 
-          r_d[4] = 0x00;  /* Spec says 0 Pad... */
-          r_d[5] = 0x00;
-          r_d[6] = 0x00;
-          r_d[7] = 0x00;
+  if (length <= 7)
+    {
+    r_d[0] = length;
+    memcpy(&r_d[1], data, length);
+    m_can->Write(&r_frame);
+    return;
+    }
 
-          m_can->Write(&r_frame);
+  r_d[0] = 0x10 | ((length >> 8) & 0x0f);
+  r_d[1] = length & 0xff;
+  memcpy(&r_d[2], data, 6);
+
+  memcpy(m_tx_data, data, length);
+  m_tx_reply = reply;
+  m_tx_length = length;
+  m_tx_pos = 6;
+  m_tx_seq = 1;
+  m_tx_time = CAN_Timestamp();
+  m_can->Write(&r_frame);
+  }
 
-          break;
+//
+// Flow control for a pending ISO-TP response: send the next block of consecutive frames
+//
+void obd2ecu::FlowControl(CAN_frame_t* p_frame)
+  {
+  CAN_frame_t r_frame;
+  uint8_t *r_d = r_frame.data.u8;
+  uint8_t *p_d = p_frame->data.u8;
+  uint32_t now = CAN_Timestamp();
 
-        default:
-          ESP_LOGD(TAG, "unknown ID=9 frame %x",p_d[2]);
-        }
-        break;
+  if (m_tx_pos >= m_tx_length || (m_tx_reply == RESPONSE_PID) != (p_frame->MsgID == FLOWCONTROL_PID))
+    {
+    ESP_LOGD(TAG, "flow control frame - no transfer pending");
+    return;
+    }
+  if (now - m_tx_time > ISOTP_FC_TIMEOUT)
+    {
+    ESP_LOGD(TAG, "flow control frame - timeout, transfer aborted");
+    m_tx_length = 0;
+    return;
+    }
 
-    case 0x03:  /* request DTCs */
-      ESP_LOGD(TAG, "Request DTCs; ignored");
+  switch (p_d[0] & 0x0f)
+    {
+    case 0:  /* clear to send */
       break;
+    case 1:  /* wait */
+      m_tx_time = now;
+      return;
+    default:  /* overflow / abort */
+      ESP_LOGD(TAG, "flow control frame - transfer aborted by receiver");
+      m_tx_length = 0;
+      return;
+    }
 
-    case 0x07: /* pending DTCs */
-      ESP_LOGD(TAG, "Pending DTCs; ignored");
-      break;
+  int bs = p_d[1];      /* block size, 0 = send all */
+  int stmin = p_d[2];   /* separation time: 0-127 ms, 0xf1-0xf9 100-900 us */
 
-    case 0x0a:  /* permanent / cleared DTCs */
-      ESP_LOGD(TAG, "permanent / cleared DTCs; ignored");
-      break;
+  r_frame.origin = NULL;
+  r_frame.FIR.U = 0;
+  r_frame.FIR.B.DLC = 8;
+  r_frame.FIR.B.FF = CAN_frame_format_t (m_tx_reply != RESPONSE_PID);
+  r_frame.MsgID = m_tx_reply;
 
-    default:
-      ESP_LOGD(TAG, "Unknown Mode %x",p_d[1]);
+  for (int n=0; m_tx_pos < m_tx_length; n++)
+    {
+    if (bs && n == bs) break;
+    if (n > 0 && stmin)
+      {
+      if (stmin <= 0x7f)
+        vTaskDelay(MAX(1, pdMS_TO_TICKS(stmin)));
+      else if (stmin >= 0xf1 && stmin <= 0xf9)
+        ets_delay_us((stmin-0xf0)*100);
+      else
+        vTaskDelay(MAX(1, pdMS_TO_TICKS(0x7f)));  /* reserved: use max */
+      }
+    int len = MIN(7, m_tx_length - m_tx_pos);
+    memset(r_d, 0x55, 8);  /* pad 0x55 */
+    r_d[0] = 0x20 | (m_tx_seq++ & 0x0f);
+    memcpy(&r_d[1], &m_tx_data[m_tx_pos], len);
+    m_tx_pos += len;
+    m_can->Write(&r_frame);
     }
 
+  m_tx_time = CAN_Timestamp();
+  }
+
+
+void obd2ecu::IncomingFrame(CAN_frame_t* p_frame)
+  {
+  uint32_t reply;
+  uint8_t *p_d = p_frame->data.u8;  /* Incoming frame data from HUD / Dongle */
+
+  ESP_LOGD(TAG, "Rcv %x: %x (%x %x %x %x %x %x %x %x)",
+                      p_frame->MsgID,
+                      p_frame->FIR.B.DLC,
+                      p_d[0],p_d[1],p_d[2],p_d[3],p_d[4],p_d[5],p_d[6],p_d[7]);
+
+  /* handle both standard and extended frame types - return like for like */
+  if (p_frame->MsgID == REQUEST_PID) reply = RESPONSE_PID;
+  else if (p_frame->MsgID == REQUEST_EXT_PID) reply = RESPONSE_EXT_PID;
+       else
+       { /* check for flow control frames - they're received on the response MsgID minus 8 */
+         if ((p_frame->MsgID == FLOWCONTROL_PID || p_frame->MsgID == FLOWCONTROL_EXT_PID) && (p_d[0] & 0xf0) == 0x30)
+         { FlowControl(p_frame);
+           return;
+         }
+         /* physical requests are also received there */
+         if (p_frame->MsgID == FLOWCONTROL_PID) reply = RESPONSE_PID;
+         else if (p_frame->MsgID == FLOWCONTROL_EXT_PID) reply = RESPONSE_EXT_PID;
+         else
+         { /* if none of the above, no idea what it is.  Ignore */
+           ESP_LOGD(TAG, "unknown MsgID %x",p_frame->MsgID);
+           return;
+         }
+       }
+
+  /* requests are single frames: length, mode, up to 6 PIDs */
+  int length = p_d[0];
+  if (length < 1 || length > 7)
+  { ESP_LOGD(TAG, "not a single frame request %x",p_d[0]);
+    return;
+  }
+
+  m_tx_length = 0;  /* a new request cancels a pending multi-frame response */
+
+  /* look up the response by request (mode + PIDs), cached for m_cache_time */
+  uint64_t key = length;
+  for (int i=1; i<=length; i++) key = (key << 8) | p_d[i];
+
+  if (m_cache_flush)
+  { m_cache.clear();
+    m_cache_flush = false;
+  }
+
+  uint32_t now = CAN_Timestamp();
+  obd2response_t response;
+  ResponseCache::iterator it = m_cache.find(key);
+  if (it != m_cache.end() && now - it->second.time < m_cache_time)
+  { response = it->second;
+  }
+  else
+  { response.time = now;
+    response.length = BuildResponse(p_d[1], &p_d[2], length-1, response.data);
+    if (m_cache_time)
+    { if (it == m_cache.end() && m_cache.size() >= OBD2ECU_CACHE_SIZE) m_cache.clear();
+      m_cache[key] = response;
+    }
+  }
+
+  if (response.length)
+    SendResponse(reply, response.data, response.length);
+
+  /* response latency from frame reception */
+  if (p_d[1] == 1)
+  { uint32_t latency = CAN_Timestamp() - p_frame->timestamp;
+    for (int i=2; i<=length; i++)
+    { PidMap::iterator pit = m_pidmap.find(p_d[i]);
+      if (pit != m_pidmap.end()) pit->second->RecordRequest(latency);
+    }
+  }
+
   return;
   }
 
@@ -752,6 +982,9 @@ void obd2ecu::LoadMap()
   m_pidmap[0x20] = new obd2pid(0x20,obd2pid::Internal);                                 // PIDs 21-40 supported (internally)
   Addpid(0x20);
 
+  // Response cache time (ms, 0 = disabled):
+  m_cache_time = MyConfig.GetParamValueInt("obd2ecu", "cache.time", OBD2ECU_CACHE_TIME) * 1000;
+
   // Look for metric overrides...
   OvmsConfigParam* cm = MyConfig.CachedParam("obd2ecu.map");
   for (ConfigParamMap::iterator it=cm->m_map.begin(); it!=cm->m_map.end(); ++it)
@@ -776,6 +1009,7 @@ void obd2ecu::LoadMap()
 
   // Look for scripts (if javascript enabled)...
   #ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+  PidList scriptpids;
   DIR *dir;
   struct dirent *dp;
   if ((dir = opendir ("/store/obd2ecu")) != NULL)
@@ -793,15 +1027,31 @@ void obd2ecu::LoadMap()
         else
           m_pidmap[pid]->SetType(obd2pid::Script);
         m_pidmap[pid]->LoadScript(fpath);
+        scriptpids.push_back(m_pidmap[pid]);
         }
       }
     closedir(dir);
     }
+
+  // Script results are computed by the timer, the CAN task only reads them:
+  if (!scriptpids.empty())
+    {
+    int refresh = MyConfig.GetParamValueInt("obd2ecu", "script.refresh", SCRIPT_REFRESH_MS);
+    if (refresh < 100) refresh = 100;
+    m_scriptmutex.Lock();
+    m_scriptpids = scriptpids;
+    m_scriptmutex.Unlock();
+    RefreshScripts();
+    xTimerChangePeriod(m_script_timer, pdMS_TO_TICKS(refresh), portMAX_DELAY);
+    }
   #endif //#ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
   }
 
 void obd2ecu::ClearMap()
   {
+  xTimerStop(m_script_timer, portMAX_DELAY);
+  OvmsMutexLock lock(&m_scriptmutex);
+  m_scriptpids.clear();
   for (PidMap::iterator it=m_pidmap.begin(); it!=m_pidmap.end(); ++it)
     {
     delete it->second;
@@ -809,8 +1059,19 @@ void obd2ecu::ClearMap()
   m_pidmap.clear();
   m_supported_01_20 = 0;
   m_supported_21_40 = 0;
+  m_cache_flush = true;
+  }
 
+void obd2ecu::RefreshScripts()
+  {
+  // Called by the timer: skip this round if the map is being (re)loaded
+  OvmsMutexLock lock(&m_scriptmutex, 0);
+  if (!lock.IsLocked())
+    return;
+  for (PidList::iterator it=m_scriptpids.begin(); it!=m_scriptpids.end(); ++it)
+    (*it)->RefreshScript();
   }
+
 /* procedure to add a PID to the vectors of supported PIDS, used with PID 0 & 0x20 */
 
 void obd2ecu::Addpid(uint8_t pid)
@@ -846,6 +1107,7 @@ obd2ecuInit::obd2ecuInit()
   cmd_start->RegisterCommand("can3","Start an OBDII ECU on can3",obd2ecu_start, "", 0, 0,true);
   cmd_ecu->RegisterCommand("stop","Stop the OBDII ECU",obd2ecu_stop, "", 0, 0,true);
   cmd_ecu->RegisterCommand("list","Show OBDII ECU pid list",obd2ecu_list, "", 0, 1,true);
+  cmd_ecu->RegisterCommand("status","Show OBDII ECU pid response statistics",obd2ecu_status, "", 0, 1,true);
   cmd_ecu->RegisterCommand("reload","Reload OBDII ECU pid map",obd2ecu_reload, "", 0, 0,true);
 
   MyConfig.RegisterParam("obd2ecu", "OBD2ECU configuration", true, true);
@@ -34,9 +34,17 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/timers.h"
+#include <vector>
 #include "pcp.h"
 #include "can.h"
 #include "ovms_metrics.h"
+#include "ovms_mutex.h"
+
+#define OBD2ECU_MAX_RESPONSE 32   // max response length (mode + data)
+#define OBD2ECU_CACHE_SIZE 16     // max cached responses
+#define OBD2ECU_CACHE_TIME 100    // default response cache time [ms]
+#define ISOTP_FC_TIMEOUT 1000000  // flow control timeout (N_Bs) [us]
 
 class obd2pid
   {
@@ -61,19 +69,45 @@ class obd2pid
     void SetType(pid_t type);
     void SetMetric(OvmsMetric* metric);
     void LoadScript(std::string path);
+    void RefreshScript();
     float Execute();
 
   public:
     float InternalPid();
 
+  public:
+    void RecordRequest(uint32_t latency);
+    uint32_t GetRequests();
+    uint32_t GetLatencyAvg();
+    uint32_t GetLatencyMax();
+
+  protected:
+    void DiscardScript();
+
   protected:
     int m_pid;
     pid_t m_type;
     char* m_script;
+    float m_value;                // script result, updated by RefreshScript()
+    volatile bool m_pending;      // script call queued
+    uint32_t m_lastrequest;       // monotonictime
+    uint32_t m_requests;
+    uint64_t m_latency_sum;       // [us]
+    uint32_t m_latency_max;       // [us]
     OvmsMetric* m_metric;
   };
 
 typedef std::map<int, obd2pid*> PidMap;
+typedef std::vector<obd2pid*> PidList;
+
+typedef struct
+  {
+  uint32_t time;                        // CAN_Timestamp() of creation
+  int length;                           // 0 = no response
+  uint8_t data[OBD2ECU_MAX_RESPONSE];
+  } obd2response_t;
+
+typedef std::map<uint64_t, obd2response_t> ResponseCache;   // key: request length, mode & PIDs
 
 class obd2ecu : public pcp, public InternalRamAllocated
   {
@@ -98,9 +132,31 @@ class obd2ecu : public pcp, public InternalRamAllocated
     void LoadMap();
     void ClearMap();
     void Addpid(uint8_t pid);
+    void RefreshScripts();
+
+  protected:
+    void FillPid(uint8_t *buf,float data,uint8_t format);
+    int Mode1Response(uint8_t pid, uint8_t* buf);
+    int Mode9Response(uint8_t pid, uint8_t* buf);
+    int BuildResponse(uint8_t mode, const uint8_t* pids, int npids, uint8_t* buf);
+    void SendResponse(uint32_t reply, const uint8_t* data, int length);
+    void FlowControl(CAN_frame_t* p_frame);
 
   protected:
-    void FillFrame(CAN_frame_t *frame,int reply,uint8_t pid,float data,uint8_t format);
+    ResponseCache m_cache;
+    uint32_t m_cache_time;        // [us], 0 = disabled
+    volatile bool m_cache_flush;  // set on map changes
+    uint8_t m_tx_data[OBD2ECU_MAX_RESPONSE];  // ISO-TP multi frame response
+    uint32_t m_tx_reply;
+    int m_tx_length;
+    int m_tx_pos;
+    uint8_t m_tx_seq;
+    uint32_t m_tx_time;           // CAN_Timestamp() of last frame / flow control
+
+  protected:
+    TimerHandle_t m_script_timer;
+    PidList m_scriptpids;         // script PIDs to refresh
+    OvmsMutex m_scriptmutex;      // protects m_scriptpids
   };
   
 class obd2ecuInit
@@ -120,5 +176,8 @@ extern class obd2ecuInit obd2ecuInit;
 #define RESPONSE_EXT_PID 0x18daf10e
 #define FLOWCONTROL_EXT_PID 0x18da0ef1
 
+#define SCRIPT_REFRESH_MS 500   // default script PID refresh interval
+#define SCRIPT_IDLE_TIME 10     // seconds without requests to pause script PID refresh
+
 
 #endif //#ifndef __OBD2ECU_H__
@@ -33,6 +33,7 @@ static const char *TAG = "ota";
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <sys/stat.h>
 #include <string>
 #include <string.h>
@@ -52,7 +53,9 @@ static const char *TAG = "ota";
 #include "ovms_boot.h"
 #include "ovms_netmanager.h"
 #include "ovms_version.h"
+#include "ovms_malloc.h"
 #include "crypt_md5.h"
+#include "crypt_base64.h"
 
 OvmsOTA MyOTA __attribute__ ((init_priority (4400)));
 
@@ -218,6 +221,215 @@ void ota_flash_vfs(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc
   MyConfig.SetParamValue("ota", "vfs.mru", argv[0]);
   }
 
+/**
+ * ota_report: output to command writer or log (writer=NULL)
+ */
+static void ota_report(OvmsWriter* writer, bool error, const char* fmt, ...)
+  {
+  char* msg = NULL;
+  va_list args;
+  va_start(args, fmt);
+  int len = vasprintf(&msg, fmt, args);
+  va_end(args);
+  if (len < 0 || !msg)
+    return;
+  if (writer)
+    writer->puts(msg);
+  else if (error)
+    ESP_LOGE(TAG, "AutoFlash: %s", msg);
+  else
+    ESP_LOGI(TAG, "AutoFlash: %s", msg);
+  free(msg);
+  }
+
+
+/**
+ * ota_download: download firmware image via HTTP and flash it to <target>
+ *  The download is resumed (HTTP Range request) after connection losses,
+ *  if the server does not support ranges, the received part is skipped.
+ *  A failed resume request (error response other than 200/416) counts as
+ *  a retry. Gives up after OTA_HTTP_RETRIES resumes without progress.
+ *  Returns the image size, 0 on failure.
+ */
+static size_t ota_download(OvmsWriter* writer, std::string url, const esp_partition_t* target)
+  {
+  OvmsOTAStream stream(target);
+  size_t expected = 0, filesize = 0, lastsize = 0, sofar = 0;
+  int retries = 0;
+  std::string contentmd5;
+
+  while (true)
+    {
+    // HTTP client request...
+    OvmsHttpClient http;
+    bool ok;
+    size_t skip = 0;
+    if (expected == 0)
+      {
+      ok = http.Request(url);
+      if (!ok || !http.IsOpen())
+        {
+        ota_report(writer, true, "Error: Request for %s failed", url.c_str());
+        return 0;
+        }
+      expected = http.BodySize();
+      if (expected < 32 || http.ResponseCode() != 200)
+        {
+        ota_report(writer, true, "Error: Expected download file size (%d) is invalid (response %d)",
+          expected, http.ResponseCode());
+        return 0;
+        }
+      if (expected > target->size)
+        {
+        ota_report(writer, true, "Error: Download firmware is bigger than available partition space");
+        return 0;
+        }
+      ota_report(writer, false, "Expected file size is %d", expected);
+      contentmd5 = http.ContentMD5();
+
+      ota_report(writer, false, "Preparing flash partition...");
+      esp_err_t err = stream.Begin(expected);
+      if (err != ESP_OK)
+        {
+        ota_report(writer, true, "Error: ESP32 error #%d when starting OTA operation", err);
+        return 0;
+        }
+      }
+    else
+      {
+      char range[40];
+      snprintf(range, sizeof(range), "Range: bytes=%u-\r\n", (unsigned)filesize);
+      ota_report(writer, false, "Resuming download at %d bytes (retry %d/%d)...",
+        filesize, retries, OTA_HTTP_RETRIES);
+      ok = http.Request(url, "GET", range) && http.IsOpen();
+      if (!ok)
+        ota_report(writer, true, "Error: Request for %s failed", url.c_str());
+      else if (http.ResponseCode() == 206 && http.BodySize() == expected - filesize)
+        skip = 0;
+      else if (http.ResponseCode() == 200 && http.BodySize() == expected)
+        skip = filesize; // server does not support ranges
+      else if (http.ResponseCode() == 200 || http.ResponseCode() == 416)
+        {
+        // the file has changed on the server
+        ota_report(writer, true, "Error: Server cannot resume download (response %d, size %d)",
+          http.ResponseCode(), http.BodySize());
+        return 0;
+        }
+      else
+        {
+        // e.g. 502/503 from a proxy or an overloaded server: count as a failed attempt
+        ota_report(writer, true, "Error: Resume request failed (response %d, size %d)",
+          http.ResponseCode(), http.BodySize());
+        http.Disconnect();
+        ok = false;
+        }
+      }
+
+    // Now, process the body
+    if (ok)
+      {
+      struct timeval tv = { OTA_HTTP_TIMEOUT, 0 };
+      setsockopt(http.Socket(), SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+      uint8_t* buf = NULL;
+      size_t len = 0;
+      while (filesize + len < expected)
+        {
+        if (!buf)
+          buf = stream.GetBuffer();
+        ssize_t k = (ssize_t) http.BodyRead(buf+len, OTA_STREAM_BUFSIZE-len);
+        if (k <= 0)
+          break;
+        if (skip > 0)
+          {
+          size_t n = ((size_t)k < skip) ? k : skip;
+          skip -= n;
+          k -= n;
+          memmove(buf+len, buf+len+n, k);
+          }
+        if (filesize + len + k > expected)
+          {
+          ota_report(writer, true, "Error: Download exceeds expected file size");
+          stream.Submit(buf, 0);
+          return 0;
+          }
+        len += k;
+        if (len == OTA_STREAM_BUFSIZE || filesize + len == expected)
+          {
+          if (!stream.Submit(buf, len))
+            {
+            buf = NULL;
+            break;
+            }
+          filesize += len;
+          sofar += len;
+          buf = NULL;
+          len = 0;
+          if (writer && sofar > 100000)
+            {
+            writer->printf("Downloading... (%d bytes so far)\n",filesize);
+            sofar = 0;
+            }
+          }
+        }
+      if (buf)
+        {
+        // connection lost: flash the part received
+        if (stream.Submit(buf, len))
+          filesize += len;
+        }
+      http.Disconnect();
+      }
+
+    if (stream.GetError() != ESP_OK)
+      {
+      ota_report(writer, true, "Error: ESP32 error #%d when writing to flash - state is inconsistent",
+        stream.GetError());
+      return 0;
+      }
+    if (filesize == expected)
+      break;
+    if (filesize > lastsize)
+      retries = 0; // count retries without progress only
+    lastsize = filesize;
+    if (++retries > OTA_HTTP_RETRIES)
+      {
+      ota_report(writer, true, "Error: Download failed at %d of %d bytes", filesize, expected);
+      return 0;
+      }
+    vTaskDelay(pdMS_TO_TICKS(5000 * retries));
+    }
+
+  ota_report(writer, false, "Download complete (at %d bytes)", filesize);
+
+  esp_err_t err = stream.End();
+  if (err != ESP_OK)
+    {
+    ota_report(writer, true, "Error: ESP32 error #%d finalising OTA operation - state is inconsistent", err);
+    return 0;
+    }
+
+  // Verify image hash:
+  char md5hex[OVMS_MD5_SIZE*2+1];
+  for (int i=0; i<OVMS_MD5_SIZE; i++)
+    sprintf(md5hex+i*2, "%02x", stream.GetMD5()[i]);
+  if (!contentmd5.empty())
+    {
+    std::string md5 = base64decode(contentmd5);
+    if (md5.size() != OVMS_MD5_SIZE || memcmp(md5.data(), stream.GetMD5(), OVMS_MD5_SIZE) != 0)
+      {
+      ota_report(writer, true, "Error: Image MD5 %s does not match server Content-MD5 %s",
+        md5hex, contentmd5.c_str());
+      return 0;
+      }
+    ota_report(writer, false, "Image MD5 %s verified", md5hex);
+    }
+  else
+    ota_report(writer, false, "Image MD5 is %s", md5hex);
+
+  return filesize;
+  }
+
+
 void ota_flash_http(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   std::string url;
@@ -277,93 +489,122 @@ void ota_flash_http(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int arg
     }
   writer->printf("Download firmware from %s to %s\n",url.c_str(),target->label);
 
-  // HTTP client request...
-  OvmsHttpClient http(url);
-  if (!http.IsOpen())
+  size_t filesize = ota_download(writer, url, target);
+  if (filesize == 0)
+    return;
+
+  // OK. Now ready to start the work...
+
+  // All done
+  writer->puts("Setting boot partition...");
+  esp_err_t err = esp_ota_set_boot_partition(target);
+  if (err != ESP_OK)
     {
-    writer->puts("Error: Request failed");
+    writer->printf("Error: ESP32 error #%d setting boot partition - check before rebooting\n",err);
     return;
     }
 
-  size_t expected = http.BodySize();
-  if (expected < 32)
+  writer->printf("OTA flash was successful\n  Flashed %d bytes from %s\n  Next boot will be from '%s'\n",
+                 filesize,url.c_str(),target->label);
+  MyConfig.SetParamValue("ota", "http.mru", url);
+  }
+
+void ota_flash_delta(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  const esp_partition_t *target = esp_ota_get_next_update_partition(running);
+
+  OvmsMutexLock m_lock(&MyOTA.m_flashing,0);
+  if (!m_lock.IsLocked())
     {
-    writer->printf("Error: Expected download file size (%d) is invalid\n",expected);
+    writer->puts("Error: Flash operation already in progress - cannot flash again");
     return;
     }
 
-  writer->printf("Expected file size is %d\n",expected);
+  if (running==NULL)
+    {
+    writer->puts("Error: Current running image cannot be determined - aborting");
+    return;
+    }
+  writer->printf("Current running partition is: %s\n",running->label);
 
-  writer->puts("Preparing flash partition...");
-  esp_ota_handle_t otah;
-  esp_err_t err = esp_ota_begin(target, expected, &otah);
-  if (err != ESP_OK)
+  if (target==NULL)
     {
-    writer->printf("Error: ESP32 error #%d when starting OTA operation\n",err);
-    http.Disconnect();
+    writer->puts("Error: Target partition cannot be determined - aborting");
+    return;
+    }
+  writer->printf("Target partition is: %s\n",target->label);
+
+  if (running == target)
+    {
+    writer->puts("Error: Cannot flash to running image partition");
     return;
     }
 
-  // Now, process the body
+  OvmsOTAStream stream(target);
+  OvmsOTAPatch patch(running, &stream);
   uint8_t rbuf[512];
-  size_t filesize = 0;
-  int sofar = 0;
-  while (int k = http.BodyRead(rbuf,512))
+  size_t patchsize = 0;
+
+  if (argv[0][0] == '/')
     {
-    filesize += k;
-    sofar += k;
-    if (sofar > 100000)
+    // Patch file:
+    if (MyConfig.ProtectedPath(argv[0]))
       {
-      writer->printf("Downloading... (%d bytes so far)\n",filesize);
-      sofar = 0;
+      writer->puts("Error: protected path");
+      return;
       }
-    if (filesize > target->size)
+    FILE* f = fopen(argv[0], "r");
+    if (f == NULL)
       {
-      writer->printf("Error: Download firmware is bigger than available partition space - state is inconsistent\n");
-      esp_ota_end(otah);
-      http.Disconnect();
+      writer->printf("Error: Cannot open %s\n",argv[0]);
       return;
       }
-    err = esp_ota_write(otah, rbuf, k);
-    if (err != ESP_OK)
+    writer->puts("Applying patch...");
+    while (size_t n = fread(rbuf, sizeof(char), sizeof(rbuf), f))
       {
-      writer->printf("Error: ESP32 error #%d when writing to flash - state is inconsistent\n",err);
-      esp_ota_end(otah);
-      http.Disconnect();
-      return;
+      patchsize += n;
+      if (!patch.Feed(rbuf, n))
+        break;
       }
+    fclose(f);
     }
-  http.Disconnect();
-  writer->printf("Download complete (at %d bytes)\n",filesize);
-
-  if (filesize != expected)
+  else
     {
-    writer->printf("Error: Download file size (%d) does not match expected (%d)\n",filesize,expected);
-    esp_ota_end(otah);
-    return;
+    // Patch download:
+    OvmsHttpClient http(argv[0]);
+    if (!http.IsOpen() || http.ResponseCode() != 200)
+      {
+      writer->printf("Error: Request for %s failed (response %d)\n", argv[0], http.ResponseCode());
+      return;
+      }
+    writer->printf("Downloading & applying patch (%d bytes)...\n", http.BodySize());
+    ssize_t n;
+    while ((n = (ssize_t) http.BodyRead(rbuf, sizeof(rbuf))) > 0)
+      {
+      patchsize += n;
+      if (!patch.Feed(rbuf, n))
+        break;
+      }
+    http.Disconnect();
     }
 
-  err = esp_ota_end(otah);
-  if (err != ESP_OK)
+  if (!patch.Finish())
     {
-    writer->printf("Error: ESP32 error #%d finalising OTA operation - state is inconsistent\n",err);
+    writer->printf("Error: Delta update failed at patch offset %d: %s\n", patchsize, patch.GetError());
     return;
     }
 
-  // OK. Now ready to start the work...
-
-  // All done
   writer->puts("Setting boot partition...");
-  err = esp_ota_set_boot_partition(target);
+  esp_err_t err = esp_ota_set_boot_partition(target);
   if (err != ESP_OK)
     {
     writer->printf("Error: ESP32 error #%d setting boot partition - check before rebooting\n",err);
     return;
     }
 
-  writer->printf("OTA flash was successful\n  Flashed %d bytes from %s\n  Next boot will be from '%s'\n",
-                 filesize,url.c_str(),target->label);
-  MyConfig.SetParamValue("ota", "http.mru", url);
+  writer->printf("OTA flash was successful\n  Patched %d bytes from %s (%d bytes)\n  Next boot will be from '%s'\n",
+                 patch.GetTargetSize(),argv[0],patchsize,target->label);
   }
 
 void ota_flash_auto(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
@@ -549,6 +790,7 @@ OvmsOTA::OvmsOTA()
   OvmsCommand* cmd_otaflash = cmd_ota->RegisterCommand("flash","OTA flash",NULL,"",0,0,true);
   cmd_otaflash->RegisterCommand("vfs","OTA flash vfs",ota_flash_vfs,"<file>",1,1,true);
   cmd_otaflash->RegisterCommand("http","OTA flash http",ota_flash_http,"<url>",0,1,true);
+  cmd_otaflash->RegisterCommand("delta","OTA flash delta patch against running firmware",ota_flash_delta,"<file/url>",1,1,true);
   OvmsCommand* cmd_otaflash_auto = cmd_otaflash->RegisterCommand("auto","Automatic regular OTA flash (over web)",ota_flash_auto,"[force]",0,1,true);
   cmd_otaflash_auto->RegisterCommand("force","…force update (even if server version older)",ota_flash_auto,"",0,0,true);
 
@@ -596,14 +838,14 @@ void OvmsOTA::GetStatus(ota_info& info, bool check_update /*=true*/)
       url.append("/ovms3.ver");
 
       OvmsHttpClient http(url);
-      if (http.IsOpen() && http.ResponseCode() == 200 && http.BodyHasLine())
+      if (http.IsOpen() && http.ResponseCode() == 200 && http.BodyHasLine() >= 0)
         {
         info.version_server = http.BodyReadLine();
-        char rbuf[512];
-        while (size_t k = http.BodyRead(rbuf,512))
+        http.BodyStream([&info](const char* data, size_t len)
           {
-          info.changelog_server.append(rbuf,k);
-          }
+          info.changelog_server.append(data, len);
+          return true;
+          });
         http.Disconnect();
         }
       }
@@ -746,73 +988,13 @@ bool OvmsOTA::AutoFlash(bool force)
     url.c_str());
   MyNotify.NotifyStringf("info", "ota.update", "New OTA firmware %s is available for download", info.version_server.c_str());
 
-  // HTTP client request...
-  OvmsHttpClient http(url);
-  if (!http.IsOpen())
-    {
-    ESP_LOGE(TAG, "AutoFlash: http://%s request failed", url.c_str());
-    return false;
-    }
-
-  size_t expected = http.BodySize();
-  if (expected < 32)
-    {
-    ESP_LOGE(TAG, "AutoFlash: Expected download file size (%d) is invalid", expected);
-    return false;
-    }
-
-  ESP_LOGI(TAG, "AutoFlash: Preparing flash partition...");
-  esp_ota_handle_t otah;
-  esp_err_t err = esp_ota_begin(target, expected, &otah);
-  if (err != ESP_OK)
-    {
-    ESP_LOGE(TAG, "AutoFlash: ESP32 error #%d when starting OTA operation", err);
-    http.Disconnect();
-    return false;
-    }
-
-  // Now, process the body
-  uint8_t rbuf[512];
-  size_t filesize = 0;
-  while (int k = http.BodyRead(rbuf,512))
-    {
-    filesize += k;
-    if (filesize > target->size)
-      {
-      ESP_LOGE(TAG, "AutoFlash: Download firmware is bigger than available partition space - state is inconsistent");
-      esp_ota_end(otah);
-      http.Disconnect();
-      return false;
-      }
-    err = esp_ota_write(otah, rbuf, k);
-    if (err != ESP_OK)
-      {
-      ESP_LOGE(TAG, "AutoFlash: ESP32 error #%d when writing to flash - state is inconsistent", err);
-      esp_ota_end(otah);
-      http.Disconnect();
-      return false;
-      }
-    }
-  http.Disconnect();
-  ESP_LOGI(TAG, "AutoFlash:: Download complete (at %d bytes)", filesize);
-
-  if (filesize != expected)
-    {
-    ESP_LOGE(TAG, "AutoFlash: Download file size (%d) does not match expected (%d)", filesize, expected);
-    esp_ota_end(otah);
-    return false;
-    }
-
-  err = esp_ota_end(otah);
-  if (err != ESP_OK)
-    {
-    ESP_LOGE(TAG, "AutoFlash: ESP32 error #%d finalising OTA operation - state is inconsistent", err);
+  size_t filesize = ota_download(NULL, url, target);
+  if (filesize == 0)
     return false;
-    }
 
   // All done
   ESP_LOGI(TAG, "AutoFlash: Setting boot partition...");
-  err = esp_ota_set_boot_partition(target);
+  esp_err_t err = esp_ota_set_boot_partition(target);
   if (err != ESP_OK)
     {
     ESP_LOGE(TAG, "AutoFlash: ESP32 error #%d setting boot partition - check before rebooting", err);
@@ -33,8 +33,17 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <esp_ota_ops.h>
 #include "ovms_events.h"
 #include "ovms_mutex.h"
+#include "crypt_md5.h"
+
+#define OTA_STREAM_BUFSIZE      16384   // size of each stream buffer
+#define OTA_STREAM_BUFFERS      2       // download & flash write overlap
+#define OTA_HTTP_RETRIES        5       // max download resumes without progress
+#define OTA_HTTP_TIMEOUT        30      // seconds without data before a resume
 
 struct ota_info
   {
@@ -46,6 +55,115 @@ struct ota_info
   std::string changelog_server;
   };
 
+/**
+ * OvmsOTAStream: pipelined partition writer
+ *  The producer (i.e. the download) fills buffers taken by GetBuffer() and
+ *  passes them on by Submit(). A writer task writes them to flash and
+ *  updates the MD5 hash, so network and flash I/O overlap.
+ */
+class OvmsOTAStream
+  {
+  public:
+    OvmsOTAStream(const esp_partition_t* target);
+    ~OvmsOTAStream();
+
+  public:
+    esp_err_t Begin(size_t size);
+    uint8_t* GetBuffer();
+    bool Submit(uint8_t* buf, size_t len);
+    esp_err_t End();
+    const esp_partition_t* GetTarget() { return m_target; }
+    esp_err_t GetError() { return m_err; }
+    size_t GetWritten() { return m_written; }
+    const uint8_t* GetMD5() { return m_md5; }
+
+  protected:
+    static void WriterTask(void* pvParameters);
+    void Finish();
+
+  protected:
+    typedef struct
+      {
+      uint8_t* buf;
+      size_t len;                     // 0 = end of stream
+      } chunk_t;
+
+    const esp_partition_t* m_target;
+    esp_ota_handle_t m_otah;
+    bool m_started;
+    TaskHandle_t m_task;
+    QueueHandle_t m_freeq;
+    QueueHandle_t m_fullq;
+    SemaphoreHandle_t m_done;
+    uint8_t* m_buffers[OTA_STREAM_BUFFERS];
+    volatile esp_err_t m_err;
+    volatile size_t m_written;
+    OVMS_MD5_CTX m_md5ctx;
+    uint8_t m_md5[OVMS_MD5_SIZE];
+  };
+
+/**
+ * OvmsOTAPatch: streaming delta patch applier
+ *  Builds the new image from the running partition and a delta patch
+ *  (see tools/ota_delta/ovms_delta.py), RAM usage is bounded by the
+ *  OvmsOTAStream buffers. The patch is fed in arbitrary pieces.
+ *
+ *  Patch format (integers little endian, varints 7 bits per byte LSB first):
+ *    "OVD1"
+ *    uint32 source size, uint8[16] source MD5
+ *    uint32 target size, uint8[16] target MD5
+ *    ops:
+ *      0x01 COPY varint offset, varint length (from source)
+ *      0x02 DATA varint length, <length> bytes
+ *      0x00 END
+ */
+#define OTA_DELTA_MAGIC         "OVD1"
+#define OTA_DELTA_HEADERSIZE    44
+
+class OvmsOTAPatch
+  {
+  public:
+    OvmsOTAPatch(const esp_partition_t* source, OvmsOTAStream* stream);
+    ~OvmsOTAPatch();
+
+  public:
+    bool Feed(const uint8_t* data, size_t len);
+    bool Finish();
+    const char* GetError() { return m_error; }
+    size_t GetTargetSize() { return m_dst_size; }
+
+  protected:
+    bool Fail(const char* error);
+    bool Header();
+    bool Output(const uint8_t* data, size_t len, uint32_t offset=0);
+
+  protected:
+    enum
+      {
+      PatchHeader,
+      PatchOp,
+      PatchVarint,
+      PatchData,
+      PatchEnd,
+      PatchError
+      } m_state;
+    const esp_partition_t* m_source;
+    OvmsOTAStream* m_stream;
+    const char* m_error;
+    uint8_t m_hdr[OTA_DELTA_HEADERSIZE];
+    size_t m_hdrlen;
+    uint32_t m_src_size;
+    uint32_t m_dst_size;
+    uint8_t m_op;
+    uint32_t m_arg[2];
+    int m_argnum;
+    int m_shift;
+    uint32_t m_remain;
+    uint8_t* m_buf;
+    size_t m_buflen;
+    size_t m_outsize;
+  };
+
 class OvmsOTA
   {
   public:
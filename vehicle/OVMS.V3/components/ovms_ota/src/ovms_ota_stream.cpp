@@ -0,0 +1,406 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        OTA stream writer & delta patch applier
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <esp_ota_ops.h>
+#include "ovms_ota.h"
+#include "ovms_malloc.h"
+#include "crypt_md5.h"
+
+/**
+ * OvmsOTAStream: pipelined partition writer
+ */
+
+OvmsOTAStream::OvmsOTAStream(const esp_partition_t* target)
+  {
+  m_target = target;
+  m_otah = 0;
+  m_started = false;
+  m_task = NULL;
+  m_freeq = NULL;
+  m_fullq = NULL;
+  m_done = NULL;
+  for (int i=0; i<OTA_STREAM_BUFFERS; i++)
+    m_buffers[i] = NULL;
+  m_err = ESP_OK;
+  m_written = 0;
+  memset(m_md5, 0, sizeof(m_md5));
+  }
+
+OvmsOTAStream::~OvmsOTAStream()
+  {
+  Finish();
+  if (m_started)
+    esp_ota_end(m_otah); // aborted, release the OTA handle
+  for (int i=0; i<OTA_STREAM_BUFFERS; i++)
+    {
+    if (m_buffers[i]) free(m_buffers[i]);
+    }
+  if (m_freeq) vQueueDelete(m_freeq);
+  if (m_fullq) vQueueDelete(m_fullq);
+  if (m_done) vSemaphoreDelete(m_done);
+  }
+
+esp_err_t OvmsOTAStream::Begin(size_t size)
+  {
+  m_freeq = xQueueCreate(OTA_STREAM_BUFFERS, sizeof(uint8_t*));
+  m_fullq = xQueueCreate(OTA_STREAM_BUFFERS+1, sizeof(chunk_t));
+  m_done = xSemaphoreCreateBinary();
+  if (!m_freeq || !m_fullq || !m_done)
+    return ESP_ERR_NO_MEM;
+  for (int i=0; i<OTA_STREAM_BUFFERS; i++)
+    {
+    m_buffers[i] = (uint8_t*) ExternalRamMalloc(OTA_STREAM_BUFSIZE);
+    if (!m_buffers[i])
+      return ESP_ERR_NO_MEM;
+    xQueueSend(m_freeq, &m_buffers[i], 0);
+    }
+
+  esp_err_t err = esp_ota_begin(m_target, size, &m_otah);
+  if (err != ESP_OK)
+    return err;
+  m_started = true;
+  OVMS_MD5_Init(&m_md5ctx);
+
+  if (xTaskCreatePinnedToCore(WriterTask, "OVMS OTAWrite",
+      4096, (void*)this, 5, &m_task, 1) != pdPASS)
+    {
+    m_task = NULL;
+    return ESP_ERR_NO_MEM;
+    }
+  return ESP_OK;
+  }
+
+void OvmsOTAStream::WriterTask(void* pvParameters)
+  {
+  OvmsOTAStream* me = (OvmsOTAStream*) pvParameters;
+  chunk_t chunk;
+
+  while (xQueueReceive(me->m_fullq, &chunk, portMAX_DELAY) == pdTRUE)
+    {
+    if (chunk.len == 0)
+      break; // end of stream
+    if (me->m_err == ESP_OK)
+      {
+      esp_err_t err = esp_ota_write(me->m_otah, chunk.buf, chunk.len);
+      if (err == ESP_OK)
+        {
+        OVMS_MD5_Update(&me->m_md5ctx, chunk.buf, chunk.len);
+        me->m_written += chunk.len;
+        }
+      else
+        me->m_err = err;
+      }
+    xQueueSend(me->m_freeq, &chunk.buf, portMAX_DELAY);
+    }
+
+  xSemaphoreGive(me->m_done);
+  vTaskDelete(NULL);
+  }
+
+/**
+ * GetBuffer: get a free buffer of OTA_STREAM_BUFSIZE bytes
+ *  Blocks while all buffers are queued for writing.
+ */
+uint8_t* OvmsOTAStream::GetBuffer()
+  {
+  uint8_t* buf = NULL;
+  if (!m_task || xQueueReceive(m_freeq, &buf, portMAX_DELAY) != pdTRUE)
+    return NULL;
+  return buf;
+  }
+
+/**
+ * Submit: queue buffer for writing (len 0 = just return the buffer)
+ *  Returns false if a write has failed.
+ */
+bool OvmsOTAStream::Submit(uint8_t* buf, size_t len)
+  {
+  if (len == 0 || m_err != ESP_OK)
+    {
+    xQueueSend(m_freeq, &buf, portMAX_DELAY);
+    return (m_err == ESP_OK);
+    }
+  chunk_t chunk = { buf, len };
+  xQueueSend(m_fullq, &chunk, portMAX_DELAY);
+  return true;
+  }
+
+void OvmsOTAStream::Finish()
+  {
+  if (!m_task)
+    return;
+  chunk_t chunk = { NULL, 0 };
+  xQueueSend(m_fullq, &chunk, portMAX_DELAY);
+  xSemaphoreTake(m_done, portMAX_DELAY);
+  m_task = NULL;
+  }
+
+/**
+ * End: wait for all writes to complete, finalize the partition
+ */
+esp_err_t OvmsOTAStream::End()
+  {
+  Finish();
+  if (m_err != ESP_OK)
+    return m_err;
+  OVMS_MD5_Final(m_md5, &m_md5ctx);
+  m_started = false;
+  return esp_ota_end(m_otah);
+  }
+
+
+/**
+ * OvmsOTAPatch: streaming delta patch applier
+ */
+
+OvmsOTAPatch::OvmsOTAPatch(const esp_partition_t* source, OvmsOTAStream* stream)
+  {
+  m_state = PatchHeader;
+  m_source = source;
+  m_stream = stream;
+  m_error = NULL;
+  m_hdrlen = 0;
+  m_src_size = 0;
+  m_dst_size = 0;
+  m_op = 0;
+  m_arg[0] = m_arg[1] = 0;
+  m_argnum = 0;
+  m_shift = 0;
+  m_remain = 0;
+  m_buf = NULL;
+  m_buflen = 0;
+  m_outsize = 0;
+  }
+
+OvmsOTAPatch::~OvmsOTAPatch()
+  {
+  if (m_buf)
+    m_stream->Submit(m_buf, 0);
+  }
+
+bool OvmsOTAPatch::Fail(const char* error)
+  {
+  if (m_state != PatchError)
+    m_error = error;
+  m_state = PatchError;
+  return false;
+  }
+
+static inline uint32_t ota_get_le32(const uint8_t* p)
+  {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+  }
+
+bool OvmsOTAPatch::Header()
+  {
+  if (memcmp(m_hdr, OTA_DELTA_MAGIC, 4) != 0)
+    return Fail("not a delta patch");
+  m_src_size = ota_get_le32(m_hdr+4);
+  m_dst_size = ota_get_le32(m_hdr+24);
+  if (m_src_size > m_source->size)
+    return Fail("patch source is bigger than the running partition");
+  // Check the target fits before Begin() erases the partition:
+  if (m_dst_size == 0 || m_dst_size > m_stream->GetTarget()->size)
+    return Fail("patch target does not fit the update partition");
+
+  // Check the patch applies to the running firmware:
+  OVMS_MD5_CTX ctx;
+  uint8_t md5[OVMS_MD5_SIZE];
+  uint8_t buf[512];
+  OVMS_MD5_Init(&ctx);
+  for (uint32_t pos = 0; pos < m_src_size; pos += sizeof(buf))
+    {
+    uint32_t n = (m_src_size-pos < sizeof(buf)) ? m_src_size-pos : sizeof(buf);
+    if (esp_partition_read(m_source, pos, buf, n) != ESP_OK)
+      return Fail("cannot read running partition");
+    OVMS_MD5_Update(&ctx, buf, n);
+    }
+  OVMS_MD5_Final(md5, &ctx);
+  if (memcmp(md5, m_hdr+8, OVMS_MD5_SIZE) != 0)
+    return Fail("patch does not match the running firmware");
+
+  if (m_stream->Begin(m_dst_size) != ESP_OK)
+    return Fail("cannot start OTA operation");
+  return true;
+  }
+
+/**
+ * Output: append <len> bytes from <data> to the target image,
+ *  or from the source partition at <offset> if data is NULL.
+ */
+bool OvmsOTAPatch::Output(const uint8_t* data, size_t len, uint32_t offset)
+  {
+  if (m_outsize + len > m_dst_size)
+    return Fail("patch output exceeds target size");
+  while (len > 0)
+    {
+    if (!m_buf)
+      {
+      m_buf = m_stream->GetBuffer();
+      m_buflen = 0;
+      if (!m_buf)
+        return Fail("no stream buffer");
+      }
+    size_t n = (OTA_STREAM_BUFSIZE-m_buflen < len) ? OTA_STREAM_BUFSIZE-m_buflen : len;
+    if (data)
+      {
+      memcpy(m_buf+m_buflen, data, n);
+      data += n;
+      }
+    else
+      {
+      if (esp_partition_read(m_source, offset, m_buf+m_buflen, n) != ESP_OK)
+        return Fail("cannot read running partition");
+      offset += n;
+      }
+    m_buflen += n;
+    m_outsize += n;
+    len -= n;
+    if (m_buflen == OTA_STREAM_BUFSIZE)
+      {
+      bool ok = m_stream->Submit(m_buf, m_buflen);
+      m_buf = NULL;
+      if (!ok)
+        return Fail("flash write failed");
+      }
+    }
+  return true;
+  }
+
+/**
+ * Feed: process the next part of the patch
+ *  Returns false on error, see GetError().
+ */
+bool OvmsOTAPatch::Feed(const uint8_t* data, size_t len)
+  {
+  const uint8_t* end = data + len;
+  while (data < end)
+    {
+    switch (m_state)
+      {
+      case PatchHeader:
+        {
+        size_t n = (OTA_DELTA_HEADERSIZE-m_hdrlen < (size_t)(end-data)) ? OTA_DELTA_HEADERSIZE-m_hdrlen : end-data;
+        memcpy(m_hdr+m_hdrlen, data, n);
+        m_hdrlen += n;
+        data += n;
+        if (m_hdrlen == OTA_DELTA_HEADERSIZE)
+          {
+          if (!Header())
+            return false;
+          m_state = PatchOp;
+          }
+        break;
+        }
+      case PatchOp:
+        m_op = *data++;
+        if (m_op == 0x00)
+          m_state = PatchEnd;
+        else if (m_op == 0x01 || m_op == 0x02)
+          {
+          m_arg[0] = m_arg[1] = 0;
+          m_argnum = 0;
+          m_shift = 0;
+          m_state = PatchVarint;
+          }
+        else
+          return Fail("invalid patch operation");
+        break;
+      case PatchVarint:
+        {
+        uint8_t b = *data++;
+        // 32 bit max: the fifth byte holds the top 4 bits, no continuation
+        if (m_shift == 28 && (b & 0xf0))
+          return Fail("invalid patch varint");
+        m_arg[m_argnum] |= (uint32_t)(b & 0x7f) << m_shift;
+        m_shift += 7;
+        if (b & 0x80)
+          break;
+        m_shift = 0;
+        if (m_op == 0x01 && m_argnum == 0)
+          {
+          m_argnum = 1; // COPY: length follows
+          }
+        else if (m_op == 0x01)
+          {
+          if (m_arg[0] > m_src_size || m_arg[1] > m_src_size-m_arg[0])
+            return Fail("invalid patch copy range");
+          if (!Output(NULL, m_arg[1], m_arg[0]))
+            return false;
+          m_state = PatchOp;
+          }
+        else
+          {
+          m_remain = m_arg[0];
+          m_state = (m_remain > 0) ? PatchData : PatchOp;
+          }
+        break;
+        }
+      case PatchData:
+        {
+        size_t n = (m_remain < (size_t)(end-data)) ? m_remain : end-data;
+        if (!Output(data, n))
+          return false;
+        data += n;
+        m_remain -= n;
+        if (m_remain == 0)
+          m_state = PatchOp;
+        break;
+        }
+      case PatchEnd:
+        return Fail("data after end of patch");
+      case PatchError:
+        return false;
+      }
+    }
+  return true;
+  }
+
+/**
+ * Finish: flush & finalize the target partition, verify the result MD5
+ */
+bool OvmsOTAPatch::Finish()
+  {
+  if (m_state == PatchError)
+    return false;
+  if (m_state != PatchEnd)
+    return Fail("patch incomplete");
+  if (m_outsize != m_dst_size)
+    return Fail("patch output size mismatch");
+  if (m_buf)
+    {
+    bool ok = m_stream->Submit(m_buf, m_buflen);
+    m_buf = NULL;
+    if (!ok)
+      return Fail("flash write failed");
+    }
+  if (m_stream->End() != ESP_OK)
+    return Fail("finalising OTA operation failed");
+  if (memcmp(m_stream->GetMD5(), m_hdr+28, OVMS_MD5_SIZE) != 0)
+    return Fail("target MD5 mismatch");
+  return true;
+  }
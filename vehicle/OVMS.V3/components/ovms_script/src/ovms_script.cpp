@@ -654,6 +654,37 @@ int OvmsScripts::DuktapeEvalIntResult(const char* text, OvmsWriter* writer)
   return result;
   }
 
+bool OvmsScripts::DuktapeCallFloatResultAsync(const void* key, const char* text, float* result, volatile bool* pending)
+  {
+  // Queue a call of the compiled function for <key>, compiling <text> on first use.
+  // Does not block: returns false if the queue is full. <pending> is set until the
+  // result has been stored, call DuktapeDiscardFunction() before freeing <result>.
+  duktape_queue_t dmsg;
+  memset(&dmsg, 0, sizeof(dmsg));
+  dmsg.type = DUKTAPE_callfloatresult;
+  dmsg.body.dt_callfloatresult.key = key;
+  dmsg.body.dt_callfloatresult.text = text;
+  dmsg.body.dt_callfloatresult.result = result;
+  dmsg.body.dt_callfloatresult.pending = pending;
+  *pending = true;
+  if (xQueueSend(m_duktaskqueue, &dmsg, 0) != pdTRUE)
+    {
+    *pending = false;
+    return false;
+    }
+  return true;
+  }
+
+void OvmsScripts::DuktapeDiscardFunction(const void* key)
+  {
+  // Waits for completion, so all calls queued before for <key> are done on return
+  duktape_queue_t dmsg;
+  memset(&dmsg, 0, sizeof(dmsg));
+  dmsg.type = DUKTAPE_discardfunction;
+  dmsg.body.dt_discardfunction.key = key;
+  DuktapeDispatchWait(&dmsg);
+  }
+
 void OvmsScripts::DuktapeReload()
   {
   duktape_queue_t dmsg;
@@ -872,6 +903,60 @@ void OvmsScripts::DukTapeTask()
             duk_pop(m_dukctx);
             }
           break;
+        case DUKTAPE_callfloatresult:
+          if (m_dukctx != NULL)
+            {
+            // Execute compiled script function (float result)
+            // The function is compiled on first use and kept in the heap stash,
+            // a heap reload discards all functions. A failed compilation is
+            // remembered as null to not repeat it on every call.
+            char key[24];
+            snprintf(key, sizeof(key), "fn%p", msg.body.dt_callfloatresult.key);
+            duk_push_heap_stash(m_dukctx);
+            bool ok = true;
+            if (!duk_get_prop_string(m_dukctx, -1, key))
+              {
+              duk_pop(m_dukctx);
+              duk_push_string(m_dukctx, msg.body.dt_callfloatresult.text);
+              duk_push_string(m_dukctx, key);
+              if (duk_pcompile(m_dukctx, DUK_COMPILE_EVAL) != 0)
+                {
+                ESP_LOGE(TAG,"Duktape: %s",duk_safe_to_string(m_dukctx, -1));
+                duk_push_null(m_dukctx);
+                duk_put_prop_string(m_dukctx, -3, key);
+                ok = false;
+                }
+              else
+                {
+                duk_dup(m_dukctx, -1);
+                duk_put_prop_string(m_dukctx, -3, key);
+                }
+              }
+            else if (duk_is_null(m_dukctx, -1))
+              {
+              ok = false;
+              }
+            if (ok && duk_pcall(m_dukctx, 0) != 0)
+              {
+              ESP_LOGE(TAG,"Duktape: %s",duk_safe_to_string(m_dukctx, -1));
+              ok = false;
+              }
+            *msg.body.dt_callfloatresult.result = ok ? (float)duk_get_number(m_dukctx,-1) : 0;
+            duk_pop_2(m_dukctx);
+            }
+          *msg.body.dt_callfloatresult.pending = false;
+          break;
+        case DUKTAPE_discardfunction:
+          if (m_dukctx != NULL)
+            {
+            // Discard compiled script function
+            char key[24];
+            snprintf(key, sizeof(key), "fn%p", msg.body.dt_discardfunction.key);
+            duk_push_heap_stash(m_dukctx);
+            duk_del_prop_string(m_dukctx, -1, key);
+            duk_pop(m_dukctx);
+            }
+          break;
         default:
           ESP_LOGE(TAG,"Duktape: Unrecognised msg type 0x%04x",msg.type);
           break;
@@ -50,7 +50,9 @@ typedef enum
   DUKTAPE_autoinit,             // Auto init
   DUKTAPE_evalnoresult,         // Execute script text (without result)
   DUKTAPE_evalfloatresult,      // Execute script text (float result)
-  DUKTAPE_evalintresult         // Execute script text (int result)
+  DUKTAPE_evalintresult,        // Execute script text (int result)
+  DUKTAPE_callfloatresult,      // Execute compiled script function (float result)
+  DUKTAPE_discardfunction       // Discard compiled script function
   } duktape_msg_t;
 
 typedef struct
@@ -112,6 +114,17 @@ typedef struct
       const char* text;
       int* result;
       } dt_evalintresult;
+    struct
+      {
+      const void* key;
+      const char* text;
+      float* result;
+      volatile bool* pending;
+      } dt_callfloatresult;
+    struct
+      {
+      const void* key;
+      } dt_discardfunction;
     } body;
   duktape_msg_t type;
   QueueHandle_t waitcompletion;
@@ -146,6 +159,8 @@ class OvmsScripts
     void  DuktapeEvalNoResult(const char* text, OvmsWriter* writer=NULL);
     float DuktapeEvalFloatResult(const char* text, OvmsWriter* writer=NULL);
     int   DuktapeEvalIntResult(const char* text, OvmsWriter* writer=NULL);
+    bool  DuktapeCallFloatResultAsync(const void* key, const char* text, float* result, volatile bool* pending);
+    void  DuktapeDiscardFunction(const void* key);
     void  DuktapeReload();
     void  DuktapeCompact();
 
@@ -1726,12 +1726,13 @@ OvmsServerV2::OvmsServerV2(const char* name)
   #undef bind  // Kludgy, but works
   using std::placeholders::_1;
   using std::placeholders::_2;
-  MyMetrics.RegisterListener(TAG, "*", std::bind(&OvmsServerV2::MetricModified, this, _1));
+  // MetricModified() only flags transmissions done by Ticker1(), so it can be deferred:
+  MyMetrics.RegisterListener(TAG, "*", std::bind(&OvmsServerV2::MetricModified, this, _1), true);
 
   if (MyOvmsServerV2Reader == 0)
     {
     MyOvmsServerV2Reader = MyNotify.RegisterReader("ovmsv2", COMMAND_RESULT_NORMAL, std::bind(OvmsServerV2ReaderCallback, _1, _2),
-                                                   true, std::bind(OvmsServerV2ReaderFilterCallback, _1, _2));
+                                                   true, std::bind(OvmsServerV2ReaderFilterCallback, _1, _2), true);
     }
 
   // init event listener:
@@ -208,12 +208,14 @@ OvmsServerV3::OvmsServerV3(const char* name)
   #undef bind  // Kludgy, but works
   using std::placeholders::_1;
   using std::placeholders::_2;
-  MyMetrics.RegisterListener(TAG, "*", std::bind(&OvmsServerV3::MetricModified, this, _1));
+  // Streaming intervals are seconds, so MetricModified() can be deferred
+  //  (keeps the transmission out of the metric update path):
+  MyMetrics.RegisterListener(TAG, "*", std::bind(&OvmsServerV3::MetricModified, this, _1), true);
 
   if (MyOvmsServerV3Reader == 0)
     {
     MyOvmsServerV3Reader = MyNotify.RegisterReader("ovmsv3", COMMAND_RESULT_NORMAL, std::bind(OvmsServerV3ReaderCallback, _1, _2),
-                                                   true, std::bind(OvmsServerV3ReaderFilterCallback, _1, _2));
+                                                   true, std::bind(OvmsServerV3ReaderFilterCallback, _1, _2), true);
     }
 
   // init event listener:
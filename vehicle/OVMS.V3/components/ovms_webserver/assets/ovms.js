@@ -300,18 +300,30 @@ function loadcmd(command, target, filter, timeout) {
 var monitorTimer, last_monotonic = 0;
 var ws, ws_inhibit = 0;
 var metrics = {};
+var metrics_schema = { version: -1, metrics: [] };
 var shellhist = [""], shellhpos = 0;
 
 function initSocketConnection(){
   ws = new WebSocket('ws://' + location.host + '/msg');
+  ws.binaryType = "arraybuffer";
   ws.onopen = function(ev) {
     console.log("WebSocket OPENED", ev);
+    if (window.DataView && window.TextDecoder)
+      ws.send("protocol bin");
     $(".receiver").subscribe();
   };
   ws.onerror = function(ev) { console.log("WebSocket ERROR", ev); };
   ws.onclose = function(ev) { console.log("WebSocket CLOSED", ev); };
   ws.onmessage = function(ev) {
     var msg;
+    if (ev.data instanceof ArrayBuffer) {
+      msg = decodeMetrics(ev.data);
+      if (msg) {
+        $.extend(metrics, msg);
+        $(".receiver").trigger("msg:metrics", msg);
+      }
+      return;
+    }
     try {
       msg = JSON.parse(ev.data);
     } catch (e) {
@@ -334,6 +346,12 @@ function initSocketConnection(){
         $.extend(metrics, msg.metrics);
         $(".receiver").trigger("msg:metrics", msg.metrics);
       }
+      else if (msgtype == "schema") {
+        if (msg.schema.start == 0)
+          metrics_schema = { version: msg.schema.version, metrics: [] };
+        for (var i = 0; i < msg.schema.metrics.length; i++)
+          metrics_schema.metrics[msg.schema.start + i] = msg.schema.metrics[i];
+      }
       else if (msgtype == "notify") {
         processNotification(msg.notify);
         $(".receiver").trigger("msg:notify", msg.notify);
@@ -342,6 +360,74 @@ function initSocketConnection(){
   };
 }
 
+/**
+ * Binary metrics frame decoder, see WebSocketHandler (ovms_webserver.h)
+ *  Schema entries: [ name, type, unit, decimals ]
+ *  Types: 0=string 1=bool 2=int 3=float 4=int vector 5=float vector
+ */
+function decodeMetrics(buf){
+  var dv = new DataView(buf), pos = 0, upd = {};
+  var varint = function() {
+    var val = 0, mul = 1, b;
+    do {
+      b = dv.getUint8(pos++);
+      val += (b & 0x7f) * mul;
+      mul *= 128;
+    } while (b & 0x80);
+    return val;
+  };
+  var zigzag = function() {
+    var val = varint();
+    return (val % 2) ? -(val + 1) / 2 : val / 2;
+  };
+  var float = function() {
+    var val = dv.getFloat32(pos, true);
+    pos += 4;
+    return Number(val.toPrecision(6));
+  };
+  if (dv.byteLength < 3 || dv.getUint8(0) != 0x01)
+    return null;
+  if (dv.getUint16(1, true) != metrics_schema.version)
+    return null; // outdated, new schema is on the way
+  pos = 3;
+  while (pos < dv.byteLength) {
+    var key = varint(), def = metrics_schema.metrics[Math.floor(key / 2)];
+    if (!def) return null;
+    var type = def[1], val, i, n, last;
+    if (key % 2) {
+      val = [ "", false, 0, 0, [], [] ][type];
+    }
+    else if (type == 1) {
+      val = (dv.getUint8(pos++) != 0);
+    }
+    else if (type == 2) {
+      val = zigzag();
+    }
+    else if (type == 3) {
+      val = float();
+    }
+    else if (type == 4) {
+      val = [];
+      for (n = varint(), i = 0, last = 0; i < n; i++) {
+        last += zigzag();
+        val.push(def[3] ? Number((last / Math.pow(10, def[3])).toFixed(def[3])) : last);
+      }
+    }
+    else if (type == 5) {
+      val = [];
+      for (n = varint(), i = 0; i < n; i++)
+        val.push(float());
+    }
+    else {
+      n = varint();
+      val = new TextDecoder().decode(new Uint8Array(buf, pos, n));
+      pos += n;
+    }
+    upd[def[0]] = val;
+  }
+  return upd;
+}
+
 function monitorInit(force){
   $(".monitor").each(function(){
     var cmd = $(this).data("updcmd");
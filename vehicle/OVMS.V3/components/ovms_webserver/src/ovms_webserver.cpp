@@ -45,6 +45,12 @@ static const char *TAG = "webserver";
 
 OvmsWebServer MyWebServer __attribute__ ((init_priority (8200)));
 
+void webserver_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+{
+  writer->printf("Webserver: %s\n", MyWebServer.m_running ? "running" : "stopped");
+  MyWebServer.ShowAssetStatus(writer);
+}
+
 OvmsWebServer::OvmsWebServer()
 {
   ESP_LOGI(TAG, "Initialising WEBSERVER (8200)");
@@ -53,6 +59,10 @@ OvmsWebServer::OvmsWebServer()
   m_configured = false;
   m_restart_countdown = 0;
   memset(m_sessions, 0, sizeof(m_sessions));
+  m_asset_requests = 0;
+  m_asset_notmodified = 0;
+  m_asset_bytes_sent = 0;
+  m_asset_bytes_saved = 0;
 
 #if MG_ENABLE_FILESYSTEM
   m_file_enable = true;
@@ -67,6 +77,9 @@ OvmsWebServer::OvmsWebServer()
   MyConfig.RegisterParam("http.server", "Webserver configuration", true, true);
   MyConfig.RegisterParam("http.plugin", "Webserver plugins", true, true);
 
+  OvmsCommand* cmd_webserver = MyCommandApp.RegisterCommand("webserver", "WEBSERVER framework", NULL, "", 0, 0, true);
+  cmd_webserver->RegisterCommand("status", "Show web server status", webserver_status, "", 0, 0, true);
+
   #undef bind  // Kludgy, but works
   using std::placeholders::_1;
   using std::placeholders::_2;
@@ -60,6 +60,11 @@
 
 #define XFER_CHUNK_SIZE           1024
 
+#define ASSET_MAXAGE_VERSIONED    31536000  // 1 year, versioned asset URLs are immutable
+
+#define PAGE_OUTBUF_SIZE          2048  // PageContext output buffer size = max HTTP chunk size
+#define PAGE_OUTBUF_POOLSIZE      2     // number of output buffers kept for reuse
+
 #define WEBSRV_USE_MG_BROADCAST   0  // Note: mg_broadcast() not working reliably yet, do not enable for production!
 
 // Asset URLs with versioning:
@@ -133,6 +138,9 @@ struct PageContext : public ExternalRamAllocated
   std::string method;
   std::string uri;
 
+  PageContext();
+  ~PageContext();
+
   // utils:
   std::string getvar(const std::string& name, size_t maxlen=200);
   bool getvar(const std::string& name, extram::string& dst);
@@ -149,6 +157,8 @@ struct PageContext : public ExternalRamAllocated
   void print(const extram::string text);
   void print(const char* text);
   void printf(const char *fmt, ...);
+  void write(const char* data, size_t len);
+  void flush();
   void done();
   void panel_start(const char* type, const char* title);
   void panel_end(const char* footer="");
@@ -182,6 +192,10 @@ struct PageContext : public ExternalRamAllocated
   void alert(const char* type, const char* text);
 
   PageResult_t callback(PageEntry_t& p, const std::string& hook);
+
+  // output buffer (collects output into HTTP chunks of up to PAGE_OUTBUF_SIZE bytes):
+  char* outbuf;
+  size_t outlen;
 };
 
 
@@ -347,14 +361,27 @@ class HttpStringSender : public MgHandler
  *
  * On creation it will do a full update of all metrics.
  * Later on, it receives TX jobs through the queue.
+ *
+ * Binary metrics protocol (client sends "protocol bin"):
+ *  The server sends the metrics schema as JSON text frames:
+ *    {"schema":{"version":<v>,"start":<index>,"metrics":[["<name>",<type>,"<unit>",<decimals>],…]}}
+ *  …followed by binary frames for all metrics updates:
+ *    uint8_t   WSBIN_METRICS
+ *    uint16_t  schema version (low 16 bits, little endian)
+ *    entries:  varint (index << 1 | undefined), value (unless undefined)
+ *  The value encoding is defined by the metric_wire_t type, see ovms_metrics.h.
+ *  If the metrics list changes, the schema is sent again before the next update.
  */
 
+#define WSBIN_METRICS             0x01
+
 enum WebSocketTxJobType
 {
   WSTX_None = 0,
   WSTX_Event,                 // payload: event
   WSTX_MetricsAll,            // payload: -
   WSTX_MetricsUpdate,         // payload: -
+  WSTX_MetricsSchema,         // payload: - (binary protocol: metrics index, followed by MetricsAll)
   WSTX_Config,                // payload: config (todo)
   WSTX_Notify,                // payload: notification
 };
@@ -393,6 +420,8 @@ class WebSocketHandler : public MgHandler
     void InitTx();
     void ContinueTx();
     void ProcessTxJob();
+    void ProcessMetricsSchema();
+    void ProcessMetricsBinary();
     int HandleEvent(int ev, void* p);
     void HandleIncomingMsg(std::string msg);
 
@@ -412,6 +441,8 @@ class WebSocketHandler : public MgHandler
     int                       m_sent;
     int                       m_ack;
     std::set<std::string>     m_subscriptions;
+    bool                      m_binary;           // binary metrics protocol enabled
+    uint32_t                  m_schema_version;   // metrics list version of last schema sent
 };
 
 struct WebSocketSlot
@@ -455,6 +486,7 @@ class HttpCommandStream : public OvmsShell, public MgHandler
     int printf(const char* fmt, ...);
     ssize_t write(const void *buf, size_t nbyte);
     void Log(LogBuffers* message);
+    virtual bool WantsLog() { return true; }
 };
 
 
@@ -514,6 +546,7 @@ class OvmsWebServer : public ExternalRamAllocated
     static void OutputHome(PageEntry_t& p, PageContext_t& c);
     static void HandleRoot(PageEntry_t& p, PageContext_t& c);
     static void HandleAsset(PageEntry_t& p, PageContext_t& c);
+    void ShowAssetStatus(OvmsWriter* writer);
     static void HandleMenu(PageEntry_t& p, PageContext_t& c);
     static void HandleHome(PageEntry_t& p, PageContext_t& c);
     static void HandleLogin(PageEntry_t& p, PageContext_t& c);
@@ -581,6 +614,11 @@ class OvmsWebServer : public ExternalRamAllocated
 
     int                       m_init_timeout;
     int                       m_restart_countdown;
+
+    uint32_t                  m_asset_requests;             // asset delivery statistics
+    uint32_t                  m_asset_notmodified;
+    uint64_t                  m_asset_bytes_sent;
+    uint64_t                  m_asset_bytes_saved;
 };
 
 extern OvmsWebServer MyWebServer;
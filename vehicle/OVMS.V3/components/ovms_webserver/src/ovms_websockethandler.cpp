@@ -66,6 +66,8 @@ WebSocketHandler::WebSocketHandler(mg_connection* nc, size_t slot, size_t modifi
   m_mutex = xSemaphoreCreateMutex();
   m_job.type = WSTX_None;
   m_sent = m_ack = 0;
+  m_binary = false;
+  m_schema_version = 0;
 }
 
 WebSocketHandler::~WebSocketHandler()
@@ -117,9 +119,20 @@ void WebSocketHandler::ProcessTxJob()
       break;
     }
     
+    case WSTX_MetricsSchema:
+    {
+      ProcessMetricsSchema();
+      break;
+    }
+    
     case WSTX_MetricsAll:
     case WSTX_MetricsUpdate:
     {
+      if (m_binary) {
+        ProcessMetricsBinary();
+        break;
+      }
+      
       // Note: this loops over the metrics by index, keeping the checked count
       //  in m_sent. It will not detect new metrics added between polls if they are
       //  inserted before m_sent, so new metrics may not be sent until first changed.
@@ -134,13 +147,17 @@ void WebSocketHandler::ProcessTxJob()
       extram::string msg;
       msg.reserve(2*XFER_CHUNK_SIZE+128);
       msg = "{\"metrics\":{";
+      std::string val;
+      val.reserve(128);
       for (i=0; m && msg.size() < XFER_CHUNK_SIZE; m=m->m_next) {
         if (m->IsModifiedAndClear(m_modifier) || m_job.type == WSTX_MetricsAll) {
           if (i) msg += ',';
           msg += '\"';
           msg += m->m_name;
           msg += "\":";
-          msg += m->AsJSON().c_str();
+          val.clear();
+          m->AppendJSON(val);
+          msg.append(val.data(), val.size());
           i++;
         }
       }
@@ -218,6 +235,104 @@ void WebSocketHandler::ProcessTxJob()
 }
 
 
+/**
+ * ProcessMetricsSchema: send metrics index for the binary protocol,
+ *  continues with a full metrics update when done.
+ */
+void WebSocketHandler::ProcessMetricsSchema()
+{
+  // find start:
+  int i;
+  OvmsMetric* m;
+  for (i=0, m=MyMetrics.m_first; i < m_sent && m != NULL; m=m->m_next, i++);
+  
+  if (m_sent == 0)
+    m_schema_version = MyMetrics.m_listversion;
+  
+  // build msg:
+  if (m) {
+    extram::string msg;
+    msg.reserve(2*XFER_CHUNK_SIZE+128);
+    char buf[100];
+    snprintf(buf, sizeof(buf), "{\"schema\":{\"version\":%u,\"start\":%d,\"metrics\":[",
+      (unsigned) (m_schema_version & 0xffff), m_sent);
+    msg = buf;
+    for (i=0; m && msg.size() < XFER_CHUNK_SIZE; m=m->m_next, i++) {
+      if (i) msg += ',';
+      msg += "[\"";
+      msg += m->m_name;
+      snprintf(buf, sizeof(buf), "\",%d,\"%s\",%d]",
+        (int) m->GetWireType(), OvmsMetricUnitLabel(m->GetUnits()), m->GetWireDecimals());
+      msg += buf;
+    }
+    msg += "]}}";
+    mg_send_websocket_frame(m_nc, WEBSOCKET_OP_TEXT, msg.data(), msg.size());
+    m_sent += i;
+  }
+  
+  // done? → continue with full update:
+  else if (m_ack == m_sent) {
+    ESP_LOGV(TAG, "WebSocketHandler[%p]: schema version %u sent, %d metrics", m_nc, m_schema_version, m_sent);
+    m_job.type = WSTX_MetricsAll;
+    m_sent = m_ack = 0;
+    ProcessMetricsBinary();
+  }
+}
+
+
+/**
+ * ProcessMetricsBinary: send metrics update in binary format
+ *  m_sent is the metrics list position reached.
+ */
+void WebSocketHandler::ProcessMetricsBinary()
+{
+  if (m_schema_version != MyMetrics.m_listversion) {
+    // metrics list changed, indexes are invalid: send new schema & full update
+    m_job.type = WSTX_MetricsSchema;
+    m_sent = m_ack = 0;
+    ProcessMetricsSchema();
+    return;
+  }
+  
+  // find start:
+  int i;
+  OvmsMetric* m;
+  for (i=0, m=MyMetrics.m_first; i < m_sent && m != NULL; m=m->m_next, i++);
+  
+  // build msg:
+  std::string msg;
+  msg.reserve(2*XFER_CHUNK_SIZE+128);
+  msg.append(1, (char) WSBIN_METRICS);
+  msg.append(1, (char) (m_schema_version & 0xff));
+  msg.append(1, (char) ((m_schema_version >> 8) & 0xff));
+  int cnt = 0;
+  for (i=m_sent; m && msg.size() < XFER_CHUNK_SIZE; m=m->m_next, i++) {
+    if (m->IsModifiedAndClear(m_modifier) || m_job.type == WSTX_MetricsAll) {
+      if (m->IsDefined()) {
+        metric_append_varint(msg, i << 1);
+        m->AppendBinary(msg);
+      } else {
+        metric_append_varint(msg, (i << 1) | 1);
+      }
+      cnt++;
+    }
+  }
+  
+  // send msg:
+  if (cnt) {
+    mg_send_websocket_frame(m_nc, WEBSOCKET_OP_BINARY, msg.data(), msg.size());
+    m_sent = i;
+  }
+  
+  // done?
+  if (!m && m_ack == m_sent) {
+    if (m_sent)
+      ESP_LOGV(TAG, "WebSocketHandler[%p]: ProcessTxJob type=%d done, binary, pos=%d", m_nc, m_job.type, m_sent);
+    ClearTxJob(m_job);
+  }
+}
+
+
 void WebSocketTxJob::clear(size_t client)
 {
   auto& slot = MyWebServer.m_client_slots[client];
@@ -353,6 +468,20 @@ void WebSocketHandler::HandleIncomingMsg(std::string msg)
       if (!arg.empty()) Unsubscribe(arg);
     }
   }
+  else if (cmd == "protocol") {
+    input >> arg;
+    if (arg == "bin" || arg == "json") {
+      // switch metrics protocol & send full update:
+      m_binary = (arg == "bin");
+      m_schema_version = 0;
+      WebSocketTxJob job;
+      job.type = WSTX_MetricsAll;
+      AddTxJob(job);
+    }
+    else {
+      ESP_LOGW(TAG, "WebSocketHandler[%p]: unknown protocol '%s'", m_nc, arg.c_str());
+    }
+  }
   else {
     ESP_LOGW(TAG, "WebSocketHandler[%p]: unhandled message: '%s'", m_nc, msg.c_str());
   }
@@ -1828,6 +1828,8 @@ void OvmsWebServer::HandleCfgLogging(PageEntry_t& p, PageContext_t& c)
       pmap["file.maxsize"] = c.getvar("file_maxsize");
     if (c.getvar("file_keepdays") != "")
       pmap["file.keepdays"] = c.getvar("file_keepdays");
+    if (c.getvar("file_syncperiod") != "")
+      pmap["file.syncperiod"] = c.getvar("file_syncperiod");
 
     file_path = c.getvar("file_path");
     pmap["file.path"] = file_path;
@@ -1835,6 +1837,7 @@ void OvmsWebServer::HandleCfgLogging(PageEntry_t& p, PageContext_t& c)
       error += "<li data-input=\"file_path\">File must be on '/sd' or '/store'</li>";
 
     pmap["level"] = c.getvar("level");
+    pmap["structured"] = (c.getvar("structured") == "yes") ? "yes" : "no";
     max = atoi(c.getvar("levelmax").c_str());
     for (i = 1; i <= max; i++) {
       sprintf(buf, "tag_%d", i);
@@ -1904,6 +1907,10 @@ void OvmsWebServer::HandleCfgLogging(PageEntry_t& p, PageContext_t& c)
   c.input("number", "Expire time", "file_keepdays", pmap["file.keepdays"].c_str(), "Default: 30",
     "<p>Automatically delete archived log files. 0 = disable</p>",
     "min=\"0\" step=\"1\"", "days");
+  c.input("number", "Sync period", "file_syncperiod", pmap["file.syncperiod"].c_str(), "Default: 3",
+    "<p>Maximum time between flushes of the log file to the storage medium."
+    " 0 = after every write (slow), -1 = only on close & shutdown (risks losing log data on crash)</p>",
+    "min=\"-1\" step=\"1\"", "sec");
 
   auto gen_options = [&c](std::string level) {
     c.printf(
@@ -1925,6 +1932,10 @@ void OvmsWebServer::HandleCfgLogging(PageEntry_t& p, PageContext_t& c)
   gen_options(pmap["level"]);
   c.input_select_end();
 
+  c.input_checkbox("Structured logging", "structured", pmap["structured"] == "yes",
+    "<p>Record log calls in binary form and format them only when read (log file, monitoring"
+    " console, <code>log show</code>). Reduces the logging overhead if no console is monitoring.</p>");
+
   c.print(
     "<div class=\"form-group\">"
     "<label class=\"control-label col-sm-3\">Component levels:</label>"
@@ -504,6 +504,7 @@ void OvmsWebServer::HandleDashboard(PageEntry_t& p, PageContext_t& c)
     "};"
     "</script>"
     , cfg.gaugeset1.c_str());
+  c.flush();
   new HttpDataSender(c.nc, (const uint8_t*)content, strlen(content));
 }
 
@@ -148,11 +148,85 @@ bool PageContext::getvar(const std::string& name, extram::string& dst) {
 }
 
 
+/**
+ * PageContext output buffer
+ *
+ *  Page output is collected in a buffer and sent in HTTP chunks of up to
+ *  PAGE_OUTBUF_SIZE bytes, instead of one chunk per print() call. The buffers
+ *  are allocated in SPIRAM and kept in a small pool for reuse. PageContext is
+ *  only used within the mongoose task, so the pool needs no locking.
+ *  Remaining output is flushed by done() or when the context is destroyed.
+ */
+
+static char* outbuf_pool[PAGE_OUTBUF_POOLSIZE] = {};
+
+static char* outbuf_get() {
+  for (int i = 0; i < PAGE_OUTBUF_POOLSIZE; i++) {
+    if (outbuf_pool[i]) {
+      char* buf = outbuf_pool[i];
+      outbuf_pool[i] = NULL;
+      return buf;
+    }
+  }
+  return (char*) ExternalRamMalloc(PAGE_OUTBUF_SIZE);
+}
+
+static void outbuf_put(char* buf) {
+  for (int i = 0; i < PAGE_OUTBUF_POOLSIZE; i++) {
+    if (!outbuf_pool[i]) {
+      outbuf_pool[i] = buf;
+      return;
+    }
+  }
+  free(buf);
+}
+
+PageContext::PageContext() {
+  nc = NULL;
+  hm = NULL;
+  session = NULL;
+  outbuf = NULL;
+  outlen = 0;
+}
+
+PageContext::~PageContext() {
+  flush();
+  if (outbuf)
+    outbuf_put(outbuf);
+}
+
+void PageContext::write(const char* data, size_t len) {
+  if (!outbuf)
+    outbuf = outbuf_get();
+  if (outbuf && outlen + len <= PAGE_OUTBUF_SIZE) {
+    memcpy(outbuf + outlen, data, len);
+    outlen += len;
+    return;
+  }
+  flush();
+  if (outbuf && len <= PAGE_OUTBUF_SIZE) {
+    memcpy(outbuf, data, len);
+    outlen = len;
+  }
+  else if (len) {
+    mg_send_http_chunk(nc, data, len);
+  }
+}
+
+void PageContext::flush() {
+  if (outlen) {
+    mg_send_http_chunk(nc, outbuf, outlen);
+    outlen = 0;
+  }
+}
+
+
 /**
  * HTML generation utils (Bootstrap widgets)
  */
 
 void PageContext::error(int code, const char* text) {
+  flush();
   mg_http_send_error(nc, code, text);
 }
 
@@ -162,40 +236,69 @@ void PageContext::head(int code, const char* headers /*=NULL*/) {
       "Content-Type: text/html; charset=utf-8\r\n"
       "Cache-Control: no-cache";
   }
+  flush();
   mg_send_head(nc, code, -1, headers);
 }
 
 void PageContext::print(const std::string text) {
-  mg_send_http_chunk(nc, text.data(), text.size());
+  write(text.data(), text.size());
 }
 
 void PageContext::print(const extram::string text) {
-  mg_send_http_chunk(nc, text.data(), text.size());
+  write(text.data(), text.size());
 }
 
 void PageContext::print(const char* text) {
-  mg_send_http_chunk(nc, text, strlen(text));
+  write(text, strlen(text));
 }
 
 void PageContext::printf(const char *fmt, ...) {
-  char* buf = NULL;
-  int len;
   va_list ap;
+  int len;
+  if (!outbuf)
+    outbuf = outbuf_get();
+  if (outbuf) {
+    // format directly into the output buffer:
+    if (outlen == PAGE_OUTBUF_SIZE)
+      flush();
+    size_t avail = PAGE_OUTBUF_SIZE - outlen;
+    va_start(ap, fmt);
+    len = vsnprintf(outbuf + outlen, avail, fmt, ap);
+    va_end(ap);
+    if (len < 0)
+      return;
+    if ((size_t)len < avail) {
+      outlen += len;
+      return;
+    }
+    // doesn't fit, retry after flush:
+    flush();
+    if ((size_t)len < PAGE_OUTBUF_SIZE) {
+      va_start(ap, fmt);
+      vsnprintf(outbuf, PAGE_OUTBUF_SIZE, fmt, ap);
+      va_end(ap);
+      outlen = len;
+      return;
+    }
+  }
+  // too large for the buffer, send as a single chunk:
+  char* buf = NULL;
   va_start(ap, fmt);
   len = vasprintf(&buf, fmt, ap);
   va_end(ap);
   if (len >= 0)
-    mg_send_http_chunk(nc, buf, len);
+    write(buf, len);
   if (buf)
     free(buf);
 }
 
 void PageContext::done() {
+  flush();
   mg_send_http_chunk(nc, "", 0);
 }
 
 void PageContext::panel_start(const char* type, const char* title) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"panel panel-%s\" id=\"panel-%s\">"
       "<div class=\"panel-heading\">%s</div>"
       "<div class=\"panel-body\">"
@@ -203,27 +306,27 @@ void PageContext::panel_start(const char* type, const char* title) {
 }
 
 void PageContext::panel_end(const char* footer) {
-  mg_printf_http_chunk(nc, (footer && footer[0])
+  printf((footer && footer[0])
     ? "</div><div class=\"panel-footer\">%s</div></div>"
     : "</div></div>"
     , footer);
 }
 
 void PageContext::form_start(std::string action, const char* target /*=NULL*/) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<form class=\"form-horizontal\" method=\"post\" action=\"%s\" target=\"%s\">"
     , _attr(action)
     , target ? _attr(target) : "#main");
 }
 
 void PageContext::form_end() {
-  mg_printf_http_chunk(nc, "</form>");
+  printf("</form>");
 }
 
 void PageContext::input(const char* type, const char* label, const char* name, const char* value,
     const char* placeholder /*=NULL*/, const char* helptext /*=NULL*/, const char* moreattrs /*=NULL*/,
     const char* unit /*=NULL*/) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"form-group\">"
       "<label class=\"control-label col-sm-3\" for=\"input-%s\">%s:</label>"
       "<div class=\"col-sm-9\">"
@@ -260,7 +363,7 @@ void PageContext::input_password(const char* label, const char* name, const char
 }
 
 void PageContext::input_select_start(const char* label, const char* name) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"form-group\">"
       "<label class=\"control-label col-sm-3\" for=\"input-%s\">%s:</label>"
       "<div class=\"col-sm-9\">"
@@ -269,20 +372,20 @@ void PageContext::input_select_start(const char* label, const char* name) {
 }
 
 void PageContext::input_select_option(const char* label, const char* value, bool selected) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<option value=\"%s\"%s>%s</option>"
     , _attr(value), selected ? " selected" : "", label);
 }
 
 void PageContext::input_select_end(const char* helptext /*=NULL*/) {
-  mg_printf_http_chunk(nc, "</select>%s%s%s</div></div>"
+  printf("</select>%s%s%s</div></div>"
     , helptext ? "<span class=\"help-block\">" : ""
     , helptext ? helptext : ""
     , helptext ? "</span>" : "");
 }
 
 void PageContext::input_radiobtn_start(const char* label, const char* name) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"form-group\">"
       "<label class=\"control-label col-sm-3\" for=\"input-%s\">%s:</label>"
       "<div class=\"col-sm-9\">"
@@ -291,7 +394,7 @@ void PageContext::input_radiobtn_start(const char* label, const char* name) {
 }
 
 void PageContext::input_radiobtn_option(const char* name, const char* label, const char* value, bool selected) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<label class=\"btn btn-default %s\">"
       "<input type=\"radio\" name=\"%s\" value=\"%s\" %s autocomplete=\"off\"> %s"
     "</label>"
@@ -302,14 +405,14 @@ void PageContext::input_radiobtn_option(const char* name, const char* label, con
 }
 
 void PageContext::input_radiobtn_end(const char* helptext /*=NULL*/) {
-  mg_printf_http_chunk(nc, "</div>%s%s%s</div></div>"
+  printf("</div>%s%s%s</div></div>"
     , helptext ? "<span class=\"help-block\">" : ""
     , helptext ? helptext : ""
     , helptext ? "</span>" : "");
 }
 
 void PageContext::input_radio_start(const char* label, const char* name) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"form-group\">"
       "<label class=\"control-label col-sm-3\" for=\"input-%s\">%s:</label>"
       "<div class=\"col-sm-9\">"
@@ -317,7 +420,7 @@ void PageContext::input_radio_start(const char* label, const char* name) {
 }
 
 void PageContext::input_radio_option(const char* name, const char* label, const char* value, bool selected) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"radio\"><label><input type=\"radio\" name=\"%s\"" " value=\"%s\" %s>%s</label></div>"
     , _attr(name), _attr(value)
     , selected ? "checked" : ""
@@ -325,7 +428,7 @@ void PageContext::input_radio_option(const char* name, const char* label, const
 }
 
 void PageContext::input_radio_end(const char* helptext /*=NULL*/) {
-  mg_printf_http_chunk(nc, "%s%s%s</div></div>"
+  printf("%s%s%s</div></div>"
     , helptext ? "<span class=\"help-block\">" : ""
     , helptext ? helptext : ""
     , helptext ? "</span>" : "");
@@ -333,7 +436,7 @@ void PageContext::input_radio_end(const char* helptext /*=NULL*/) {
 
 void PageContext::input_checkbox(const char* label, const char* name, bool value,
     const char* helptext /*=NULL*/) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"form-group\">"
       "<div class=\"col-sm-9 col-sm-offset-3\">"
         "<div class=\"checkbox\">"
@@ -353,7 +456,7 @@ void PageContext::input_slider(const char* label, const char* name, int size, co
     int enabled, double value, double defval, double min, double max, double step /*=1*/,
     const char* helptext /*=NULL*/) {
   int width = 50 + size * 10;
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"form-group\">"
       "<label class=\"control-label col-sm-3\" for=\"input-%s\">%s:</label>"
       "<div class=\"col-sm-9\">"
@@ -400,7 +503,7 @@ void PageContext::input_slider(const char* label, const char* name, int size, co
 
 void PageContext::input_button(const char* btnclass, const char* label,
     const char* name /*=NULL*/, const char* value /*=NULL*/) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"form-group\">"
       "<div class=\"col-sm-offset-3 col-sm-9\">"
         "<button type=\"submit\" class=\"btn btn-%s\" %s%s%s %s%s%s>%s</button>"
@@ -413,7 +516,7 @@ void PageContext::input_button(const char* btnclass, const char* label,
 }
 
 void PageContext::input_info(const char* label, const char* text) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"form-group\">"
       "<label class=\"control-label col-sm-3\">%s:</label>"
       "<div class=\"col-sm-9\">"
@@ -424,13 +527,13 @@ void PageContext::input_info(const char* label, const char* text) {
 }
 
 void PageContext::alert(const char* type, const char* text) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<div class=\"alert alert-%s\">%s</div>"
     , _attr(type), text);
 }
 
 void PageContext::fieldset_start(const char* title, const char* css_class /*=NULL*/) {
-  mg_printf_http_chunk(nc,
+  printf(
     "<fieldset class=\"%s\" id=\"fieldset-%s\"><legend>%s</legend>"
     , css_class ? css_class : ""
     , make_id(title).c_str()
@@ -438,11 +541,11 @@ void PageContext::fieldset_start(const char* title, const char* css_class /*=NUL
 }
 
 void PageContext::fieldset_end() {
-  mg_printf_http_chunk(nc, "</fieldset>");
+  printf("</fieldset>");
 }
 
 void PageContext::hr() {
-  mg_printf_http_chunk(nc, "<hr>");
+  printf("<hr>");
 }
 
 
@@ -561,7 +664,7 @@ void OvmsWebServer::OutputHome(PageEntry_t& p, PageContext_t& c)
 
   if (vehicle != "") {
     const char* vehiclename = MyVehicleFactory.ActiveVehicleName();
-    mg_printf_http_chunk(c.nc,
+    c.printf(
       "<fieldset class=\"menu\" id=\"fieldset-menu-vehicle\"><legend>%s</legend>"
       "<ul class=\"list-inline\">%s</ul>"
       "</fieldset>"
@@ -666,7 +769,7 @@ void OvmsWebServer::HandleMenu(PageEntry_t& p, PageContext_t& c)
 {
   std::string menu = CreateMenu(c);
   c.head(200);
-  mg_send_http_chunk(c.nc, menu.data(), menu.length());
+  c.print(menu);
   c.done();
 }
 
@@ -730,6 +833,11 @@ void OvmsWebServer::OutputReconnect(PageEntry_t& p, PageContext_t& c, const char
 /**
  * HandleAsset: output gzip assets
  * Note: no check for Accept-Encoding, we can't unzip & a modern browser is required anyway
+ *
+ * Conditional GET: the ETag is a content hash (computed on first delivery), requests
+ * with a matching If-None-Match (or If-Modified-Since if no ETag is given) get a 304.
+ * Versioned asset URLs ("?v=<mtime>", see URL_ASSETS_*) are immutable and may be cached
+ * for ASSET_MAXAGE_VERSIONED, unversioned URLs need revalidation.
  */
 
 extern const uint8_t script_js_gz_start[]     asm("_binary_script_js_gz_start");
@@ -743,56 +851,107 @@ extern const uint8_t favicon_png_end[]        asm("_binary_favicon_png_end");
 extern const uint8_t zones_json_gz_start[]    asm("_binary_zones_json_gz_start");
 extern const uint8_t zones_json_gz_end[]      asm("_binary_zones_json_gz_end");
 
-void OvmsWebServer::HandleAsset(PageEntry_t& p, PageContext_t& c)
+struct asset_info
 {
-  const uint8_t* data = NULL;
-  size_t size;
-  time_t mtime;
-  const char* type;
-  bool gzip_encoded = true;
-
-  if (c.uri == "/assets/style.css") {
-    data = style_css_gz_start;
-    size = style_css_gz_end - style_css_gz_start;
-    mtime = MTIME_ASSETS_STYLE_CSS;
-    type = "text/css";
-  }
-  else if (c.uri == "/assets/script.js") {
-    data = script_js_gz_start;
-    size = script_js_gz_end - script_js_gz_start;
-    mtime = MTIME_ASSETS_SCRIPT_JS;
-    type = "application/javascript";
-  }
-  else if (c.uri == "/assets/charts.js") {
-    data = charts_js_gz_start;
-    size = charts_js_gz_end - charts_js_gz_start;
-    mtime = MTIME_ASSETS_CHARTS_JS;
-    type = "application/javascript";
-  }
-  else if (c.uri == "/assets/zones.json") {
-    data = zones_json_gz_start;
-    size = zones_json_gz_end - zones_json_gz_start;
-    mtime = MTIME_ASSETS_ZONES_JSON;
-    type = "application/json";
-  }
-  else if (c.uri == "/favicon.ico" || c.uri == "/apple-touch-icon.png") {
-    data = favicon_png_start;
-    size = favicon_png_end - favicon_png_start;
-    mtime = MTIME_ASSETS_FAVICON_PNG;
-    type = "image/png";
-    gzip_encoded = false;
+  const uint8_t*  start;
+  const uint8_t*  end;
+  time_t          mtime;
+  const char*     type;
+  bool            gzip_encoded;
+  uint32_t        hash;                 // content hash, 0 = not yet computed
+};
+
+static asset_info assets[] = {
+  { style_css_gz_start,   style_css_gz_end,   MTIME_ASSETS_STYLE_CSS,   "text/css",               true,   0 },
+  { script_js_gz_start,   script_js_gz_end,   MTIME_ASSETS_SCRIPT_JS,   "application/javascript", true,   0 },
+  { charts_js_gz_start,   charts_js_gz_end,   MTIME_ASSETS_CHARTS_JS,   "application/javascript", true,   0 },
+  { zones_json_gz_start,  zones_json_gz_end,  MTIME_ASSETS_ZONES_JSON,  "application/json",       true,   0 },
+  { favicon_png_start,    favicon_png_end,    MTIME_ASSETS_FAVICON_PNG, "image/png",              false,  0 },
+};
+
+// mg_str_contains: check if header value contains text
+static bool mg_str_contains(const struct mg_str* hdr, const char* text)
+{
+  size_t len = strlen(text);
+  for (size_t i = 0; i + len <= hdr->len; i++) {
+    if (memcmp(hdr->p + i, text, len) == 0)
+      return true;
   }
+  return false;
+}
+
+void OvmsWebServer::HandleAsset(PageEntry_t& p, PageContext_t& c)
+{
+  asset_info* asset;
+
+  if (c.uri == "/assets/style.css")
+    asset = &assets[0];
+  else if (c.uri == "/assets/script.js")
+    asset = &assets[1];
+  else if (c.uri == "/assets/charts.js")
+    asset = &assets[2];
+  else if (c.uri == "/assets/zones.json")
+    asset = &assets[3];
+  else if (c.uri == "/favicon.ico" || c.uri == "/apple-touch-icon.png")
+    asset = &assets[4];
   else {
     mg_http_send_error(c.nc, 404, "Not found");
     return;
   }
 
-  char etag[50], current_time[50], last_modified[50];
+  const uint8_t* data = asset->start;
+  size_t size = asset->end - asset->start;
+  time_t mtime = asset->mtime;
+
+  // content hash (FNV-1a), computed once:
+  if (asset->hash == 0) {
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < size; i++)
+      hash = (hash ^ data[i]) * 16777619U;
+    asset->hash = hash ? hash : 1;
+  }
+
+  char etag[30], current_time[50], last_modified[50], version[30], reqversion[30];
   time_t t = (time_t) mg_time();
-  snprintf(etag, sizeof(etag), "\"%lx.%" INT64_FMT "\"", (unsigned long) mtime, (int64_t) size);
+  snprintf(etag, sizeof(etag), "\"%08x-%x\"", (unsigned) asset->hash, (unsigned) size);
   strftime(current_time, sizeof(current_time), "%a, %d %b %Y %H:%M:%S GMT", gmtime(&t));
   strftime(last_modified, sizeof(last_modified), "%a, %d %b %Y %H:%M:%S GMT", gmtime(&mtime));
 
+  // versioned URL?
+  snprintf(version, sizeof(version), "%lu", (unsigned long) mtime);
+  char cache_control[60];
+  if (mg_get_http_var(&c.hm->query_string, "v", reqversion, sizeof(reqversion)) > 0
+      && strcmp(reqversion, version) == 0)
+    snprintf(cache_control, sizeof(cache_control), "public, max-age=%d, immutable", ASSET_MAXAGE_VERSIONED);
+  else
+    strcpy(cache_control, "no-cache");
+
+  // conditional request?
+  bool notmodified = false;
+  struct mg_str* hdr;
+  if ((hdr = mg_get_http_header(c.hm, "If-None-Match")) != NULL)
+    notmodified = (mg_str_contains(hdr, etag) || (hdr->len == 1 && hdr->p[0] == '*'));
+  else if ((hdr = mg_get_http_header(c.hm, "If-Modified-Since")) != NULL)
+    notmodified = (hdr->len == strlen(last_modified) && memcmp(hdr->p, last_modified, hdr->len) == 0);
+
+  MyWebServer.m_asset_requests++;
+  if (notmodified) {
+    MyWebServer.m_asset_notmodified++;
+    MyWebServer.m_asset_bytes_saved += size;
+    mg_send_response_line(c.nc, 304, NULL);
+    mg_printf(c.nc,
+      "Date: %s\r\n"
+      "Etag: %s\r\n"
+      "Cache-Control: %s\r\n"
+      "Content-Length: 0\r\n"
+      "\r\n"
+      , current_time
+      , etag
+      , cache_control);
+    return;
+  }
+  MyWebServer.m_asset_bytes_sent += size;
+
   mg_send_response_line(c.nc, 200, NULL);
   mg_printf(c.nc,
     "Date: %s\r\n"
@@ -801,13 +960,23 @@ void OvmsWebServer::HandleAsset(PageEntry_t& p, PageContext_t& c)
     "%s"
     "Transfer-Encoding: chunked\r\n"
     "Etag: %s\r\n"
+    "Cache-Control: %s\r\n"
     "\r\n"
     , current_time
     , last_modified
-    , type
-    , gzip_encoded ? "Content-Encoding: gzip\r\n" : ""
-    , etag);
+    , asset->type
+    , asset->gzip_encoded ? "Content-Encoding: gzip\r\n" : ""
+    , etag
+    , cache_control);
 
   // start chunked transfer:
   new HttpDataSender(c.nc, data, size);
 }
+
+void OvmsWebServer::ShowAssetStatus(OvmsWriter* writer)
+{
+  writer->printf("Asset requests: %u, not modified: %u\n",
+    (unsigned) m_asset_requests, (unsigned) m_asset_notmodified);
+  writer->printf("Asset bytes sent: %llu, saved: %llu\n",
+    (unsigned long long) m_asset_bytes_sent, (unsigned long long) m_asset_bytes_saved);
+}
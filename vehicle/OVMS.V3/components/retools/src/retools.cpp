@@ -207,7 +207,8 @@ void re::MongooseHandler(struct mg_connection *nc, int ev, void *p)
           switch (m_servemode)
             {
             case Simulate:
-              MyCan.IncomingFrame(&frame);
+              frame.timestamp = CAN_Timestamp();
+              MyCan.InjectFrame(&frame, pdMS_TO_TICKS(10));
               break;
             case Transmit:
               frame.origin->Write(&frame);
@@ -339,7 +340,7 @@ void re::DoServe(CAN_frame_t* frame)
     OvmsMutexLock lock(&m_smapmutex);
 
     struct timeval t;
-    gettimeofday(&t,NULL);
+    CAN_TimestampToTimeval(frame->timestamp, &t);
     std::string encoded = m_serveformat_in->get(&t, frame);
     const char* s = encoded.c_str();
     size_t len = encoded.length();
@@ -127,23 +127,24 @@ GsmMuxChannel::GsmMuxChannel(GsmMux* mux, int channel, size_t buffersize)
   m_state = ChanClosed;
   m_mux = mux;
   m_channel = channel;
+  m_overflows = 0;
   }
 
 GsmMuxChannel::~GsmMuxChannel()
   {
   }
 
-void GsmMuxChannel::ProcessFrame(uint8_t* frame, size_t length, size_t iframepos)
+void GsmMuxChannel::ProcessFrame(uint8_t addr, uint8_t ctrl, uint8_t* data, size_t length)
   {
-  // Note the <length> provided excludes the start byte, stop byte, and checksum
-  // The <frame> pointer itself points to the byte after the start byte
-  ESP_LOGV(TAG, "ChanProcessFrame(CHAN=%d, ADDR=%02x, CTRL=%02x, LEN=%d, IFP=%d)", m_channel, frame[0], frame[1], length, iframepos);
+  // Note the <data> and <length> provided are the frame payload (information field)
+  // <data> may point directly into the modem receive buffer, so must be consumed here
+  ESP_LOGV(TAG, "ChanProcessFrame(CHAN=%d, ADDR=%02x, CTRL=%02x, LEN=%zu)", m_channel, addr, ctrl, length);
   switch (m_state)
     {
     case ChanClosed:
       break;
     case ChanOpening:
-      if (frame[1] == (GSM_UA + GSM_PF))
+      if (ctrl == (GSM_UA + GSM_PF))
         {
         ESP_LOGI(TAG, "Channel #%d is open",m_channel);
         m_state = ChanOpen; // SABM established
@@ -152,10 +153,21 @@ void GsmMuxChannel::ProcessFrame(uint8_t* frame, size_t length, size_t iframepos
         if (m_channel<GSM_MUX_CHANNELS) m_mux->StartChannel(m_channel+1);
         }
     case ChanOpen:
-      if (frame[1] == (GSM_UIH + GSM_PF))
+      if (ctrl == (GSM_UIH + GSM_PF))
         {
-        for (size_t k=iframepos;k<length;k++)
-          m_buffer.Push(frame[k]);
+        if (m_mux->m_modem->IncomingMuxPayload(this, data, length))
+          break; // consumed directly
+        size_t n = m_buffer.FreeSpace();
+        if (length > n)
+          {
+          // Consumer stalled: keep what fits, the rest is lost
+          ESP_LOGW(TAG, "Channel #%d buffer overflow: %zu of %zu bytes dropped",
+            m_channel, length-n, length);
+          m_overflows += length-n;
+          m_mux->m_rxoverflows++;
+          length = n;
+          }
+        m_buffer.Push(data, length);
         m_mux->m_modem->IncomingMuxData(this);
         }
       break;
@@ -181,6 +193,7 @@ GsmMux::GsmMux(simcom* modem, size_t maxframesize)
   m_lastgoodrxframe = 0;
   m_rxframecount = 0;
   m_txframecount = 0;
+  m_rxoverflows = 0;
   }
 
 GsmMux::~GsmMux()
@@ -195,6 +208,7 @@ void GsmMux::Start()
   m_lastgoodrxframe = 0;
   m_rxframecount = 0;
   m_txframecount = 0;
+  m_rxoverflows = 0;
   m_channels.insert(m_channels.end(),new GsmMuxChannel(this,0,8));
   for (int k=1; k<=GSM_MUX_CHANNELS; k++)
     {
@@ -208,22 +222,20 @@ void GsmMux::Start()
 void GsmMux::Stop()
   {
   ESP_LOGI(TAG, "Stop MUX");
-  for (int k=0; k<m_channels.size(); k++)
+  for (size_t k=0; k<m_channels.size(); k++)
     {
     GsmMuxChannel* chan = m_channels[k];
     if (chan) delete chan;
     }
   m_channels.clear();
   m_state = DlciClosed;
-  m_framepos = 0;
-  m_frameipos = 0;
-  m_framelen = 0;
-  m_framemorelen = false;
+  ResetFrame();
   m_openchannels = 0;
   m_framingerrors = 0;
   m_lastgoodrxframe = 0;
   m_rxframecount = 0;
   m_txframecount = 0;
+  m_rxoverflows = 0;
   }
 
 void GsmMux::StartChannel(int channel)
@@ -260,91 +272,140 @@ bool GsmMux::IsMuxUp()
 
 void GsmMux::Process(OvmsBuffer* buf)
   {
-  while (buf->UsedSpace()>0)
+  // Scan the contiguous spans of the receive buffer in place. ProcessSpan()
+  // returns after each complete frame, so we peek again in case the frame
+  // handler changed the buffer.
+  uint8_t* data;
+  size_t len;
+  while ((len = buf->PeekSpan(&data)) > 0)
     {
-    if (m_framepos == m_framesize)
+    buf->Skip(ProcessSpan(data, len));
+    }
+  }
+
+size_t GsmMux::ProcessSpan(uint8_t* data, size_t length)
+  {
+  size_t pos = 0;
+  while (pos < length)
+    {
+    if (m_framepos == 0)
       {
-      // Overflow frame
-      ESP_LOGW(TAG, "Frame overflow (%d bytes)",m_framesize);
-      m_framepos = 0;
-      m_framelen = 0;
-      m_framemorelen = false;
-      m_framingerrors++;
-      continue;
+      // Skip to start of frame
+      uint8_t* sof = (uint8_t*)memchr(data+pos, GSM0_SOF, length-pos);
+      if (!sof)
+        {
+        m_framingerrors += length-pos;
+        return length;
+        }
+      m_framingerrors += (sof-data)-pos;
+      pos = sof-data;
+      m_frame[m_framepos++] = data[pos++];
       }
-    uint8_t b = buf->Pop();
-    if ((m_framepos == 0)&&(b != GSM0_SOF))
+    else if ((m_framepos < 4)||(m_framemorelen))
       {
-      m_framingerrors++;
-      continue; // Skip to start of frame
+      // Frame header
+      uint8_t b = data[pos++];
+      if ((m_framepos == 1)&&(b == GSM0_SOF)) continue; // We found end of previous frame, so just skip it
+      m_frame[m_framepos++] = b;
+      if (m_framepos == 4)
+        {
+        // First byte of length field
+        m_framemorelen = !(b & GSM_EA);
+        m_framelen = (b>>1);
+        if (!m_framemorelen)
+          {
+          m_framelen += (m_framepos+2);
+          m_frameipos = m_framepos;
+          }
+        else
+          {
+          m_framelen += (m_framepos+3);
+          m_frameipos = m_framepos+1;
+          }
+        }
+      else if (m_framepos == 5)
+        {
+        // Second byte of length field
+        m_framelen += (b<<7);
+        m_framemorelen = false;
+        }
+      if ((m_framepos >= 4)&&(!m_framemorelen)&&(m_framelen > m_framesize))
+        {
+        // Overflow frame
+        ESP_LOGW(TAG, "Frame overflow (%zu > %zu bytes)",m_framelen,m_framesize);
+        m_framingerrors++;
+        ResetFrame();
+        }
       }
-    if ((m_framepos == 1)&&(b == GSM0_SOF)) continue; // We found end of previous frame, so just skip it
-    // ESP_LOGI(TAG, "Got %02x at %d (length sofar = %d)",b,m_framepos,m_framelen);
-    m_frame[m_framepos++] = b;
-    if (m_framepos == 4)
+    else
       {
-      // First byte of length field
-      m_framemorelen = !(b & GSM_EA);
-      m_framelen = (b>>1);
-      if (!m_framemorelen)
+      // Frame body: process in place if the frame is complete in this span,
+      // else collect in m_frame
+      size_t need = m_framelen - m_framepos;
+      if (need > length-pos)
+        {
+        memcpy(m_frame+m_framepos, data+pos, length-pos);
+        m_framepos += length-pos;
+        return length;
+        }
+      if (data[pos+need-1] != GSM0_SOF)
         {
-        m_framelen += (m_framepos+2);
-        m_frameipos = m_framepos;
+        // Resync after the expected frame end (as if the frame had been collected)
+        ESP_LOGW(TAG, "Frame end mismatch (LEN=%zu)",m_framelen);
+        m_framingerrors++;
+        ResetFrame();
+        pos += need-1;
+        continue;
+        }
+      if (m_framepos == m_frameipos)
+        {
+        ProcessFrame(data+pos, data[pos+need-2]);
         }
       else
         {
-        m_framelen += (m_framepos+3);
-        m_frameipos = m_framepos+1;
+        memcpy(m_frame+m_framepos, data+pos, need);
+        ProcessFrame(m_frame+m_frameipos, m_frame[m_framelen-2]);
         }
-      // ESP_LOGI(TAG, "Frame length (first byte) = %d",m_framelen);
-      }
-    if ((m_framepos == 5)&&(m_framemorelen))
-      {
-      // Second byte of length field
-      m_framelen += (b<<7);
-      m_framemorelen = false;
-      // ESP_LOGI(TAG, "Frame length (second byte) = %d",m_framelen);
-      }
-    if ((m_framepos == m_framelen)&&(b == GSM0_SOF))
-      {
-      // We have a complete frame...
-      ProcessFrame();
+      return pos+need;
       }
     }
+  return length;
   }
 
-void GsmMux::ProcessFrame()
+void GsmMux::ProcessFrame(uint8_t* data, uint8_t fcs)
   {
   int channel = m_frame[1] >>2;
 
-  ESP_LOGV(TAG, "ProcessFrame(CHAN=%d, ADDR=%02x, CTRL=%02x, FCS=%02x, LEN=%d)",
-    channel, m_frame[1], m_frame[2], m_frame[m_framelen-2], m_framelen);
+  ESP_LOGV(TAG, "ProcessFrame(CHAN=%d, ADDR=%02x, CTRL=%02x, FCS=%02x, LEN=%zu)",
+    channel, m_frame[1], m_frame[2], fcs, m_framelen);
 
-  uint8_t fcs = 0xFF - gsm_fcs_add_block(FCS_INIT, m_frame+1, m_frameipos-1);
-  if (fcs != m_frame[m_framelen-2])
+  uint8_t cfcs = 0xFF - gsm_fcs_add_block(FCS_INIT, m_frame+1, m_frameipos-1);
+  if (cfcs != fcs)
     {
-    ESP_LOGW(TAG, "FCS mismatch (%02x != %02x)",fcs,m_frame[m_framelen-2]);
-    m_framepos = 0;
-    m_frameipos = 0;
-    m_framelen = 0;
+    ESP_LOGW(TAG, "FCS mismatch (%02x != %02x)",cfcs,fcs);
     m_framingerrors++;
-    m_framemorelen = false;
+    ResetFrame();
     return;
     }
 
-  GsmMuxChannel* chan = m_channels[channel];
+  GsmMuxChannel* chan = (channel < (int)m_channels.size()) ? m_channels[channel] : NULL;
   if (chan)
     {
     m_framingerrors = 0;
     m_lastgoodrxframe = monotonictime;
     m_rxframecount++;
-    chan->ProcessFrame(m_frame+1,m_framelen-3,m_frameipos-1);
+    chan->ProcessFrame(m_frame[1], m_frame[2], data, m_framelen-m_frameipos-2);
     }
   else
     {
     ESP_LOGW(TAG, "Incoming message for unrecognised channel #%d",channel);
     }
 
+  ResetFrame();
+  }
+
+void GsmMux::ResetFrame()
+  {
   m_framepos = 0;
   m_frameipos = 0;
   m_framelen = 0;
@@ -382,7 +443,7 @@ size_t GsmMux::tx(int channel, uint8_t* data, ssize_t size)
     buf[4] = (uint8_t)len; // Length: upper 7 bits
     ipos = 5;
     }
-  for (size_t k=0; k<size; k++)
+  for (ssize_t k=0; k<size; k++)
     {
     buf[ipos+k] = data[k];
     }
@@ -61,13 +61,14 @@ class GsmMuxChannel
       };
 
   public:
-    void ProcessFrame(uint8_t* frame, size_t length, size_t iframepos);
+    void ProcessFrame(uint8_t addr, uint8_t ctrl, uint8_t* data, size_t length);
 
   public:
     GsmMuxChannelState m_state;
     GsmMux* m_mux;
     int m_channel;
     OvmsBuffer m_buffer;
+    uint32_t m_overflows;               // payload bytes dropped (buffer full)
   };
 
 class GsmMux
@@ -82,7 +83,8 @@ class GsmMux
     void StartChannel(int channel);
     void StopChannel(int channel);
     void Process(OvmsBuffer* buf);
-    void ProcessFrame();
+    size_t ProcessSpan(uint8_t* data, size_t length);
+    void ProcessFrame(uint8_t* data, uint8_t fcs);
     size_t tx(int channel, uint8_t* data, ssize_t size);
     size_t tx(int channel, const char* data, ssize_t size = -1);
     bool IsChannelOpen(int channel);
@@ -90,6 +92,7 @@ class GsmMux
 
   protected:
     void txfcs(uint8_t* data, size_t size, size_t ipos = 4);
+    void ResetFrame();
 
   public:
     enum GsmMuxState
@@ -107,6 +110,7 @@ class GsmMux
     uint32_t m_lastgoodrxframe;
     uint32_t m_rxframecount;
     uint32_t m_txframecount;
+    uint32_t m_rxoverflows;             // frames truncated (channel buffer full)
 
   public:
     simcom* m_modem;
@@ -33,7 +33,7 @@
 static const char *TAG = "gsm-nmea";
 
 #include <string>
-#include <sstream>
+#include <string.h>
 
 #include "gsmnmea.h"
 #include "ovms_command.h"
@@ -48,19 +48,109 @@ static const char *TAG = "gsm-nmea";
 
 
 /**
- * gps2latlon: convert NMEA degree/minute form to degrees
+ * nmea_fixed: parse decimal number into fixed point integer
+ *  i.e. decimals=2: "0.9" → 90, "-12.345" → -1234
  */
-static float gps2latlon(const char *gpscoord)
-{
-  double f;
-  long d;
+static int32_t nmea_fixed(const char* p, size_t len, int decimals)
+  {
+  const char* end = p + len;
+  bool neg = (p < end && *p == '-');
+  if (neg) p++;
+  uint32_t val = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; p++)
+    val = val*10 + (*p-'0');
+  int dec = 0;
+  if (p < end && *p == '.')
+    {
+    for (p++; p < end && dec < decimals && *p >= '0' && *p <= '9'; p++, dec++)
+      val = val*10 + (*p-'0');
+    }
+  for (; dec < decimals; dec++)
+    val *= 10;
+  return neg ? -(int32_t)val : (int32_t)val;
+  }
 
-  f = atof(gpscoord);
-  d = (long) (f / 100); // extract degrees
-  f = d + (f - (d * 100)) / 60; // convert to decimal format
 
-  return (float) f;
-}
+/**
+ * nmea_coord: convert NMEA degree/minute form ("dddmm.mmmmmm") to degrees
+ *  Fixed point parsing (minutes in 1e-6), one division to get the degrees
+ */
+static float nmea_coord(const char* p, size_t len)
+  {
+  const char* dot = (const char*) memchr(p, '.', len);
+  size_t ilen = dot ? dot-p : len;
+  uint32_t ipart = nmea_fixed(p, ilen, 0);
+  uint32_t fpart = dot ? nmea_fixed(dot, len-ilen, 6) : 0;
+  uint32_t min6 = (ipart % 100) * 1000000 + fpart;
+  return (float) ((ipart / 100) + min6 / 60e6);
+  }
+
+
+static inline int nmea_hexval(char c)
+  {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+  }
+
+
+/**
+ * GsmNMEASentence::Parse: copy & tokenize sentence, verify checksum
+ *  Single pass over the line, no allocations.
+ *  Returns false for malformed sentences and checksum mismatches.
+ */
+bool GsmNMEASentence::Parse(const char* data, size_t len)
+  {
+  count = 0;
+  if (len < 9 || len >= NMEA_MAXLEN || data[0] != '$')
+    return false;
+
+  uint8_t cs = 0;
+  size_t i;
+  pos[0] = 0;
+  line[0] = '$';
+  for (i = 1; i < len; i++)
+    {
+    char c = data[i];
+    line[i] = c;
+    if (c == '*')
+      break;
+    cs ^= c;
+    if (c == ',')
+      {
+      if (count+2 >= NMEA_MAXFIELDS)
+        {
+        count = 0;
+        return false;
+        }
+      pos[++count] = i+1;
+      }
+    }
+  if (i+2 >= len)
+    {
+    count = 0;
+    return false; // no checksum
+    }
+  line[i] = 0;
+  pos[++count] = i+1;
+
+  int hi = nmea_hexval(data[i+1]), lo = nmea_hexval(data[i+2]);
+  if (hi < 0 || lo < 0 || ((hi << 4) | lo) != cs)
+    {
+    count = 0;
+    return false;
+    }
+  return true;
+  }
+
+
+bool GsmNMEASentence::FieldEquals(const GsmNMEASentence& other, int i) const
+  {
+  size_t len = FieldLen(i);
+  return (i < count && i < other.count && len == other.FieldLen(i) &&
+    memcmp(Field(i), other.Field(i), len) == 0);
+  }
 
 
 /**
@@ -99,149 +189,136 @@ static unsigned long utc_to_timestamp(const char* date, const char* time)
   }
 
 
-void GsmNMEA::IncomingLine(const std::string line)
+void GsmNMEA::IncomingLine(const char* line, size_t len)
   {
-  ESP_LOGV(TAG, "IncomingLine: %s", line.c_str());
+  ESP_LOGV(TAG, "IncomingLine: %.*s", (int)len, line);
 
-  std::istringstream sentence(line);
-  std::string token;
-
-  if (!std::getline(sentence, token, ','))
-    return;
-  if (token[0] != '$')
-    return;
-
-  if (token.substr(3) == "GNS")
+  GsmNMEASentence sentence;
+  if (!sentence.Parse(line, len))
     {
-    // NMEA sentence type "GNS": GNSS Position Fix Data (GPS/GLONASS/… combined position data)
-    //  $..GNS,<Time>,<Latitude>,<NS>,<Longitude>,<EW>,<Mode>,<SatCnt>,<HDOP>,<Altitude>,<GeoidalSep>,<DiffAge>,<Chksum>
-    // Example:
-    //  $GNGNS,085320.0,5118.138139,N,00723.398844,E,AA,12,0.9,321.3,47.0,,*6E
-    // Notes:
-    //  <Mode>: first char = GPS, second = GLONASS;
-    //    N = No fix
-    //    A = Autonomous mode (non differential)
-    //    D = Differential mode
-    //    E = Estimation mode
-
-    float lat=0, lon=0, alt=0, hdop=0;
-    char ns=0, ew=0;
-    char mode[3] = {0,0,0};
-    int satcnt=0;
-
-    // Parse sentence:
-
-    if (std::getline(sentence, token, ','))
-      {;} // Time ignored here, see RMC handler
-    if (std::getline(sentence, token, ','))
-      lat = gps2latlon(token.c_str());
-    if (std::getline(sentence, token, ','))
-      ns = token[0];
-    if (std::getline(sentence, token, ','))
-      lon = gps2latlon(token.c_str());
-    if (std::getline(sentence, token, ','))
-      ew = token[0];
-    if (std::getline(sentence, token, ','))
+    if (len > 0 && line[0] == '$')
       {
-      mode[0] = token[0];
-      mode[1] = token[1];
+      ESP_LOGD(TAG, "Invalid sentence: %.*s", (int)len, line);
+      m_badsentences++;
       }
-    if (std::getline(sentence, token, ','))
-      satcnt = atoi(token.c_str());
-    if (std::getline(sentence, token, ','))
-      hdop = atof(token.c_str());
-    if (std::getline(sentence, token, ','))
-      alt = atof(token.c_str());
+    return;
+    }
+  m_sentences++;
 
-    // Check:
+  // Address field "$<talker:2><type:3>":
+  if (sentence.FieldLen(0) != 6)
+    return;
+  const char* type = sentence.Field(0) + 3;
 
-    if (!ns || !ew || !mode[0])
-      return; // malformed/empty sentence
+  if (memcmp(type, "GNS", 3) == 0)
+    IncomingGNS(sentence);
+  else if (memcmp(type, "RMC", 3) == 0)
+    IncomingRMC(sentence);
+  }
 
-    // Data set complete, store:
 
-    if (ns == 'S')
-      lat = -lat;
-    if (ew == 'W')
-      lon = -lon;
+void GsmNMEA::IncomingGNS(const GsmNMEASentence& s)
+  {
+  // NMEA sentence type "GNS": GNSS Position Fix Data (GPS/GLONASS/… combined position data)
+  //  $..GNS,<Time>,<Latitude>,<NS>,<Longitude>,<EW>,<Mode>,<SatCnt>,<HDOP>,<Altitude>,<GeoidalSep>,<DiffAge>,<Chksum>
+  // Example:
+  //  $GNGNS,085320.0,5118.138139,N,00723.398844,E,AA,12,0.9,321.3,47.0,,*6E
+  // Notes:
+  //  <Mode>: first char = GPS, second = GLONASS;
+  //    N = No fix
+  //    A = Autonomous mode (non differential)
+  //    D = Differential mode
+  //    E = Estimation mode
+
+  // Check:
+
+  if (s.count < 10 || !s.FieldLen(3) || !s.FieldLen(5) || !s.FieldLen(6))
+    return; // malformed/empty sentence
+
+  // Convert changed fields (the time field changes every second, the
+  // position only while moving):
+
+  if (!s.FieldEquals(m_gns, 2) || !s.FieldEquals(m_gns, 3))
+    {
+    m_lat = nmea_coord(s.Field(2), s.FieldLen(2));
+    if (s.Field(3)[0] == 'S')
+      m_lat = -m_lat;
+    }
+  if (!s.FieldEquals(m_gns, 4) || !s.FieldEquals(m_gns, 5))
+    {
+    m_lon = nmea_coord(s.Field(4), s.FieldLen(4));
+    if (s.Field(5)[0] == 'W')
+      m_lon = -m_lon;
+    }
+  if (!s.FieldEquals(m_gns, 7))
+    m_satcnt = nmea_fixed(s.Field(7), s.FieldLen(7), 0);
+  if (!s.FieldEquals(m_gns, 8))
+    m_hdop = nmea_fixed(s.Field(8), s.FieldLen(8), 2) / 100.0f;
+  if (!s.FieldEquals(m_gns, 9))
+    m_alt = nmea_fixed(s.Field(9), s.FieldLen(9), 2) / 100.0f;
 
-    bool gpslock = (mode[0] != 'N' || mode[1] != 'N');
+  m_gns = s;
 
-    *StdMetrics.ms_v_pos_gpsmode = (std::string) mode;
-    *StdMetrics.ms_v_pos_satcount = (int) satcnt;
-    *StdMetrics.ms_v_pos_gpshdop = (float) hdop;
+  // Data set complete, store:
 
-    if (gpslock)
-      {
-      *StdMetrics.ms_v_pos_latitude = (float) lat;
-      *StdMetrics.ms_v_pos_longitude = (float) lon;
-      *StdMetrics.ms_v_pos_altitude = (float) alt;
-      }
+  char mode[3] = { s.Field(6)[0], (s.FieldLen(6) > 1) ? s.Field(6)[1] : (char)0, 0 };
+  bool gpslock = (mode[0] != 'N' || mode[1] != 'N');
 
-    // upodate gpslock last, so listeners will see updated lat/lon values:
-    if (gpslock != StdMetrics.ms_v_pos_gpslock->AsBool())
-      {
-      *StdMetrics.ms_v_pos_gpslock = (bool) gpslock;
-      if (gpslock)
-        MyEvents.SignalEvent("system.modem.gotgps", NULL);
-      else
-        MyEvents.SignalEvent("system.modem.lostgps", NULL);
-      }
+  *StdMetrics.ms_v_pos_gpsmode = (std::string) mode;
+  *StdMetrics.ms_v_pos_satcount = (int) m_satcnt;
+  *StdMetrics.ms_v_pos_gpshdop = (float) m_hdop;
 
-    // END "GNS" handler
+  if (gpslock)
+    {
+    *StdMetrics.ms_v_pos_latitude = (float) m_lat;
+    *StdMetrics.ms_v_pos_longitude = (float) m_lon;
+    *StdMetrics.ms_v_pos_altitude = (float) m_alt;
     }
 
-  else if (token.substr(3) == "RMC")
+  // upodate gpslock last, so listeners will see updated lat/lon values:
+  if (gpslock != StdMetrics.ms_v_pos_gpslock->AsBool())
     {
-    // NMEA sentence type "RMC": Recommended Minimum Specific GNSS Data
-    //  $..RMC,<Time>,<Status>,<Latitude>,<NS>,<Longitude>,<EW>,<SpeedKnots>,<Direction>,<Date>,<MagVar>,<MagVarEW>,<Mode>,<Chksum>
-    // Example:
-    //  $GPRMC,085320.0,A,5118.138139,N,00723.398844,E,0.0,265.5,101217,,,A*62
-
-    char date[6] = {0}, time[6] = {0};
-    float direction=0, speed=0;
-
-    // Parse sentence:
-
-    if (std::getline(sentence, token, ','))
-      strncpy(time, token.c_str(), 6);
-    if (std::getline(sentence, token, ','))
-      {;} // Status
-    if (std::getline(sentence, token, ','))
-      {;} // Latitude
-    if (std::getline(sentence, token, ','))
-      {;} // NS
-    if (std::getline(sentence, token, ','))
-      {;} // Longitude
-    if (std::getline(sentence, token, ','))
-      {;} // EW
-    if (std::getline(sentence, token, ','))
-      speed = atof(token.c_str()) * 1.852;
-    if (std::getline(sentence, token, ','))
-      direction = atof(token.c_str());
-    if (std::getline(sentence, token, ','))
-      strncpy(date, token.c_str(), 6);
-
-    // Check:
-
-    if (!date[0] || !time[0])
-      return; // malformed/empty sentence
-
-    // Data complete, store:
-
-    if (m_gpstime_enabled)
-      {
-      int tm = utc_to_timestamp(date, time);
-      *StdMetrics.ms_m_timeutc = (int) tm;
-      MyTime.Set(TAG, 2, true, tm);
-      }
+    *StdMetrics.ms_v_pos_gpslock = (bool) gpslock;
+    if (gpslock)
+      MyEvents.SignalEvent("system.modem.gotgps", NULL);
+    else
+      MyEvents.SignalEvent("system.modem.lostgps", NULL);
+    }
+  }
+
 
-    *StdMetrics.ms_v_pos_direction = (float) direction;
-    *StdMetrics.ms_v_pos_gpsspeed = (float) speed;
+void GsmNMEA::IncomingRMC(const GsmNMEASentence& s)
+  {
+  // NMEA sentence type "RMC": Recommended Minimum Specific GNSS Data
+  //  $..RMC,<Time>,<Status>,<Latitude>,<NS>,<Longitude>,<EW>,<SpeedKnots>,<Direction>,<Date>,<MagVar>,<MagVarEW>,<Mode>,<Chksum>
+  // Example:
+  //  $GPRMC,085320.0,A,5118.138139,N,00723.398844,E,0.0,265.5,101217,,,A*62
+
+  // Check:
+
+  if (s.count < 10 || s.FieldLen(1) < 6 || s.FieldLen(9) < 6)
+    return; // malformed/empty sentence
+
+  // Convert changed fields:
 
-    // END "RMC" handler
+  if (!s.FieldEquals(m_rmc, 7))
+    m_speed = nmea_fixed(s.Field(7), s.FieldLen(7), 3) * (1.852f / 1000);
+  if (!s.FieldEquals(m_rmc, 8))
+    m_direction = nmea_fixed(s.Field(8), s.FieldLen(8), 2) / 100.0f;
+
+  m_rmc = s;
+
+  // Data complete, store:
+
+  if (m_gpstime_enabled)
+    {
+    int tm = utc_to_timestamp(s.Field(9), s.Field(1));
+    *StdMetrics.ms_m_timeutc = (int) tm;
+    MyTime.Set(TAG, 2, true, tm);
     }
 
+  *StdMetrics.ms_v_pos_direction = (float) m_direction;
+  *StdMetrics.ms_v_pos_gpsspeed = (float) m_speed;
   }
 
 
@@ -289,6 +366,13 @@ GsmNMEA::GsmNMEA(GsmMux* mux, int channel)
   m_channel = channel;
   m_connected = false;
   m_gpstime_enabled = false;
+  m_sentences = 0;
+  m_badsentences = 0;
+  m_gns.count = 0;
+  m_rmc.count = 0;
+  m_lat = m_lon = m_alt = m_hdop = 0;
+  m_satcnt = 0;
+  m_speed = m_direction = 0;
   }
 
 GsmNMEA::~GsmNMEA()
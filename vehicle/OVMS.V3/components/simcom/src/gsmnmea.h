@@ -38,6 +38,26 @@
 #include "driver/uart.h"
 #include "gsmmux.h"
 
+#define NMEA_MAXLEN       96      // max sentence length incl. checksum (standard: 82)
+#define NMEA_MAXFIELDS    24
+
+/**
+ * GsmNMEASentence: tokenized sentence
+ *  Fields are spans into the line copy, field 0 is the address ("$GPRMC").
+ *  Field i starts at line+pos[i] and has length pos[i+1]-pos[i]-1.
+ */
+struct GsmNMEASentence
+  {
+  char          line[NMEA_MAXLEN];
+  uint8_t       count;                      // number of fields
+  uint8_t       pos[NMEA_MAXFIELDS+1];      // field start offsets
+
+  bool Parse(const char* data, size_t len);
+  const char* Field(int i) const { return line + pos[i]; }
+  size_t FieldLen(int i) const { return (i < count) ? pos[i+1]-pos[i]-1 : 0; }
+  bool FieldEquals(const GsmNMEASentence& other, int i) const;
+  };
+
 class GsmNMEA
   {
   public:
@@ -45,15 +65,29 @@ class GsmNMEA
     ~GsmNMEA();
 
   public:
-    void IncomingLine(const std::string line);
+    void IncomingLine(const char* line, size_t len);
     void Startup();
     void Shutdown(bool hard=false);
 
+  protected:
+    void IncomingGNS(const GsmNMEASentence& s);
+    void IncomingRMC(const GsmNMEASentence& s);
+
   public:
     GsmMux*       m_mux;
     int           m_channel;
     bool          m_connected;
     bool          m_gpstime_enabled;
+    uint32_t      m_sentences;
+    uint32_t      m_badsentences;
+
+  protected:
+    // Last sentences & converted values (unchanged fields are not converted again):
+    GsmNMEASentence m_gns;
+    GsmNMEASentence m_rmc;
+    float         m_lat, m_lon, m_alt, m_hdop;
+    int           m_satcnt;
+    float         m_speed, m_direction;
   };
 
 #endif //#ifndef __GSM_NMEA__
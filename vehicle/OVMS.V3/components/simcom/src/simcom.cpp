@@ -171,6 +171,7 @@ simcom::simcom(const char* name, uart_port_t uartnum, int baud, int rxpin, int t
 
 simcom::~simcom()
   {
+  MyEvents.DeregisterEvent(TAG);
   StopTask();
   }
 
@@ -211,9 +212,10 @@ void simcom::StopTask()
   {
   if (m_task)
     {
-    uart_driver_delete(m_uartnum);
+    // Delete the task first, it may be waiting on the UART event queue
     vTaskDelete(m_task);
     m_task = 0;
+    uart_driver_delete(m_uartnum);
     }
   }
 
@@ -290,6 +292,19 @@ void simcom::EventListener(std::string event, void* data)
     }
   }
 
+bool simcom::IncomingMuxPayload(GsmMuxChannel* channel, uint8_t* data, size_t len)
+  {
+  // The MUX offers frame payload before buffering it: PPP data is passed
+  // on directly (zero copy) unless older data is still queued in the channel
+  if ((channel->m_channel == GSM_MUX_CHAN_DATA)&&(m_state1 == NetMode)&&
+      (channel->m_buffer.UsedSpace() == 0))
+    {
+    m_ppp.IncomingData(data,len);
+    return true;
+    }
+  return false;
+  }
+
 void simcom::IncomingMuxData(GsmMuxChannel* channel)
   {
   // The MUX has indicated there is data on the specified channel
@@ -300,17 +315,34 @@ void simcom::IncomingMuxData(GsmMuxChannel* channel)
       channel->m_buffer.EmptyAll();
       break;
     case GSM_MUX_CHAN_NMEA:
-      while (channel->m_buffer.HasLine() >= 0)
-        m_nmea.IncomingLine(channel->m_buffer.ReadLine());
+      {
+      char line[NMEA_MAXLEN];
+      int len;
+      while ((len = channel->m_buffer.HasLine()) >= 0)
+        {
+        if ((size_t)len < sizeof(line))
+          {
+          channel->m_buffer.Pop(len, (uint8_t*)line);
+          m_nmea.IncomingLine(line, len);
+          }
+        else
+          channel->m_buffer.Skip(len); // too long for NMEA
+        if (channel->m_buffer.Peek() == '\r') channel->m_buffer.Pop();
+        if (channel->m_buffer.Peek() == '\n') channel->m_buffer.Pop();
+        }
+      if (channel->m_buffer.FreeSpace() == 0)
+        channel->m_buffer.EmptyAll(); // no line end in a full buffer, drop the line
+      }
       break;
     case GSM_MUX_CHAN_DATA:
       if (m_state1 == NetMode)
         {
-        uint8_t buf[32];
+        uint8_t* data;
         size_t n;
-        while ((n = channel->m_buffer.Pop(sizeof(buf),buf)) > 0)
+        while ((n = channel->m_buffer.PeekSpan(&data)) > 0)
           {
-          m_ppp.IncomingData(buf,n);
+          m_ppp.IncomingData(data,n);
+          channel->m_buffer.Skip(n);
           }
         }
       else
@@ -741,7 +773,7 @@ void simcom::StandardLineHandler(int channel, OvmsBuffer* buf, std::string line)
     line = m_line_buffer;
     }
 
-  ESP_LOGD(TAG, "rx line ch=%d len=%-4d: %s", channel, line.length(), line.c_str());
+  ESP_LOGD(TAG, "rx line ch=%d len=%-4d: %s", channel, (int)line.length(), line.c_str());
 
   if ((line.compare(0, 8, "CONNECT ") == 0)&&(m_state1 == NetStart)&&(m_state1_userdata == 1))
     {
@@ -826,8 +858,8 @@ void simcom::StandardLineHandler(int channel, OvmsBuffer* buf, std::string line)
     size_t qp = line.find_last_of(',');
     if (qp != string::npos)
       {
-      buf->m_userdata = (void*)atoi(line.substr(qp+1).c_str());
-      ESP_LOGI(TAG,"SMS length is %d",(int)buf->m_userdata);
+      buf->m_userdata = (void*)(intptr_t)atoi(line.substr(qp+1).c_str());
+      ESP_LOGI(TAG,"SMS length is %d",(int)(intptr_t)buf->m_userdata);
       }
     }
   // MMI/USSD response (URC):
@@ -894,7 +926,7 @@ void simcom::tx(const char* data, ssize_t size)
   if (size == -1) size = strlen(data);
   MyCommandApp.HexDump(TAG, "tx", data, size);
   if (size > 0)
-    ESP_LOGD(TAG, "tx scmd ch=0 len=%-4d: %s", size, data);
+    ESP_LOGD(TAG, "tx scmd ch=0 len=%-4d: %s", (int)size, data);
   uart_write_bytes(m_uartnum, data, size);
   }
 
@@ -911,7 +943,7 @@ void simcom::muxtx(int channel, const char* data, ssize_t size)
   if (size == -1) size = strlen(data);
   MyCommandApp.HexDump(TAG, "mux tx", data, size);
   if (size > 0 && (channel == GSM_MUX_CHAN_POLL || channel == GSM_MUX_CHAN_CMD))
-    ESP_LOGD(TAG, "tx mcmd ch=%d len=%-4d: %s", channel, size, data);
+    ESP_LOGD(TAG, "tx mcmd ch=%d len=%-4d: %s", channel, (int)size, data);
   m_mux.tx(channel, (uint8_t*)data, size);
   }
 
@@ -922,13 +954,13 @@ bool simcom::txcmd(const char* data, ssize_t size)
   if (size <= 0) return false;
   if (m_mux.m_state == GsmMux::DlciClosed)
     {
-    ESP_LOGD(TAG, "tx scmd ch=0 len=%-4d: %s", size, data);
+    ESP_LOGD(TAG, "tx scmd ch=0 len=%-4d: %s", (int)size, data);
     tx((uint8_t*)data, size);
     return true;
     }
   else if (m_mux.IsChannelOpen(GSM_MUX_CHAN_CMD))
     {
-    ESP_LOGD(TAG, "tx mcmd ch=%d len=%-4d: %s", GSM_MUX_CHAN_CMD, size, data);
+    ESP_LOGD(TAG, "tx mcmd ch=%d len=%-4d: %s", GSM_MUX_CHAN_CMD, (int)size, data);
     m_mux.tx(GSM_MUX_CHAN_CMD, (uint8_t*)data, size);
     return true;
     }
@@ -1030,6 +1062,9 @@ void simcom_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc
 
     writer->printf("    TX frames: %d\n",
       MyPeripherals->m_simcom->m_mux.m_txframecount);
+
+    writer->printf("    RX overflows: %d\n",
+      MyPeripherals->m_simcom->m_mux.m_rxoverflows);
     }
 
   if (MyPeripherals->m_simcom->m_ppp.m_connected)
@@ -1062,6 +1097,9 @@ void simcom_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc
       MyConfig.GetParamValueBool("modem", "enable.gps", false) ? "enabled" : "disabled");
     writer->printf("     Time: %s\n",
       MyConfig.GetParamValueBool("modem", "enable.gpstime", false) ? "enabled" : "disabled");
+    writer->printf("     Sentences: %u (%u invalid)\n",
+      MyPeripherals->m_simcom->m_nmea.m_sentences,
+      MyPeripherals->m_simcom->m_nmea.m_badsentences);
     }
 
   }
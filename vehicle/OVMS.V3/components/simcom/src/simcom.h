@@ -147,6 +147,7 @@ class simcom : public pcp, public InternalRamAllocated
     void Task();
     void Ticker(std::string event, void* data);
     void EventListener(std::string event, void* data);
+    bool IncomingMuxPayload(GsmMuxChannel* channel, uint8_t* data, size_t len);
     void IncomingMuxData(GsmMuxChannel* channel);
     void SendSetState1(SimcomState1 newstate);
     bool IsStarted();
@@ -959,6 +959,8 @@ OvmsVehicle::OvmsVehicle()
   m_poll_ml_remain = 0;
   m_poll_ml_offset = 0;
   m_poll_ml_frame = 0;
+  m_poll_txtime = 0;
+  m_poll_rxtime = 0;
 
   m_bms_voltages = NULL;
   m_bms_vmins = NULL;
@@ -976,8 +978,8 @@ OvmsVehicle::OvmsVehicle()
   m_bms_talerts_new = 0;
   m_bms_has_temperatures = false;
 
-  m_bms_bitset_v.clear();
-  m_bms_bitset_t.clear();
+  m_bms_bitset_v = NULL;
+  m_bms_bitset_t = NULL;
   m_bms_bitset_cv = 0;
   m_bms_bitset_ct = 0;
   m_bms_readings_v = 0;
@@ -995,7 +997,17 @@ OvmsVehicle::OvmsVehicle()
   m_bms_defthr_twarn  = BMS_DEFTHR_TWARN;
   m_bms_defthr_talert = BMS_DEFTHR_TALERT;
 
-  m_rxqueue = xQueueCreate(CONFIG_OVMS_VEHICLE_CAN_RX_QUEUE_SIZE,sizeof(CAN_frame_t));
+  m_bms_hist_size = BMS_HISTORY_SIZE;
+  m_bms_vhist = NULL;
+  m_bms_vhist_avg = NULL;
+  m_bms_vhist_count = 0;
+  m_bms_vhist_pos = 0;
+  m_bms_thist = NULL;
+  m_bms_thist_avg = NULL;
+  m_bms_thist_count = 0;
+  m_bms_thist_pos = 0;
+
+  m_rxring = new CanListenerRing();
   xTaskCreatePinnedToCore(OvmsVehicleRxTask, "OVMS Vehicle",
     CONFIG_OVMS_VEHICLE_RXTASK_STACK, (void*)this, 10, &m_rxtask, 1);
 
@@ -1005,7 +1017,28 @@ OvmsVehicle::OvmsVehicle()
   MyEvents.RegisterEvent(TAG, "config.changed", std::bind(&OvmsVehicle::VehicleConfigChanged, this, _1, _2));
   MyEvents.RegisterEvent(TAG, "config.mounted", std::bind(&OvmsVehicle::VehicleConfigChanged, this, _1, _2));
 
-  MyMetrics.RegisterListener(TAG, "*", std::bind(&OvmsVehicle::MetricModified, this, _1));
+  // Listen to the metrics handled by MetricModified() only, so updates of
+  //  all other metrics stay on the listener-free fast path (vehicle modules
+  //  add their own by ListenMetric()):
+  OvmsMetric* listen[] =
+    {
+    StandardMetrics.ms_v_env_on,
+    StandardMetrics.ms_v_env_awake,
+    StandardMetrics.ms_v_charge_inprogress,
+    StandardMetrics.ms_v_door_chargeport,
+    StandardMetrics.ms_v_charge_pilot,
+    StandardMetrics.ms_v_env_charging12v,
+    StandardMetrics.ms_v_env_locked,
+    StandardMetrics.ms_v_env_valet,
+    StandardMetrics.ms_v_env_headlights,
+    StandardMetrics.ms_v_door_hood,
+    StandardMetrics.ms_v_door_trunk,
+    StandardMetrics.ms_v_env_alarm,
+    StandardMetrics.ms_v_charge_mode,
+    StandardMetrics.ms_v_charge_state,
+    };
+  for (OvmsMetric* metric : listen)
+    ListenMetric(metric);
   }
 
 OvmsVehicle::~OvmsVehicle()
@@ -1066,14 +1099,45 @@ OvmsVehicle::~OvmsVehicle()
     m_bms_talerts = NULL;
     }
 
+  if (m_bms_bitset_v != NULL)
+    {
+    delete [] m_bms_bitset_v;
+    m_bms_bitset_v = NULL;
+    }
+  if (m_bms_bitset_t != NULL)
+    {
+    delete [] m_bms_bitset_t;
+    m_bms_bitset_t = NULL;
+    }
+  if (m_bms_vhist != NULL)
+    {
+    delete [] m_bms_vhist;
+    m_bms_vhist = NULL;
+    }
+  if (m_bms_vhist_avg != NULL)
+    {
+    delete [] m_bms_vhist_avg;
+    m_bms_vhist_avg = NULL;
+    }
+  if (m_bms_thist != NULL)
+    {
+    delete [] m_bms_thist;
+    m_bms_thist = NULL;
+    }
+  if (m_bms_thist_avg != NULL)
+    {
+    delete [] m_bms_thist_avg;
+    m_bms_thist_avg = NULL;
+    }
+
   if (m_registeredlistener)
     {
-    MyCan.DeregisterListener(m_rxqueue);
+    MyCan.DeregisterListener(m_rxring);
     m_registeredlistener = false;
     }
 
-  vQueueDelete(m_rxqueue);
   vTaskDelete(m_rxtask);
+  delete m_rxring;
 
   MyEvents.DeregisterEvent(TAG);
   MyMetrics.DeregisterListener(TAG);
@@ -1090,7 +1154,9 @@ void OvmsVehicle::RxTask()
 
   while(1)
     {
-    if (xQueueReceive(m_rxqueue, &frame, (portTickType)portMAX_DELAY)==pdTRUE)
+    // Woken once per burst by the CAN RX task, see CanListenerRing:
+    ulTaskNotifyTake(pdTRUE, (portTickType)portMAX_DELAY);
+    while (m_rxring->Pop(&frame))
       {
       if ((frame.origin == m_poll_bus)&&(m_poll_plist))
         {
@@ -1155,7 +1221,7 @@ void OvmsVehicle::RegisterCanBus(int bus, CAN_mode_t mode, CAN_speed_t speed)
   if (!m_registeredlistener)
     {
     m_registeredlistener = true;
-    MyCan.RegisterListener(m_rxqueue);
+    MyCan.RegisterListener(m_rxring, m_rxtask);
     }
   }
 
@@ -1538,6 +1604,20 @@ void OvmsVehicle::ConfigChanged(OvmsConfigParam* param)
   {
   }
 
+/**
+ * ListenMetric: call MetricModified() on modifications of the metric
+ *  - the standard metrics raising vehicle events are listened to by default
+ *  - vehicle modules add their own metrics (once each, e.g. in the constructor)
+ *    and override MetricModified(), passing all other metrics on to
+ *    OvmsVehicle::MetricModified()
+ *  - the listeners are removed when the vehicle is deleted
+ */
+void OvmsVehicle::ListenMetric(OvmsMetric* metric)
+  {
+  using std::placeholders::_1;
+  MyMetrics.RegisterListener(TAG, metric->m_name, std::bind(&OvmsVehicle::MetricModified, this, _1));
+  }
+
 void OvmsVehicle::MetricModified(OvmsMetric* metric)
   {
   if (metric == StandardMetrics.ms_v_env_on)
@@ -1694,13 +1774,15 @@ void OvmsVehicle::MetricModified(OvmsMetric* metric)
     }
   else if (metric == StandardMetrics.ms_v_charge_mode)
     {
-    const char* m = metric->AsString().c_str();
+    std::string mode = metric->AsString();
+    const char* m = mode.c_str();
     MyEvents.SignalEvent("vehicle.charge.mode",(void*)m, strlen(m)+1);
     NotifiedVehicleChargeMode(m);
     }
   else if (metric == StandardMetrics.ms_v_charge_state)
     {
-    const char* m = metric->AsString().c_str();
+    std::string state = metric->AsString();
+    const char* m = state.c_str();
     MyEvents.SignalEvent("vehicle.charge.state",(void*)m, strlen(m)+1);
     if (strcmp(m,"done")==0)
       {
@@ -1720,7 +1802,8 @@ void OvmsVehicle::MetricModified(OvmsMetric* metric)
 
 void OvmsVehicle::NotifyChargeState()
   {
-  const char* m = StandardMetrics.ms_v_charge_state->AsString().c_str();
+  std::string state = StandardMetrics.ms_v_charge_state->AsString();
+  const char* m = state.c_str();
   if (strcmp(m,"done")==0)
     NotifyChargeDone();
   else if (strcmp(m,"stopped")==0)
@@ -1821,6 +1904,7 @@ void OvmsVehicle::PollerSend()
           txframe.data.u8[3] = m_poll_pid & 0xff;
           break;
         }
+      m_poll_txtime = CAN_Timestamp();
       m_poll_bus->Write(&txframe);
       m_poll_plcur++;
       return;
@@ -1835,7 +1919,8 @@ void OvmsVehicle::PollerSend()
 
 void OvmsVehicle::PollerReceive(CAN_frame_t* frame)
   {
-  // ESP_LOGI(TAG, "Receive Poll Response for %d/%02x",m_poll_type,m_poll_pid);
+  // ESP_LOGI(TAG, "Receive Poll Response for %d/%02x after %uus",m_poll_type,m_poll_pid,frame->timestamp-m_poll_txtime);
+  m_poll_rxtime = frame->timestamp;
   switch (m_poll_type)
     {
     case VEHICLE_POLL_TYPE_OBDIICURRENT:
@@ -1985,6 +2070,10 @@ OvmsVehicle::vehicle_command_t OvmsVehicle::ProcessMsgCommand(std::string &resul
 
 // BMS helpers
 
+#define BMS_BITSET_WORDS(n)     (((n)+31) >> 5)
+#define BMS_BITSET_TEST(b,i)    ((b)[(i) >> 5] & (1U << ((i) & 31)))
+#define BMS_BITSET_SET(b,i)     ((b)[(i) >> 5] |= (1U << ((i) & 31)))
+
 void OvmsVehicle::BmsSetCellArrangementVoltage(int readings, int readingspermodule)
   {
   if (m_bms_voltages != NULL) delete m_bms_voltages;
@@ -1998,11 +2087,12 @@ void OvmsVehicle::BmsSetCellArrangementVoltage(int readings, int readingspermodu
   if (m_bms_valerts != NULL) delete m_bms_valerts;
   m_bms_valerts = new short[readings];
 
-  m_bms_bitset_v.clear();
-  m_bms_bitset_v.reserve(readings);
+  if (m_bms_bitset_v != NULL) delete [] m_bms_bitset_v;
+  m_bms_bitset_v = new uint32_t[BMS_BITSET_WORDS(readings)];
 
   m_bms_readings_v = readings;
   m_bms_readingspermodule_v = readingspermodule;
+  BmsInitCellHistoryVoltage();
 
   BmsResetCellVoltages();
   }
@@ -2021,15 +2111,56 @@ void OvmsVehicle::BmsSetCellArrangementTemperature(int readings, int readingsper
   m_bms_talerts = new short[readings];
   m_bms_talerts_new = 0;
 
-  m_bms_bitset_t.clear();
-  m_bms_bitset_t.reserve(readings);
+  if (m_bms_bitset_t != NULL) delete [] m_bms_bitset_t;
+  m_bms_bitset_t = new uint32_t[BMS_BITSET_WORDS(readings)];
 
   m_bms_readings_t = readings;
   m_bms_readingspermodule_t = readingspermodule;
+  BmsInitCellHistoryTemperature();
 
   BmsResetCellTemperatures();
   }
 
+/**
+ * BmsInitCellHistory…: (re)allocate the history ring for the current
+ *  arrangement & history size, clears the history
+ */
+void OvmsVehicle::BmsInitCellHistoryVoltage()
+  {
+  if (m_bms_vhist != NULL) delete [] m_bms_vhist;
+  m_bms_vhist = (m_bms_hist_size > 0 && m_bms_readings_v > 0) ? new uint16_t[m_bms_hist_size * m_bms_readings_v] : NULL;
+  if (m_bms_vhist_avg != NULL) delete [] m_bms_vhist_avg;
+  m_bms_vhist_avg = (m_bms_vhist != NULL) ? new float[m_bms_hist_size] : NULL;
+  m_bms_vhist_pos = 0;
+  m_bms_vhist_count = 0;
+  }
+
+void OvmsVehicle::BmsInitCellHistoryTemperature()
+  {
+  if (m_bms_thist != NULL) delete [] m_bms_thist;
+  m_bms_thist = (m_bms_hist_size > 0 && m_bms_readings_t > 0) ? new int16_t[m_bms_hist_size * m_bms_readings_t] : NULL;
+  if (m_bms_thist_avg != NULL) delete [] m_bms_thist_avg;
+  m_bms_thist_avg = (m_bms_thist != NULL) ? new float[m_bms_hist_size] : NULL;
+  m_bms_thist_pos = 0;
+  m_bms_thist_count = 0;
+  }
+
+/**
+ * BmsSetCellHistorySize: set number of complete sets kept in the per cell history
+ *  - may be called before or after BmsSetCellArrangement…()
+ *  - changing the size clears the history
+ *  - 0 disables the history
+ */
+void OvmsVehicle::BmsSetCellHistorySize(int sets)
+  {
+  sets = LIMIT_MIN(sets, 0);
+  if (sets == m_bms_hist_size)
+    return;
+  m_bms_hist_size = sets;
+  BmsInitCellHistoryVoltage();
+  BmsInitCellHistoryTemperature();
+  }
+
 int OvmsVehicle::BmsGetCellArangementVoltage(int* readings, int* readingspermodule)
   {
   if (readings) *readings = m_bms_readings_v;
@@ -2079,169 +2210,226 @@ void OvmsVehicle::BmsSetCellLimitsTemperature(float min, float max)
 
 void OvmsVehicle::BmsSetCellVoltage(int index, float value)
   {
-  // ESP_LOGI(TAG,"BmsSetCellVoltage(%d,%f) c=%d", index, value, m_bms_bitset_cv);
-  if ((index<0)||(index>=m_bms_readings_v)) return;
-  if ((value<m_bms_limit_vmin)||(value>m_bms_limit_vmax)) return;
-  m_bms_voltages[index] = value;
+  BmsSetCellVoltages(index, 1, &value);
+  }
 
-  if (! m_bms_has_voltages)
-    {
-    m_bms_vmins[index] = value;
-    m_bms_vmaxs[index] = value;
-    }
-  else if (m_bms_vmins[index] > value)
-    m_bms_vmins[index] = value;
-  else if (m_bms_vmaxs[index] < value)
-    m_bms_vmaxs[index] = value;
+/**
+ * BmsSetCellVoltages: set a block of consecutive cell voltages in one pass
+ *  - start: index of first cell, count: number of values
+ *  - values outside the cell limits are skipped (see BmsSetCellLimitsVoltage)
+ *  - a set is completed (statistics, alerts, metrics, history) as soon as all
+ *    cells have been set, remaining values begin the next set
+ */
+void OvmsVehicle::BmsSetCellVoltages(int start, int count, const float* values)
+  {
+  if (start < 0 || m_bms_readings_v <= 0) return;
+  if (start + count > m_bms_readings_v) count = m_bms_readings_v - start;
 
-  if (m_bms_bitset_v[index] == false) m_bms_bitset_cv++;
-  if (m_bms_bitset_cv == m_bms_readings_v)
+  for (int i=0, index=start; i<count; i++, index++)
     {
-    // get min, max, avg & standard deviation:
-    double sum=0, sqrsum=0, avg, stddev=0;
-    float min=0, max=0;
-    for (int i=0; i<m_bms_readings_v; i++)
+    float value = values[i];
+    if ((value<m_bms_limit_vmin)||(value>m_bms_limit_vmax)) continue;
+    m_bms_voltages[index] = value;
+
+    if (! m_bms_has_voltages)
       {
-      sum += m_bms_voltages[i];
-      sqrsum += SQR(m_bms_voltages[i]);
-      if (min==0 || m_bms_voltages[i]<min)
-        min = m_bms_voltages[i];
-      if (max==0 || m_bms_voltages[i]>max)
-        max = m_bms_voltages[i];
+      m_bms_vmins[index] = value;
+      m_bms_vmaxs[index] = value;
       }
-    avg = sum / m_bms_readings_v;
-    stddev = sqrt(LIMIT_MIN((sqrsum / m_bms_readings_v) - SQR(avg), 0));
-    // check cell deviations:
-    float dev;
-    float thr_warn  = MyConfig.GetParamValueFloat("vehicle", "bms.dev.voltage.warn", m_bms_defthr_vwarn);
-    float thr_alert = MyConfig.GetParamValueFloat("vehicle", "bms.dev.voltage.alert", m_bms_defthr_valert);
-    for (int i=0; i<m_bms_readings_v; i++)
+    else if (m_bms_vmins[index] > value)
+      m_bms_vmins[index] = value;
+    else if (m_bms_vmaxs[index] < value)
+      m_bms_vmaxs[index] = value;
+
+    if (!BMS_BITSET_TEST(m_bms_bitset_v, index))
       {
-      dev = ROUNDPREC(m_bms_voltages[i] - avg, 5);
-      if (ABS(dev) > ABS(m_bms_vdevmaxs[i]))
-        m_bms_vdevmaxs[i] = dev;
-      if (ABS(dev) >= thr_alert && m_bms_valerts[i] < 2)
-        {
-        m_bms_valerts[i] = 2;
-        m_bms_valerts_new++; // trigger notification
-        }
-      else if (ABS(dev) >= thr_warn && m_bms_valerts[i] < 1)
-        m_bms_valerts[i] = 1;
+      BMS_BITSET_SET(m_bms_bitset_v, index);
+      if (++m_bms_bitset_cv == m_bms_readings_v)
+        BmsCompleteCellVoltages();
       }
-    // publish to metrics:
-    avg = ROUNDPREC(avg, 5);
-    stddev = ROUNDPREC(stddev, 5);
-    StandardMetrics.ms_v_bat_pack_vmin->SetValue(min);
-    StandardMetrics.ms_v_bat_pack_vmax->SetValue(max);
-    StandardMetrics.ms_v_bat_pack_vavg->SetValue(avg);
-    StandardMetrics.ms_v_bat_pack_vstddev->SetValue(stddev);
-    if (stddev > StandardMetrics.ms_v_bat_pack_vstddev_max->AsFloat())
-      StandardMetrics.ms_v_bat_pack_vstddev_max->SetValue(stddev);
-    StandardMetrics.ms_v_bat_cell_voltage->SetElemValues(0, m_bms_readings_v, m_bms_voltages);
-    StandardMetrics.ms_v_bat_cell_vmin->SetElemValues(0, m_bms_readings_v, m_bms_vmins);
-    StandardMetrics.ms_v_bat_cell_vmax->SetElemValues(0, m_bms_readings_v, m_bms_vmaxs);
-    StandardMetrics.ms_v_bat_cell_vdevmax->SetElemValues(0, m_bms_readings_v, m_bms_vdevmaxs);
-    StandardMetrics.ms_v_bat_cell_valert->SetElemValues(0, m_bms_readings_v, m_bms_valerts);
-    // complete:
-    m_bms_has_voltages = true;
-    m_bms_bitset_v.clear();
-    m_bms_bitset_v.resize(m_bms_readings_v);
-    m_bms_bitset_cv = 0;
     }
-  else
+  }
+
+/**
+ * BmsCompleteCellVoltages: (internal) process a complete set of cell voltages
+ */
+void OvmsVehicle::BmsCompleteCellVoltages()
+  {
+  // get min, max, avg & standard deviation:
+  double sum=0, sqrsum=0, avg, stddev=0;
+  float min=0, max=0;
+  for (int i=0; i<m_bms_readings_v; i++)
     {
-    m_bms_bitset_v[index] = true;
-    }
+    float v = m_bms_voltages[i];
+    sum += v;
+    sqrsum += SQR(v);
+    if (min==0 || v<min)
+      min = v;
+    if (max==0 || v>max)
+      max = v;
+    }
+  avg = sum / m_bms_readings_v;
+  stddev = sqrt(LIMIT_MIN((sqrsum / m_bms_readings_v) - SQR(avg), 0));
+  // check cell deviations & record history:
+  float dev;
+  float thr_warn  = MyConfig.GetParamValueFloat("vehicle", "bms.dev.voltage.warn", m_bms_defthr_vwarn);
+  float thr_alert = MyConfig.GetParamValueFloat("vehicle", "bms.dev.voltage.alert", m_bms_defthr_valert);
+  uint16_t* hist = m_bms_vhist ? &m_bms_vhist[m_bms_vhist_pos * m_bms_readings_v] : NULL;
+  for (int i=0; i<m_bms_readings_v; i++)
+    {
+    dev = ROUNDPREC(m_bms_voltages[i] - avg, 5);
+    if (ABS(dev) > ABS(m_bms_vdevmaxs[i]))
+      m_bms_vdevmaxs[i] = dev;
+    if (ABS(dev) >= thr_alert && m_bms_valerts[i] < 2)
+      {
+      m_bms_valerts[i] = 2;
+      m_bms_valerts_new++; // trigger notification
+      }
+    else if (ABS(dev) >= thr_warn && m_bms_valerts[i] < 1)
+      m_bms_valerts[i] = 1;
+    if (hist)
+      hist[i] = LIMIT_MAX(LIMIT_MIN(lroundf(m_bms_voltages[i] * 1000), 0), UINT16_MAX);
+    }
+  if (hist)
+    {
+    m_bms_vhist_avg[m_bms_vhist_pos] = avg;
+    m_bms_vhist_pos = (m_bms_vhist_pos + 1) % m_bms_hist_size;
+    if (m_bms_vhist_count < m_bms_hist_size) m_bms_vhist_count++;
+    }
+  // publish to metrics:
+  avg = ROUNDPREC(avg, 5);
+  stddev = ROUNDPREC(stddev, 5);
+  StandardMetrics.ms_v_bat_pack_vmin->SetValue(min);
+  StandardMetrics.ms_v_bat_pack_vmax->SetValue(max);
+  StandardMetrics.ms_v_bat_pack_vavg->SetValue(avg);
+  StandardMetrics.ms_v_bat_pack_vstddev->SetValue(stddev);
+  if (stddev > StandardMetrics.ms_v_bat_pack_vstddev_max->AsFloat())
+    StandardMetrics.ms_v_bat_pack_vstddev_max->SetValue(stddev);
+  StandardMetrics.ms_v_bat_cell_voltage->SetElemValues(0, m_bms_readings_v, m_bms_voltages);
+  StandardMetrics.ms_v_bat_cell_vmin->SetElemValues(0, m_bms_readings_v, m_bms_vmins);
+  StandardMetrics.ms_v_bat_cell_vmax->SetElemValues(0, m_bms_readings_v, m_bms_vmaxs);
+  StandardMetrics.ms_v_bat_cell_vdevmax->SetElemValues(0, m_bms_readings_v, m_bms_vdevmaxs);
+  StandardMetrics.ms_v_bat_cell_valert->SetElemValues(0, m_bms_readings_v, m_bms_valerts);
+  // complete:
+  m_bms_has_voltages = true;
+  BmsRestartCellVoltages();
   }
 
 void OvmsVehicle::BmsSetCellTemperature(int index, float value)
   {
-  // ESP_LOGI(TAG,"BmsSetCellTemperature(%d,%f) c=%d", index, value, m_bms_bitset_ct);
-  if ((index<0)||(index>=m_bms_readings_t)) return;
-  if ((value<m_bms_limit_tmin)||(value>m_bms_limit_tmax)) return;
-  m_bms_temperatures[index] = value;
+  BmsSetCellTemperatures(index, 1, &value);
+  }
 
-  if (! m_bms_has_temperatures)
-    {
-    m_bms_tmins[index] = value;
-    m_bms_tmaxs[index] = value;
-    }
-  else if (m_bms_tmins[index] > value)
-    m_bms_tmins[index] = value;
-  else if (m_bms_tmaxs[index] < value)
-    m_bms_tmaxs[index] = value;
+/**
+ * BmsSetCellTemperatures: set a block of consecutive cell temperatures in one pass
+ *  - see BmsSetCellVoltages()
+ */
+void OvmsVehicle::BmsSetCellTemperatures(int start, int count, const float* values)
+  {
+  if (start < 0 || m_bms_readings_t <= 0) return;
+  if (start + count > m_bms_readings_t) count = m_bms_readings_t - start;
 
-  if (m_bms_bitset_t[index] == false) m_bms_bitset_ct++;
-  if (m_bms_bitset_ct == m_bms_readings_t)
+  for (int i=0, index=start; i<count; i++, index++)
     {
-    // get min, max, avg & standard deviation:
-    double sum=0, sqrsum=0, avg, stddev=0;
-    float min=0, max=0;
-    for (int i=0; i<m_bms_readings_t; i++)
+    float value = values[i];
+    if ((value<m_bms_limit_tmin)||(value>m_bms_limit_tmax)) continue;
+    m_bms_temperatures[index] = value;
+
+    if (! m_bms_has_temperatures)
       {
-      sum += m_bms_temperatures[i];
-      sqrsum += SQR(m_bms_temperatures[i]);
-      if (min==0 || m_bms_temperatures[i]<min)
-        min = m_bms_temperatures[i];
-      if (max==0 || m_bms_temperatures[i]>max)
-        max = m_bms_temperatures[i];
+      m_bms_tmins[index] = value;
+      m_bms_tmaxs[index] = value;
       }
-    avg = sum / m_bms_readings_t;
-    stddev = sqrt(LIMIT_MIN((sqrsum / m_bms_readings_t) - SQR(avg), 0));
-    // check cell deviations:
-    float dev;
-    float thr_warn  = MyConfig.GetParamValueFloat("vehicle", "bms.dev.temp.warn", m_bms_defthr_twarn);
-    float thr_alert = MyConfig.GetParamValueFloat("vehicle", "bms.dev.temp.alert", m_bms_defthr_talert);
-    for (int i=0; i<m_bms_readings_t; i++)
+    else if (m_bms_tmins[index] > value)
+      m_bms_tmins[index] = value;
+    else if (m_bms_tmaxs[index] < value)
+      m_bms_tmaxs[index] = value;
+
+    if (!BMS_BITSET_TEST(m_bms_bitset_t, index))
       {
-      dev = ROUNDPREC(m_bms_temperatures[i] - avg, 2);
-      if (ABS(dev) > ABS(m_bms_tdevmaxs[i]))
-        m_bms_tdevmaxs[i] = dev;
-      if (ABS(dev) >= thr_alert && m_bms_talerts[i] < 2)
-        {
-        m_bms_talerts[i] = 2;
-        m_bms_talerts_new++; // trigger notification
-        }
-      else if (ABS(dev) >= thr_warn && m_bms_valerts[i] < 1)
-        m_bms_talerts[i] = 1;
+      BMS_BITSET_SET(m_bms_bitset_t, index);
+      if (++m_bms_bitset_ct == m_bms_readings_t)
+        BmsCompleteCellTemperatures();
       }
-    // publish to metrics:
-    avg = ROUNDPREC(avg, 2);
-    stddev = ROUNDPREC(stddev, 2);
-    StandardMetrics.ms_v_bat_pack_tmin->SetValue(min);
-    StandardMetrics.ms_v_bat_pack_tmax->SetValue(max);
-    StandardMetrics.ms_v_bat_pack_tavg->SetValue(avg);
-    StandardMetrics.ms_v_bat_pack_tstddev->SetValue(stddev);
-    if (stddev > StandardMetrics.ms_v_bat_pack_tstddev_max->AsFloat())
-      StandardMetrics.ms_v_bat_pack_tstddev_max->SetValue(stddev);
-    StandardMetrics.ms_v_bat_cell_temp->SetElemValues(0, m_bms_readings_t, m_bms_temperatures);
-    StandardMetrics.ms_v_bat_cell_tmin->SetElemValues(0, m_bms_readings_t, m_bms_tmins);
-    StandardMetrics.ms_v_bat_cell_tmax->SetElemValues(0, m_bms_readings_t, m_bms_tmaxs);
-    StandardMetrics.ms_v_bat_cell_tdevmax->SetElemValues(0, m_bms_readings_t, m_bms_tdevmaxs);
-    StandardMetrics.ms_v_bat_cell_talert->SetElemValues(0, m_bms_readings_t, m_bms_talerts);
-    // complete:
-    m_bms_has_temperatures = true;
-    m_bms_bitset_t.clear();
-    m_bms_bitset_t.resize(m_bms_readings_t);
-    m_bms_bitset_ct = 0;
-    }
-  else
-    {
-    m_bms_bitset_t[index] = true;
     }
   }
 
+/**
+ * BmsCompleteCellTemperatures: (internal) process a complete set of cell temperatures
+ */
+void OvmsVehicle::BmsCompleteCellTemperatures()
+  {
+  // get min, max, avg & standard deviation:
+  double sum=0, sqrsum=0, avg, stddev=0;
+  float min=0, max=0;
+  for (int i=0; i<m_bms_readings_t; i++)
+    {
+    float t = m_bms_temperatures[i];
+    sum += t;
+    sqrsum += SQR(t);
+    if (min==0 || t<min)
+      min = t;
+    if (max==0 || t>max)
+      max = t;
+    }
+  avg = sum / m_bms_readings_t;
+  stddev = sqrt(LIMIT_MIN((sqrsum / m_bms_readings_t) - SQR(avg), 0));
+  // check cell deviations & record history:
+  float dev;
+  float thr_warn  = MyConfig.GetParamValueFloat("vehicle", "bms.dev.temp.warn", m_bms_defthr_twarn);
+  float thr_alert = MyConfig.GetParamValueFloat("vehicle", "bms.dev.temp.alert", m_bms_defthr_talert);
+  int16_t* hist = m_bms_thist ? &m_bms_thist[m_bms_thist_pos * m_bms_readings_t] : NULL;
+  for (int i=0; i<m_bms_readings_t; i++)
+    {
+    dev = ROUNDPREC(m_bms_temperatures[i] - avg, 2);
+    if (ABS(dev) > ABS(m_bms_tdevmaxs[i]))
+      m_bms_tdevmaxs[i] = dev;
+    if (ABS(dev) >= thr_alert && m_bms_talerts[i] < 2)
+      {
+      m_bms_talerts[i] = 2;
+      m_bms_talerts_new++; // trigger notification
+      }
+    else if (ABS(dev) >= thr_warn && m_bms_talerts[i] < 1)
+      m_bms_talerts[i] = 1;
+    if (hist)
+      hist[i] = LIMIT_MAX(LIMIT_MIN(lroundf(m_bms_temperatures[i] * 10), INT16_MIN), INT16_MAX);
+    }
+  if (hist)
+    {
+    m_bms_thist_avg[m_bms_thist_pos] = avg;
+    m_bms_thist_pos = (m_bms_thist_pos + 1) % m_bms_hist_size;
+    if (m_bms_thist_count < m_bms_hist_size) m_bms_thist_count++;
+    }
+  // publish to metrics:
+  avg = ROUNDPREC(avg, 2);
+  stddev = ROUNDPREC(stddev, 2);
+  StandardMetrics.ms_v_bat_pack_tmin->SetValue(min);
+  StandardMetrics.ms_v_bat_pack_tmax->SetValue(max);
+  StandardMetrics.ms_v_bat_pack_tavg->SetValue(avg);
+  StandardMetrics.ms_v_bat_pack_tstddev->SetValue(stddev);
+  if (stddev > StandardMetrics.ms_v_bat_pack_tstddev_max->AsFloat())
+    StandardMetrics.ms_v_bat_pack_tstddev_max->SetValue(stddev);
+  StandardMetrics.ms_v_bat_cell_temp->SetElemValues(0, m_bms_readings_t, m_bms_temperatures);
+  StandardMetrics.ms_v_bat_cell_tmin->SetElemValues(0, m_bms_readings_t, m_bms_tmins);
+  StandardMetrics.ms_v_bat_cell_tmax->SetElemValues(0, m_bms_readings_t, m_bms_tmaxs);
+  StandardMetrics.ms_v_bat_cell_tdevmax->SetElemValues(0, m_bms_readings_t, m_bms_tdevmaxs);
+  StandardMetrics.ms_v_bat_cell_talert->SetElemValues(0, m_bms_readings_t, m_bms_talerts);
+  // complete:
+  m_bms_has_temperatures = true;
+  BmsRestartCellTemperatures();
+  }
+
 void OvmsVehicle::BmsRestartCellVoltages()
   {
-  m_bms_bitset_v.clear();
-  m_bms_bitset_v.resize(m_bms_readings_v);
+  if (m_bms_bitset_v)
+    memset(m_bms_bitset_v, 0, BMS_BITSET_WORDS(m_bms_readings_v) * sizeof(uint32_t));
   m_bms_bitset_cv = 0;
   }
 
 void OvmsVehicle::BmsRestartCellTemperatures()
   {
-  m_bms_bitset_t.clear();
-  m_bms_bitset_v.resize(m_bms_readings_t);
+  if (m_bms_bitset_t)
+    memset(m_bms_bitset_t, 0, BMS_BITSET_WORDS(m_bms_readings_t) * sizeof(uint32_t));
   m_bms_bitset_ct = 0;
   }
 
@@ -2249,9 +2437,7 @@ void OvmsVehicle::BmsResetCellVoltages()
   {
   if (m_bms_readings_v > 0)
     {
-    m_bms_bitset_v.clear();
-    m_bms_bitset_v.resize(m_bms_readings_v);
-    m_bms_bitset_cv = 0;
+    BmsRestartCellVoltages();
     m_bms_has_voltages = false;
     for (int k=0; k<m_bms_readings_v; k++)
       {
@@ -2261,6 +2447,8 @@ void OvmsVehicle::BmsResetCellVoltages()
       m_bms_valerts[k] = 0;
       }
     m_bms_valerts_new = 0;
+    m_bms_vhist_count = 0;
+    m_bms_vhist_pos = 0;
     StandardMetrics.ms_v_bat_cell_vmin->ClearValue();
     StandardMetrics.ms_v_bat_cell_vmax->ClearValue();
     StandardMetrics.ms_v_bat_cell_vdevmax->ClearValue();
@@ -2273,9 +2461,7 @@ void OvmsVehicle::BmsResetCellTemperatures()
   {
   if (m_bms_readings_t > 0)
     {
-    m_bms_bitset_t.clear();
-    m_bms_bitset_t.resize(m_bms_readings_t);
-    m_bms_bitset_ct = 0;
+    BmsRestartCellTemperatures();
     m_bms_has_temperatures = false;
     for (int k=0; k<m_bms_readings_t; k++)
       {
@@ -2285,6 +2471,8 @@ void OvmsVehicle::BmsResetCellTemperatures()
       m_bms_talerts[k] = 0;
       }
     m_bms_talerts_new = 0;
+    m_bms_thist_count = 0;
+    m_bms_thist_pos = 0;
     StandardMetrics.ms_v_bat_cell_tmin->ClearValue();
     StandardMetrics.ms_v_bat_cell_tmax->ClearValue();
     StandardMetrics.ms_v_bat_cell_tdevmax->ClearValue();
@@ -2293,6 +2481,71 @@ void OvmsVehicle::BmsResetCellTemperatures()
     }
   }
 
+/**
+ * BmsGetCellHistoryVoltage: get voltage history of a cell
+ *  - fills values with up to maxsets voltages [V], newest first
+ *  - history resolution is 1 mV, range 0 … 65.535 V (readings outside are clamped)
+ *  - returns number of values
+ */
+int OvmsVehicle::BmsGetCellHistoryVoltage(int index, float* values, int maxsets)
+  {
+  if (index < 0 || index >= m_bms_readings_v || !m_bms_vhist) return 0;
+  int cnt = LIMIT_MAX(maxsets, m_bms_vhist_count);
+  for (int k=0; k<cnt; k++)
+    {
+    int pos = (m_bms_vhist_pos + m_bms_hist_size - 1 - k) % m_bms_hist_size;
+    values[k] = (float) m_bms_vhist[pos * m_bms_readings_v + index] / 1000;
+    }
+  return cnt;
+  }
+
+/**
+ * BmsGetCellHistoryTemperature: get temperature history of a cell
+ *  - fills values with up to maxsets temperatures [°C], newest first
+ *  - returns number of values
+ */
+int OvmsVehicle::BmsGetCellHistoryTemperature(int index, float* values, int maxsets)
+  {
+  if (index < 0 || index >= m_bms_readings_t || !m_bms_thist) return 0;
+  int cnt = LIMIT_MAX(maxsets, m_bms_thist_count);
+  for (int k=0; k<cnt; k++)
+    {
+    int pos = (m_bms_thist_pos + m_bms_hist_size - 1 - k) % m_bms_hist_size;
+    values[k] = (float) m_bms_thist[pos * m_bms_readings_t + index] / 10;
+    }
+  return cnt;
+  }
+
+/**
+ * BmsGetCellDriftVoltage: get imbalance trend of a cell over the history
+ *  - result: change of the cell deviation from the pack average [V]
+ *    from the oldest to the newest set in the history
+ *  - positive = cell drifting up relative to the pack
+ */
+float OvmsVehicle::BmsGetCellDriftVoltage(int index)
+  {
+  if (index < 0 || index >= m_bms_readings_v || !m_bms_vhist || m_bms_vhist_count < 2) return 0;
+  int pnew = (m_bms_vhist_pos + m_bms_hist_size - 1) % m_bms_hist_size;
+  int pold = (m_bms_vhist_pos + m_bms_hist_size - m_bms_vhist_count) % m_bms_hist_size;
+  float devnew = (float) m_bms_vhist[pnew * m_bms_readings_v + index] / 1000 - m_bms_vhist_avg[pnew];
+  float devold = (float) m_bms_vhist[pold * m_bms_readings_v + index] / 1000 - m_bms_vhist_avg[pold];
+  return devnew - devold;
+  }
+
+/**
+ * BmsGetCellDriftTemperature: get imbalance trend of a cell over the history
+ *  - result: change of the cell deviation from the pack average [°C]
+ */
+float OvmsVehicle::BmsGetCellDriftTemperature(int index)
+  {
+  if (index < 0 || index >= m_bms_readings_t || !m_bms_thist || m_bms_thist_count < 2) return 0;
+  int pnew = (m_bms_thist_pos + m_bms_hist_size - 1) % m_bms_hist_size;
+  int pold = (m_bms_thist_pos + m_bms_hist_size - m_bms_thist_count) % m_bms_hist_size;
+  float devnew = (float) m_bms_thist[pnew * m_bms_readings_t + index] / 10 - m_bms_thist_avg[pnew];
+  float devold = (float) m_bms_thist[pold * m_bms_readings_t + index] / 10 - m_bms_thist_avg[pold];
+  return devnew - devold;
+  }
+
 void OvmsVehicle::BmsResetCellStats()
   {
   BmsResetCellVoltages();
@@ -96,6 +96,9 @@ struct DashboardConfig;
 #define BMS_DEFTHR_TWARN    2.00    // [°C]
 #define BMS_DEFTHR_TALERT   3.00    // [°C]
 
+// BMS cell history: number of complete sets kept per cell (0 = disabled)
+#define BMS_HISTORY_SIZE    8
+
 
 class OvmsVehicle : public InternalRamAllocated
   {
@@ -105,7 +108,7 @@ class OvmsVehicle : public InternalRamAllocated
     virtual const char* VehicleShortName();
 
   protected:
-    QueueHandle_t m_rxqueue;
+    CanListenerRing* m_rxring;
     TaskHandle_t m_rxtask;
     bool m_registeredlistener;
     bool m_autonotifications;
@@ -180,7 +183,8 @@ class OvmsVehicle : public InternalRamAllocated
 
   protected:
     virtual void ConfigChanged(OvmsConfigParam* param);
-    virtual void MetricModified(OvmsMetric* metric);
+    virtual void MetricModified(OvmsMetric* metric); // metrics listened to, see ListenMetric()
+    void ListenMetric(OvmsMetric* metric);
     virtual void CalculateEfficiency();
 
   public:
@@ -261,6 +265,8 @@ class OvmsVehicle : public InternalRamAllocated
     uint16_t          m_poll_ml_remain;       // Bytes remainign for ML poll
     uint16_t          m_poll_ml_offset;       // Offset of ML poll
     uint16_t          m_poll_ml_frame;        // Frame number for ML poll
+    uint32_t          m_poll_txtime;          // Time of last request sent (see CAN_Timestamp())
+    uint32_t          m_poll_rxtime;          // Time of last response frame received
 
   protected:
     void PollSetPidList(canbus* bus, const poll_pid_t* plist);
@@ -282,8 +288,8 @@ class OvmsVehicle : public InternalRamAllocated
     short* m_bms_talerts;                     // BMS temperature deviation alerts (since reset)
     int m_bms_talerts_new;                    // BMS new temperature alerts since last notification
     bool m_bms_has_temperatures;              // True if BMS has a complete set of temperature values
-    std::vector<bool> m_bms_bitset_v;         // BMS tracking: true if corresponding voltage set
-    std::vector<bool> m_bms_bitset_t;         // BMS tracking: true if corresponding temperature set
+    uint32_t* m_bms_bitset_v;                 // BMS tracking: bit set if corresponding voltage set
+    uint32_t* m_bms_bitset_t;                 // BMS tracking: bit set if corresponding temperature set
     int m_bms_bitset_cv;                      // BMS tracking: count of unique voltage values set
     int m_bms_bitset_ct;                      // BMS tracking: count of unique temperature values set
     int m_bms_readings_v;                     // Number of BMS voltage readings expected
@@ -298,6 +304,15 @@ class OvmsVehicle : public InternalRamAllocated
     float m_bms_defthr_valert;                // Default voltage deviation alert threshold [V]
     float m_bms_defthr_twarn;                 // Default temperature deviation warn threshold [°C]
     float m_bms_defthr_talert;                // Default temperature deviation alert threshold [°C]
+    int m_bms_hist_size;                      // BMS history: ring size (complete sets per cell)
+    uint16_t* m_bms_vhist;                    // BMS history: voltages [set][cell] in mV (0…65.535 V, clamped)
+    float* m_bms_vhist_avg;                   // BMS history: pack average voltage per set
+    int m_bms_vhist_count;                    // BMS history: number of voltage sets stored
+    int m_bms_vhist_pos;                      // BMS history: next voltage set slot
+    int16_t* m_bms_thist;                     // BMS history: temperatures [set][cell] in 1/10 °C (clamped)
+    float* m_bms_thist_avg;                   // BMS history: pack average temperature per set
+    int m_bms_thist_count;                    // BMS history: number of temperature sets stored
+    int m_bms_thist_pos;                      // BMS history: next temperature set slot
 
   protected:
     void BmsSetCellArrangementVoltage(int readings, int readingspermodule);
@@ -306,12 +321,19 @@ class OvmsVehicle : public InternalRamAllocated
     void BmsSetCellDefaultThresholdsTemperature(float warn, float alert);
     void BmsSetCellLimitsVoltage(float min, float max);
     void BmsSetCellLimitsTemperature(float min, float max);
+    void BmsSetCellHistorySize(int sets);
+    void BmsInitCellHistoryVoltage();
+    void BmsInitCellHistoryTemperature();
     void BmsSetCellVoltage(int index, float value);
+    void BmsSetCellVoltages(int start, int count, const float* values);
     void BmsResetCellVoltages();
     void BmsSetCellTemperature(int index, float value);
+    void BmsSetCellTemperatures(int start, int count, const float* values);
     void BmsResetCellTemperatures();
     void BmsRestartCellVoltages();
     void BmsRestartCellTemperatures();
+    void BmsCompleteCellVoltages();
+    void BmsCompleteCellTemperatures();
     virtual void NotifyBmsAlerts();
 
   public:
@@ -320,6 +342,10 @@ class OvmsVehicle : public InternalRamAllocated
     void BmsGetCellDefaultThresholdsVoltage(float* warn, float* alert);
     void BmsGetCellDefaultThresholdsTemperature(float* warn, float* alert);
     void BmsResetCellStats();
+    int BmsGetCellHistoryVoltage(int index, float* values, int maxsets);
+    int BmsGetCellHistoryTemperature(int index, float* values, int maxsets);
+    float BmsGetCellDriftVoltage(int index);
+    float BmsGetCellDriftTemperature(int index);
     virtual void BmsStatus(int verbosity, OvmsWriter* writer);
     virtual bool FormatBmsAlerts(int verbosity, OvmsWriter* writer, bool show_warnings);
   };
@@ -190,10 +190,13 @@ void OvmsVehicleRenaultTwizy::BatteryUpdateMetrics()
     cell.UpdateMetrics();
   
   int i;
+  float temps[BATT_CMODS], volts[BATT_CELLS];
   for (i = 0; i < batt_cmod_count; i++)
-    BmsSetCellTemperature(i, (float) twizy_cmod[i].temp_act - 40);
+    temps[i] = (float) twizy_cmod[i].temp_act - 40;
+  BmsSetCellTemperatures(0, batt_cmod_count, temps);
   for (i = 0; i < batt_cell_count; i++)
-    BmsSetCellVoltage(i, (float) twizy_cell[i].volt_act / 200);
+    volts[i] = (float) twizy_cell[i].volt_act / 200;
+  BmsSetCellVoltages(0, batt_cell_count, volts);
 }
 
 
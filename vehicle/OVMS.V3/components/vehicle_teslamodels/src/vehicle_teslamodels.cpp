@@ -214,20 +214,18 @@ void OvmsVehicleTeslaModelS::IncomingFrameCan1(CAN_frame_t* p_frame)
         if (d[0]<24)
           {
           // Voltages
-          int k = d[0]*4;
-          BmsSetCellVoltage(k,   0.000305 * v1);
-          BmsSetCellVoltage(k+1, 0.000305 * v2);
-          BmsSetCellVoltage(k+2, 0.000305 * v3);
-          BmsSetCellVoltage(k+3, 0.000305 * v4);
+          float v[4] = { 0.000305f * v1, 0.000305f * v2, 0.000305f * v3, 0.000305f * v4 };
+          BmsSetCellVoltages(d[0]*4, 4, v);
           }
         else
           {
           // Temperatures
-          int k = (d[0]-24)*4;
-          BmsSetCellTemperature(k,   0.0122 * ((v1 & 0x1FFF) - (v1 & 0x2000)));
-          BmsSetCellTemperature(k+1, 0.0122 * ((v2 & 0x1FFF) - (v2 & 0x2000)));
-          BmsSetCellTemperature(k+2, 0.0122 * ((v3 & 0x1FFF) - (v3 & 0x2000)));
-          BmsSetCellTemperature(k+3, 0.0122 * ((v4 & 0x1FFF) - (v4 & 0x2000)));
+          float t[4] = {
+            0.0122f * ((v1 & 0x1FFF) - (v1 & 0x2000)),
+            0.0122f * ((v2 & 0x1FFF) - (v2 & 0x2000)),
+            0.0122f * ((v3 & 0x1FFF) - (v3 & 0x2000)),
+            0.0122f * ((v4 & 0x1FFF) - (v4 & 0x2000)) };
+          BmsSetCellTemperatures((d[0]-24)*4, 4, t);
           }
         }
       break;
@@ -52,6 +52,7 @@ class BufferedShell : public OvmsShell
     char ** GetCompletion(OvmsCommandMap& children, const char* token);
     void Log(LogBuffers* message);
     virtual bool IsInteractive() { return false; }
+    virtual bool WantsLog() { return m_output != NULL; }
     void Output(OvmsWriter*);
     void Dump(std::string&);
     void Dump(extram::string&);
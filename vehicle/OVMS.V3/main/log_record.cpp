@@ -0,0 +1,563 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Binary log records with deferred formatting
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "soc/soc.h"
+#include "ovms_malloc.h"
+#include "log_record.h"
+
+typedef enum
+  {
+  LRA_INVALID = 0,
+  LRA_PERCENT,          // "%%", no argument
+  LRA_INT,
+  LRA_LONG,
+  LRA_LLONG,
+  LRA_SIZE,
+  LRA_INTMAX,
+  LRA_PTRDIFF,
+  LRA_DOUBLE,
+  LRA_PTR,
+  LRA_STR,
+  } logrecord_arg_t;
+
+typedef struct
+  {
+  logrecord_arg_t type;
+  uint8_t stars;        // number of '*' width/precision arguments
+  uint8_t len;          // length of the conversion specification
+  } logrecord_spec_t;
+
+/**
+ * ParseSpec: parse printf conversion specification starting at '%'
+ */
+static logrecord_spec_t ParseSpec(const char* f)
+  {
+  logrecord_spec_t spec = { LRA_INVALID, 0, 0 };
+  const char* s = f + 1;
+  if (*s == '%')
+    {
+    spec.type = LRA_PERCENT;
+    spec.len = 2;
+    return spec;
+    }
+  while (*s && strchr("-+ #0", *s))
+    s++;
+  if (*s == '*')
+    spec.stars++, s++;
+  else
+    while (*s >= '0' && *s <= '9') s++;
+  if (*s == '.')
+    {
+    s++;
+    if (*s == '*')
+      spec.stars++, s++;
+    else
+      while (*s >= '0' && *s <= '9') s++;
+    }
+  int lng = 0;
+  char lmod = 0;
+  if (*s == 'h')
+    {
+    s++;
+    if (*s == 'h') s++;
+    }
+  else if (*s == 'l')
+    {
+    lng = 1, s++;
+    if (*s == 'l') lng = 2, s++;
+    }
+  else if (*s == 'j' || *s == 'z' || *s == 't' || *s == 'L' || *s == 'q')
+    {
+    lmod = *s++;
+    }
+  switch (*s)
+    {
+    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+      if (lmod == 'j') spec.type = LRA_INTMAX;
+      else if (lmod == 'z') spec.type = LRA_SIZE;
+      else if (lmod == 't') spec.type = LRA_PTRDIFF;
+      else if (lmod == 'q' || lng == 2) spec.type = LRA_LLONG;
+      else if (lmod == 'L') spec.type = LRA_INVALID;
+      else if (lng == 1) spec.type = LRA_LONG;
+      else spec.type = LRA_INT;
+      break;
+    case 'c':
+      spec.type = (lng || lmod) ? LRA_INVALID : LRA_INT;
+      break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+      spec.type = (lmod == 'L') ? LRA_INVALID : LRA_DOUBLE;
+      break;
+    case 's':
+      spec.type = (lng || lmod) ? LRA_INVALID : LRA_STR;
+      break;
+    case 'p':
+      spec.type = LRA_PTR;
+      break;
+    default:
+      spec.type = LRA_INVALID;
+      break;
+    }
+  spec.len = s + 1 - f;
+  return spec;
+  }
+
+static inline bool IsStaticString(const char* s)
+  {
+#ifdef SOC_DROM_LOW
+  return ((intptr_t)s >= SOC_DROM_LOW && (intptr_t)s < SOC_DROM_HIGH);
+#else
+  return false;
+#endif
+  }
+
+#define PACK(val) \
+  do { \
+    if (p + sizeof(val) > end) return 0; \
+    memcpy(p, &val, sizeof(val)); \
+    p += sizeof(val); \
+  } while (0)
+
+#define PACK_ARG(type) \
+  do { \
+    type v = va_arg(args, type); \
+    PACK(v); \
+  } while (0)
+
+/**
+ * LogRecordPack: pack format & arguments into record
+ *  Returns the record size or 0 if the log call cannot be packed.
+ */
+size_t LogRecordPack(uint8_t* rec, size_t size, const char* fmt, va_list args)
+  {
+  uint8_t* p = rec + 4;
+  uint8_t* end = rec + size;
+  uint8_t flags = 0;
+  if (size < 4 + sizeof(fmt))
+    return 0;
+
+  if (IsStaticString(fmt))
+    {
+    PACK(fmt);
+    }
+  else
+    {
+    size_t len = strlen(fmt) + 1;
+    if (p + len > end)
+      return 0;
+    memcpy(p, fmt, len);
+    p += len;
+    flags |= LOGRECORD_FMT_INLINE;
+    }
+
+  for (const char* f = strchr(fmt, '%'); f; f = strchr(f, '%'))
+    {
+    logrecord_spec_t spec = ParseSpec(f);
+    f += spec.len;
+    switch (spec.type)
+      {
+      case LRA_INVALID: return 0;
+      case LRA_PERCENT: continue;
+      default: break;
+      }
+    for (int i = 0; i < spec.stars; i++)
+      PACK_ARG(int);
+    switch (spec.type)
+      {
+      case LRA_INT:       PACK_ARG(int); break;
+      case LRA_LONG:      PACK_ARG(long); break;
+      case LRA_LLONG:     PACK_ARG(long long); break;
+      case LRA_SIZE:      PACK_ARG(size_t); break;
+      case LRA_INTMAX:    PACK_ARG(intmax_t); break;
+      case LRA_PTRDIFF:   PACK_ARG(ptrdiff_t); break;
+      case LRA_DOUBLE:    PACK_ARG(double); break;
+      case LRA_PTR:       PACK_ARG(void*); break;
+      case LRA_STR:
+        {
+        const char* s = va_arg(args, const char*);
+        if (!s) s = "(null)";
+        size_t len = strlen(s);
+        if (len > 255) len = 255;
+        if (p + 1 + len > end)
+          return 0;
+        *p++ = len;
+        memcpy(p, s, len);
+        p += len;
+        break;
+        }
+      default:
+        return 0;
+      }
+    }
+
+  uint16_t recsize = p - rec;
+  rec[0] = LOGRECORD_MAGIC;
+  rec[1] = flags;
+  memcpy(rec + 2, &recsize, 2);
+  return recsize;
+  }
+
+/**
+ * LogRecordPackText: pack preformatted text (truncated to fit)
+ */
+size_t LogRecordPackText(uint8_t* rec, size_t size, const char* text)
+  {
+  if (size < 5)
+    return 0;
+  size_t len = strlen(text);
+  if (4 + len + 1 > size)
+    len = size - 5;
+  memcpy(rec + 4, text, len);
+  rec[4 + len] = 0;
+  uint16_t recsize = 4 + len + 1;
+  rec[0] = LOGRECORD_MAGIC;
+  rec[1] = LOGRECORD_TEXT;
+  memcpy(rec + 2, &recsize, 2);
+  return recsize;
+  }
+
+template <typename T>
+static int FormatArg(char* buf, size_t size, const char* sf, int stars, const int* sv, T val)
+  {
+  switch (stars)
+    {
+    case 0:   return snprintf(buf, size, sf, val);
+    case 1:   return snprintf(buf, size, sf, sv[0], val);
+    default:  return snprintf(buf, size, sf, sv[0], sv[1], val);
+    }
+  }
+
+#define UNPACK(val) \
+  do { \
+    if (p + sizeof(val) > end) goto done; \
+    memcpy(&val, p, sizeof(val)); \
+    p += sizeof(val); \
+  } while (0)
+
+#define FORMAT_ARG(type) \
+  do { \
+    type v; \
+    UNPACK(v); \
+    n = FormatArg(o, oend - o, sf, spec.stars, sv, v); \
+  } while (0)
+
+/**
+ * LogRecordFormat: format record into buf (NUL terminated, truncated to fit)
+ *  Returns the text length.
+ */
+int LogRecordFormat(char* buf, size_t size, const uint8_t* rec, size_t len)
+  {
+  if (size == 0)
+    return 0;
+  char* o = buf;
+  char* oend = buf + size;
+  *o = 0;
+  if (!IsLogRecord(rec, len))
+    return 0;
+
+  uint8_t flags = rec[1];
+  const uint8_t* p = rec + 4;
+  const uint8_t* end = rec + len;
+  const char* fmt;
+  if (flags & LOGRECORD_TEXT)
+    {
+    size_t tl = strnlen((const char*)p, end - p);
+    if (tl >= size) tl = size - 1;
+    memcpy(buf, p, tl);
+    buf[tl] = 0;
+    return tl;
+    }
+  else if (flags & LOGRECORD_FMT_INLINE)
+    {
+    fmt = (const char*) p;
+    p += strnlen(fmt, end - p) + 1;
+    }
+  else
+    {
+    UNPACK(fmt);
+    }
+
+  while (*fmt && o < oend - 1)
+    {
+    // copy literal text:
+    const char* f = strchr(fmt, '%');
+    size_t lit = f ? (size_t)(f - fmt) : strlen(fmt);
+    if (lit)
+      {
+      if (lit > (size_t)(oend - 1 - o))
+        lit = oend - 1 - o;
+      memcpy(o, fmt, lit);
+      o += lit;
+      *o = 0;
+      fmt += lit;
+      continue;
+      }
+
+    // format conversion:
+    logrecord_spec_t spec = ParseSpec(fmt);
+    if (spec.type == LRA_INVALID || spec.len >= 32)
+      break;
+    if (spec.type == LRA_PERCENT)
+      {
+      *o++ = '%';
+      *o = 0;
+      fmt += spec.len;
+      continue;
+      }
+    char sf[32];
+    memcpy(sf, fmt, spec.len);
+    sf[spec.len] = 0;
+    fmt += spec.len;
+    int sv[2] = { 0, 0 };
+    for (int i = 0; i < spec.stars; i++)
+      UNPACK(sv[i]);
+    int n = 0;
+    switch (spec.type)
+      {
+      case LRA_INT:       FORMAT_ARG(int); break;
+      case LRA_LONG:      FORMAT_ARG(long); break;
+      case LRA_LLONG:     FORMAT_ARG(long long); break;
+      case LRA_SIZE:      FORMAT_ARG(size_t); break;
+      case LRA_INTMAX:    FORMAT_ARG(intmax_t); break;
+      case LRA_PTRDIFF:   FORMAT_ARG(ptrdiff_t); break;
+      case LRA_DOUBLE:    FORMAT_ARG(double); break;
+      case LRA_PTR:       FORMAT_ARG(void*); break;
+      case LRA_STR:
+        {
+        if (p >= end) goto done;
+        size_t sl = *p++;
+        if (p + sl > end) goto done;
+        char s[256];
+        memcpy(s, p, sl);
+        s[sl] = 0;
+        p += sl;
+        n = FormatArg(o, oend - o, sf, spec.stars, sv, (const char*) s);
+        break;
+        }
+      default:
+        goto done;
+      }
+    if (n > 0)
+      o += ((size_t)n < (size_t)(oend - o)) ? n : (oend - 1 - o);
+    }
+
+done:
+  return o - buf;
+  }
+
+
+/**
+ * LogRecorder
+ *
+ * Entry layout: uint16_t length (0xffff = padding to end of buffer), uint16_t
+ * reserved, uint32_t sequence number, record data, aligned to 4 bytes.
+ */
+#define LOGRECORDER_HDRSIZE     8
+#define LOGRECORDER_PAD         0xffff
+#define LOGRECORDER_ALIGN(len)  (((len) + 3) & ~3U)
+
+LogRecorder::LogRecorder()
+  : m_buffer(NULL), m_size(0), m_mask(0), m_head(0), m_tail(0), m_first_seq(0), m_next_seq(0)
+  {
+  vPortCPUInitializeMutex(&m_lock);
+  }
+
+LogRecorder::~LogRecorder()
+  {
+  if (m_buffer)
+    free(m_buffer);
+  }
+
+bool LogRecorder::Init(size_t size)
+  {
+  if (m_buffer)
+    return true;
+  uint32_t sz = 1024;
+  while (sz < size)
+    sz <<= 1;
+  uint8_t* buffer = (uint8_t*) ExternalRamMalloc(sz);
+  if (!buffer)
+    return false;
+  m_size = sz;
+  m_mask = sz - 1;
+  m_buffer = buffer;
+  return true;
+  }
+
+// Evict: remove oldest entry (called with lock held)
+void LogRecorder::Evict()
+  {
+  uint16_t len;
+  memcpy(&len, m_buffer + (m_tail & m_mask), 2);
+  if (len == LOGRECORDER_PAD)
+    {
+    m_tail += m_size - (m_tail & m_mask);
+    }
+  else
+    {
+    m_tail += LOGRECORDER_HDRSIZE + LOGRECORDER_ALIGN(len);
+    m_first_seq++;
+    }
+  }
+
+void LogRecorder::Put(const uint8_t* rec, size_t len)
+  {
+  if (!m_buffer || len == 0 || len > LOGRECORD_MAXSIZE)
+    return;
+  uint32_t need = LOGRECORDER_HDRSIZE + LOGRECORDER_ALIGN(len);
+  uint16_t len16 = len;
+
+  portENTER_CRITICAL(&m_lock);
+  uint32_t pos = m_head & m_mask;
+  uint32_t pad = (pos + need > m_size) ? m_size - pos : 0;
+  while (m_head + pad + need - m_tail > m_size)
+    Evict();
+  if (pad)
+    {
+    uint16_t marker = LOGRECORDER_PAD;
+    memcpy(m_buffer + pos, &marker, 2);
+    m_head += pad;
+    pos = 0;
+    }
+  memcpy(m_buffer + pos, &len16, 2);
+  memcpy(m_buffer + pos + 4, &m_next_seq, 4);
+  memcpy(m_buffer + pos + LOGRECORDER_HDRSIZE, rec, len);
+  m_head += need;
+  m_next_seq++;
+  portEXIT_CRITICAL(&m_lock);
+  }
+
+/**
+ * Seek: advance cursor by one entry towards cursor.seq
+ *  Returns false when the cursor points to the record or the buffer end.
+ *  The lock is held per entry only, so writers are not blocked by a scan.
+ */
+bool LogRecorder::Seek(cursor_t& cursor)
+  {
+  bool more = false;
+  portENTER_CRITICAL(&m_lock);
+  if (cursor.seq < m_first_seq || (int32_t)(cursor.pos - m_tail) < 0)
+    {
+    // records overwritten while seeking, continue with oldest:
+    cursor.seq = m_first_seq;
+    cursor.pos = m_tail;
+    }
+  else if (cursor.pos != m_head)
+    {
+    uint8_t* entry = m_buffer + (cursor.pos & m_mask);
+    uint16_t elen;
+    uint32_t eseq;
+    memcpy(&elen, entry, 2);
+    memcpy(&eseq, entry + 4, 4);
+    if (elen == LOGRECORDER_PAD)
+      {
+      cursor.pos += m_size - (cursor.pos & m_mask);
+      more = true;
+      }
+    else if (eseq < cursor.seq)
+      {
+      cursor.pos += LOGRECORDER_HDRSIZE + LOGRECORDER_ALIGN(elen);
+      more = true;
+      }
+    }
+  portEXIT_CRITICAL(&m_lock);
+  return more;
+  }
+
+/**
+ * Cursor: get read cursor for the last count records
+ */
+LogRecorder::cursor_t LogRecorder::Cursor(uint32_t count)
+  {
+  cursor_t cursor;
+  portENTER_CRITICAL(&m_lock);
+  if (count < m_next_seq - m_first_seq)
+    {
+    cursor.seq = m_next_seq - count;
+    cursor.pos = (count == 0) ? m_head : m_tail;
+    }
+  else
+    {
+    cursor.seq = m_first_seq;
+    cursor.pos = m_tail;
+    }
+  portEXIT_CRITICAL(&m_lock);
+  while (Seek(cursor))
+    ;
+  return cursor;
+  }
+
+/**
+ * Read: copy next record at/after cursor into rec, advance cursor
+ *  Returns the record size, 0 if no record available.
+ *  The cursor position normally points to the record (see Cursor()), so
+ *  this only skips a padding entry.
+ */
+size_t LogRecorder::Read(cursor_t& cursor, uint8_t* rec, size_t size)
+  {
+  size_t len = 0;
+  portENTER_CRITICAL(&m_lock);
+  if (cursor.seq < m_first_seq || (int32_t)(cursor.pos - m_tail) < 0)
+    {
+    // records overwritten, continue with oldest:
+    cursor.seq = m_first_seq;
+    cursor.pos = m_tail;
+    }
+  uint32_t pos = cursor.pos;
+  while (pos != m_head)
+    {
+    uint8_t* entry = m_buffer + (pos & m_mask);
+    uint16_t elen;
+    uint32_t eseq;
+    memcpy(&elen, entry, 2);
+    if (elen == LOGRECORDER_PAD)
+      {
+      pos += m_size - (pos & m_mask);
+      continue;
+      }
+    memcpy(&eseq, entry + 4, 4);
+    pos += LOGRECORDER_HDRSIZE + LOGRECORDER_ALIGN(elen);
+    if (eseq < cursor.seq)
+      continue;
+    len = (elen <= size) ? elen : 0;
+    memcpy(rec, entry + LOGRECORDER_HDRSIZE, len);
+    cursor.seq = eseq + 1;
+    break;
+    }
+  cursor.pos = pos;
+  portEXIT_CRITICAL(&m_lock);
+  return len;
+  }
+
+void LogRecorder::Clear()
+  {
+  portENTER_CRITICAL(&m_lock);
+  m_tail = m_head;
+  m_first_seq = m_next_seq;
+  portEXIT_CRITICAL(&m_lock);
+  }
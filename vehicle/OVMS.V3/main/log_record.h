@@ -0,0 +1,126 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Binary log records with deferred formatting
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+#ifndef __LOG_RECORD_H__
+#define __LOG_RECORD_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include "freertos/FreeRTOS.h"
+
+/**
+ * Binary log records
+ *
+ *  A log record holds the format string pointer plus the raw printf arguments
+ *  of a log call, so the expensive text formatting can be deferred until (and
+ *  unless) a reader needs the text. Format strings located in flash (DROM) are
+ *  referenced by pointer, others are copied into the record. String arguments
+ *  are always copied (max 255 chars each).
+ *
+ *  Record layout (packed, native byte order):
+ *    uint8_t   magic         LOGRECORD_MAGIC (0, cannot start a text log line)
+ *    uint8_t   flags         LOGRECORD_FMT_INLINE / LOGRECORD_TEXT
+ *    uint16_t  size          total record size
+ *    fmt       const char* or inline NUL terminated string
+ *    args      int: 4/8 bytes, double: 8 bytes, string: uint8_t length + chars
+ *
+ *  LogRecordPack() returns 0 if the format cannot be packed (unsupported
+ *  conversion or record too large), the caller then needs to log as text.
+ */
+
+#define LOGRECORD_MAXSIZE       256
+#define LOGRECORD_TEXTSIZE      512     // formatting buffer size (text is truncated to fit)
+#define LOGRECORD_MAGIC         0x00
+#define LOGRECORD_FMT_INLINE    0x01    // format string copied into the record
+#define LOGRECORD_TEXT          0x02    // preformatted text, no arguments
+
+extern size_t LogRecordPack(uint8_t* rec, size_t size, const char* fmt, va_list args);
+extern size_t LogRecordPackText(uint8_t* rec, size_t size, const char* text);
+extern int LogRecordFormat(char* buf, size_t size, const uint8_t* rec, size_t len);
+
+inline bool IsLogRecord(const void* data, size_t len)
+  {
+  return len >= 4 && ((const uint8_t*)data)[0] == LOGRECORD_MAGIC;
+  }
+
+
+/**
+ * LogRecorder: in memory log record history
+ *
+ *  Circular buffer keeping the most recent log records, the oldest records
+ *  are overwritten. Records are numbered by a sequence counter, readers keep
+ *  their own cursor and format the records on demand:
+ *
+ *    LogRecorder::cursor_t cur = recorder.Cursor(100);   // last 100 records
+ *    uint8_t rec[LOGRECORD_MAXSIZE];
+ *    size_t len;
+ *    while ((len = recorder.Read(cur, rec, sizeof(rec))) > 0)
+ *      LogRecordFormat(buf, sizeof(buf), rec, len);
+ *
+ *  Access is serialized by a spinlock held only for copying a record.
+ */
+class LogRecorder
+  {
+  public:
+    typedef struct
+      {
+      uint32_t seq;                           // next record to read
+      uint32_t pos;                           // position hint
+      } cursor_t;
+
+  public:
+    LogRecorder();
+    ~LogRecorder();
+
+  public:
+    bool Init(size_t size);
+    bool IsInitialized() { return m_buffer != NULL; }
+    void Put(const uint8_t* rec, size_t len);
+    cursor_t Cursor(uint32_t count);
+    size_t Read(cursor_t& cursor, uint8_t* rec, size_t size);
+    void Clear();
+
+  public:
+    size_t GetSize() { return m_size; }
+    uint32_t GetCount() { return m_next_seq - m_first_seq; }
+    uint32_t GetTotal() { return m_next_seq; }
+
+  protected:
+    void Evict();
+    bool Seek(cursor_t& cursor);
+
+  protected:
+    portMUX_TYPE m_lock;
+    uint8_t* m_buffer;
+    uint32_t m_size;                          // power of 2
+    uint32_t m_mask;
+    uint32_t m_head;                          // write position (monotonic)
+    uint32_t m_tail;                          // oldest entry position (monotonic)
+    uint32_t m_first_seq;                     // sequence number of oldest entry
+    uint32_t m_next_seq;                      // sequence number of next entry
+  };
+
+#endif //#ifndef __LOG_RECORD_H__
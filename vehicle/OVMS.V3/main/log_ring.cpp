@@ -0,0 +1,162 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Lock-free log record ring
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "ovms_malloc.h"
+#include "log_ring.h"
+
+// Record header: 32 bit word, written atomically
+#define LOGRING_COMMIT        0x80000000U   // record complete
+#define LOGRING_PAD           0x40000000U   // padding to end of buffer, skip
+#define LOGRING_LENMASK       0x3fffffffU
+#define LOGRING_HDRSIZE       sizeof(uint32_t)
+#define LOGRING_ALIGN(len)    (((len) + 3) & ~3U)
+
+LogRing::LogRing()
+  : m_buffer(NULL), m_size(0), m_mask(0), m_head(0), m_tail(0), m_current(0),
+    m_maxused(0), m_dropped_records(0), m_dropped_bytes(0)
+  {
+  }
+
+LogRing::~LogRing()
+  {
+  if (m_buffer)
+    free(m_buffer);
+  }
+
+/**
+ * Init: allocate the buffer (SPIRAM if available), size is rounded up to a power of 2
+ */
+bool LogRing::Init(size_t size)
+  {
+  if (m_buffer)
+    return true;
+  uint32_t sz = 256;
+  while (sz < size)
+    sz <<= 1;
+  char* buffer = (char*) ExternalRamCalloc(1, sz);
+  if (!buffer)
+    return false;
+  m_size = sz;
+  m_mask = sz - 1;
+  m_head = m_tail = 0;
+  m_buffer = buffer;
+  return true;
+  }
+
+bool LogRing::Put(const char* data, size_t len)
+  {
+  uint32_t need = LOGRING_HDRSIZE + LOGRING_ALIGN(len);
+  if (!m_buffer || need > m_size / 2)
+    {
+    m_dropped_records++;
+    m_dropped_bytes += len;
+    return false;
+    }
+
+  // reserve space:
+  uint32_t head = m_head.load(std::memory_order_relaxed);
+  uint32_t pos, pad, next;
+  do
+    {
+    pos = head & m_mask;
+    pad = (pos + need > m_size) ? m_size - pos : 0;
+    next = head + pad + need;
+    if (next - m_tail.load(std::memory_order_acquire) > m_size)
+      {
+      m_dropped_records++;
+      m_dropped_bytes += len;
+      return false;
+      }
+    } while (!m_head.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+  // track usage:
+  uint32_t used = next - m_tail.load(std::memory_order_relaxed);
+  uint32_t maxused = m_maxused.load(std::memory_order_relaxed);
+  while (used > maxused && !m_maxused.compare_exchange_weak(maxused, used, std::memory_order_relaxed))
+    ;
+
+  // fill & commit:
+  if (pad)
+    {
+    __atomic_store_n((uint32_t*)(m_buffer + pos), LOGRING_COMMIT | LOGRING_PAD | pad, __ATOMIC_RELEASE);
+    pos = 0;
+    }
+  memcpy(m_buffer + pos + LOGRING_HDRSIZE, data, len);
+  __atomic_store_n((uint32_t*)(m_buffer + pos), LOGRING_COMMIT | len, __ATOMIC_RELEASE);
+  return true;
+  }
+
+/**
+ * Peek: get next committed record, NULL if none available
+ */
+const char* LogRing::Peek(size_t* len)
+  {
+  if (!m_buffer)
+    return NULL;
+  uint32_t tail = m_tail.load(std::memory_order_relaxed);
+  while (tail != m_head.load(std::memory_order_acquire))
+    {
+    uint32_t* hdr = (uint32_t*)(m_buffer + (tail & m_mask));
+    uint32_t h = __atomic_load_n(hdr, __ATOMIC_ACQUIRE);
+    if (!(h & LOGRING_COMMIT))
+      return NULL;
+    if (h & LOGRING_PAD)
+      {
+      // skip & free padding:
+      uint32_t pad = h & LOGRING_LENMASK;
+      memset(hdr, 0, pad);
+      tail += pad;
+      m_tail.store(tail, std::memory_order_release);
+      continue;
+      }
+    *len = h & LOGRING_LENMASK;
+    m_current = LOGRING_HDRSIZE + LOGRING_ALIGN(*len);
+    return (const char*)(hdr + 1);
+    }
+  return NULL;
+  }
+
+/**
+ * Release: free the record returned by Peek()
+ */
+void LogRing::Release()
+  {
+  if (!m_current)
+    return;
+  uint32_t tail = m_tail.load(std::memory_order_relaxed);
+  memset(m_buffer + (tail & m_mask), 0, m_current);
+  m_tail.store(tail + m_current, std::memory_order_release);
+  m_current = 0;
+  }
+
+void LogRing::ResetStats()
+  {
+  m_maxused = UsedSpace();
+  m_dropped_records = 0;
+  m_dropped_bytes = 0;
+  }
@@ -0,0 +1,93 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Lock-free log record ring
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+#ifndef __LOG_RING_H__
+#define __LOG_RING_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/**
+ * LogRing: lock-free multiple producer / single consumer record ring
+ *
+ *  Passes variable length records (log lines) from any number of tasks to a
+ *  single consumer (the log file writer) without blocking the producers.
+ *  Producers reserve space by an atomic compare & swap on the head position,
+ *  copy their data and then commit the record by writing its header. If the
+ *  ring is full, the record is dropped and counted.
+ *
+ *  The consumer reads committed records in order. A record reserved but not
+ *  yet committed (i.e. producer preempted while copying) stops the consumer
+ *  until it has been committed. Consumed space is zeroed, so stale data can
+ *  never be mistaken for a committed header.
+ *
+ *  Consumer:
+ *    const char* data; size_t len;
+ *    while ((data = ring.Peek(&len)) != NULL) { … process data …; ring.Release(); }
+ *
+ *  Only one consumer may be active at a time (serialize by a mutex if needed).
+ */
+class LogRing
+  {
+  public:
+    LogRing();
+    ~LogRing();
+
+  public:
+    bool Init(size_t size);
+    bool IsInitialized() { return m_buffer != NULL; }
+
+  public:
+    // Producer API:
+    bool Put(const char* data, size_t len);
+
+  public:
+    // Consumer API:
+    const char* Peek(size_t* len);
+    void Release();
+
+  public:
+    // Status (approximate if called concurrently):
+    size_t GetSize() { return m_size; }
+    size_t UsedSpace() { return m_head.load() - m_tail.load(); }
+    size_t MaxUsedSpace() { return m_maxused.load(); }
+    uint32_t GetDroppedRecords() { return m_dropped_records.load(); }
+    uint32_t GetDroppedBytes() { return m_dropped_bytes.load(); }
+    void ResetStats();
+
+  protected:
+    char* m_buffer;
+    uint32_t m_size;                          // power of 2
+    uint32_t m_mask;
+    std::atomic<uint32_t> m_head;             // next reservation position
+    std::atomic<uint32_t> m_tail;             // next read position
+    uint32_t m_current;                       // size of record returned by Peek()
+    std::atomic<uint32_t> m_maxused;
+    std::atomic<uint32_t> m_dropped_records;
+    std::atomic<uint32_t> m_dropped_bytes;
+  };
+
+#endif //#ifndef __LOG_RING_H__
@@ -94,16 +94,16 @@ MetricsStandard::MetricsStandard()
   ms_v_bat_pack_tstddev = new OvmsMetricFloat(MS_V_BAT_PACK_TSTDDEV, SM_STALE_HIGH, Celcius);
   ms_v_bat_pack_tstddev_max = new OvmsMetricFloat(MS_V_BAT_PACK_TSTDDEVMAX, SM_STALE_HIGH, Celcius);
 
-  ms_v_bat_cell_voltage = new OvmsMetricVector<float>(MS_V_BAT_CELL_VOLTAGE, SM_STALE_HIGH, Volts);
-  ms_v_bat_cell_vmin = new OvmsMetricVector<float>(MS_V_BAT_CELL_VMIN, SM_STALE_HIGH, Volts);
-  ms_v_bat_cell_vmax = new OvmsMetricVector<float>(MS_V_BAT_CELL_VMAX, SM_STALE_HIGH, Volts);
-  ms_v_bat_cell_vdevmax = new OvmsMetricVector<float>(MS_V_BAT_CELL_VDEVMAX, SM_STALE_HIGH, Volts);
+  ms_v_bat_cell_voltage = new OvmsMetricFixedVector<uint16_t,3>(MS_V_BAT_CELL_VOLTAGE, SM_STALE_HIGH, Volts);
+  ms_v_bat_cell_vmin = new OvmsMetricFixedVector<uint16_t,3>(MS_V_BAT_CELL_VMIN, SM_STALE_HIGH, Volts);
+  ms_v_bat_cell_vmax = new OvmsMetricFixedVector<uint16_t,3>(MS_V_BAT_CELL_VMAX, SM_STALE_HIGH, Volts);
+  ms_v_bat_cell_vdevmax = new OvmsMetricFixedVector<int16_t,4>(MS_V_BAT_CELL_VDEVMAX, SM_STALE_HIGH, Volts);
   ms_v_bat_cell_valert = new OvmsMetricVector<short>(MS_V_BAT_CELL_VALERT, SM_STALE_HIGH, Other);
   
-  ms_v_bat_cell_temp = new OvmsMetricVector<float>(MS_V_BAT_CELL_TEMP, SM_STALE_HIGH, Celcius);
-  ms_v_bat_cell_tmin = new OvmsMetricVector<float>(MS_V_BAT_CELL_TMIN, SM_STALE_HIGH, Celcius);
-  ms_v_bat_cell_tmax = new OvmsMetricVector<float>(MS_V_BAT_CELL_TMAX, SM_STALE_HIGH, Celcius);
-  ms_v_bat_cell_tdevmax = new OvmsMetricVector<float>(MS_V_BAT_CELL_TDEVMAX, SM_STALE_HIGH, Celcius);
+  ms_v_bat_cell_temp = new OvmsMetricFixedVector<int16_t,2>(MS_V_BAT_CELL_TEMP, SM_STALE_HIGH, Celcius);
+  ms_v_bat_cell_tmin = new OvmsMetricFixedVector<int16_t,2>(MS_V_BAT_CELL_TMIN, SM_STALE_HIGH, Celcius);
+  ms_v_bat_cell_tmax = new OvmsMetricFixedVector<int16_t,2>(MS_V_BAT_CELL_TMAX, SM_STALE_HIGH, Celcius);
+  ms_v_bat_cell_tdevmax = new OvmsMetricFixedVector<int16_t,2>(MS_V_BAT_CELL_TDEVMAX, SM_STALE_HIGH, Celcius);
   ms_v_bat_cell_talert = new OvmsMetricVector<short>(MS_V_BAT_CELL_TALERT, SM_STALE_HIGH, Other);
 
   ms_v_charge_voltage = new OvmsMetricFloat(MS_V_CHARGE_VOLTAGE, SM_STALE_MID, Volts);
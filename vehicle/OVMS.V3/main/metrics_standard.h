@@ -256,17 +256,18 @@ class MetricsStandard
     OvmsMetricFloat*  ms_v_bat_pack_tstddev;              // Cell temperature - current standard deviation [°C]
     OvmsMetricFloat*  ms_v_bat_pack_tstddev_max;          // Cell temperature - maximum standard deviation observed [°C]
 
-    OvmsMetricVector<float>* ms_v_bat_cell_voltage;       // Cell voltages [V]
-    OvmsMetricVector<float>* ms_v_bat_cell_vmin;          // Cell minimum voltages [V]
-    OvmsMetricVector<float>* ms_v_bat_cell_vmax;          // Cell maximum voltages [V]
-    OvmsMetricVector<float>* ms_v_bat_cell_vdevmax;       // Cell maximum voltage deviation observed [V]
-    OvmsMetricVector<short>* ms_v_bat_cell_valert;        // Cell voltage deviation alert level [0=normal, 1=warning, 2=alert]
-
-    OvmsMetricVector<float>* ms_v_bat_cell_temp;          // Cell temperatures [°C]
-    OvmsMetricVector<float>* ms_v_bat_cell_tmin;          // Cell minimum temperatures [°C]
-    OvmsMetricVector<float>* ms_v_bat_cell_tmax;          // Cell maximum temperatures [°C]
-    OvmsMetricVector<float>* ms_v_bat_cell_tdevmax;       // Cell maximum temperature deviation observed [°C]
-    OvmsMetricVector<short>* ms_v_bat_cell_talert;        // Cell temperature deviation alert level [0=normal, 1=warning, 2=alert]
+    // Cell vectors are stored as fixed point, values outside the ranges noted are saturated:
+    OvmsMetricFixedVector<uint16_t,3>* ms_v_bat_cell_voltage;  // Cell voltages [V] (0 … 65.535)
+    OvmsMetricFixedVector<uint16_t,3>* ms_v_bat_cell_vmin;     // Cell minimum voltages [V] (0 … 65.535)
+    OvmsMetricFixedVector<uint16_t,3>* ms_v_bat_cell_vmax;     // Cell maximum voltages [V] (0 … 65.535)
+    OvmsMetricFixedVector<int16_t,4>* ms_v_bat_cell_vdevmax;   // Cell maximum voltage deviation observed [V] (±3.2767)
+    OvmsMetricVector<short>* ms_v_bat_cell_valert;             // Cell voltage deviation alert level [0=normal, 1=warning, 2=alert]
+
+    OvmsMetricFixedVector<int16_t,2>* ms_v_bat_cell_temp;      // Cell temperatures [°C] (±327.67)
+    OvmsMetricFixedVector<int16_t,2>* ms_v_bat_cell_tmin;      // Cell minimum temperatures [°C] (±327.67)
+    OvmsMetricFixedVector<int16_t,2>* ms_v_bat_cell_tmax;      // Cell maximum temperatures [°C] (±327.67)
+    OvmsMetricFixedVector<int16_t,2>* ms_v_bat_cell_tdevmax;   // Cell maximum temperature deviation observed [°C] (±327.67)
+    OvmsMetricVector<short>* ms_v_bat_cell_talert;             // Cell temperature deviation alert level [0=normal, 1=warning, 2=alert]
 
     OvmsMetricFloat*  ms_v_charge_voltage;          // Momentary charger supply voltage [V]
     OvmsMetricFloat*  ms_v_charge_current;          // Momentary charger output current [A]
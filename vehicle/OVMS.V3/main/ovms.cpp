@@ -57,6 +57,16 @@ static void* ExternalRamAllocated::operator new[](std::size_t sz)
   return ExternalRamMalloc(sz);
   }
 
+void ExternalRamAllocated::operator delete(void* ptr)
+  {
+  free(ptr);
+  }
+
+void ExternalRamAllocated::operator delete[](void* ptr)
+  {
+  free(ptr);
+  }
+
 char* ExternalRamAllocated::strdup(const char* src)
   {
   if (!src)
@@ -119,6 +129,16 @@ static void* InternalRamAllocated::operator new[](std::size_t sz)
   return InternalRamMalloc(sz);
   }
 
+void InternalRamAllocated::operator delete(void* ptr)
+  {
+  free(ptr);
+  }
+
+void InternalRamAllocated::operator delete[](void* ptr)
+  {
+  free(ptr);
+  }
+
 char* InternalRamAllocated::strdup(const char* src)
   {
   if (!src)
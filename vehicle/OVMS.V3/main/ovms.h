@@ -48,6 +48,8 @@ class ExternalRamAllocated
   public:
     static void* operator new(std::size_t sz);
     static void* operator new[](std::size_t sz);
+    static void operator delete(void* ptr);
+    static void operator delete[](void* ptr);
     static char* strdup(const char* src);
     static int asprintf(char** strp, const char* fmt, ...);
     static int vasprintf(char** strp, const char* fmt, va_list ap);
@@ -58,6 +60,8 @@ class InternalRamAllocated
   public:
     static void* operator new(std::size_t sz);
     static void* operator new[](std::size_t sz);
+    static void operator delete(void* ptr);
+    static void operator delete[](void* ptr);
     static char* strdup(const char* src);
     static int asprintf(char** strp, const char* fmt, ...);
     static int vasprintf(char** strp, const char* fmt, va_list ap);
@@ -145,10 +145,35 @@ size_t OvmsBuffer::Peek(size_t count, uint8_t *dest)
   return done;
   }
 
+/**
+ * PeekSpan: get the contiguous readable data at the tail (zero copy)
+ *  Returns the span length; the data remains in the buffer until Skip()ed.
+ *  If the data wraps around the buffer end, call again after Skip() to
+ *  get the remainder.
+ */
+size_t OvmsBuffer::PeekSpan(uint8_t **data)
+  {
+  *data = m_buffer + m_tail;
+  if (m_used==0) return 0;
+  size_t span = m_size - m_tail;
+  return (span < m_used) ? span : m_used;
+  }
+
+size_t OvmsBuffer::Skip(size_t count)
+  {
+  if (count > m_used) count = m_used;
+
+  m_used -= count;
+  m_tail += count;
+  if (m_tail >= m_size) m_tail -= m_size;
+
+  return count;
+  }
+
 void OvmsBuffer::Diagnostics()
   {
-  size_t hl = HasLine();
-  ESP_LOGI(TAG, "OvmsBuffer has %d/%d bytes (head %d, tail %d), hasline %d",
+  int hl = HasLine();
+  ESP_LOGI(TAG, "OvmsBuffer has %zu/%zu bytes (head %zu, tail %zu), hasline %d",
     m_used,m_size,m_head,m_tail,hl);
   }
 
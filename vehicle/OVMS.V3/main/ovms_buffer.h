@@ -53,6 +53,8 @@ class OvmsBuffer
     size_t Pop(size_t count, uint8_t *dest);
     uint8_t Peek();
     size_t Peek(size_t count, uint8_t *dest);
+    size_t PeekSpan(uint8_t **data);
+    size_t Skip(size_t count);
     void Diagnostics();
 
   public:
@@ -67,8 +69,8 @@ class OvmsBuffer
 
   protected:
     uint8_t *m_buffer;
-    int m_head;
-    int m_tail;
+    size_t m_head;
+    size_t m_tail;
     size_t m_size;
     size_t m_used;
   };
@@ -38,6 +38,7 @@ static const char *TAG = "command";
 #include <functional>
 #include <esp_log.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <dirent.h>
 #include "freertos/FreeRTOS.h"
 #include "ovms_command.h"
@@ -49,6 +50,9 @@ static const char *TAG = "command";
 #include "buffered_shell.h"
 #include "log_buffers.h"
 
+#define LOGFILE_WRITER_INTERVAL   250     // ms, max delay of log file writes
+#define LOGFILE_STDIO_BUFSIZE     4096    // bytes, file write batch size
+
 OvmsCommandApp MyCommandApp __attribute__ ((init_priority (1000)));
 
 bool CompareCharPtr::operator()(const char* a, const char* b)
@@ -106,7 +110,7 @@ void OvmsWriter::SetSecure(bool secure)
 
 OvmsCommand* OvmsCommandMap::FindUniquePrefix(const char* key)
   {
-  int len = strlen(key);
+  size_t len = strlen(key);
   OvmsCommand* found = NULL;
   for (iterator it = begin(); it != end(); ++it)
     {
@@ -455,6 +459,23 @@ void log_expire(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, c
 static OvmsCommand* monitor;
 static OvmsCommand* monitor_yes;
 
+void log_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (strcmp(cmd->GetName(), "reset") == 0)
+    {
+    MyCommandApp.ResetLogStatus();
+    writer->puts("Log statistics reset");
+    return;
+    }
+  MyCommandApp.ShowLogStatus(verbosity, writer);
+  }
+
+void log_show(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  uint32_t count = (argc > 0) ? atoi(argv[0]) : 20;
+  MyCommandApp.ShowLogRecords(verbosity, writer, count);
+  }
+
 void log_monitor(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   bool state;
@@ -541,7 +562,15 @@ OvmsCommandApp::OvmsCommandApp()
   m_logfile_path = "";
   m_logfile_size = 0;
   m_logfile_maxsize = 0;
+  m_logfile_syncperiod = 3;
+  m_logfile_synctime = 0;
+  m_logfile_dirty = false;
+  m_logfile_dropped = 0;
+  m_logfile_writes = 0;
+  m_logfile_syncs = 0;
+  m_logstructured = false;
   m_expiretask = 0;
+  m_logtask = 0;
 
   m_root.RegisterCommand("help", "Ask for help", help, "", 0, 0);
   m_root.RegisterCommand("exit", "End console session", Exit , "", 0, 0);
@@ -549,6 +578,10 @@ OvmsCommandApp::OvmsCommandApp()
   cmd_log->RegisterCommand("file", "Start logging to specified file", log_file , "<vfspath>", 0, 1, true);
   cmd_log->RegisterCommand("close", "Stop logging to file", log_file , "", 0, 0, true);
   cmd_log->RegisterCommand("expire", "Expire old log files", log_expire, "[<keepdays>]", 0, 1, true);
+  OvmsCommand* cmd_status = cmd_log->RegisterCommand("status", "Show log file status", log_status, "[reset]", 0, 1, true);
+  cmd_status->RegisterCommand("reset", "Reset log statistics", log_status, "", 0, 0, true);
+  cmd_log->RegisterCommand("show", "Show recorded log (structured mode)", log_show, "[<count>]\n"
+    "Default: last 20 records", 0, 1, true);
   OvmsCommand* level_cmd = cmd_log->RegisterCommand("level", "Set logging level", NULL, "$C [<tag>]");
   level_cmd->RegisterCommand("verbose", "Log at the VERBOSE level (5)", log_level , "[<tag>]", 0, 1, true);
   level_cmd->RegisterCommand("debug", "Log at the DEBUG level (4)", log_level , "[<tag>]", 0, 1, true);
@@ -577,6 +610,17 @@ void OvmsCommandApp::ConfigureLogging()
   MyEvents.RegisterEvent(TAG, "sd.mounted", std::bind(&OvmsCommandApp::EventHandler, this, _1, _2));
   MyEvents.RegisterEvent(TAG, "sd.unmounting", std::bind(&OvmsCommandApp::EventHandler, this, _1, _2));
   MyEvents.RegisterEvent(TAG, "ticker.3600", std::bind(&OvmsCommandApp::EventHandler, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "system.shuttingdown", std::bind(&OvmsCommandApp::EventHandler, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "system.shutdown", std::bind(&OvmsCommandApp::EventHandler, this, _1, _2));
+
+  // start log file writer:
+  if (!m_logring.Init(CONFIG_OVMS_SYS_LOGFILE_RING_SIZE))
+    ESP_LOGE(TAG, "ConfigureLogging: cannot allocate log file ring buffer");
+  xTaskCreatePinnedToCore(LogfileTask, "OVMS LogFile", 4096, this, 1, &m_logtask, 1);
+
+  // log record history for structured mode:
+  if (!m_recorder.Init(CONFIG_OVMS_SYS_LOGRECORDER_SIZE))
+    ESP_LOGE(TAG, "ConfigureLogging: cannot allocate log recorder buffer");
 
   ReadConfig();
   }
@@ -623,13 +667,42 @@ int OvmsCommandApp::Log(const char* fmt, va_list args)
   TaskHandle_t task = xTaskGetCurrentTaskHandle();
   PartialLogs::iterator it = m_partials.find(task);
   if (it == m_partials.end())
+    {
+    if (m_logstructured)
+      {
+      // Structured mode: record format & arguments, only format the text
+      // if a console currently wants to see it:
+      uint8_t rec[LOGRECORD_MAXSIZE];
+      va_list recargs;
+      va_copy(recargs, args);
+      size_t len = LogRecordPack(rec, sizeof(rec), fmt, recargs);
+      va_end(recargs);
+      if (len)
+        {
+        m_recorder.Put(rec, len);
+        QueueLogfile((const char*) rec, len);
+        if (!ConsolesWantLog())
+          return len;
+        lb = new LogBuffers();
+        int ret = LogBuffer(lb, fmt, args, false);
+        lb->set(m_consoles.size());
+        for (ConsoleSet::iterator it = m_consoles.begin(); it != m_consoles.end(); ++it)
+          {
+          (*it)->Log(lb);
+          }
+        return ret;
+        }
+      }
     lb = new LogBuffers();
+    }
   else
     {
     lb = it->second;
     m_partials.erase(task);
     }
   int ret = LogBuffer(lb, fmt, args);
+  if (m_logstructured)
+    RecordText(lb);
   lb->set(m_consoles.size());
   for (ConsoleSet::iterator it = m_consoles.begin(); it != m_consoles.end(); ++it)
     {
@@ -659,14 +732,12 @@ int OvmsCommandApp::LogPartial(const char* fmt, ...)
   return ret;
   }
 
-int OvmsCommandApp::LogBuffer(LogBuffers* lb, const char* fmt, va_list args)
+/**
+ * NormalizeLogText: replace CR/LF except last by "|", but don't leave '|' at the end.
+ *  An ESC sequence to change color may be appended after the log text.
+ */
+static void NormalizeLogText(char* buffer)
   {
-  char *buffer;
-  int ret = vasprintf(&buffer, fmt, args);
-  if (ret < 0) return ret;
-
-  // Replace CR/LF except last by "|", but don't leave '|' at the end.
-  // An ESC sequence to change color may be appended after the log text.
   char* s;
   for (s=buffer; *s; s++)
     {
@@ -686,28 +757,67 @@ int OvmsCommandApp::LogBuffer(LogBuffers* lb, const char* fmt, va_list args)
       break;
       }
     }
+  }
 
-  if (m_logfile)
-    {
-    // Log to the log file as well...
-    // We need to protect this with a mutex lock, as fsync appears to NOT be thread safe
-    // https://github.com/espressif/esp-idf/issues/1837
-    OvmsMutexLock fsynclock(&m_fsync_mutex);
-    m_logfile_size += fwrite(buffer,1,strlen(buffer),m_logfile);
-    if (m_logfile_maxsize && m_logfile_size > (m_logfile_maxsize*1024))
-      {
-      CycleLogfile();
-      }
-    else
-      {
-      fflush(m_logfile);
-      fsync(fileno(m_logfile));
-      }
-    }
+int OvmsCommandApp::LogBuffer(LogBuffers* lb, const char* fmt, va_list args, bool tofile /*=true*/)
+  {
+  char *buffer;
+  int ret = vasprintf(&buffer, fmt, args);
+  if (ret < 0) return ret;
+
+  NormalizeLogText(buffer);
+
+  if (tofile)
+    QueueLogfile(buffer, strlen(buffer));
   lb->append(buffer);
   return ret;
   }
 
+/**
+ * QueueLogfile: queue text line or log record for the log file writer task
+ *  The writer is woken up early if the ring fills up. Lines are dropped (and
+ *  counted) if the writer cannot keep up.
+ */
+void OvmsCommandApp::QueueLogfile(const char* data, size_t len)
+  {
+  if (!m_logfile || !m_logtask)
+    return;
+  m_logring.Put(data, len);
+  if (m_logring.UsedSpace() > m_logring.GetSize() / 2)
+    xTaskNotifyGive(m_logtask);
+  }
+
+bool OvmsCommandApp::ConsolesWantLog()
+  {
+  for (ConsoleSet::iterator it = m_consoles.begin(); it != m_consoles.end(); ++it)
+    {
+    if ((*it)->WantsLog())
+      return true;
+    }
+  return false;
+  }
+
+/**
+ * RecordText: add preformatted log text to the recorder (structured mode fallback)
+ */
+void OvmsCommandApp::RecordText(LogBuffers* lb)
+  {
+  char text[LOGRECORD_MAXSIZE];
+  size_t len = 0;
+  for (LogBuffers::iterator it = lb->begin(); it != lb->end() && len < sizeof(text)-1; ++it)
+    {
+    size_t n = strlen(*it);
+    if (n > sizeof(text)-1 - len)
+      n = sizeof(text)-1 - len;
+    memcpy(text + len, *it, n);
+    len += n;
+    }
+  text[len] = 0;
+  uint8_t rec[LOGRECORD_MAXSIZE];
+  len = LogRecordPackText(rec, sizeof(rec), text);
+  m_recorder.Put(rec, len);
+  }
+
 int OvmsCommandApp::HexDump(const char* tag, const char* prefix, const char* data, size_t length, size_t colsize /*=16*/)
   {
   char* buffer = NULL;
@@ -744,46 +854,197 @@ void OvmsCommandApp::Execute(int verbosity, OvmsWriter* writer, int argc, const
 
 bool OvmsCommandApp::SetLogfile(std::string path)
   {
+  OvmsMutexLock lock(&m_logfile_mutex);
   // close old file:
   if (m_logfile)
     {
-    fclose(m_logfile);
-    m_logfile = NULL;
+    FlushLogfile();
+    CloseLogfile();
     ESP_LOGI(TAG, "SetLogfile: file logging stopped");
     }
   // open new file:
   if (!path.empty())
+    return OpenLogfile(path);
+  return true;
+  }
+
+bool OvmsCommandApp::OpenLogfile(std::string path)
+  {
+  if (MyConfig.ProtectedPath(path))
     {
-    if (MyConfig.ProtectedPath(path))
-      {
-      ESP_LOGE(TAG, "SetLogfile: '%s' is a protected path", path.c_str());
-      return false;
-      }
+    ESP_LOGE(TAG, "SetLogfile: '%s' is a protected path", path.c_str());
+    return false;
+    }
 #ifdef CONFIG_OVMS_COMP_SDCARD
-    if (startsWith(path, "/sd") && (!MyPeripherals || !MyPeripherals->m_sdcard || !MyPeripherals->m_sdcard->isavailable()))
-      {
-      ESP_LOGW(TAG, "SetLogfile: cannot open '%s', will retry on SD mount", path.c_str());
-      return false;
-      }
+  if (startsWith(path, "/sd") && (!MyPeripherals || !MyPeripherals->m_sdcard || !MyPeripherals->m_sdcard->isavailable()))
+    {
+    ESP_LOGW(TAG, "SetLogfile: cannot open '%s', will retry on SD mount", path.c_str());
+    return false;
+    }
 #endif // #ifdef CONFIG_OVMS_COMP_SDCARD
-    struct stat st;
-    if (stat(path.c_str(), &st) == 0)
-      m_logfile_size = st.st_size;
-    else
-      m_logfile_size = 0;
-    FILE* file = fopen(path.c_str(), "a+");
-    if (file == NULL)
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0)
+    m_logfile_size = st.st_size;
+  else
+    m_logfile_size = 0;
+  FILE* file = fopen(path.c_str(), "a+");
+  if (file == NULL)
+    {
+    ESP_LOGE(TAG, "SetLogfile: cannot open '%s'", path.c_str());
+    return false;
+    }
+  else
+    {
+    ESP_LOGI(TAG, "SetLogfile: now logging to file '%s'", path.c_str());
+    }
+  // collect batches of log lines in a larger stdio buffer:
+  setvbuf(file, NULL, _IOFBF, LOGFILE_STDIO_BUFSIZE);
+  m_logfile_synctime = monotonictime;
+  m_logfile_dirty = false;
+  m_logfile = file;
+  return true;
+  }
+
+void OvmsCommandApp::CloseLogfile()
+  {
+  if (!m_logfile)
+    return;
+  fclose(m_logfile);
+  m_logfile = NULL;
+  }
+
+/**
+ * FlushLogfile: write queued log lines to the log file (called with m_logfile_mutex held)
+ *  The log lines are collected in the stdio buffer and written in one go,
+ *  fsync is done according to the configured sync period:
+ *    log [file.syncperiod] = 0   → after every write
+ *    log [file.syncperiod] = n   → at most every n seconds
+ *    log [file.syncperiod] = -1  → never (only on close & system shutdown)
+ *  <sync> forces the fsync (used on system shutdown).
+ */
+void OvmsCommandApp::FlushLogfile(bool sync)
+  {
+  const char* data;
+  size_t len, written = 0;
+  char text[LOGRECORD_TEXTSIZE];
+  while ((data = m_logring.Peek(&len)) != NULL)
+    {
+    if (m_logfile)
       {
-      ESP_LOGE(TAG, "SetLogfile: cannot open '%s'", path.c_str());
-      return false;
+      if (IsLogRecord(data, len))
+        {
+        // structured log record: format now
+        LogRecordFormat(text, sizeof(text), (const uint8_t*) data, len);
+        NormalizeLogText(text);
+        written += fwrite(text, 1, strlen(text), m_logfile);
+        }
+      else
+        {
+        written += fwrite(data, 1, len, m_logfile);
+        }
       }
-    else
+    m_logring.Release();
+    }
+  if (!m_logfile)
+    return;
+
+  uint32_t dropped = m_logring.GetDroppedRecords();
+  if (dropped != m_logfile_dropped)
+    {
+    int n = fprintf(m_logfile, "[%u log lines dropped]\n", (unsigned)(dropped - m_logfile_dropped));
+    if (n > 0) written += n;
+    m_logfile_dropped = dropped;
+    }
+
+  if (written)
+    {
+    fflush(m_logfile);
+    m_logfile_size += written;
+    m_logfile_writes++;
+    m_logfile_dirty = true;
+    }
+
+  if (m_logfile_maxsize && m_logfile_size > (m_logfile_maxsize*1024))
+    {
+    CycleLogfile();
+    }
+  else if (m_logfile_dirty && (sync || (m_logfile_syncperiod >= 0 &&
+           monotonictime - m_logfile_synctime >= (uint32_t)m_logfile_syncperiod)))
+    {
+    fsync(fileno(m_logfile));
+    m_logfile_synctime = monotonictime;
+    m_logfile_dirty = false;
+    m_logfile_syncs++;
+    }
+  }
+
+void OvmsCommandApp::LogfileTask(void* data)
+  {
+  OvmsCommandApp* me = (OvmsCommandApp*) data;
+  while (true)
+    {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOGFILE_WRITER_INTERVAL));
+    if (me->m_logfile_mutex.Lock())
       {
-      ESP_LOGI(TAG, "SetLogfile: now logging to file '%s'", path.c_str());
+      me->FlushLogfile();
+      me->m_logfile_mutex.Unlock();
       }
-    m_logfile = file;
     }
-  return true;
+  }
+
+void OvmsCommandApp::ShowLogStatus(int verbosity, OvmsWriter* writer)
+  {
+  if (m_logfile)
+    writer->printf("Log file: %s (%u kB)\n", m_logfile_path.c_str(), (unsigned) m_logfile_size / 1024);
+  else
+    writer->puts("Log file: inactive");
+  writer->printf("  Sync period: %d sec, %u writes, %u syncs\n",
+    m_logfile_syncperiod, (unsigned) m_logfile_writes, (unsigned) m_logfile_syncs);
+  writer->printf("  Write queue: %u bytes, %u used, %u max used\n",
+    (unsigned) m_logring.GetSize(), (unsigned) m_logring.UsedSpace(), (unsigned) m_logring.MaxUsedSpace());
+  writer->printf("  Dropped: %u lines, %u bytes\n",
+    (unsigned) m_logring.GetDroppedRecords(), (unsigned) m_logring.GetDroppedBytes());
+  writer->printf("Structured logging: %s\n", m_logstructured ? "enabled" : "disabled");
+  if (m_recorder.IsInitialized())
+    writer->printf("  Recorder: %u bytes, %u records, %u total\n",
+      (unsigned) m_recorder.GetSize(), (unsigned) m_recorder.GetCount(), (unsigned) m_recorder.GetTotal());
+  }
+
+/**
+ * ResetLogStatus: reset the write queue & log file statistics
+ *  Queued lines are flushed first, so drops counted so far are still
+ *  noted in the log file.
+ */
+void OvmsCommandApp::ResetLogStatus()
+  {
+  OvmsMutexLock lock(&m_logfile_mutex);
+  FlushLogfile();
+  m_logring.ResetStats();
+  m_logfile_dropped = 0;
+  m_logfile_writes = 0;
+  m_logfile_syncs = 0;
+  }
+
+void OvmsCommandApp::ShowLogRecords(int verbosity, OvmsWriter* writer, uint32_t count)
+  {
+  if (!m_recorder.IsInitialized() || m_recorder.GetCount() == 0)
+    {
+    writer->puts("No log records");
+    return;
+    }
+  LogRecorder::cursor_t cursor = m_recorder.Cursor(count);
+  uint8_t rec[LOGRECORD_MAXSIZE];
+  char text[LOGRECORD_TEXTSIZE];
+  size_t len;
+  while ((len = m_recorder.Read(cursor, rec, sizeof(rec))) > 0)
+    {
+    LogRecordFormat(text, sizeof(text), rec, len);
+    NormalizeLogText(text);
+    size_t tlen = strlen(text);
+    writer->write(text, tlen);
+    if (tlen == 0 || text[tlen-1] != '\n')
+      writer->puts("");
+    }
   }
 
 void OvmsCommandApp::SetLoglevel(std::string tag, std::string level)
@@ -814,8 +1075,7 @@ void OvmsCommandApp::CycleLogfile()
   {
   if (!m_logfile)
     return;
-  fclose(m_logfile);
-  m_logfile = NULL;
+  CloseLogfile();
   char ts[20];
   time_t tm = time(NULL);
   strftime(ts, sizeof(ts), ".%Y%m%d-%H%M%S", localtime(&tm));
@@ -825,7 +1085,7 @@ void OvmsCommandApp::CycleLogfile()
     ESP_LOGI(TAG, "CycleLogfile: log file '%s' archived as '%s'", m_logfile_path.c_str(), archpath.c_str());
   else
     ESP_LOGE(TAG, "CycleLogfile: rename log file '%s' to '%s' failed", m_logfile_path.c_str(), archpath.c_str());
-  SetLogfile(m_logfile_path);
+  OpenLogfile(m_logfile_path);
   }
 
 void OvmsCommandApp::ExpireLogFiles(int verbosity, OvmsWriter* writer, int keepdays)
@@ -936,6 +1196,12 @@ void OvmsCommandApp::EventHandler(std::string event, void* data)
     if (startsWith(m_logfile_path, "/sd"))
       SetLogfile("");
     }
+  else if (event == "system.shuttingdown" || event == "system.shutdown")
+    {
+    // write & sync the queued lines now, the restart may follow any moment
+    OvmsMutexLock lock(&m_logfile_mutex);
+    FlushLogfile(true);
+    }
   else if (event == "ticker.3600")
     {
     int keepdays = MyConfig.GetParamValueInt("log", "file.keepdays", 30);
@@ -960,8 +1226,12 @@ void OvmsCommandApp::ReadConfig()
       SetLoglevel(kv.first.substr(6), kv.second);
     }
 
+  // structured logging (deferred formatting):
+  m_logstructured = MyConfig.GetParamValueBool("log", "structured", false) && m_recorder.IsInitialized();
+
   // configure log file:
   m_logfile_maxsize = MyConfig.GetParamValueInt("log", "file.maxsize", 1024);
+  m_logfile_syncperiod = MyConfig.GetParamValueInt("log", "file.syncperiod", 3);
   if (MyConfig.GetParamValueBool("log", "file.enable", false) == false)
     m_logfile_path = "";
   else
@@ -42,6 +42,8 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "microrl_config.h"
+#include "log_ring.h"
+#include "log_record.h"
 
 #define COMMAND_RESULT_MINIMAL    140
 #define COMMAND_RESULT_SMS        160
@@ -69,6 +71,7 @@ class OvmsWriter
     virtual void Log(LogBuffers* message) = 0;
     virtual void Exit();
     virtual bool IsInteractive() { return true; }
+    virtual bool WantsLog() { return m_monitoring; }
     void RegisterInsertCallback(InsertCallback cb, void* ctx);
     void DeregisterInsertCallback(InsertCallback cb);
     virtual void finalise() {}
@@ -195,16 +198,29 @@ class OvmsCommandApp
     bool SetLogfile(std::string path);
     void SetLoglevel(std::string tag, std::string level);
     void ExpireLogFiles(int verbosity, OvmsWriter* writer, int keepdays);
+    void ShowLogStatus(int verbosity, OvmsWriter* writer);
+    void ResetLogStatus();
+    void ShowLogRecords(int verbosity, OvmsWriter* writer, uint32_t count);
     static void ExpireTask(void* data);
+    static void LogfileTask(void* data);
     void EventHandler(std::string event, void* data);
 
   private:
+    bool OpenLogfile(std::string path);
+    void CloseLogfile();
+    void FlushLogfile(bool sync=false);
     void CycleLogfile();
     void ReadConfig();
 
   private:
-    int LogBuffer(LogBuffers* lb, const char* fmt, va_list args);
-    OvmsMutex m_fsync_mutex;
+    int LogBuffer(LogBuffers* lb, const char* fmt, va_list args, bool tofile=true);
+    void QueueLogfile(const char* data, size_t len);
+    bool ConsolesWantLog();
+    void RecordText(LogBuffers* lb);
+    OvmsMutex m_logfile_mutex;
+    LogRing m_logring;
+    LogRecorder m_recorder;
+    bool m_logstructured;
 
   private:
     OvmsCommand m_root;
@@ -215,9 +231,16 @@ class OvmsCommandApp
     std::string m_logfile_path;
     size_t m_logfile_size;
     size_t m_logfile_maxsize;
+    int m_logfile_syncperiod;
+    uint32_t m_logfile_synctime;
+    bool m_logfile_dirty;
+    uint32_t m_logfile_dropped;
+    uint32_t m_logfile_writes;
+    uint32_t m_logfile_syncs;
 
   public:
     TaskHandle_t m_expiretask;
+    TaskHandle_t m_logtask;
   };
 
 extern OvmsCommandApp MyCommandApp;
@@ -39,6 +39,7 @@ static const char *TAG = "events";
 #include "ovms_events.h"
 #include "ovms_command.h"
 #include "ovms_script.h"
+#include "ovms_profiler.h"
 
 OvmsEvents MyEvents __attribute__ ((init_priority (1200)));
 
@@ -94,6 +95,8 @@ OvmsEvents::OvmsEvents()
   cmd_eventtrace->RegisterCommand("off","Turn event tracing OFF",event_trace,"", 0, 0, true);
 
   m_taskqueue = xQueueCreate(CONFIG_OVMS_HW_EVENT_QUEUE_SIZE,sizeof(event_queue_t));
+  m_taskqueue_profile = MyProfiler.RegisterQueue("Events", m_taskqueue);
+  m_script_profile = MyProfiler.GetEntry("event", "scripts", "*");
   xTaskCreatePinnedToCore(EventLaunchTask, "OVMS Events", 8192, (void*)this, 5, &m_taskid, 1);
   AddTaskToMap(m_taskid);
   }
@@ -112,6 +115,7 @@ void OvmsEvents::EventTask()
     if (xQueueReceive(m_taskqueue, &msg, (portTickType)portMAX_DELAY)==pdTRUE)
       {
       esp_task_wdt_reset(); // Reset WATCHDOG timer for this task
+      if (m_taskqueue_profile) m_taskqueue_profile->Sample(1);
       switch(msg.type)
         {
         case EVENT_none:
@@ -149,6 +153,7 @@ void OvmsEvents::HandleQueueSignalEvent(event_queue_t* msg)
       for (EventCallbackList::iterator itc=el->begin(); itc!=el->end(); ++itc)
         {
         EventCallbackEntry* ec = *itc;
+        OvmsProfileTimer pt(ec->m_profile);
         ec->m_callback(event, msg->body.signal.data);
         }
       }
@@ -163,12 +168,16 @@ void OvmsEvents::HandleQueueSignalEvent(event_queue_t* msg)
       for (EventCallbackList::iterator itc=el->begin(); itc!=el->end(); ++itc)
         {
         EventCallbackEntry* ec = *itc;
+        OvmsProfileTimer pt(ec->m_profile);
         ec->m_callback(event, msg->body.signal.data);
         }
       }
     }
 
-  MyScripts.EventScript(event, msg->body.signal.data);
+    {
+    OvmsProfileTimer pt(m_script_profile);
+    MyScripts.EventScript(event, msg->body.signal.data);
+    }
 
   FreeQueueSignalEvent(msg);
   }
@@ -197,7 +206,9 @@ void OvmsEvents::RegisterEvent(std::string caller, std::string event, EventCallb
     }
 
   EventCallbackList *el = k->second;
-  el->push_back(new EventCallbackEntry(caller,callback));
+  EventCallbackEntry* ec = new EventCallbackEntry(caller,callback);
+  ec->m_profile = MyProfiler.GetEntry("event", caller, event);
+  el->push_back(ec);
   }
 
 void OvmsEvents::DeregisterEvent(std::string caller)
@@ -371,6 +382,7 @@ EventCallbackEntry::EventCallbackEntry(std::string caller, EventCallback callbac
   {
   m_caller = caller;
   m_callback = callback;
+  m_profile = NULL;
   }
 
 EventCallbackEntry::~EventCallbackEntry()
@@ -40,6 +40,9 @@
 #include "freertos/task.h"
 #include "freertos/queue.h"
 
+class OvmsProfileEntry;
+class OvmsProfileQueue;
+
 typedef std::function<void(std::string,void*)> EventCallback;
 
 class EventCallbackEntry
@@ -51,6 +54,7 @@ class EventCallbackEntry
   public:
     std::string m_caller;
     EventCallback m_callback;
+    OvmsProfileEntry* m_profile;
   };
 
 typedef std::list<EventCallbackEntry*> EventCallbackList;
@@ -106,6 +110,8 @@ class OvmsEvents
     bool m_trace;
     TaskHandle_t m_taskid;
     QueueHandle_t m_taskqueue;
+    OvmsProfileQueue* m_taskqueue_profile;
+    OvmsProfileEntry* m_script_profile;
   };
 
 extern OvmsEvents MyEvents;
@@ -31,36 +31,167 @@
 #include "ovms_log.h"
 static const char *TAG = "http";
 
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include "ovms.h"
 #include "ovms_http.h"
 #include "ovms_config.h"
+#include "ovms_events.h"
+#include "ovms_mutex.h"
 #include "metrics_standard.h"
 
+/**
+ * Keep-alive connection pool: idle connections tagged by "server:port"
+ *  A connection is returned to the pool by Disconnect() if the server
+ *  allows keep-alive and the response body has been read completely.
+ *  The pool is shared by all servers (OVMS_HTTP_POOLSIZE connections in
+ *  total). Expired connections are closed every 10 seconds, all idle
+ *  connections are closed when the network goes down or changes.
+ */
+
+struct http_idleconn_t
+  {
+  std::string host;
+  int sock = -1;
+  uint32_t since = 0;
+  };
+
+static http_idleconn_t s_idle[OVMS_HTTP_POOLSIZE];
+static OvmsMutex s_idle_mutex;
+
+static int http_pool_get(const std::string& host)
+  {
+  OvmsMutexLock lock(&s_idle_mutex);
+  int sock = -1;
+  for (int i = 0; i < OVMS_HTTP_POOLSIZE; i++)
+    {
+    http_idleconn_t& conn = s_idle[i];
+    if (conn.sock < 0)
+      continue;
+    if (monotonictime - conn.since > OVMS_HTTP_KEEPALIVE)
+      {
+      close(conn.sock);
+      conn.sock = -1;
+      }
+    else if (sock < 0 && conn.host == host)
+      {
+      // Check the server has not closed the connection meanwhile:
+      char c;
+      int n = recv(conn.sock, &c, 1, MSG_PEEK|MSG_DONTWAIT);
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        sock = conn.sock;
+      else
+        close(conn.sock);
+      conn.sock = -1;
+      }
+    }
+  return sock;
+  }
+
+static void http_pool_expire(bool all)
+  {
+  OvmsMutexLock lock(&s_idle_mutex);
+  for (int i = 0; i < OVMS_HTTP_POOLSIZE; i++)
+    {
+    http_idleconn_t& conn = s_idle[i];
+    if (conn.sock >= 0 && (all || monotonictime - conn.since > OVMS_HTTP_KEEPALIVE))
+      {
+      ESP_LOGD(TAG, "Closing idle connection to %s", conn.host.c_str());
+      close(conn.sock);
+      conn.sock = -1;
+      }
+    }
+  }
+
+static void http_pool_put(const std::string& host, int sock)
+  {
+  OvmsMutexLock lock(&s_idle_mutex);
+  int slot = 0;
+  for (int i = 0; i < OVMS_HTTP_POOLSIZE; i++)
+    {
+    if (s_idle[i].sock < 0)
+      {
+      slot = i;
+      break;
+      }
+    if (s_idle[i].since < s_idle[slot].since)
+      slot = i; // replace the oldest
+    }
+  if (s_idle[slot].sock >= 0)
+    close(s_idle[slot].sock);
+  s_idle[slot].host = host;
+  s_idle[slot].sock = sock;
+  s_idle[slot].since = monotonictime;
+  }
+
+static void http_pool_eventhandler(std::string event, void* data)
+  {
+  http_pool_expire(event != "ticker.10");
+  }
+
+class OvmsHttpPoolInit
+  {
+  public:
+  OvmsHttpPoolInit()
+    {
+    ESP_LOGI(TAG, "Initialising HTTP connection pool (5300)");
+    MyEvents.RegisterEvent(TAG, "ticker.10", http_pool_eventhandler);
+    MyEvents.RegisterEvent(TAG, "network.down", http_pool_eventhandler);
+    MyEvents.RegisterEvent(TAG, "network.interface.change", http_pool_eventhandler);
+    MyEvents.RegisterEvent(TAG, "network.mgr.stop", http_pool_eventhandler);
+    }
+  } MyHttpPoolInit __attribute__ ((init_priority (5300)));
+
+
 OvmsHttpClient::OvmsHttpClient()
   {
-  m_buf = NULL;
-  m_bodysize = 0;
-  m_responsecode = 0;
+  m_rbuf = NULL;
+  Init();
   }
 
 OvmsHttpClient::OvmsHttpClient(std::string url, const char* method)
   {
-  m_buf = NULL;
+  m_rbuf = NULL;
+  Init();
   Request(url, method);
   }
 
 OvmsHttpClient::~OvmsHttpClient()
   {
-  if (m_buf)
+  Disconnect();
+  if (m_rbuf)
     {
-    delete m_buf;
-    m_buf = NULL;
+    delete [] m_rbuf;
+    m_rbuf = NULL;
     }
   }
 
-bool OvmsHttpClient::Request(std::string url, const char* method)
+void OvmsHttpClient::Init()
   {
+  m_rpos = 0;
+  m_rlen = 0;
+  m_line.clear();
+  m_bodymode = BodyDone;
+  m_bodyremain = 0;
+  m_keepalive = false;
+  m_reused = false;
   m_bodysize = 0;
   m_responsecode = 0;
+  m_contentmd5.clear();
+  }
+
+/**
+ * Request: send request & read response headers
+ *  headers: optional additional request headers, each terminated by "\r\n"
+ *  An idle keep-alive connection to the server is reused if available.
+ */
+bool OvmsHttpClient::Request(std::string url, const char* method, const char* headers)
+  {
+  // Finish a previous request (keeps the connection for reuse if possible):
+  if (IsOpen())
+    Disconnect();
+  Init();
 
   // First, split URL into server and path components
   if (url.compare(0, 7, "http://", 7) == 0)
@@ -91,19 +222,14 @@ bool OvmsHttpClient::Request(std::string url, const char* method)
     service = server.substr(delim+1);
     server = server.substr(0,delim);
     }
+  m_host = server + ":" + service;
 
-  Connect(server.c_str(), service.c_str());
-  if (!IsOpen())
-    {
-    return false;
-    }
-
-  // Now, we need to send the HTTP request...
+  // Build the HTTP request...
   // ESP_LOGI(TAG, "Server is %s, path is %s",server.c_str(),path.c_str());
   std::string req(method);
   req.append(" ");
   req.append(path);
-  req.append(" HTTP/1.0\r\nHost: ");
+  req.append(" HTTP/1.1\r\nHost: ");
   req.append(server);
   req.append("\r\nUser-Agent: ovms/");
   #ifdef CONFIG_OVMS_HW_BASE_3_0
@@ -115,118 +241,355 @@ bool OvmsHttpClient::Request(std::string url, const char* method)
   req.append(MyConfig.GetParamValue("vehicle","id",""));
   req.append(" ");
   req.append(StandardMetrics.ms_m_version->AsString());
-  req.append(")\r\n\r\n");
-  if (Write(req.c_str(), req.length()) < 0)
+  req.append(")\r\n");
+  if (headers)
+    req.append(headers);
+  req.append("\r\n");
+
+  if (m_rbuf == NULL)
+    m_rbuf = new char[OVMS_HTTP_RBUFSIZE];
+
+  // Send it, retry once on a new connection if a pooled one turns out to be dead:
+  for (int attempt = 0; attempt < 2; attempt++)
     {
-    ESP_LOGE(TAG, "Unable to write to server connection");
-    Disconnect();
-    return false;
+    m_rpos = m_rlen = 0;
+    m_sock = http_pool_get(m_host);
+    m_reused = (m_sock >= 0);
+    if (!m_reused)
+      {
+      Connect(server.c_str(), service.c_str());
+      if (!IsOpen())
+        return false;
+      }
+
+    if (Write(req.c_str(), req.length()) >= 0 && ReadHeaders(method))
+      return true;
+
+    bool retry = (m_reused && m_rlen == 0);
+    OvmsNetTcpConnection::Disconnect();
+    if (!retry)
+      {
+      ESP_LOGE(TAG, "Error: Premature end of server response");
+      return false;
+      }
+    ESP_LOGD(TAG, "Keep-alive connection to %s lost, reconnecting", m_host.c_str());
     }
+  return false;
+  }
 
-  m_buf = new OvmsBuffer(1024);
-  bool inheaders = true;
-  // ESP_LOGI(TAG,"Reading headers...");
-  while((inheaders)&&(m_buf->PollSocket(m_sock, 10000) >= 0))
+/**
+ * ReadHeaders: parse status line & headers in place from the receive buffer,
+ *  any body data received along with them stays buffered for BodyRead.
+ *  Interim responses (1xx, e.g. "100 Continue") are skipped, except for
+ *  "101 Switching Protocols", which has no body.
+ */
+bool OvmsHttpClient::ReadHeaders(const char* method)
+  {
+  bool status = true;
+  bool http11 = false, chunked = false, close = false, keepalive = false, havelength = false;
+  while (true)
     {
-    // ESP_LOGI(TAG, "Now buffered %d bytes",m_buf->UsedSpace());
-    int k = m_buf->HasLine();
-    while ((inheaders)&&(k >= 0))
+    int len = RawLine();
+    if (len < 0)
+      return false;
+    char* line = m_rbuf + m_rpos;
+    m_rpos += len;
+    int n = len-1;
+    if (n > 0 && line[n-1] == '\r')
+      n--;
+    line[n] = 0;
+
+    if (status)
       {
-      if (k == 0)
-        {
-        inheaders = 0;
-        }
-      else
-        {
-        // ESP_LOGI(TAG, "Got response %s",m_buf->ReadLine().c_str());
-        std::string header = m_buf->ReadLine();
-        if (header.compare(0,15,"Content-Length:") == 0)
-          {
-          m_bodysize = atoi(header.substr(15).c_str());
-          }
-        if (header.compare(0,5,"HTTP/") == 0)
-          {
-          size_t space = header.find(' ');
-          if (space!=std::string::npos)
-            {
-            m_responsecode = atoi(header.substr(space+1).c_str());
-            }
-          }
-        k = m_buf->HasLine();
-        }
+      if (strncmp(line, "HTTP/", 5) != 0)
+        return false;
+      http11 = (strncmp(line+5, "1.0", 3) != 0);
+      char* space = strchr(line, ' ');
+      if (space)
+        m_responsecode = atoi(space+1);
+      status = false;
+      continue;
+      }
+    if (n == 0)
+      {
+      if (m_responsecode < 100 || m_responsecode >= 200 || m_responsecode == 101)
+        break; // end of headers
+      // interim response, the final one follows:
+      status = true;
+      http11 = chunked = close = keepalive = havelength = false;
+      continue;
+      }
+
+    char* value = strchr(line, ':');
+    if (!value)
+      continue;
+    *value++ = 0;
+    while (*value == ' ' || *value == '\t')
+      value++;
+    if (strcasecmp(line, "Content-Length") == 0)
+      {
+      m_bodysize = atoi(value);
+      havelength = true;
+      }
+    else if (strcasecmp(line, "Content-MD5") == 0)
+      m_contentmd5 = value;
+    else if (strcasecmp(line, "Transfer-Encoding") == 0)
+      chunked = (strcasecmp(value, "chunked") == 0);
+    else if (strcasecmp(line, "Connection") == 0)
+      {
+      if (strcasecmp(value, "close") == 0)
+        close = true;
+      else if (strcasecmp(value, "keep-alive") == 0)
+        keepalive = true;
       }
     }
-  if (inheaders)
+
+  // Determine how the body is delimited:
+  m_keepalive = http11 ? !close : keepalive;
+  if (strcmp(method, "HEAD") == 0 || m_responsecode == 204 || m_responsecode == 304
+    || m_responsecode == 101)
     {
-    ESP_LOGE(TAG, "Error: Premature end of server response");
-    Disconnect();
+    m_bodymode = BodyDone;
+    }
+  else if (chunked)
+    {
+    m_bodymode = BodyChunked;
+    m_bodyremain = 0;
+    m_bodysize = 0;
+    }
+  else if (havelength)
+    {
+    m_bodymode = (m_bodysize > 0) ? BodyLength : BodyDone;
+    m_bodyremain = m_bodysize;
+    }
+  else
+    {
+    m_bodymode = BodyToClose;
+    m_keepalive = false;
+    }
+  return true;
+  }
+
+void OvmsHttpClient::Disconnect()
+  {
+  if (m_sock >= 0 && m_keepalive && m_bodymode == BodyDone && m_rpos == m_rlen)
+    {
+    struct timeval tv = { 0, 0 };
+    setsockopt(m_sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    http_pool_put(m_host, m_sock);
+    m_sock = -1;
+    }
+  OvmsNetTcpConnection::Disconnect();
+  m_keepalive = false;
+  m_rpos = m_rlen = 0;
+  m_line.clear();
+  }
+
+/**
+ * RawFill: read more data into the receive buffer (waits max OVMS_HTTP_TIMEOUT)
+ */
+bool OvmsHttpClient::RawFill()
+  {
+  if (m_rpos > 0)
+    {
+    memmove(m_rbuf, m_rbuf+m_rpos, m_rlen-m_rpos);
+    m_rlen -= m_rpos;
+    m_rpos = 0;
+    }
+  if (m_rlen == OVMS_HTTP_RBUFSIZE)
+    {
+    ESP_LOGE(TAG, "Error: Server response line too long");
     return false;
     }
 
-  // Process the separator line
-  // m_buf->Diagnostics();
-  m_buf->ReadLine(); // Discard the empty header/body line
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(m_sock, &fds);
+  struct timeval timeout = { OVMS_HTTP_TIMEOUT/1000, (OVMS_HTTP_TIMEOUT%1000)*1000 };
+  if (select(m_sock+1, &fds, NULL, NULL, &timeout) <= 0)
+    return false;
 
+  ssize_t n = (ssize_t) Read(m_rbuf+m_rlen, OVMS_HTTP_RBUFSIZE-m_rlen);
+  if (n <= 0)
+    return false;
+  m_rlen += n;
   return true;
   }
 
-void OvmsHttpClient::Disconnect()
+/**
+ * RawLine: get the length of the next raw line (including "\n") at m_rpos
+ *  Returns -1 on timeout / connection loss.
+ */
+int OvmsHttpClient::RawLine()
   {
-  if (m_buf != NULL)
+  while (true)
     {
-    delete m_buf;
-    m_buf = NULL;
+    char* nl = (char*) memchr(m_rbuf+m_rpos, '\n', m_rlen-m_rpos);
+    if (nl)
+      return nl - (m_rbuf+m_rpos) + 1;
+    if (!RawFill())
+      return -1;
     }
-  OvmsNetTcpConnection::Disconnect();
   }
 
-size_t OvmsHttpClient::BodyRead(void *buf, size_t nbyte)
+/**
+ * RawRead: read raw data, buffered data first, then directly from the socket
+ */
+size_t OvmsHttpClient::RawRead(void *buf, size_t nbyte)
   {
-  // char *x = (char*)buf;
-  if ((m_buf == NULL)||(m_buf->UsedSpace() == 0))
+  if (m_rpos < m_rlen)
     {
-    size_t n = Read(buf,nbyte);
-    // ESP_EARLY_LOGI(TAG, "BodyRead got %d bytes direct (%02x %02x %02x %02x)",n,x[0],x[1],x[2],x[3]);
+    size_t n = (m_rlen-m_rpos < nbyte) ? m_rlen-m_rpos : nbyte;
+    memcpy(buf, m_rbuf+m_rpos, n);
+    m_rpos += n;
     return n;
     }
-  else
+  return Read(buf, nbyte);
+  }
+
+size_t OvmsHttpClient::BodyAbort()
+  {
+  ESP_LOGW(TAG, "Invalid chunked response body from %s", m_host.c_str());
+  m_bodymode = BodyDone;
+  m_keepalive = false;
+  return 0;
+  }
+
+/**
+ * BodyDecode: read body data, removes chunked transfer framing
+ *  Returns 0 at the end of the body, (size_t)-1 on a socket error.
+ */
+size_t OvmsHttpClient::BodyDecode(void *buf, size_t nbyte)
+  {
+  if (m_bodymode == BodyChunked && m_bodyremain == 0)
     {
-    size_t n = m_buf->Pop(nbyte,(uint8_t*)buf);
-    // ESP_EARLY_LOGI(TAG, "Body Read got %d bytes from buf (%d left) (%02x %02x %02x %02x)",n,m_buf->UsedSpace(),x[0],x[1],x[2],x[3]);
-    if (m_buf->UsedSpace() == 0)
+    // Read the next chunk size line, skipping the previous chunk's CRLF:
+    while (true)
       {
-      delete m_buf;
-      m_buf = NULL;
+      int len = RawLine();
+      if (len < 0)
+        return BodyAbort();
+      char* line = m_rbuf + m_rpos;
+      m_rpos += len;
+      if (line[0] == '\r' || line[0] == '\n')
+        continue;
+      char* end;
+      unsigned long size = strtoul(line, &end, 16);
+      if (end == line)
+        return BodyAbort();
+      if (size == 0)
+        {
+        // Last chunk: skip trailers up to the empty line
+        while ((len = RawLine()) > 0)
+          {
+          bool empty = (m_rbuf[m_rpos] == '\r' || m_rbuf[m_rpos] == '\n');
+          m_rpos += len;
+          if (empty)
+            break;
+          }
+        if (len < 0)
+          return BodyAbort();
+        m_bodymode = BodyDone;
+        return 0;
+        }
+      m_bodyremain = size;
+      break;
       }
+    }
+
+  if (m_bodymode == BodyDone || nbyte == 0)
+    return 0;
+  if (m_bodymode != BodyToClose && nbyte > m_bodyremain)
+    nbyte = m_bodyremain;
+
+  size_t n = RawRead(buf, nbyte);
+  if ((ssize_t)n <= 0)
+    {
+    // Connection closed or socket error:
+    m_keepalive = false;
+    if (m_bodymode == BodyToClose && n == 0)
+      m_bodymode = BodyDone;
     return n;
     }
+  if (m_bodymode != BodyToClose)
+    {
+    m_bodyremain -= n;
+    if (m_bodyremain == 0 && m_bodymode == BodyLength)
+      m_bodymode = BodyDone;
+    }
+  return n;
   }
 
-int OvmsHttpClient::BodyHasLine()
+size_t OvmsHttpClient::BodyRead(void *buf, size_t nbyte)
   {
-  if (m_buf == NULL)
-    return -1;
+  if (!m_line.empty())
+    {
+    size_t n = (m_line.size() < nbyte) ? m_line.size() : nbyte;
+    memcpy(buf, m_line.data(), n);
+    m_line.erase(0, n);
+    return n;
+    }
+  return BodyDecode(buf, nbyte);
+  }
 
-  if (m_buf->HasLine()<0)
+/**
+ * BodyHasLine: returns the length of the next complete body line or -1
+ */
+int OvmsHttpClient::BodyHasLine()
+  {
+  size_t pos;
+  while ((pos = m_line.find_first_of("\r\n")) == std::string::npos)
     {
-    m_buf->PollSocket(m_sock, 10000);
-    // m_buf->Diagnostics();
+    char buf[128];
+    ssize_t n = (ssize_t) BodyDecode(buf, sizeof(buf));
+    if (n <= 0)
+      return -1;
+    m_line.append(buf, n);
     }
-  return m_buf->HasLine();
+  return pos;
   }
 
 std::string OvmsHttpClient::BodyReadLine()
   {
-  if (m_buf == NULL)
+  int len = BodyHasLine();
+  if (len < 0)
     return std::string("");
 
-  if (m_buf->HasLine()<0)
+  std::string line = m_line.substr(0, len);
+  if (m_line[len] == '\r')
     {
-    m_buf->PollSocket(m_sock, 10000);
-    // m_buf->Diagnostics();
+    // CR LF: consume the LF as well, it may not have been received yet
+    if (len+1 == (int)m_line.size())
+      {
+      char c;
+      if (BodyDecode(&c, 1) == 1)
+        m_line.push_back(c);
+      }
+    if (len+1 < (int)m_line.size() && m_line[len+1] == '\n')
+      len++;
     }
+  m_line.erase(0, len+1);
+  return line;
+  }
 
-  return m_buf->ReadLine();
+/**
+ * BodyStream: pass the response body to <callback> as it arrives
+ *  Returns the number of body bytes delivered.
+ */
+size_t OvmsHttpClient::BodyStream(BodyCallback callback)
+  {
+  size_t total = 0;
+  char buf[512];
+  while (true)
+    {
+    ssize_t n = (ssize_t) BodyRead(buf, sizeof(buf));
+    if (n <= 0)
+      break;
+    total += n;
+    if (!callback(buf, n))
+      break;
+    }
+  return total;
   }
 
 size_t OvmsHttpClient::BodySize()
@@ -238,3 +601,13 @@ int OvmsHttpClient::ResponseCode()
   {
   return m_responsecode;
   }
+
+std::string OvmsHttpClient::ContentMD5()
+  {
+  return m_contentmd5;
+  }
+
+bool OvmsHttpClient::IsReused()
+  {
+  return m_reused;
+  }
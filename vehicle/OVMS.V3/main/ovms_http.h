@@ -32,11 +32,20 @@
 #define __OVMS_HTTP_H__
 
 #include <string>
+#include <functional>
 #include "ovms_net.h"
-#include "ovms_buffer.h"
+
+#define OVMS_HTTP_RBUFSIZE      1024    // receive buffer: header lines, chunk framing, prefetched body
+#define OVMS_HTTP_TIMEOUT       10000   // ms to wait for response headers / lines
+#define OVMS_HTTP_POOLSIZE      2       // max idle keep-alive connections kept (all servers)
+#define OVMS_HTTP_KEEPALIVE     30      // max seconds an idle connection is kept
 
 class OvmsHttpClient : public OvmsNetTcpConnection
   {
+  public:
+    // BodyStream callback: return false to stop reading
+    typedef std::function<bool(const char* data, size_t len)> BodyCallback;
+
   public:
     OvmsHttpClient();
     OvmsHttpClient(std::string url, const char* method = "GET");
@@ -46,17 +55,44 @@ class OvmsHttpClient : public OvmsNetTcpConnection
     virtual void Disconnect();
 
   public:
-    bool Request(std::string url, const char* method = "GET");
+    bool Request(std::string url, const char* method = "GET", const char* headers = NULL);
     size_t BodyRead(void *buf, size_t nbyte);
     int BodyHasLine();
     std::string BodyReadLine();
+    size_t BodyStream(BodyCallback callback);
     size_t BodySize();
     int ResponseCode();
+    std::string ContentMD5();
+    bool IsReused();
+
+  protected:
+    void Init();
+    bool ReadHeaders(const char* method);
+    bool RawFill();
+    int RawLine();
+    size_t RawRead(void *buf, size_t nbyte);
+    size_t BodyDecode(void *buf, size_t nbyte);
+    size_t BodyAbort();
 
   protected:
-    OvmsBuffer* m_buf;
+    char* m_rbuf;                 // raw receive buffer
+    size_t m_rpos;                // raw buffer read position
+    size_t m_rlen;                // raw buffer fill level
+    std::string m_host;           // "server:port", connection pool key
+    std::string m_line;           // decoded body data for line reads
+    enum
+      {
+      BodyLength,                 // Content-Length
+      BodyChunked,                // Transfer-Encoding: chunked
+      BodyToClose,                // read until the server closes
+      BodyDone
+      } m_bodymode;
+    size_t m_bodyremain;          // remaining bytes of body / current chunk
+    bool m_keepalive;             // connection may be reused after the body
+    bool m_reused;                // request was sent on a pooled connection
     size_t m_bodysize;
     int m_responsecode;
+    std::string m_contentmd5;
   };
 
 #endif //#ifndef __OVMS_HTTP_H__
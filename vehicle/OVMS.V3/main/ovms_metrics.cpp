@@ -33,11 +33,12 @@ static const char *TAG = "metrics";
 
 #include <stdlib.h>
 #include <stdio.h>
-#include <sstream>
 #include "ovms.h"
 #include "ovms_metrics.h"
 #include "ovms_command.h"
+#include "ovms_events.h"
 #include "ovms_script.h"
+#include "ovms_profiler.h"
 #include "string.h"
 
 using namespace std;
@@ -112,10 +113,13 @@ static duk_ret_t DukOvmsMetricFloat(duk_context *ctx)
 
 #endif //#ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
 
-MetricCallbackEntry::MetricCallbackEntry(const char* caller, MetricCallback callback)
+MetricCallbackEntry::MetricCallbackEntry(const char* caller, const char* name, MetricCallback callback, bool deferred)
   {
   m_caller = caller;
+  m_name = name;
   m_callback = callback;
+  m_deferred = deferred;
+  m_profile = NULL;
   }
 
 MetricCallbackEntry::~MetricCallbackEntry()
@@ -129,6 +133,9 @@ OvmsMetrics::OvmsMetrics()
   m_nextmodifier = 1;
   m_first = NULL;
   m_trace = false;
+  m_listversion = 0;
+  m_listen_all = 0;
+  m_listen_deferred = false;
 
   // Register our commands
   OvmsCommand* cmd_metric = MyCommandApp.RegisterCommand("metrics","METRICS framework",NULL, "", 0, 0, true);
@@ -145,6 +152,10 @@ OvmsMetrics::OvmsMetrics()
   dto->RegisterDuktapeFunction(DukOvmsMetricFloat, 1, "AsFloat");
   MyScripts.RegisterDuktapeObject(dto);
 #endif //#ifdef CONFIG_OVMS_SC_JAVASCRIPT_DUKTAPE
+
+  using std::placeholders::_1;
+  using std::placeholders::_2;
+  MyEvents.RegisterEvent(TAG, "ticker.1", std::bind(&OvmsMetrics::NotifyDeferred, this, _1, _2));
   }
 
 OvmsMetrics::~OvmsMetrics()
@@ -159,6 +170,17 @@ OvmsMetrics::~OvmsMetrics()
 
 void OvmsMetrics::RegisterMetric(OvmsMetric* metric)
   {
+  m_listversion++;
+
+  // Attach listeners registered before the metric:
+  auto k = m_listeners.find(metric->m_name);
+  if (k != m_listeners.end())
+    {
+    metric->m_listeners = k->second;
+    metric->m_listen = ListenFlags(metric->m_listeners);
+    m_listeners.erase(k);
+    }
+
   // Quick simple check for if we are the first metric.
   if (m_first == NULL)
     {
@@ -193,10 +215,20 @@ void OvmsMetrics::RegisterMetric(OvmsMetric* metric)
 
 void OvmsMetrics::DeregisterMetric(OvmsMetric* metric)
   {
+  m_listversion++;
+
+  // Keep the listeners for a reregistration of the metric:
+  if (metric->m_listeners)
+    {
+    m_listeners[metric->m_listeners->front()->m_name] = metric->m_listeners;
+    metric->m_listen = 0;
+    metric->m_listeners = NULL;
+    }
+
+  // Called by the metric destructor, so only unlink:
   if (m_first == metric)
     {
     m_first = metric->m_next;
-    delete metric;
     return;
     }
 
@@ -205,7 +237,6 @@ void OvmsMetrics::DeregisterMetric(OvmsMetric* metric)
     if (m->m_next == metric)
       {
       m->m_next = metric->m_next;
-      delete metric;
       return;
       }
     }
@@ -295,8 +326,36 @@ OvmsMetricFloat* OvmsMetrics::InitFloat(const char* metric, uint16_t autostale,
   return m;
   }
 
-void OvmsMetrics::RegisterListener(const char* caller, const char* name, MetricCallback callback)
+/**
+ * RegisterListener: register a callback for modifications of a metric
+ *  (name "*" = all metrics). Deferred listeners are called once per second
+ *  from the events task for metrics modified since the last call, use them
+ *  if you only need the latest value.
+ */
+void OvmsMetrics::RegisterListener(const char* caller, const char* name, MetricCallback callback, bool deferred)
   {
+  MetricCallbackEntry* ec = new MetricCallbackEntry(caller,name,callback,deferred);
+  ec->m_profile = MyProfiler.GetEntry("metric", caller, name);
+  if (deferred)
+    m_listen_deferred = true;
+
+  if (strcmp(name, "*") == 0)
+    {
+    m_listeners_all.push_back(ec);
+    m_listen_all = ListenFlags(&m_listeners_all);
+    return;
+    }
+
+  OvmsMetric* metric = Find(name);
+  if (metric)
+    {
+    if (!metric->m_listeners)
+      metric->m_listeners = new MetricCallbackList();
+    metric->m_listeners->push_back(ec);
+    metric->m_listen = ListenFlags(metric->m_listeners);
+    return;
+    }
+
   auto k = m_listeners.find(name);
   if (k == m_listeners.end())
     {
@@ -306,33 +365,62 @@ void OvmsMetrics::RegisterListener(const char* caller, const char* name, MetricC
   if (k == m_listeners.end())
     {
     ESP_LOGE(TAG, "Problem registering metric %s for caller %s",name,caller);
+    delete ec;
     return;
     }
 
   MetricCallbackList *ml = k->second;
-  ml->push_back(new MetricCallbackEntry(caller,callback));
+  ml->push_back(ec);
+  }
+
+static void RemoveListeners(MetricCallbackList* ml, const char* caller)
+  {
+  MetricCallbackList::iterator itc=ml->begin();
+  while (itc!=ml->end())
+    {
+    MetricCallbackEntry* ec = *itc;
+    if (ec->m_caller == caller)
+      {
+      itc = ml->erase(itc);
+      delete ec;
+      }
+    else
+      {
+      ++itc;
+      }
+    }
   }
 
 void OvmsMetrics::DeregisterListener(const char* caller)
   {
+  RemoveListeners(&m_listeners_all, caller);
+  m_listen_all = ListenFlags(&m_listeners_all);
+  bool deferred = (m_listen_all & METRIC_LISTEN_DEFERRED);
+
+  for (OvmsMetric* m=m_first; m != NULL; m=m->m_next)
+    {
+    if (!m->m_listeners)
+      continue;
+    RemoveListeners(m->m_listeners, caller);
+    if (m->m_listeners->empty())
+      {
+      m->m_listen = 0;
+      delete m->m_listeners;
+      m->m_listeners = NULL;
+      }
+    else
+      {
+      m->m_listen = ListenFlags(m->m_listeners);
+      if (m->m_listen & METRIC_LISTEN_DEFERRED)
+        deferred = true;
+      }
+    }
+
   MetricCallbackMap::iterator itm=m_listeners.begin();
   while (itm!=m_listeners.end())
     {
     MetricCallbackList* ml = itm->second;
-    MetricCallbackList::iterator itc=ml->begin();
-    while (itc!=ml->end())
-      {
-      MetricCallbackEntry* ec = *itc;
-      if (ec->m_caller == caller)
-        {
-        itc = ml->erase(itc);
-        delete ec;
-        }
-      else
-        {
-        ++itc;
-        }
-      }
+    RemoveListeners(ml, caller);
     if (ml->empty())
       {
       itm = m_listeners.erase(itm);
@@ -340,11 +428,39 @@ void OvmsMetrics::DeregisterListener(const char* caller)
       }
     else
       {
+      if (ListenFlags(ml) & METRIC_LISTEN_DEFERRED)
+        deferred = true;
       ++itm;
       }
     }
+
+  m_listen_deferred = deferred;
+  }
+
+uint8_t OvmsMetrics::ListenFlags(MetricCallbackList* ml)
+  {
+  uint8_t flags = 0;
+  for (auto ec : *ml)
+    flags |= (ec->m_deferred) ? METRIC_LISTEN_DEFERRED : METRIC_LISTEN_IMMEDIATE;
+  return flags;
+  }
+
+void OvmsMetrics::CallListeners(MetricCallbackList* ml, OvmsMetric* metric, bool deferred)
+  {
+  for (MetricCallbackList::iterator itc=ml->begin(); itc!=ml->end(); ++itc)
+    {
+    MetricCallbackEntry* ec = *itc;
+    if (ec->m_deferred != deferred)
+      continue;
+    OvmsProfileTimer pt(ec->m_profile);
+    ec->m_callback(metric);
+    }
   }
 
+/**
+ * NotifyModified: called by OvmsMetric::SetModified() only if the metric
+ *  or the "*" list has listeners (or tracing is enabled).
+ */
 void OvmsMetrics::NotifyModified(OvmsMetric* metric)
   {
   if (m_trace &&
@@ -358,22 +474,36 @@ void OvmsMetrics::NotifyModified(OvmsMetric* metric)
       metric->m_name, metric->AsUnitString().c_str());
     }
 
-  auto k = m_listeners.find("*");
-  for (int x=0;x<2;x++)
+  uint8_t listen = m_listen_all | metric->m_listen;
+  if (listen & METRIC_LISTEN_DEFERRED)
+    metric->m_notify_deferred = true;
+  if (listen & METRIC_LISTEN_IMMEDIATE)
     {
-    if (k != m_listeners.end())
-      {
-      MetricCallbackList* ml = k->second;
-      if (ml)
-        {
-        for (MetricCallbackList::iterator itc=ml->begin(); itc!=ml->end(); ++itc)
-          {
-          MetricCallbackEntry* ec = *itc;
-          ec->m_callback(metric);
-          }
-        }
-      }
-    k = m_listeners.find(metric->m_name);
+    if (m_listen_all & METRIC_LISTEN_IMMEDIATE)
+      CallListeners(&m_listeners_all, metric, false);
+    MetricCallbackList* ml = metric->m_listeners;
+    if (ml && (metric->m_listen & METRIC_LISTEN_IMMEDIATE))
+      CallListeners(ml, metric, false);
+    }
+  }
+
+/**
+ * NotifyDeferred: call the deferred listeners for all metrics modified
+ *  since the last tick, once per metric
+ */
+void OvmsMetrics::NotifyDeferred(std::string event, void* data)
+  {
+  if (!m_listen_deferred)
+    return;
+  for (OvmsMetric* m=m_first; m != NULL; m=m->m_next)
+    {
+    if (!m->m_notify_deferred.exchange(false))
+      continue;
+    if (m_listen_all & METRIC_LISTEN_DEFERRED)
+      CallListeners(&m_listeners_all, m, true);
+    MetricCallbackList* ml = m->m_listeners;
+    if (ml && (m->m_listen & METRIC_LISTEN_DEFERRED))
+      CallListeners(ml, m, true);
     }
   }
 
@@ -391,6 +521,9 @@ OvmsMetric::OvmsMetric(const char* name, uint16_t autostale, metric_unit_t units
   m_autostale = autostale;
   m_units = units;
   m_next = NULL;
+  m_listeners = NULL;
+  m_listen = 0;
+  m_notify_deferred = false;
   MyMetrics.RegisterMetric(this);
   }
 
@@ -405,24 +538,60 @@ OvmsMetric::~OvmsMetric()
 
 std::string OvmsMetric::AsString(const char* defvalue, metric_unit_t units, int precision)
   {
-  return std::string(defvalue);
+  std::string buf;
+  AppendString(buf, defvalue, units, precision);
+  return buf;
   }
 
 std::string OvmsMetric::AsUnitString(const char* defvalue, metric_unit_t units, int precision)
   {
-  if (!IsDefined())
-    return std::string(defvalue);
-  return AsString(defvalue, units, precision) + OvmsMetricUnitLabel(units==Native ? GetUnits() : units);
+  std::string buf;
+  AppendUnitString(buf, defvalue, units, precision);
+  return buf;
   }
 
 std::string OvmsMetric::AsJSON(const char* defvalue, metric_unit_t units, int precision)
   {
-  std::string buf = "\"";
-  buf.append(json_encode(AsString(defvalue, units, precision)));
-  buf.append("\"");
+  std::string buf;
+  AppendJSON(buf, defvalue, units, precision);
   return buf;
   }
 
+/**
+ * AppendString / AppendUnitString / AppendJSON: append the value representation
+ *  to a string buffer. Use these instead of AsString() etc. when serializing
+ *  many metrics, reusing a reserved buffer avoids the temporary strings.
+ */
+void OvmsMetric::AppendString(std::string& out, const char* defvalue, metric_unit_t units, int precision)
+  {
+  out.append(defvalue);
+  }
+
+void OvmsMetric::AppendUnitString(std::string& out, const char* defvalue, metric_unit_t units, int precision)
+  {
+  if (!IsDefined())
+    {
+    out.append(defvalue);
+    return;
+    }
+  AppendString(out, defvalue, units, precision);
+  out.append(OvmsMetricUnitLabel(units==Native ? GetUnits() : units));
+  }
+
+void OvmsMetric::AppendJSON(std::string& out, const char* defvalue, metric_unit_t units, int precision)
+  {
+  out.append(1, '"');
+  out.append(json_encode(AsString(defvalue, units, precision)));
+  out.append(1, '"');
+  }
+
+void OvmsMetric::AppendBinary(std::string& out)
+  {
+  std::string value = AsString();
+  metric_append_varint(out, value.size());
+  out.append(value);
+  }
+
 float OvmsMetric::AsFloat(const float defvalue, metric_unit_t units)
   {
   return defvalue;
@@ -457,7 +626,9 @@ void OvmsMetric::SetModified(bool changed)
   if (changed)
     {
     m_modified = ULONG_MAX;
-    MyMetrics.NotifyModified(this);
+    // Fast path: no dispatch for unobserved metrics
+    if (m_listen | MyMetrics.m_listen_all | MyMetrics.m_trace)
+      MyMetrics.NotifyModified(this);
     }
   }
 
@@ -525,29 +696,32 @@ OvmsMetricInt::~OvmsMetricInt()
   {
   }
 
-std::string OvmsMetricInt::AsString(const char* defvalue, metric_unit_t units, int precision)
+void OvmsMetricInt::AppendString(std::string& out, const char* defvalue, metric_unit_t units, int precision)
   {
   if (IsDefined())
     {
-    char buffer[33];
     if ((units != Other)&&(units != m_units))
-      itoa(UnitConvert(m_units,units,m_value),buffer,10);
+      num_append(out, UnitConvert(m_units,units,m_value));
     else
-      itoa (m_value,buffer,10);
-    return buffer;
+      num_append(out, m_value);
     }
   else
     {
-    return std::string(defvalue);
+    out.append(defvalue);
     }
   }
 
-std::string OvmsMetricInt::AsJSON(const char* defvalue, metric_unit_t units, int precision)
+void OvmsMetricInt::AppendJSON(std::string& out, const char* defvalue, metric_unit_t units, int precision)
   {
   if (IsDefined())
-    return AsString(defvalue, units, precision);
+    AppendString(out, defvalue, units, precision);
   else
-    return std::string((defvalue && *defvalue) ? defvalue : "0");
+    out.append((defvalue && *defvalue) ? defvalue : "0");
+  }
+
+void OvmsMetricInt::AppendBinary(std::string& out)
+  {
+  metric_append_zigzag(out, m_value);
   }
 
 float OvmsMetricInt::AsFloat(const float defvalue, metric_unit_t units)
@@ -584,7 +758,8 @@ void OvmsMetricInt::SetValue(int value, metric_unit_t units)
 
 void OvmsMetricInt::SetValue(std::string value)
   {
-  int nvalue = atoi(value.c_str());
+  int nvalue;
+  num_parse(value.c_str(), &nvalue);
   if (m_value != nvalue)
     {
     m_value = nvalue;
@@ -604,39 +779,44 @@ OvmsMetricBool::~OvmsMetricBool()
   {
   }
 
-std::string OvmsMetricBool::AsString(const char* defvalue, metric_unit_t units, int precision)
+void OvmsMetricBool::AppendString(std::string& out, const char* defvalue, metric_unit_t units, int precision)
   {
   if (IsDefined())
     {
     if (m_value)
-      return std::string("yes");
+      out.append("yes");
     else
-      return std::string("no");
+      out.append("no");
     }
   else
     {
-    return std::string(defvalue);
+    out.append(defvalue);
     }
   }
 
-std::string OvmsMetricBool::AsJSON(const char* defvalue, metric_unit_t units, int precision)
+void OvmsMetricBool::AppendJSON(std::string& out, const char* defvalue, metric_unit_t units, int precision)
   {
   if (IsDefined())
     {
     if (m_value)
-      return std::string("true");
+      out.append("true");
     else
-      return std::string("false");
+      out.append("false");
     }
   else
     {
     if (strtobool(defvalue) == true)
-      return std::string("true");
+      out.append("true");
     else
-      return std::string("false");
+      out.append("false");
     }
   }
 
+void OvmsMetricBool::AppendBinary(std::string& out)
+  {
+  out.append(1, m_value ? 1 : 0);
+  }
+
 float OvmsMetricBool::AsFloat(const float defvalue, metric_unit_t units)
   {
   return (float)AsBool((bool)defvalue);
@@ -683,35 +863,32 @@ OvmsMetricFloat::~OvmsMetricFloat()
   {
   }
 
-std::string OvmsMetricFloat::AsString(const char* defvalue, metric_unit_t units, int precision)
+void OvmsMetricFloat::AppendString(std::string& out, const char* defvalue, metric_unit_t units, int precision)
   {
   if (IsDefined())
     {
-    std::ostringstream ss;
-    if (precision >= 0)
-      {
-      ss.precision(precision); // Set desired precision
-      ss << fixed;
-      }
     if ((units != Other)&&(units != m_units))
-      ss << UnitConvert(m_units,units,m_value);
+      num_append(out, UnitConvert(m_units,units,m_value), precision);
     else
-      ss << m_value;
-    std::string s(ss.str());
-    return s;
+      num_append(out, m_value, precision);
     }
   else
     {
-    return std::string(defvalue);
+    out.append(defvalue);
     }
   }
 
-std::string OvmsMetricFloat::AsJSON(const char* defvalue, metric_unit_t units, int precision)
+void OvmsMetricFloat::AppendJSON(std::string& out, const char* defvalue, metric_unit_t units, int precision)
   {
   if (IsDefined())
-    return AsString(defvalue, units, precision);
+    AppendString(out, defvalue, units, precision);
   else
-    return std::string((defvalue && *defvalue) ? defvalue : "0");
+    out.append((defvalue && *defvalue) ? defvalue : "0");
+  }
+
+void OvmsMetricFloat::AppendBinary(std::string& out)
+  {
+  metric_append_float(out, m_value);
   }
 
 float OvmsMetricFloat::AsFloat(const float defvalue, metric_unit_t units)
@@ -748,7 +925,8 @@ void OvmsMetricFloat::SetValue(float value, metric_unit_t units)
 
 void OvmsMetricFloat::SetValue(std::string value)
   {
-  float nvalue = atof(value.c_str());
+  float nvalue;
+  num_parse(value.c_str(), &nvalue);
   if (m_value != nvalue)
     {
     m_value = nvalue;
@@ -767,17 +945,32 @@ OvmsMetricString::~OvmsMetricString()
   {
   }
 
-std::string OvmsMetricString::AsString(const char* defvalue, metric_unit_t units, int precision)
+void OvmsMetricString::AppendString(std::string& out, const char* defvalue, metric_unit_t units, int precision)
   {
   if (IsDefined())
     {
     OvmsMutexLock lock(&m_mutex);
-    return m_value;
+    out.append(m_value);
+    }
+  else
+    {
+    out.append(defvalue);
+    }
+  }
+
+void OvmsMetricString::AppendJSON(std::string& out, const char* defvalue, metric_unit_t units, int precision)
+  {
+  out.append(1, '"');
+  if (IsDefined())
+    {
+    OvmsMutexLock lock(&m_mutex);
+    out.append(json_encode(m_value));
     }
   else
     {
-    return std::string(defvalue);
+    out.append(json_encode(std::string(defvalue)));
     }
+  out.append(1, '"');
   }
 
 void OvmsMetricString::SetValue(std::string value)
@@ -41,8 +41,14 @@
 #include <set>
 #include <vector>
 #include <atomic>
+#include <limits>
+#include <math.h>
+#include <stdlib.h>
 #include "ovms_utils.h"
 #include "ovms_mutex.h"
+#include "ovms_numfmt.h"
+
+class OvmsProfileEntry;
 
 #define METRICS_MAX_MODIFIERS 32
 
@@ -110,6 +116,98 @@ extern const char* OvmsMetricUnitLabel(metric_unit_t units);
 extern int UnitConvert(metric_unit_t from, metric_unit_t to, int value);
 extern float UnitConvert(metric_unit_t from, metric_unit_t to, float value);
 
+constexpr float OvmsMetricPow10(int n)
+  {
+  return (n <= 0) ? 1.0f : 10.0f * OvmsMetricPow10(n-1);
+  }
+
+/**
+ * Compact binary value encoding (i.e. for the web UI binary metrics protocol)
+ *  - integers are written as varints (7 bits per byte, LSB first), signed
+ *    integers zigzag encoded (0,-1,1,-2,… → 0,1,2,3,…)
+ *  - floats are written as 32 bit IEEE little endian
+ *  - integer vectors are written as count + deltas to the previous element,
+ *    so similar values (i.e. cell voltages) need one byte each
+ *  - fixed point vectors are integer vectors, the decimals are given by
+ *    GetWireDecimals()
+ */
+typedef enum : uint8_t
+  {
+  MetricWire_String = 0,        // varint length + UTF-8 chars (AsString)
+  MetricWire_Bool,              // 1 byte
+  MetricWire_Int,               // zigzag varint
+  MetricWire_Float,             // float32
+  MetricWire_IntVector,         // varint count + zigzag varint deltas
+  MetricWire_FloatVector,       // varint count + float32 values
+  } metric_wire_t;
+
+inline void metric_append_varint(std::string& out, uint32_t value)
+  {
+  while (value >= 0x80)
+    {
+    out.append(1, (char)(value | 0x80));
+    value >>= 7;
+    }
+  out.append(1, (char)value);
+  }
+
+inline void metric_append_zigzag(std::string& out, int32_t value)
+  {
+  metric_append_varint(out, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+  }
+
+inline void metric_append_float(std::string& out, float value)
+  {
+  out.append((const char*)&value, sizeof(value));
+  }
+
+// Vector element encoding (delta to previous element for integers):
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value>::type
+metric_append_elem(std::string& out, T value, int32_t& last)
+  {
+  metric_append_zigzag(out, (int32_t)value - last);
+  last = (int32_t)value;
+  }
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type
+metric_append_elem(std::string& out, T value, int32_t& last)
+  {
+  metric_append_float(out, (float)value);
+  }
+
+template <typename T>
+inline typename std::enable_if<!std::is_arithmetic<T>::value>::type
+metric_append_elem(std::string& out, const T& value, int32_t& last)
+  {
+  }
+
+class OvmsMetric;
+
+typedef std::function<void(OvmsMetric*)> MetricCallback;
+
+class MetricCallbackEntry
+  {
+  public:
+    MetricCallbackEntry(const char* caller, const char* name, MetricCallback callback, bool deferred=false);
+    virtual ~MetricCallbackEntry();
+
+  public:
+    const char *m_caller;
+    const char *m_name;
+    MetricCallback m_callback;
+    bool m_deferred;                    // called once per tick with the latest value
+    OvmsProfileEntry* m_profile;
+  };
+
+typedef std::list<MetricCallbackEntry*> MetricCallbackList;
+typedef std::map<const char*, MetricCallbackList*, CmpStrOp> MetricCallbackMap;
+
+// Listener flags (OvmsMetric::m_listen, OvmsMetrics::m_listen_all):
+#define METRIC_LISTEN_IMMEDIATE   0x01
+#define METRIC_LISTEN_DEFERRED    0x02
+
 class OvmsMetric
   {
   public:
@@ -120,6 +218,12 @@ class OvmsMetric
     virtual std::string AsString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
     std::string AsUnitString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
     virtual std::string AsJSON(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    virtual void AppendString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    void AppendUnitString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    virtual void AppendJSON(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    virtual metric_wire_t GetWireType() { return MetricWire_String; }
+    virtual int GetWireDecimals() { return 0; }
+    virtual void AppendBinary(std::string& out);
     virtual float AsFloat(const float defvalue = 0, metric_unit_t units = Other);
     virtual void SetValue(std::string value);
     virtual void operator=(std::string value);
@@ -145,6 +249,9 @@ class OvmsMetric
     metric_unit_t m_units;
     metric_defined_t m_defined;
     bool m_stale;
+    MetricCallbackList* m_listeners;    // NULL if the metric has no listeners
+    uint8_t m_listen;                   // METRIC_LISTEN_* flags of m_listeners
+    std::atomic_bool m_notify_deferred; // modified since the last deferred dispatch
   };
 
 class OvmsMetricBool : public OvmsMetric
@@ -154,8 +261,10 @@ class OvmsMetricBool : public OvmsMetric
     virtual ~OvmsMetricBool();
 
   public:
-    std::string AsString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
-    virtual std::string AsJSON(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    void AppendString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    void AppendJSON(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    metric_wire_t GetWireType() { return MetricWire_Bool; }
+    void AppendBinary(std::string& out);
     float AsFloat(const float defvalue = 0, metric_unit_t units = Other);
     int AsBool(const bool defvalue = false);
     void SetValue(bool value);
@@ -174,8 +283,10 @@ class OvmsMetricInt : public OvmsMetric
     virtual ~OvmsMetricInt();
 
   public:
-    std::string AsString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
-    virtual std::string AsJSON(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    void AppendString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    void AppendJSON(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    metric_wire_t GetWireType() { return MetricWire_Int; }
+    void AppendBinary(std::string& out);
     float AsFloat(const float defvalue = 0, metric_unit_t units = Other);
     int AsInt(const int defvalue = 0, metric_unit_t units = Other);
     void SetValue(int value, metric_unit_t units = Other);
@@ -194,8 +305,10 @@ class OvmsMetricFloat : public OvmsMetric
     virtual ~OvmsMetricFloat();
 
   public:
-    std::string AsString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
-    virtual std::string AsJSON(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    void AppendString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    void AppendJSON(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    metric_wire_t GetWireType() { return MetricWire_Float; }
+    void AppendBinary(std::string& out);
     float AsFloat(const float defvalue = 0, metric_unit_t units = Other);
     int AsInt(const int defvalue = 0, metric_unit_t units = Other);
     void SetValue(float value, metric_unit_t units = Other);
@@ -214,7 +327,8 @@ class OvmsMetricString : public OvmsMetric
     virtual ~OvmsMetricString();
 
   public:
-    std::string AsString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    void AppendString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
+    void AppendJSON(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1);
     void SetValue(std::string value);
     void operator=(std::string value) { SetValue(value); }
 
@@ -241,36 +355,39 @@ class OvmsMetricBitset : public OvmsMetric
       }
 
   public:
-    std::string AsString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
+    void AppendString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
       {
       if (!IsDefined())
-        return std::string(defvalue);
-      std::ostringstream ss;
+        {
+        out.append(defvalue);
+        return;
+        }
+      bool first = true;
       OvmsMutexLock lock(&m_mutex);
       for (int i = 0; i < N; i++)
         {
         if (m_value[i])
           {
-          if (ss.tellp() > 0)
-            ss << ',';
-          ss << i+1;
+          if (!first)
+            out.append(1, ',');
+          num_append(out, i+1);
+          first = false;
           }
         }
-      return ss.str();
       }
 
     void SetValue(std::string value)
       {
       std::bitset<N> n_value;
-      std::istringstream vs(value);
-      std::string token;
-      int elem;
-      while(std::getline(vs, token, ','))
+      const char* s = value.c_str();
+      while (*s)
         {
-        std::istringstream ts(token);
-        ts >> elem;
+        int elem;
+        const char* e = num_parse(s, &elem);
         if (elem > 0 && elem <= N)
           n_value[elem-1] = 1;
+        while (*e && *e != ',') e++;
+        s = (*e == ',') ? e+1 : e;
         }
       SetValue(n_value);
       }
@@ -324,32 +441,33 @@ class OvmsMetricSet : public OvmsMetric
       }
 
   public:
-    std::string AsString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
+    void AppendString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
       {
       if (!IsDefined())
-        return std::string(defvalue);
-      std::ostringstream ss;
+        {
+        out.append(defvalue);
+        return;
+        }
       OvmsMutexLock lock(&m_mutex);
       for (auto i = m_value.begin(); i != m_value.end(); i++)
         {
-        if (ss.tellp() > 0)
-          ss << ',';
-        ss << *i;
+        if (i != m_value.begin())
+          out.append(1, ',');
+        num_append(out, *i);
         }
-      return ss.str();
       }
 
     void SetValue(std::string value)
       {
       std::set<ElemType> n_value;
-      std::istringstream vs(value);
-      std::string token;
-      ElemType elem;
-      while(std::getline(vs, token, ','))
+      const char* s = value.c_str();
+      while (*s)
         {
-        std::istringstream ts(token);
-        ts >> elem;
+        ElemType elem{};
+        const char* e = num_parse(s, &elem);
         n_value.insert(elem);
+        while (*e && *e != ',') e++;
+        s = (*e == ',') ? e+1 : e;
         }
       SetValue(n_value);
       }
@@ -417,45 +535,64 @@ class OvmsMetricVector : public OvmsMetric
       }
 
   public:
-    virtual std::string AsString(const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
+    virtual void AppendString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
       {
       if (!IsDefined())
-        return std::string(defvalue);
-      std::ostringstream ss;
-      if (precision >= 0)
         {
-        ss.precision(precision); // Set desired precision
-        ss << fixed;
+        out.append(defvalue);
+        return;
         }
       OvmsMutexLock lock(&m_mutex);
       for (auto i = m_value.begin(); i != m_value.end(); i++)
         {
-        if (ss.tellp() > 0)
-          ss << ',';
-        ss << *i;
+        if (i != m_value.begin())
+          out.append(1, ',');
+        num_append(out, *i, precision);
         }
-      return ss.str();
       }
 
-    virtual std::string AsJSON(const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
+    virtual void AppendJSON(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
+      {
+      out.append(1, '[');
+      AppendString(out, defvalue, units, precision);
+      out.append(1, ']');
+      }
+
+    virtual metric_wire_t GetWireType()
       {
-      std::string json = "[";
-      json += AsString(defvalue, units, precision);
-      json += "]";
-      return json;
+      if (std::is_floating_point<ElemType>::value)
+        return MetricWire_FloatVector;
+      else if (std::is_integral<ElemType>::value)
+        return MetricWire_IntVector;
+      else
+        return MetricWire_String;
+      }
+
+    virtual void AppendBinary(std::string& out)
+      {
+      if (GetWireType() == MetricWire_String)
+        {
+        OvmsMetric::AppendBinary(out);
+        return;
+        }
+      OvmsMutexLock lock(&m_mutex);
+      metric_append_varint(out, m_value.size());
+      int32_t last = 0;
+      for (auto i = m_value.begin(); i != m_value.end(); i++)
+        metric_append_elem(out, *i, last);
       }
 
     virtual void SetValue(std::string value)
       {
       std::vector<ElemType, Allocator> n_value;
-      std::istringstream vs(value);
-      std::string token;
-      ElemType elem;
-      while(std::getline(vs, token, ','))
+      const char* s = value.c_str();
+      while (*s)
         {
-        std::istringstream ts(token);
-        ts >> elem;
+        ElemType elem{};
+        const char* e = num_parse(s, &elem);
         n_value.push_back(elem);
+        while (*e && *e != ',') e++;
+        s = (*e == ',') ? e+1 : e;
         }
       SetValue(n_value);
       }
@@ -550,21 +687,199 @@ class OvmsMetricVector : public OvmsMetric
   };
 
 
-typedef std::function<void(OvmsMetric*)> MetricCallback;
-
-class MetricCallbackEntry
+/**
+ * OvmsMetricFixedVector<type,decimals>: fixed point vector metric
+ *  - values are stored as integers of StoreType scaled by 10^Decimals,
+ *    i.e. OvmsMetricFixedVector<int16_t,3> stores Volts as millivolts
+ *  - float API compatible with OvmsMetricVector<float> for Set/GetElemValue(s)
+ *  - bulk access (SetElemValues/GetElemValues) under a single lock
+ *  - string representation as comma separated values
+ *  - values exceeding the StoreType range saturate at its min/max, e.g.
+ *    <uint16_t,3> covers 0 … 65.535, <int16_t,2> covers ±327.67; use a wider
+ *    StoreType (e.g. uint32_t) for quantities that may exceed this
+ *
+ * Usage example:
+ *  OvmsMetricFixedVector<int16_t,3>* cv = new OvmsMetricFixedVector<int16_t,3>("test.cell.volts", SM_STALE_MIN, Volts);
+ *  float myvals[3] = { 3.912, 3.915, 3.908 };
+ *  cv->SetElemValues(0, 3, myvals);
+ */
+template
+  <
+  typename StoreType,
+  int Decimals,
+  class Allocator = std::allocator<StoreType>
+  >
+class OvmsMetricFixedVector : public OvmsMetric
   {
   public:
-    MetricCallbackEntry(const char* caller, MetricCallback callback);
-    virtual ~MetricCallbackEntry();
+    OvmsMetricFixedVector(const char* name, uint16_t autostale=0, metric_unit_t units = Other)
+      : OvmsMetric(name, autostale, units)
+      {
+      }
+    virtual ~OvmsMetricFixedVector()
+      {
+      }
 
   public:
-    const char *m_caller;
-    MetricCallback m_callback;
+    static StoreType Encode(float value)
+      {
+      float scaled = roundf(value * Scale());
+      if (scaled < (float) std::numeric_limits<StoreType>::min())
+        return std::numeric_limits<StoreType>::min();
+      if (scaled > (float) std::numeric_limits<StoreType>::max())
+        return std::numeric_limits<StoreType>::max();
+      return (StoreType) scaled;
+      }
+    static float Decode(StoreType value)
+      {
+      return (float) value / Scale();
+      }
+    static constexpr float Scale()
+      {
+      return OvmsMetricPow10(Decimals);
+      }
+
+  public:
+    virtual void AppendString(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
+      {
+      if (!IsDefined())
+        {
+        out.append(defvalue);
+        return;
+        }
+      char buf[NUMFMT_BUFSIZE];
+      OvmsMutexLock lock(&m_mutex);
+      out.reserve(out.size() + m_value.size() * (Decimals + 4));
+      for (auto i = m_value.begin(); i != m_value.end(); i++)
+        {
+        if (i != m_value.begin())
+          out.append(1, ',');
+        out.append(buf, num_format_scaled(buf, *i, Decimals, precision) - buf);
+        }
+      }
+
+    virtual void AppendJSON(std::string& out, const char* defvalue = "", metric_unit_t units = Other, int precision = -1)
+      {
+      out.append(1, '[');
+      AppendString(out, defvalue, units, precision);
+      out.append(1, ']');
+      }
+
+    virtual metric_wire_t GetWireType() { return MetricWire_IntVector; }
+    virtual int GetWireDecimals() { return Decimals; }
+
+    virtual void AppendBinary(std::string& out)
+      {
+      OvmsMutexLock lock(&m_mutex);
+      metric_append_varint(out, m_value.size());
+      int32_t last = 0;
+      for (auto i = m_value.begin(); i != m_value.end(); i++)
+        metric_append_elem(out, *i, last);
+      }
+
+    virtual void SetValue(std::string value)
+      {
+      std::vector<StoreType, Allocator> n_value;
+      const char* s = value.c_str();
+      while (*s)
+        {
+        float elem;
+        const char* e = num_parse_float(s, &elem);
+        n_value.push_back(Encode(elem));
+        while (*e && *e != ',') e++;
+        s = (*e == ',') ? e+1 : e;
+        }
+      SetValue(n_value);
+      }
+    void operator=(std::string value) { SetValue(value); }
+
+    void SetValue(const std::vector<StoreType, Allocator>& value, metric_unit_t units = Other)
+      {
+      if (m_mutex.Lock())
+        {
+        bool modified = false;
+        if (m_value != value)
+          {
+          m_value = value;
+          modified = true;
+          }
+        m_mutex.Unlock();
+        SetModified(modified);
+        }
+      }
+
+    void ClearValue()
+      {
+      if (IsDefined())
+        {
+        if (m_mutex.Lock())
+          {
+          m_value.clear();
+          m_mutex.Unlock();
+          }
+        SetModified(true);
+        }
+      }
+
+    size_t GetSize()
+      {
+      OvmsMutexLock lock(&m_mutex);
+      return m_value.size();
+      }
+
+    float GetElemValue(size_t n)
+      {
+      StoreType val{};
+      OvmsMutexLock lock(&m_mutex);
+      if (m_value.size() > n)
+        val = m_value[n];
+      return Decode(val);
+      }
+
+    // GetElemValues: copy cnt values beginning at start, returns number of values copied
+    size_t GetElemValues(size_t start, size_t cnt, float* values)
+      {
+      OvmsMutexLock lock(&m_mutex);
+      if (start >= m_value.size())
+        return 0;
+      if (start + cnt > m_value.size())
+        cnt = m_value.size() - start;
+      for (size_t i = 0; i < cnt; i++)
+        values[i] = Decode(m_value[start+i]);
+      return cnt;
+      }
+
+    void SetElemValue(size_t n, float value)
+      {
+      SetElemValues(n, 1, &value);
+      }
+
+    void SetElemValues(size_t start, size_t cnt, const float* values)
+      {
+      bool modified = false;
+      if (m_mutex.Lock())
+        {
+        if (m_value.size() < start+cnt)
+          m_value.resize(start+cnt);
+        for (size_t i = 0; i < cnt; i++)
+          {
+          StoreType v = Encode(values[i]);
+          if (m_value[start+i] != v)
+            {
+            m_value[start+i] = v;
+            modified = true;
+            }
+          }
+        m_mutex.Unlock();
+        }
+      SetModified(modified);
+      }
+
+  protected:
+    OvmsMutex m_mutex;
+    std::vector<StoreType, Allocator> m_value;
   };
 
-typedef std::list<MetricCallbackEntry*> MetricCallbackList;
-typedef std::map<const char*, MetricCallbackList*, CmpStrOp> MetricCallbackMap;
 
 class OvmsMetrics
   {
@@ -607,12 +922,22 @@ class OvmsMetrics
       }
 
   public:
-    void RegisterListener(const char* caller, const char* name, MetricCallback callback);
+    void RegisterListener(const char* caller, const char* name, MetricCallback callback, bool deferred=false);
     void DeregisterListener(const char* caller);
     void NotifyModified(OvmsMetric* metric);
+    void NotifyDeferred(std::string event, void* data);
+
+  protected:
+    void CallListeners(MetricCallbackList* ml, OvmsMetric* metric, bool deferred);
+    static uint8_t ListenFlags(MetricCallbackList* ml);
 
   protected:
-    MetricCallbackMap m_listeners;
+    MetricCallbackList m_listeners_all; // "*" listeners
+    MetricCallbackMap m_listeners;      // listeners of metrics not (yet) registered
+
+  public:
+    uint8_t m_listen_all;               // METRIC_LISTEN_* flags of m_listeners_all
+    bool m_listen_deferred;             // any deferred listeners registered
 
   public:
     size_t RegisterModifier();
@@ -623,6 +948,7 @@ class OvmsMetrics
   public:
     OvmsMetric* m_first;
     bool m_trace;
+    uint32_t m_listversion;           // incremented on metric (de)registration
   };
 
 extern OvmsMetrics MyMetrics;
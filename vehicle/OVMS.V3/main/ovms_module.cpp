@@ -47,6 +47,7 @@ static const char *TAG = "ovms-module";
 #include "esp_heap_task_info.h"
 #endif
 #include "ovms_boot.h"
+#include "ovms_profiler.h"
 
 #define MAX_TASKS 30
 #define DUMPSIZE 1000
@@ -709,7 +710,7 @@ static void module_memory(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, i
 static void module_tasks(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   UBaseType_t num = uxTaskGetNumberOfTasks();
-  writer->printf("Number of Tasks =%3u%s  Stack:  Now   Max Total    Heap 32-bit SPIRAM C# PRI\n", num,
+  writer->printf("Number of Tasks =%3u%s  Stack:  Now   Max Total    Heap 32-bit SPIRAM C# PRI  CPU%%\n", num,
     num > MAX_TASKS ? ">max" : "    ");
   if (!allocate())
     {
@@ -737,10 +738,16 @@ static void module_tasks(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, in
         uint32_t total = (uint32_t)taskstatus[i].pxStackBase >> 16;
         uint32_t used = total - ((uint32_t)taskstatus[i].pxStackBase & 0xFFFF);
         int core = xTaskGetAffinity(taskstatus[i].xHandle);
-        writer->printf("%08X %2u %s %-15s %5u %5u %5u %7u%7u%7u  %c %3d\n", taskstatus[i].xHandle,
+        int load = MyProfiler.GetTaskLoad(taskstatus[i].xHandle);
+        char cpu[8];
+        if (load < 0)
+          strcpy(cpu, "    -");
+        else
+          snprintf(cpu, sizeof(cpu), "%5.1f", load / 10.0);
+        writer->printf("%08X %2u %s %-15s %5u %5u %5u %7u%7u%7u  %c %3d %s\n", taskstatus[i].xHandle,
           taskstatus[i].xTaskNumber, states[taskstatus[i].eCurrentState], taskstatus[i].pcTaskName,
           used, total - taskstatus[i].usStackHighWaterMark, total, heaptotal, heap32bit, heapspi,
-          (core == tskNO_AFFINITY) ? '*' : '0'+core, taskstatus[i].uxCurrentPriority);
+          (core == tskNO_AFFINITY) ? '*' : '0'+core, taskstatus[i].uxCurrentPriority, cpu);
         if (showStack)
           {
           uint32_t* stack = (uint32_t*)(pxTaskGetStackStart(taskstatus[i].xHandle) + total);
@@ -769,6 +776,17 @@ static void module_check(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, in
   }
 #endif // NOGO
 
+static void module_profile(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
+  {
+  if (strcmp(cmd->GetName(), "reset") == 0)
+    {
+    MyProfiler.Reset();
+    writer->puts("Profiler statistics reset");
+    return;
+    }
+  MyProfiler.Output(writer, verbosity);
+  }
+
 static void module_fault(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, const char* const* argv)
   {
   ESP_LOGI(TAG,"Abort faulting module (on command)");
@@ -897,6 +915,8 @@ class OvmsModuleInit
     cmd_module->RegisterCommand("leaks","Show module memory changes",module_memory,"[<task names or ids>|*|=]",0,TASKLIST,true);
     OvmsCommand* cmd_tasks = cmd_module->RegisterCommand("tasks","Show module task usage",module_tasks,"[stack]",0,1,true);
     cmd_tasks->RegisterCommand("stack","Show module task usage with stack",module_tasks,"",0,0,true);
+    OvmsCommand* cmd_profile = cmd_module->RegisterCommand("profile","Show task CPU load, queue and callback timing",module_profile,"[reset]",0,1,true);
+    cmd_profile->RegisterCommand("reset","Reset profiler statistics",module_profile,"",0,0,true);
     cmd_module->RegisterCommand("fault","Abort fault the module",module_fault,"",0,0,true);
     cmd_module->RegisterCommand("reset","Reset module",module_reset,"",0,0,true);
     cmd_module->RegisterCommand("check","Check heap integrity",module_check,"",0,0,true);
@@ -33,7 +33,11 @@ static const char *TAG = "notify";
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include <sstream>
+#include <esp_system.h>
 #include "ovms.h"
 #include "ovms_notify.h"
 #include "ovms_command.h"
@@ -44,6 +48,7 @@ static const char *TAG = "notify";
 #include "string.h"
 
 using namespace std;
+using namespace std::placeholders;
 
 ////////////////////////////////////////////////////////////////////////
 // Console commands...
@@ -76,8 +81,15 @@ void notify_status(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc
     for (OvmsNotifyTypeMap_t::iterator itm=MyNotify.m_types.begin(); itm!=MyNotify.m_types.end(); ++itm)
       {
       OvmsNotifyType* mt = itm->second;
-      writer->printf("  %s: %d entries\n",
-        mt->m_name, mt->m_entries.size());
+      writer->printf("  %s: %d entries (%d bytes)\n",
+        mt->m_name, mt->m_entries.size(), mt->m_ramsize);
+      OvmsNotifySpool* sp = mt->m_spool;
+      if (sp && (sp->m_open || sp->m_spilled))
+        {
+        writer->printf("    spool: %d pending (%d bytes), %u spilled, %u loaded, %u dropped, %u compactions, %u errors\n",
+          sp->m_count, sp->m_end - sp->m_readpos, sp->m_spilled, sp->m_loadcnt,
+          sp->m_dropped, sp->m_compactions, sp->m_errors);
+        }
       for (NotifyEntryMap_t::iterator ite=mt->m_entries.begin(); ite!=mt->m_entries.end(); ++ite)
         {
         OvmsNotifyEntry* e = ite->second;
@@ -138,6 +150,7 @@ OvmsNotifyEntry::OvmsNotifyEntry(const char* subtype)
   m_created = monotonictime;
   m_type = NULL;
   m_subtype = strdup(subtype);
+  m_spooled = false;
   }
 
 OvmsNotifyEntry::~OvmsNotifyEntry()
@@ -230,6 +243,438 @@ const extram::string OvmsNotifyEntryCommand::GetValue()
   return m_value;
   }
 
+////////////////////////////////////////////////////////////////////////
+// OvmsNotifySpool is the file store for entries exceeding the RAM budget
+// of their type. Records are appended to <spool.path>/<type>.spool and
+// loaded back in order. Entries loaded into RAM are tracked until all
+// readers have processed them; only then the persisted read position
+// (header "commit") advances, so a reboot delivers them again.
+
+#define SPOOL_HEADERSIZE sizeof(OvmsNotifySpoolHeader_t)
+
+static size_t notify_entry_size(OvmsNotifyEntry* entry)
+  {
+  return sizeof(OvmsNotifyEntryString) + strlen(entry->m_subtype) + entry->GetValueSize();
+  }
+
+static bool notify_time_valid(time_t t)
+  {
+  return (t > 1500000000);
+  }
+
+OvmsNotifySpool::OvmsNotifySpool(OvmsNotifyType* type)
+  {
+  m_type = type;
+  m_open = false;
+  m_commit = m_readpos = m_end = SPOOL_HEADERSIZE;
+  m_count = 0;
+  m_spilled = 0;
+  m_loadcnt = 0;
+  m_dropped = 0;
+  m_compactions = 0;
+  m_errors = 0;
+  }
+
+OvmsNotifySpool::~OvmsNotifySpool()
+  {
+  }
+
+/**
+ * Open: check / recover the spool file on first use
+ *  Records from a previous boot get new IDs and their readers are
+ *  determined again when loading.
+ */
+bool OvmsNotifySpool::Open()
+  {
+  OvmsMutexLock lock(&m_mutex);
+  return OpenFile();
+  }
+
+bool OvmsNotifySpool::OpenFile()
+  {
+  if (m_open)
+    return true;
+  if (MyNotify.m_spool_path.empty())
+    return false;
+
+  m_path = MyNotify.m_spool_path + "/" + m_type->m_name + ".spool";
+  m_loaded.clear();
+  m_count = 0;
+
+  OvmsNotifySpoolHeader_t hdr;
+  FILE* f = fopen(m_path.c_str(), "rb");
+  if (f && fread(&hdr, sizeof(hdr), 1, f) == 1 && memcmp(hdr.magic, NOTIFY_SPOOL_MAGIC, 4) == 0)
+    {
+    fseek(f, 0, SEEK_END);
+    uint32_t filesize = ftell(f);
+    m_commit = (hdr.commit >= SPOOL_HEADERSIZE && hdr.commit <= filesize) ? hdr.commit : filesize;
+    m_readpos = m_end = m_commit;
+    // Find the last complete record (a power loss may leave a partial one):
+    OvmsNotifySpoolRecord_t rec;
+    while (fseek(f, m_end, SEEK_SET) == 0 && fread(&rec, sizeof(rec), 1, f) == 1
+      && rec.size > sizeof(rec) && m_end + rec.size <= filesize)
+      {
+      m_end += rec.size;
+      m_count++;
+      }
+    fclose(f);
+    m_open = true;
+    if (hdr.bootid != MyNotify.m_bootid || m_end != filesize || m_commit > SPOOL_HEADERSIZE)
+      {
+      if (!Compact(hdr.bootid != MyNotify.m_bootid))
+        {
+        m_open = false;
+        return false;
+        }
+      }
+    if (m_count)
+      ESP_LOGI(TAG, "Spool %s: %d entries pending", m_path.c_str(), m_count);
+    }
+  else
+    {
+    if (f)
+      fclose(f);
+    mkpath(MyNotify.m_spool_path);
+    if (!Reset())
+      return false;
+    m_open = true;
+    }
+  return true;
+  }
+
+/**
+ * Close: forget the file state (i.e. on path change), only if no loaded entries are pending
+ */
+void OvmsNotifySpool::Close()
+  {
+  OvmsMutexLock lock(&m_mutex);
+  if (m_loaded.empty())
+    m_open = false;
+  }
+
+/**
+ * Reset: create empty spool file
+ */
+bool OvmsNotifySpool::Reset()
+  {
+  m_commit = m_readpos = m_end = SPOOL_HEADERSIZE;
+  m_count = 0;
+  FILE* f = fopen(m_path.c_str(), "wb");
+  if (!f)
+    {
+    m_errors++;
+    m_open = false;
+    ESP_LOGW(TAG, "Spool %s: cannot create file", m_path.c_str());
+    return false;
+    }
+  OvmsNotifySpoolHeader_t hdr = {};
+  memcpy(hdr.magic, NOTIFY_SPOOL_MAGIC, 4);
+  hdr.bootid = MyNotify.m_bootid;
+  hdr.commit = m_commit;
+  bool ok = (fwrite(&hdr, sizeof(hdr), 1, f) == 1);
+  fclose(f);
+  if (!ok)
+    {
+    m_errors++;
+    m_open = false;
+    }
+  return ok;
+  }
+
+bool OvmsNotifySpool::WriteHeader()
+  {
+  FILE* f = fopen(m_path.c_str(), "r+b");
+  if (!f)
+    {
+    m_errors++;
+    return false;
+    }
+  OvmsNotifySpoolHeader_t hdr = {};
+  memcpy(hdr.magic, NOTIFY_SPOOL_MAGIC, 4);
+  hdr.bootid = MyNotify.m_bootid;
+  hdr.commit = m_commit;
+  bool ok = (fwrite(&hdr, sizeof(hdr), 1, f) == 1);
+  fclose(f);
+  if (!ok)
+    m_errors++;
+  return ok;
+  }
+
+/**
+ * Compact: copy the undelivered records [m_commit,m_end) to a new file
+ *  renumber: assign new entry IDs (records from a previous boot)
+ *  skipfrom/skipto: range of dropped records (not loaded) to leave out
+ */
+bool OvmsNotifySpool::Compact(bool renumber, uint32_t skipfrom, uint32_t skipto)
+  {
+  std::string tmppath = m_path + ".tmp";
+  FILE* src = fopen(m_path.c_str(), "rb");
+  FILE* dst = fopen(tmppath.c_str(), "wb");
+  bool ok = (src && dst);
+
+  OvmsNotifySpoolHeader_t hdr = {};
+  memcpy(hdr.magic, NOTIFY_SPOOL_MAGIC, 4);
+  hdr.bootid = MyNotify.m_bootid;
+  hdr.commit = SPOOL_HEADERSIZE;
+  ok = ok && (fwrite(&hdr, sizeof(hdr), 1, dst) == 1);
+
+  ok = ok && (fseek(src, m_commit, SEEK_SET) == 0);
+  char buf[256];
+  uint32_t pos = m_commit;
+  while (ok && pos < m_end)
+    {
+    if (pos == skipfrom && skipto > skipfrom)
+      {
+      pos = skipto;
+      ok = (fseek(src, pos, SEEK_SET) == 0);
+      continue;
+      }
+    OvmsNotifySpoolRecord_t rec;
+    ok = (fread(&rec, sizeof(rec), 1, src) == 1);
+    if (!ok)
+      break;
+    if (renumber)
+      {
+      rec.id = m_type->AllocateNextID();
+      rec.pending = 0;
+      }
+    ok = (fwrite(&rec, sizeof(rec), 1, dst) == 1);
+    for (uint32_t left = rec.size - sizeof(rec); ok && left > 0; )
+      {
+      size_t n = (left < sizeof(buf)) ? left : sizeof(buf);
+      ok = (fread(buf, n, 1, src) == 1 && fwrite(buf, n, 1, dst) == 1);
+      left -= n;
+      }
+    pos += rec.size;
+    }
+  if (src)
+    fclose(src);
+  if (dst)
+    fclose(dst);
+
+  if (ok)
+    {
+    unlink(m_path.c_str());
+    ok = (rename(tmppath.c_str(), m_path.c_str()) == 0);
+    }
+  if (!ok)
+    {
+    m_errors++;
+    unlink(tmppath.c_str());
+    ESP_LOGW(TAG, "Spool %s: compaction failed", m_path.c_str());
+    return false;
+    }
+
+  // Loaded records are below the skipped range, the read position at its end:
+  uint32_t shift = m_commit - SPOOL_HEADERSIZE;
+  uint32_t skipped = (skipto > skipfrom) ? skipto - skipfrom : 0;
+  m_commit -= shift;
+  m_readpos -= shift + ((m_readpos >= skipto) ? skipped : 0);
+  m_end -= shift + skipped;
+  for (auto& l : m_loaded)
+    l.second -= shift;
+  m_compactions++;
+  return true;
+  }
+
+/**
+ * Commit: advance the persisted read position to the first entry not yet
+ *  processed by all readers, truncate the file when everything is delivered
+ */
+void OvmsNotifySpool::Commit()
+  {
+  uint32_t commit = m_readpos;
+  for (auto& l : m_loaded)
+    {
+    if (l.second < commit)
+      commit = l.second;
+    }
+  if (commit == m_commit)
+    return;
+  m_commit = commit;
+  if (m_commit == m_end)
+    Reset();
+  else
+    WriteHeader();
+  }
+
+/**
+ * Append: spool an entry
+ *  Returns false if the entry needs to stay in RAM (no spool file or entry
+ *  exceeds the spool size), true if spooled or dropped (spool full).
+ */
+bool OvmsNotifySpool::Append(OvmsNotifyEntry* entry)
+  {
+  OvmsMutexLock lock(&m_mutex);
+  if (!OpenFile())
+    return false;
+
+  extram::string value = entry->GetValue();
+  size_t subtypelen = strlen(entry->m_subtype) + 1;
+  OvmsNotifySpoolRecord_t rec;
+  rec.size = sizeof(rec) + subtypelen + value.size();
+  rec.id = entry->m_id;
+  rec.created = entry->m_created;
+  time_t now = time(NULL);
+  rec.utc = notify_time_valid(now) ? now - (monotonictime - entry->m_created) : 0;
+  rec.pending = entry->m_pendingreaders;
+  if (SPOOL_HEADERSIZE + rec.size > MyNotify.m_spool_size)
+    return false;
+
+  // Make room:
+  if (m_end + rec.size > MyNotify.m_spool_size && m_commit > SPOOL_HEADERSIZE)
+    Compact(false);
+  if (m_end + rec.size > MyNotify.m_spool_size)
+    {
+    // Spool full: drop the oldest entries not yet loaded, free a quarter of
+    //  the file at once to avoid compacting on every append. Loaded entries
+    //  (still pending in RAM) stay in the file up to their delivery.
+    FILE* f = fopen(m_path.c_str(), "rb");
+    OvmsNotifySpoolRecord_t old;
+    uint32_t skipfrom = m_readpos, dropped = 0;
+    while (f && m_readpos < m_end && m_end - (m_readpos - skipfrom) + rec.size > MyNotify.m_spool_size * 3 / 4
+      && fseek(f, m_readpos, SEEK_SET) == 0 && fread(&old, sizeof(old), 1, f) == 1)
+      {
+      m_readpos += old.size;
+      m_count--;
+      dropped++;
+      }
+    if (f)
+      fclose(f);
+    if (dropped)
+      {
+      m_dropped += dropped;
+      ESP_LOGW(TAG, "Spool %s full: %u oldest entries dropped", m_path.c_str(), dropped);
+      Compact(false, skipfrom, m_readpos);
+      }
+    }
+  if (m_end + rec.size > MyNotify.m_spool_size)
+    {
+    // Still full of loaded entries: drop the new entry, RAM use stays bounded
+    m_dropped++;
+    ESP_LOGW(TAG, "Spool %s full: entry %u dropped", m_path.c_str(), entry->m_id);
+    return true;
+    }
+
+  FILE* f = fopen(m_path.c_str(), "ab");
+  if (!f)
+    {
+    m_errors++;
+    return false;
+    }
+  bool ok = (fwrite(&rec, sizeof(rec), 1, f) == 1
+    && fwrite(entry->m_subtype, subtypelen, 1, f) == 1
+    && (value.empty() || fwrite(value.data(), value.size(), 1, f) == 1));
+  fclose(f);
+  if (!ok)
+    {
+    // drop the partial record on next open:
+    m_errors++;
+    m_open = false;
+    return false;
+    }
+  m_end += rec.size;
+  m_count++;
+  m_spilled++;
+  return true;
+  }
+
+/**
+ * Load: read the next spooled entry
+ *  Returns a new entry or NULL if the spool is empty.
+ */
+OvmsNotifyEntry* OvmsNotifySpool::Load()
+  {
+  OvmsMutexLock lock(&m_mutex);
+  if (!OpenFile())
+    return NULL;
+
+  OvmsNotifyEntry* entry = NULL;
+  FILE* f = NULL;
+  while (!entry && m_readpos < m_end)
+    {
+    OvmsNotifySpoolRecord_t rec;
+    if (!f)
+      f = fopen(m_path.c_str(), "rb");
+    if (!f || fseek(f, m_readpos, SEEK_SET) != 0 || fread(&rec, sizeof(rec), 1, f) != 1
+      || rec.size <= sizeof(rec) || m_readpos + rec.size > m_end)
+      {
+      // unreadable: skip the rest
+      m_errors++;
+      m_readpos = m_end;
+      m_count = 0;
+      break;
+      }
+    uint32_t pos = m_readpos;
+    m_readpos += rec.size;
+    m_count--;
+
+    extram::string data;
+    data.resize(rec.size - sizeof(rec));
+    if (fread(&data[0], data.size(), 1, f) != 1 || memchr(data.data(), 0, data.size()) == NULL)
+      {
+      m_errors++;
+      continue;
+      }
+    const char* subtype = data.c_str();
+    size_t subtypelen = strlen(subtype) + 1;
+    const char* value = subtype + subtypelen;
+
+    // Readers that may still need the entry:
+    unsigned long pending;
+    if (rec.pending)
+      {
+      // same boot: the readers recorded, unless cleared meanwhile
+      pending = rec.pending & MyNotify.GetSpoolReaders();
+      }
+    else if (MyNotify.GetSpoolReaders() == 0)
+      {
+      // previous boot, no reader registered yet (i.e. servers not started):
+      //  keep the entry and all following in the spool
+      m_readpos = pos;
+      m_count++;
+      break;
+      }
+    else
+      pending = MyNotify.GetSpoolReaders(m_type, subtype, data.size() - subtypelen);
+    if (!pending)
+      continue;
+
+    entry = new OvmsNotifyEntryString(subtype, value);
+    entry->m_id = rec.id;
+    entry->m_type = m_type;
+    entry->m_pendingreaders = pending;
+    entry->m_spooled = true;
+    time_t now = time(NULL);
+    if (rec.pending)
+      entry->m_created = rec.created; // same boot
+    else if (rec.utc && notify_time_valid(now))
+      entry->m_created = ((uint32_t)(now - rec.utc) < monotonictime) ? monotonictime - (now - rec.utc) : 0;
+    else
+      entry->m_created = monotonictime;
+    m_loaded[rec.id] = pos;
+    m_loadcnt++;
+    }
+  if (f)
+    fclose(f);
+  Commit();
+  return entry;
+  }
+
+/**
+ * Release: a loaded entry has been processed by all readers
+ */
+void OvmsNotifySpool::Release(OvmsNotifyEntry* entry)
+  {
+  OvmsMutexLock lock(&m_mutex);
+  auto k = m_loaded.find(entry->m_id);
+  if (k != m_loaded.end())
+    {
+    m_loaded.erase(k);
+    Commit();
+    }
+  }
+
 ////////////////////////////////////////////////////////////////////////
 // OvmsNotifyType is the container for an ordered list of
 // OvmsNotifyEntry objects (being the notification data queued)
@@ -238,10 +683,17 @@ OvmsNotifyType::OvmsNotifyType(const char* name)
   {
   m_name = name;
   m_nextid = 1;
+  m_ramsize = 0;
+  m_spool = NULL;
+  m_refilling = false;
+  for (int i=0; i<NOTIFY_MAX_READERS; i++)
+    m_cursor[i] = m_nextid;
   }
 
 OvmsNotifyType::~OvmsNotifyType()
   {
+  if (m_spool)
+    delete m_spool;
   }
 
 uint32_t OvmsNotifyType::QueueEntry(OvmsNotifyEntry* entry)
@@ -251,6 +703,7 @@ uint32_t OvmsNotifyType::QueueEntry(OvmsNotifyEntry* entry)
   entry->m_id = id;
   entry->m_type = this;
   m_entries[id] = entry;
+  m_ramsize += notify_entry_size(entry);
 
   if (strcmp(m_name, "data") != 0 &&
       strcmp(m_name, "stream") != 0)
@@ -259,7 +712,7 @@ uint32_t OvmsNotifyType::QueueEntry(OvmsNotifyEntry* entry)
     event.append(m_name);
     event.append(".");
     event.append(entry->m_subtype);
-    MyEvents.SignalEvent(event, (void*)id);
+    MyEvents.SignalEvent(event, (void*)(uintptr_t)id);
     }
 
   // Dispatch the callbacks...
@@ -268,6 +721,23 @@ uint32_t OvmsNotifyType::QueueEntry(OvmsNotifyEntry* entry)
   // Check if we can cleanup...
   Cleanup(entry);
 
+  // Spill to the spool if over budget (or to keep the order if the spool has entries),
+  // unless a reader may hold a pointer to the entry:
+  auto k = m_entries.find(id);
+  if (k != m_entries.end() && m_spool
+    && (m_ramsize > MyNotify.m_spool_ram || !m_spool->IsEmpty())
+    && (entry->m_pendingreaders & ~MyNotify.GetSpoolReaders()) == 0)
+    {
+    if (m_spool->Append(entry))
+      {
+      if (MyNotify.m_trace)
+        ESP_LOGI(TAG,"Spooled type %s id %d",m_name,id);
+      m_entries.erase(k);
+      m_ramsize -= notify_entry_size(entry);
+      delete entry;
+      }
+    }
+
   return id;
   }
 
@@ -280,7 +750,8 @@ void OvmsNotifyType::ClearReader(size_t reader)
   {
   if (m_entries.size() > 0)
     {
-    for (NotifyEntryMap_t::iterator ite=m_entries.begin(); ite!=m_entries.end(); )
+    // Entries below the reader cursor have been read already:
+    for (NotifyEntryMap_t::iterator ite=m_entries.lower_bound(m_cursor[reader]); ite!=m_entries.end(); )
       {
       OvmsNotifyEntry* e = ite->second;
       ++ite;
@@ -288,17 +759,29 @@ void OvmsNotifyType::ClearReader(size_t reader)
       Cleanup(e);
       }
     }
+  m_cursor[reader] = m_nextid;
   }
 
+/**
+ * FirstUnreadEntry: get the oldest entry with an ID above floor not yet read by reader
+ *  The reader cursor skips the read head of the queue, so draining a backlog
+ *  does not rescan entries already processed by the reader.
+ */
 OvmsNotifyEntry* OvmsNotifyType::FirstUnreadEntry(size_t reader, uint32_t floor)
   {
-  for (NotifyEntryMap_t::iterator ite=m_entries.begin(); ite!=m_entries.end(); ++ite)
+  Refill();
+  uint32_t& cursor = m_cursor[reader];
+  bool advance = (floor < cursor);
+  NotifyEntryMap_t::iterator ite = m_entries.lower_bound(advance ? cursor : floor+1);
+  for (; ite!=m_entries.end(); ++ite)
     {
     OvmsNotifyEntry* e = ite->second;
-    if ((!e->IsRead(reader))&&(e->m_id > floor))
-      return e;
+    if (!e->IsRead(reader))
+      break;
     }
-  return NULL;
+  if (advance)
+    cursor = (ite == m_entries.end()) ? m_nextid : ite->first;
+  return (ite == m_entries.end()) ? NULL : ite->second;
   }
 
 OvmsNotifyEntry* OvmsNotifyType::FindEntry(uint32_t id)
@@ -325,10 +808,54 @@ void OvmsNotifyType::Cleanup(OvmsNotifyEntry* entry)
     if (k != m_entries.end())
        {
        m_entries.erase(k);
+       m_ramsize -= notify_entry_size(entry);
        }
     if (MyNotify.m_trace)
       ESP_LOGI(TAG,"Cleanup type %s id %d",m_name,entry->m_id);
+    if (entry->m_spooled && m_spool)
+      m_spool->Release(entry);
     delete entry;
+    Refill();
+    }
+  }
+
+/**
+ * Refill: load spooled entries while below the RAM budget and pass
+ *  them to their pending readers
+ */
+void OvmsNotifyType::Refill()
+  {
+  if (!m_spool || m_refilling)
+    return;
+  m_refilling = true;
+  while (m_ramsize < MyNotify.m_spool_ram && !m_spool->IsEmpty())
+    {
+    OvmsNotifyEntry* e = m_spool->Load();
+    if (!e)
+      break;
+    m_entries[e->m_id] = e;
+    m_ramsize += notify_entry_size(e);
+    if (MyNotify.m_trace)
+      ESP_LOGI(TAG,"Loaded type %s id %d",m_name,e->m_id);
+    RewindCursors(e);
+    MyNotify.NotifyReaders(this, e, true);
+    Cleanup(e);
+    }
+  m_refilling = false;
+  }
+
+/**
+ * RewindCursors: move the cursors of the readers pending on an entry
+ *  back to it (entries loaded from the spool may be older than the
+ *  entries the readers have already passed)
+ */
+void OvmsNotifyType::RewindCursors(OvmsNotifyEntry* entry)
+  {
+  unsigned long pend = entry->m_pendingreaders;
+  for (int i=0; pend; i++, pend >>= 1)
+    {
+    if ((pend & 1) && m_cursor[i] > entry->m_id)
+      m_cursor[i] = entry->m_id;
     }
   }
 
@@ -337,7 +864,8 @@ void OvmsNotifyType::Cleanup(OvmsNotifyEntry* entry)
 // particular reader
 
 OvmsNotifyCallbackEntry::OvmsNotifyCallbackEntry(const char* caller, size_t reader, int verbosity, OvmsNotifyCallback_t callback,
-                                                 bool configfiltered/*=true*/, OvmsNotifyFilterCallback_t filtercallback/*=NULL*/)
+                                                 bool configfiltered/*=true*/, OvmsNotifyFilterCallback_t filtercallback/*=NULL*/,
+                                                 bool spooled/*=false*/)
   {
   m_caller = caller;
   m_reader = reader;
@@ -345,6 +873,7 @@ OvmsNotifyCallbackEntry::OvmsNotifyCallbackEntry(const char* caller, size_t read
   m_callback = callback;
   m_configfiltered = configfiltered;
   m_filtercallback = filtercallback;
+  m_spooled = spooled;
   }
 
 OvmsNotifyCallbackEntry::~OvmsNotifyCallbackEntry()
@@ -354,7 +883,7 @@ OvmsNotifyCallbackEntry::~OvmsNotifyCallbackEntry()
 bool OvmsNotifyCallbackEntry::Accepts(OvmsNotifyType* type, const char* subtype, size_t size)
   {
   // Check size
-  if (size > m_verbosity)
+  if (size > (size_t)m_verbosity)
     return false;
   // Check filter by config:
   if (m_configfiltered)
@@ -382,6 +911,10 @@ OvmsNotify::OvmsNotify()
   ESP_LOGI(TAG, "Initialising NOTIFICATIONS (1820)");
 
   m_nextreader = 1;
+  m_bootid = esp_random();
+  m_spool_path = NOTIFY_SPOOL_PATH;
+  m_spool_ram = NOTIFY_SPOOL_RAM * 1024;
+  m_spool_size = NOTIFY_SPOOL_SIZE * 1024;
 
 #ifdef CONFIG_OVMS_DEV_DEBUGNOTIFICATIONS
   m_trace = true;
@@ -410,6 +943,9 @@ OvmsNotify::OvmsNotify()
   RegisterType("alert");    // payload: human readable text message
   RegisterType("data");     // payload: MP historical data record (tagged CSV, see MP documentation)
   RegisterType("stream");   // payload: subtype specific, use for high volume / short latency data streams
+
+  MyEvents.RegisterEvent(TAG, "config.mounted", std::bind(&OvmsNotify::ConfigChanged, this, _1, _2));
+  MyEvents.RegisterEvent(TAG, "config.changed", std::bind(&OvmsNotify::ConfigChanged, this, _1, _2));
   }
 
 OvmsNotify::~OvmsNotify()
@@ -417,19 +953,21 @@ OvmsNotify::~OvmsNotify()
   }
 
 size_t OvmsNotify::RegisterReader(const char* caller, int verbosity, OvmsNotifyCallback_t callback,
-                                  bool configfiltered/*=false*/, OvmsNotifyFilterCallback_t filtercallback/*=NULL*/)
+                                  bool configfiltered/*=false*/, OvmsNotifyFilterCallback_t filtercallback/*=NULL*/,
+                                  bool spooled/*=false*/)
   {
   size_t reader = m_nextreader++;
 
-  m_readers[reader] = new OvmsNotifyCallbackEntry(caller, reader, verbosity, callback, configfiltered, filtercallback);
+  m_readers[reader] = new OvmsNotifyCallbackEntry(caller, reader, verbosity, callback, configfiltered, filtercallback, spooled);
 
   return reader;
   }
 
 void OvmsNotify::RegisterReader(size_t reader, const char* caller, int verbosity, OvmsNotifyCallback_t callback,
-                                bool configfiltered/*=false*/, OvmsNotifyFilterCallback_t filtercallback/*=NULL*/)
+                                bool configfiltered/*=false*/, OvmsNotifyFilterCallback_t filtercallback/*=NULL*/,
+                                bool spooled/*=false*/)
   {
-  m_readers[reader] = new OvmsNotifyCallbackEntry(caller, reader, verbosity, callback, configfiltered, filtercallback);
+  m_readers[reader] = new OvmsNotifyCallbackEntry(caller, reader, verbosity, callback, configfiltered, filtercallback, spooled);
   }
 
 void OvmsNotify::ClearReader(size_t reader)
@@ -462,11 +1000,17 @@ OvmsNotifyType* OvmsNotify::GetType(const char* type)
     return k->second;
   }
 
-void OvmsNotify::NotifyReaders(OvmsNotifyType* type, OvmsNotifyEntry* entry)
+/**
+ * NotifyReaders: deliver entry to readers
+ *  pendingonly: only to readers still pending (entries loaded from the spool)
+ */
+void OvmsNotify::NotifyReaders(OvmsNotifyType* type, OvmsNotifyEntry* entry, bool pendingonly)
   {
   for (OvmsNotifyCallbackMap_t::iterator itc=m_readers.begin(); itc!=m_readers.end(); ++itc)
     {
     OvmsNotifyCallbackEntry* mc = itc->second;
+    if (pendingonly && entry->IsRead(mc->m_reader))
+      continue;
     if (mc->Accepts(type, entry->GetSubType(), entry->GetValueSize()))
       {
       // deliver notification:
@@ -481,6 +1025,47 @@ void OvmsNotify::NotifyReaders(OvmsNotifyType* type, OvmsNotifyEntry* entry)
     }
   }
 
+/**
+ * GetSpoolReaders: get readers that allow spooling
+ *  type/subtype/size: only those accepting the entry
+ */
+unsigned long OvmsNotify::GetSpoolReaders(OvmsNotifyType* type, const char* subtype, size_t size)
+  {
+  unsigned long readers = 0;
+  for (OvmsNotifyCallbackMap_t::iterator itc=m_readers.begin(); itc!=m_readers.end(); ++itc)
+    {
+    OvmsNotifyCallbackEntry* mc = itc->second;
+    if (mc->m_spooled && (!type || mc->Accepts(type, subtype, size)))
+      readers |= (1ul << mc->m_reader);
+    }
+  return readers;
+  }
+
+void OvmsNotify::ConfigChanged(std::string event, void* data)
+  {
+  OvmsConfigParam* param = (OvmsConfigParam*) data;
+  if (param && param->GetName() != "notify")
+    return;
+
+  std::string path = MyConfig.GetParamValue("notify", "spool.path", NOTIFY_SPOOL_PATH);
+  m_spool_ram = MyConfig.GetParamValueInt("notify", "spool.ram", NOTIFY_SPOOL_RAM) * 1024;
+  m_spool_size = MyConfig.GetParamValueInt("notify", "spool.size", NOTIFY_SPOOL_SIZE) * 1024;
+  bool pathchanged = (path != m_spool_path);
+  m_spool_path = path;
+
+  for (OvmsNotifyTypeMap_t::iterator itt=m_types.begin(); itt!=m_types.end(); ++itt)
+    {
+    OvmsNotifySpool* sp = itt->second->m_spool;
+    if (!sp)
+      continue;
+    if (pathchanged)
+      sp->Close();
+    // On mount: recover entries spooled before the reboot
+    if (event == "config.mounted")
+      sp->Open();
+    }
+  }
+
 bool OvmsNotify::HasReader(const char* type, const char* subtype, size_t size)
   {
   OvmsNotifyType* mt = GetType(type);
@@ -499,6 +1084,8 @@ void OvmsNotify::RegisterType(const char* type)
   if (mt == NULL)
     {
     mt = new OvmsNotifyType(type);
+    if (strcmp(type, "stream") != 0)
+      mt->m_spool = new OvmsNotifySpool(mt);
     m_types[type] = mt;
     ESP_LOGI(TAG,"Registered notification type %s",type);
     }
@@ -526,7 +1113,7 @@ uint32_t OvmsNotify::NotifyString(const char* type, const char* subtype, const c
     }
   if (readers.count() == 0)
     {
-    ESP_LOGD(TAG, "Abort: no readers for type '%s' subtype '%s' size %d", type, subtype, size);
+    ESP_LOGD(TAG, "Abort: no readers for type '%s' subtype '%s' size %zu", type, subtype, size);
     return 0;
     }
 
@@ -534,7 +1121,7 @@ uint32_t OvmsNotify::NotifyString(const char* type, const char* subtype, const c
   OvmsNotifyEntry* msg = (OvmsNotifyEntry*) new OvmsNotifyEntryString(subtype, value);
   msg->m_pendingreaders = readers.to_ulong();
 
-  ESP_LOGD(TAG, "Created entry type '%s' subtype '%s' size %d has %d readers pending", type, subtype, size, readers.count());
+  ESP_LOGD(TAG, "Created entry type '%s' subtype '%s' size %zu has %zu readers pending", type, subtype, size, readers.count());
 
   return mt->QueueEntry(msg);
   }
@@ -578,7 +1165,7 @@ uint32_t OvmsNotify::NotifyCommand(const char* type, const char* subtype, const
   for (auto ritm=verbosity_msgs.rbegin(); ritm!=verbosity_msgs.rend(); ritm++)
     {
     int verbosity = ritm->first;
-    if (msg && msglen <= verbosity)
+    if (msg && msglen <= (size_t)verbosity)
       {
       // reuse last verbosity level message:
       verbosity_msgs[verbosity] = msg;
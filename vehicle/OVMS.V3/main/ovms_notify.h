@@ -40,10 +40,16 @@
 #include <stdint.h>
 #include "ovms.h"
 #include "ovms_utils.h"
+#include "ovms_mutex.h"
 
 #define NOTIFY_MAX_READERS 32
 #define NOTIFY_ERROR_AUTOSUPPRESS 120 // Auto-suppress for 120 seconds
 
+#define NOTIFY_SPOOL_MAGIC      "OVNS"
+#define NOTIFY_SPOOL_PATH       "/store/notify"   // default spool directory
+#define NOTIFY_SPOOL_RAM        16      // default RAM budget per type [kB]
+#define NOTIFY_SPOOL_SIZE       256     // default max spool file size per type [kB]
+
 using namespace std;
 
 class OvmsNotifyType;
@@ -69,6 +75,7 @@ class OvmsNotifyEntry : public ExternalRamAllocated
     uint32_t m_created;
     OvmsNotifyType* m_type;
     char* m_subtype;
+    bool m_spooled;                     // loaded from the spool file
   };
 
 class OvmsNotifyEntryString : public OvmsNotifyEntry
@@ -103,6 +110,71 @@ class OvmsNotifyEntryCommand : public OvmsNotifyEntry
 typedef std::map<uint32_t, OvmsNotifyEntry*, std::less<uint32_t>,
   ExtRamAllocator<std::pair<const uint32_t, OvmsNotifyEntry*>>> NotifyEntryMap_t;
 
+/**
+ * OvmsNotifySpool: append-only file store for the entries of a type that
+ *  exceed its RAM budget while readers are offline. Entries are loaded back
+ *  in order as RAM entries get consumed. The file header records the offset
+ *  of the first undelivered entry, so entries survive a reboot.
+ *  When the file is full, the oldest entries not yet loaded are dropped.
+ *  Spool access is serialized by m_mutex (callers may be any task).
+ */
+
+typedef struct
+  {
+  char magic[4];
+  uint32_t bootid;                      // boot the entry IDs belong to
+  uint32_t commit;                      // offset of first undelivered record
+  uint32_t reserved;
+  } OvmsNotifySpoolHeader_t;
+
+typedef struct
+  {
+  uint32_t size;                        // record size including this header
+  uint32_t id;
+  uint32_t created;                     // monotonictime
+  uint32_t utc;                         // creation time, 0 = unknown
+  uint32_t pending;                     // pending readers, 0 = determine on load
+  // followed by: subtype, '\0', value
+  } OvmsNotifySpoolRecord_t;
+
+class OvmsNotifySpool
+  {
+  public:
+    OvmsNotifySpool(OvmsNotifyType* type);
+    ~OvmsNotifySpool();
+
+  public:
+    bool Open();
+    void Close();
+    bool IsEmpty() { return (!m_open || m_readpos == m_end); }
+    bool Append(OvmsNotifyEntry* entry);
+    OvmsNotifyEntry* Load();
+    void Release(OvmsNotifyEntry* entry);
+
+  protected:
+    bool OpenFile();
+    bool Reset();
+    bool Compact(bool renumber, uint32_t skipfrom=0, uint32_t skipto=0);
+    bool WriteHeader();
+    void Commit();
+
+  public:
+    OvmsMutex m_mutex;
+    OvmsNotifyType* m_type;
+    std::string m_path;
+    bool m_open;
+    uint32_t m_commit;                  // persisted read position
+    uint32_t m_readpos;                 // next record to load
+    uint32_t m_end;                     // file size
+    uint32_t m_count;                   // records not yet loaded
+    std::map<uint32_t, uint32_t> m_loaded; // entry id -> record offset, for loaded entries in RAM
+    uint32_t m_spilled;                 // statistics...
+    uint32_t m_loadcnt;
+    uint32_t m_dropped;
+    uint32_t m_compactions;
+    uint32_t m_errors;
+  };
+
 class OvmsNotifyType
   {
   public:
@@ -116,14 +188,20 @@ class OvmsNotifyType
     OvmsNotifyEntry* FirstUnreadEntry(size_t reader, uint32_t floor);
     OvmsNotifyEntry* FindEntry(uint32_t id);
     void MarkRead(size_t reader, OvmsNotifyEntry* entry);
+    void Refill();
 
   protected:
     void Cleanup(OvmsNotifyEntry* entry);
+    void RewindCursors(OvmsNotifyEntry* entry);
 
   public:
     const char* m_name;
     uint32_t m_nextid;
     NotifyEntryMap_t m_entries;
+    size_t m_ramsize;                   // RAM used by m_entries
+    OvmsNotifySpool* m_spool;           // NULL = RAM only
+    bool m_refilling;
+    uint32_t m_cursor[NOTIFY_MAX_READERS]; // per reader: all entries below this ID have been read
   };
 
 typedef std::function<bool(OvmsNotifyType*,OvmsNotifyEntry*)> OvmsNotifyCallback_t;
@@ -133,7 +211,8 @@ class OvmsNotifyCallbackEntry
   {
   public:
     OvmsNotifyCallbackEntry(const char* caller, size_t reader, int verbosity, OvmsNotifyCallback_t callback,
-                            bool configfiltered=false, OvmsNotifyFilterCallback_t filtercallback=NULL);
+                            bool configfiltered=false, OvmsNotifyFilterCallback_t filtercallback=NULL,
+                            bool spooled=false);
     virtual ~OvmsNotifyCallbackEntry();
 
   public:
@@ -146,6 +225,7 @@ class OvmsNotifyCallbackEntry
     int m_verbosity;
     OvmsNotifyCallback_t m_callback;
     OvmsNotifyFilterCallback_t m_filtercallback;
+    bool m_spooled;                     // reads by FirstUnreadEntry/FindEntry, keeps no entry pointers
   };
 
 typedef struct
@@ -170,14 +250,18 @@ class OvmsNotify : public ExternalRamAllocated
 
   public:
     size_t RegisterReader(const char* caller, int verbosity, OvmsNotifyCallback_t callback,
-                          bool configfiltered=false, OvmsNotifyFilterCallback_t filtercallback=NULL);
+                          bool configfiltered=false, OvmsNotifyFilterCallback_t filtercallback=NULL,
+                          bool spooled=false);
     void RegisterReader(size_t reader, const char* caller, int verbosity, OvmsNotifyCallback_t callback,
-                          bool configfiltered=false, OvmsNotifyFilterCallback_t filtercallback=NULL);
+                          bool configfiltered=false, OvmsNotifyFilterCallback_t filtercallback=NULL,
+                          bool spooled=false);
     void ClearReader(size_t reader);
     size_t CountReaders();
     OvmsNotifyType* GetType(const char* type);
     bool HasReader(const char* type, const char* subtype, size_t size=0);
-    void NotifyReaders(OvmsNotifyType* type, OvmsNotifyEntry* entry);
+    void NotifyReaders(OvmsNotifyType* type, OvmsNotifyEntry* entry, bool pendingonly=false);
+    unsigned long GetSpoolReaders(OvmsNotifyType* type=NULL, const char* subtype=NULL, size_t size=0);
+    void ConfigChanged(std::string event, void* data);
 
   public:
     void RegisterType(const char* type);
@@ -197,6 +281,12 @@ class OvmsNotify : public ExternalRamAllocated
     OvmsNotifyTypeMap_t m_types;
     OvmsNotifyErrorCodeMap_t m_errorcodes;
     bool m_trace;
+
+  public:
+    uint32_t m_bootid;                  // spool entry ID generation
+    std::string m_spool_path;           // spool directory, empty = disabled
+    size_t m_spool_ram;                 // RAM budget per type [bytes]
+    size_t m_spool_size;                // max spool file size per type [bytes]
   };
 
 extern OvmsNotify MyNotify;
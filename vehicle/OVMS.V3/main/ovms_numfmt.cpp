@@ -0,0 +1,512 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Number formatting & parsing
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "ovms_numfmt.h"
+
+// Exact powers of 10 representable by a double:
+static const double s_pow10[] =
+  {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+#define POW10_MAX   22
+
+static const uint64_t s_upow10[] =
+  {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+  100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+  1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+  1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL
+  };
+#define UPOW10_MAX  17
+
+// value * 10^exp, exact for |exp| <= 22 and values with <= 53 significant bits
+static double scale10(double value, int exp)
+  {
+  while (exp > POW10_MAX)
+    {
+    value *= s_pow10[POW10_MAX];
+    exp -= POW10_MAX;
+    }
+  while (exp < -POW10_MAX)
+    {
+    value /= s_pow10[POW10_MAX];
+    exp += POW10_MAX;
+    }
+  return (exp >= 0) ? value * s_pow10[exp] : value / s_pow10[-exp];
+  }
+
+// write digits of u in reverse order ending at end, returns start
+static inline char* put_digits32(char* end, uint32_t u)
+  {
+  do
+    {
+    *--end = '0' + (u % 10);
+    u /= 10;
+    } while (u);
+  return end;
+  }
+
+static inline char* put_digits64(char* end, uint64_t u)
+  {
+  // use 32 bit divisions where possible (no 64 bit hardware divide on the ESP32):
+  while (u > 0xffffffffULL)
+    {
+    *--end = '0' + (u % 10);
+    u /= 10;
+    }
+  return put_digits32(end, (uint32_t) u);
+  }
+
+static inline char* copy_out(char* buf, const char* start, const char* end)
+  {
+  size_t len = end - start;
+  memmove(buf, start, len);
+  buf[len] = 0;
+  return buf + len;
+  }
+
+/**
+ * near_tie: check if the scaled value a may round differently than the exact
+ *  decimal value, i.e. if a is within the scaling error of a rounding tie.
+ *  Scaling by an exact power of 10 is correctly rounded (max 1/2 ulp), ulps
+ *  gives the tolerance. These (rare) cases are left to printf, which rounds
+ *  from the exact binary value.
+ */
+static inline bool near_tie(double a, int ulps)
+  {
+  double frac = a - floor(a);
+  return fabs(frac - 0.5) <= a * (ulps * DBL_EPSILON);
+  }
+
+static char* format_special(char* buf, double value)
+  {
+  const char* s;
+  if (isnan(value))
+    s = "nan";
+  else if (value < 0)
+    s = "-inf";
+  else
+    s = "inf";
+  size_t len = strlen(s);
+  memcpy(buf, s, len+1);
+  return buf + len;
+  }
+
+
+char* num_format_int(char* buf, int32_t value)
+  {
+  char tmp[12];
+  char* end = tmp + sizeof(tmp);
+  char* p = put_digits32(end, (value < 0) ? -(uint32_t)value : (uint32_t)value);
+  if (value < 0)
+    *--p = '-';
+  return copy_out(buf, p, end);
+  }
+
+char* num_format_uint(char* buf, uint32_t value)
+  {
+  char tmp[12];
+  char* end = tmp + sizeof(tmp);
+  return copy_out(buf, put_digits32(end, value), end);
+  }
+
+char* num_format_int64(char* buf, int64_t value)
+  {
+  char tmp[21];
+  char* end = tmp + sizeof(tmp);
+  char* p = put_digits64(end, (value < 0) ? -(uint64_t)value : (uint64_t)value);
+  if (value < 0)
+    *--p = '-';
+  return copy_out(buf, p, end);
+  }
+
+char* num_format_uint64(char* buf, uint64_t value)
+  {
+  char tmp[21];
+  char* end = tmp + sizeof(tmp);
+  return copy_out(buf, put_digits64(end, value), end);
+  }
+
+/**
+ * num_format_fixed: format with precision decimals, rounded like printf
+ *  (from the exact binary value, exact ties half to even). Precision is
+ *  limited to 15 decimals. Values exceeding the 64 bit integer range are
+ *  output in exponent format.
+ */
+char* num_format_fixed(char* buf, double value, int precision)
+  {
+  if (!isfinite(value))
+    return format_special(buf, value);
+  if (precision < 0)
+    precision = 0;
+  else if (precision > 15)
+    precision = 15;
+
+  double a = fabs(value) * s_pow10[precision];
+  if (a >= 1e19)
+    return num_format_general(buf, value, 17);
+  if (a >= 0x1p52 || near_tie(a, 1))
+    {
+    // the scaled value may have been rounded onto / across the tie,
+    // let printf decide from the exact binary value:
+    return buf + snprintf(buf, NUMFMT_BUFSIZE, "%.*f", precision, value);
+    }
+  uint64_t r = (uint64_t) nearbyint(a);
+
+  char tmp[NUMFMT_BUFSIZE];
+  char* end = tmp + sizeof(tmp);
+  char* p = end;
+  if (precision > 0)
+    {
+    uint64_t frac = r % s_upow10[precision];
+    r /= s_upow10[precision];
+    for (int i = 0; i < precision; i++)
+      {
+      *--p = '0' + (frac % 10);
+      frac /= 10;
+      }
+    *--p = '.';
+    }
+  p = put_digits64(p, r);
+  if (signbit(value))
+    *--p = '-';
+  return copy_out(buf, p, end);
+  }
+
+/**
+ * num_format_general: format with significant digits, layout as printf("%g"):
+ *  trailing zeros removed, exponent format if exponent < -4 or >= digits.
+ */
+char* num_format_general(char* buf, double value, int digits)
+  {
+  if (!isfinite(value))
+    return format_special(buf, value);
+  if (digits < 1)
+    digits = 1;
+  else if (digits > UPOW10_MAX)
+    digits = UPOW10_MAX;
+
+  char* p = buf;
+  if (signbit(value))
+    *p++ = '-';
+  double a = fabs(value);
+  if (a == 0)
+    {
+    *p++ = '0';
+    *p = 0;
+    return p;
+    }
+
+  // get digits significant digits into r, decimal exponent into exp:
+  int exp = (int) floor(log10(a));
+  double sa = scale10(a, digits-1-exp);
+  uint64_t r = (uint64_t) nearbyint(sa);
+  if (r >= s_upow10[digits])
+    {
+    exp++;
+    sa = scale10(a, digits-1-exp);
+    r = (uint64_t) nearbyint(sa);
+    }
+  else if (r < s_upow10[digits-1])
+    {
+    exp--;
+    sa = scale10(a, digits-1-exp);
+    r = (uint64_t) nearbyint(sa);
+    }
+  if (digits > 15 || abs(digits-1-exp) > POW10_MAX || near_tie(sa, 2))
+    {
+    // inexact scaling or near a tie, see num_format_fixed():
+    return p + snprintf(p, NUMFMT_BUFSIZE - (p - buf), "%.*g", digits, a);
+    }
+  if (r >= s_upow10[digits])
+    {
+    // rounded up to next power of 10:
+    exp++;
+    r = s_upow10[digits-1];
+    }
+
+  // strip trailing zeros:
+  int nd = digits;
+  while (nd > 1 && (r % 10) == 0)
+    {
+    r /= 10;
+    nd--;
+    }
+  char dig[UPOW10_MAX+1];
+  put_digits64(dig + nd, r);
+
+  if (exp < -4 || exp >= digits)
+    {
+    // exponent format:
+    *p++ = dig[0];
+    if (nd > 1)
+      {
+      *p++ = '.';
+      memcpy(p, dig+1, nd-1);
+      p += nd-1;
+      }
+    *p++ = 'e';
+    *p++ = (exp < 0) ? '-' : '+';
+    int ue = (exp < 0) ? -exp : exp;
+    if (ue >= 100)
+      *p++ = '0' + ue / 100;
+    *p++ = '0' + (ue / 10) % 10;
+    *p++ = '0' + ue % 10;
+    }
+  else if (exp >= 0)
+    {
+    // integer part, optional fraction:
+    int ni = exp + 1;
+    for (int i = 0; i < ni; i++)
+      *p++ = (i < nd) ? dig[i] : '0';
+    if (nd > ni)
+      {
+      *p++ = '.';
+      memcpy(p, dig+ni, nd-ni);
+      p += nd-ni;
+      }
+    }
+  else
+    {
+    // 0.000ddd:
+    *p++ = '0';
+    *p++ = '.';
+    for (int i = -1; i > exp; i--)
+      *p++ = '0';
+    memcpy(p, dig, nd);
+    p += nd;
+    }
+  *p = 0;
+  return p;
+  }
+
+/**
+ * num_format_shortest: format float with the minimum number of significant
+ *  digits needed to parse back to the same value (max 9)
+ */
+char* num_format_shortest(char* buf, float value)
+  {
+  if (!isfinite(value) || value == 0)
+    return num_format_general(buf, value, 1);
+  for (int digits = 1; digits < 9; digits++)
+    {
+    char* end = num_format_general(buf, value, digits);
+    float check;
+    num_parse_float(buf, &check);
+    if (check == value)
+      return end;
+    }
+  return num_format_general(buf, value, 9);
+  }
+
+/**
+ * num_format_scaled: format integer fixed point value
+ *  - value: integer value scaled by 10^decimals
+ *  - precision: number of decimal places to output (rounded or zero padded),
+ *    -1 = all significant decimals (trailing zeros removed)
+ */
+char* num_format_scaled(char* buf, int32_t value, int decimals, int precision)
+  {
+  char tmp[NUMFMT_BUFSIZE];
+  char* end = tmp + sizeof(tmp);
+  char* p = end;
+
+  if (decimals < 0)
+    decimals = 0;
+  else if (decimals > 9)
+    decimals = 9;
+  if (precision >= 0 && precision < decimals)
+    {
+    // round to precision:
+    int32_t div = 1;
+    for (int i = precision; i < decimals; i++)
+      div *= 10;
+    value = (value >= 0) ? (value + div/2) / div : -((-value + div/2) / div);
+    decimals = precision;
+    }
+
+  bool neg = (value < 0);
+  uint32_t u = neg ? -(uint32_t)value : (uint32_t)value;
+  int digits = decimals;
+  int pad = 0;
+  if (precision < 0)
+    {
+    while (digits > 0 && (u % 10) == 0)
+      {
+      u /= 10;
+      digits--;
+      }
+    }
+  else if (precision > decimals)
+    {
+    pad = (precision - decimals > 10) ? 10 : precision - decimals;
+    }
+
+  for (int i = 0; i < pad; i++)
+    *--p = '0';
+  if (digits > 0 || pad > 0)
+    {
+    for (int i = 0; i < digits; i++)
+      {
+      *--p = '0' + (u % 10);
+      u /= 10;
+      }
+    *--p = '.';
+    }
+  p = put_digits32(p, u);
+  if (neg)
+    *--p = '-';
+
+  return copy_out(buf, p, end);
+  }
+
+
+/**
+ * num_parse_int64: parse decimal integer, clipped to the int64_t range
+ */
+const char* num_parse_int64(const char* str, int64_t* value)
+  {
+  const char* s = str;
+  while (*s == ' ' || *s == '\t')
+    s++;
+  bool neg = false;
+  if (*s == '-' || *s == '+')
+    neg = (*s++ == '-');
+  if (*s < '0' || *s > '9')
+    {
+    *value = 0;
+    return str;
+    }
+  const uint64_t limit = neg ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+  uint64_t u = 0;
+  bool overflow = false;
+  for (; *s >= '0' && *s <= '9'; s++)
+    {
+    if (overflow || u > (limit - (*s - '0')) / 10)
+      overflow = true;
+    else
+      u = u * 10 + (*s - '0');
+    }
+  if (overflow)
+    u = limit;
+  *value = neg ? (int64_t)(0 - u) : (int64_t)u;
+  return s;
+  }
+
+/**
+ * num_parse_double: parse decimal floating point number
+ *  Up to 15 significant digits and decimal exponents within ±22 (i.e. all
+ *  usual metric values) are converted exactly without library calls, other
+ *  input (hex, inf, nan, long mantissas, large exponents) is passed to strtod().
+ */
+const char* num_parse_double(const char* str, double* value)
+  {
+  const char* s = str;
+  while (*s == ' ' || *s == '\t')
+    s++;
+  const char* start = s;
+  bool neg = false;
+  if (*s == '-' || *s == '+')
+    neg = (*s++ == '-');
+
+  uint64_t mant = 0;
+  int ndigits = 0, exp = 0;
+  bool any = false, exact = true;
+  for (; *s >= '0' && *s <= '9'; s++)
+    {
+    any = true;
+    if (mant == 0 && *s == '0')
+      continue;
+    if (ndigits < 19)
+      mant = mant * 10 + (*s - '0'), ndigits++;
+    else
+      exp++, exact = false;
+    }
+  if (*s == '.')
+    {
+    for (s++; *s >= '0' && *s <= '9'; s++)
+      {
+      any = true;
+      if (mant == 0 && *s == '0')
+        {
+        exp--;
+        continue;
+        }
+      if (ndigits < 19)
+        mant = mant * 10 + (*s - '0'), ndigits++, exp--;
+      else
+        exact = false;
+      }
+    }
+  if (!any)
+    {
+    if (*s == 'x' || *s == 'X' || *s == 'i' || *s == 'I' || *s == 'n' || *s == 'N')
+      {
+      char* end;
+      *value = strtod(start, &end);
+      return (end == start) ? str : end;
+      }
+    *value = 0;
+    return str;
+    }
+  if (*s == 'e' || *s == 'E')
+    {
+    const char* e = s + 1;
+    bool eneg = false;
+    if (*e == '-' || *e == '+')
+      eneg = (*e++ == '-');
+    if (*e >= '0' && *e <= '9')
+      {
+      int ev = 0;
+      for (; *e >= '0' && *e <= '9'; e++)
+        {
+        if (ev < 10000)
+          ev = ev * 10 + (*e - '0');
+        }
+      exp += eneg ? -ev : ev;
+      s = e;
+      }
+    }
+
+  double d;
+  if (mant == 0)
+    d = 0;
+  else if (exact && mant <= (1ULL << 53) && exp >= -POW10_MAX && exp <= POW10_MAX)
+    d = (exp >= 0) ? (double)mant * s_pow10[exp] : (double)mant / s_pow10[-exp];
+  else
+    {
+    *value = strtod(start, NULL);
+    return s;
+    }
+  *value = neg ? -d : d;
+  return s;
+  }
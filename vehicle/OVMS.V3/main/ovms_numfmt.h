@@ -0,0 +1,160 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Number formatting & parsing
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __OVMS_NUMFMT_H__
+#define __OVMS_NUMFMT_H__
+
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <limits>
+
+/**
+ * Allocation free number formatting & parsing
+ *
+ *  These replace std::ostringstream / std::istringstream for the hot paths
+ *  (metrics serialization, protocol output). No locale, no heap, no streams.
+ *
+ *  Formatters write into a caller supplied buffer of at least NUMFMT_BUFSIZE
+ *  bytes, NUL terminate it and return a pointer to the terminating NUL (like
+ *  stpcpy), so calls can be chained and the length is (end - buf):
+ *
+ *    char buf[NUMFMT_BUFSIZE];
+ *    char* end = num_format_fixed(buf, 3.14159, 2);    // "3.14"
+ *    out.append(buf, end - buf);
+ *
+ *  Float output formats:
+ *    num_format_fixed():     fixed number of decimals, like printf("%.*f")
+ *    num_format_general():   significant digits, like printf("%.*g"), this is
+ *                            the std::ostream default format (6 digits)
+ *    num_format_shortest():  shortest string that parses back to the same float
+ *    num_format_scaled():    integer fixed point value (i.e. millivolts as Volts)
+ *
+ *  Parsers skip leading white space and return a pointer to the first character
+ *  not consumed (== input if no number could be read, the value is then 0).
+ *
+ *  num_append() / num_parse() are the type generic wrappers used by the metric
+ *  templates.
+ */
+
+#define NUMFMT_BUFSIZE        32
+
+extern char* num_format_int(char* buf, int32_t value);
+extern char* num_format_uint(char* buf, uint32_t value);
+extern char* num_format_int64(char* buf, int64_t value);
+extern char* num_format_uint64(char* buf, uint64_t value);
+extern char* num_format_fixed(char* buf, double value, int precision);
+extern char* num_format_general(char* buf, double value, int digits = 6);
+extern char* num_format_shortest(char* buf, float value);
+extern char* num_format_scaled(char* buf, int32_t value, int decimals, int precision = -1);
+
+extern const char* num_parse_int64(const char* str, int64_t* value);
+extern const char* num_parse_double(const char* str, double* value);
+
+inline const char* num_parse_float(const char* str, float* value)
+  {
+  double d;
+  const char* end = num_parse_double(str, &d);
+  *value = (float) d;
+  return end;
+  }
+
+
+/**
+ * num_append: append value to string
+ *  - precision applies to floating point types only:
+ *    -1 = std::ostream default (6 significant digits), else number of decimals
+ */
+template <typename T, typename String>
+inline typename std::enable_if<std::is_integral<T>::value>::type
+num_append(String& out, T value, int precision = -1)
+  {
+  char buf[NUMFMT_BUFSIZE];
+  char* end;
+  if (std::is_signed<T>::value)
+    end = (sizeof(T) <= 4) ? num_format_int(buf, (int32_t) value) : num_format_int64(buf, (int64_t) value);
+  else
+    end = (sizeof(T) <= 4) ? num_format_uint(buf, (uint32_t) value) : num_format_uint64(buf, (uint64_t) value);
+  out.append(buf, end - buf);
+  }
+
+template <typename T, typename String>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type
+num_append(String& out, T value, int precision = -1)
+  {
+  char buf[NUMFMT_BUFSIZE];
+  char* end = (precision >= 0) ? num_format_fixed(buf, value, precision) : num_format_general(buf, value);
+  out.append(buf, end - buf);
+  }
+
+template <typename String>
+inline void num_append(String& out, const std::string& value, int precision = -1)
+  {
+  out.append(value.data(), value.size());
+  }
+
+
+/**
+ * num_parse: parse value from string
+ *  - integer values are clipped to the type range
+ *  - strings are read up to the next white space or comma
+ */
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, const char*>::type
+num_parse(const char* str, T* value)
+  {
+  int64_t v;
+  const char* end = num_parse_int64(str, &v);
+  if (v < (int64_t) std::numeric_limits<T>::min())
+    v = std::numeric_limits<T>::min();
+  else if ((std::numeric_limits<T>::digits < 64) && v > (int64_t) std::numeric_limits<T>::max())
+    v = std::numeric_limits<T>::max();
+  *value = (T) v;
+  return end;
+  }
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, const char*>::type
+num_parse(const char* str, T* value)
+  {
+  double d;
+  const char* end = num_parse_double(str, &d);
+  *value = (T) d;
+  return end;
+  }
+
+inline const char* num_parse(const char* str, std::string* value)
+  {
+  while (*str == ' ' || *str == '\t')
+    str++;
+  const char* end = str;
+  while (*end && *end != ',' && *end != ' ' && *end != '\t')
+    end++;
+  value->assign(str, end - str);
+  return end;
+  }
+
+#endif //#ifndef __OVMS_NUMFMT_H__
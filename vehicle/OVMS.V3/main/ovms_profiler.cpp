@@ -0,0 +1,387 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Task & callback profiler
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "profiler";
+
+#include <string.h>
+#include <sys/param.h>
+#include <algorithm>
+#include <vector>
+#include "ovms_profiler.h"
+#include "ovms_events.h"
+#include "ovms_metrics.h"
+#include "ovms_config.h"
+#include "ovms_command.h"
+#include "metrics_standard.h"
+
+#define PROFILER_WINDOW   10    // default task sampling window [s]
+#define PROFILER_TOP      5     // entries in the profiler metrics
+
+OvmsProfiler MyProfiler __attribute__ ((init_priority (1050)));
+
+OvmsProfileEntry::OvmsProfileEntry(const char* type, const std::string& caller, const std::string& detail)
+  : m_type(type), m_caller(caller), m_detail(detail)
+  {
+  Reset();
+  }
+
+void OvmsProfileEntry::Reset()
+  {
+  m_count = 0;
+  m_total = 0;
+  m_max = 0;
+  m_window_total = 0;
+  m_window_max = 0;
+  m_last_total = 0;
+  m_last_max = 0;
+  }
+
+OvmsProfileQueue::OvmsProfileQueue(const char* name, QueueHandle_t queue)
+  {
+  m_name = name;
+  m_queue = queue;
+  m_size = uxQueueMessagesWaiting(queue) + uxQueueSpacesAvailable(queue);
+  m_max = 0;
+  }
+
+OvmsProfiler::OvmsProfiler()
+  {
+  m_window = PROFILER_WINDOW;
+  m_window_timer = 0;
+  m_window_start = 0;
+  m_window_length = 0;
+  m_metric_cpu = NULL;
+  m_metric_tasks = NULL;
+  m_metric_callbacks = NULL;
+  }
+
+OvmsProfiler::~OvmsProfiler()
+  {
+  }
+
+OvmsProfileEntry* OvmsProfiler::GetEntry(const char* type, const std::string& caller, const std::string& detail)
+  {
+#ifdef CONFIG_OVMS_SYS_PROFILER
+  OvmsMutexLock lock(&m_mutex);
+  for (auto entry : m_entries)
+    {
+    if (strcmp(entry->m_type, type) == 0 && entry->m_caller == caller && entry->m_detail == detail)
+      return entry;
+    }
+  OvmsProfileEntry* entry = new OvmsProfileEntry(type, caller, detail);
+  m_entries.push_back(entry);
+  return entry;
+#else
+  return NULL;
+#endif // CONFIG_OVMS_SYS_PROFILER
+  }
+
+OvmsProfileQueue* OvmsProfiler::RegisterQueue(const char* name, QueueHandle_t queue)
+  {
+#ifdef CONFIG_OVMS_SYS_PROFILER
+  OvmsMutexLock lock(&m_mutex);
+  OvmsProfileQueue* pq = new OvmsProfileQueue(name, queue);
+  m_queues.push_back(pq);
+  return pq;
+#else
+  return NULL;
+#endif // CONFIG_OVMS_SYS_PROFILER
+  }
+
+void OvmsProfiler::Init()
+  {
+#ifdef CONFIG_OVMS_SYS_PROFILER
+  m_metric_cpu = new OvmsMetricVector<float>("m.prof.cpu", SM_STALE_MID, Percentage);
+  m_metric_tasks = new OvmsMetricString("m.prof.tasks", SM_STALE_MID);
+  m_metric_callbacks = new OvmsMetricString("m.prof.callbacks", SM_STALE_MID);
+
+  using std::placeholders::_1;
+  using std::placeholders::_2;
+  MyEvents.RegisterEvent(TAG, "ticker.1", std::bind(&OvmsProfiler::Ticker, this, _1, _2));
+#endif // CONFIG_OVMS_SYS_PROFILER
+  }
+
+void OvmsProfiler::Ticker(std::string event, void* data)
+  {
+  // Sample queues every second, tasks and callbacks every window:
+    {
+    OvmsMutexLock lock(&m_mutex);
+    for (auto pq : m_queues)
+      pq->Sample();
+    }
+
+  if (++m_window_timer < m_window)
+    return;
+  m_window_timer = 0;
+  m_window = MyConfig.GetParamValueInt("module", "profile.window", PROFILER_WINDOW);
+  if (m_window < 1) m_window = 1;
+
+  SampleTasks();
+
+    {
+    OvmsMutexLock lock(&m_mutex);
+    for (auto entry : m_entries)
+      {
+      entry->m_last_total = entry->m_window_total;
+      entry->m_last_max = entry->m_window_max;
+      entry->m_window_total = 0;
+      entry->m_window_max = 0;
+      }
+    }
+
+  UpdateMetrics();
+  }
+
+void OvmsProfiler::SampleTasks()
+  {
+#if configUSE_TRACE_FACILITY
+  UBaseType_t num = uxTaskGetNumberOfTasks() + 2;
+  TaskStatus_t* status = (TaskStatus_t*)ExternalRamMalloc(num * sizeof(TaskStatus_t));
+  if (!status)
+    return;
+  num = uxTaskGetSystemState(status, num, NULL);
+
+  int64_t now = esp_timer_get_time();
+  uint32_t window = (m_window_start) ? now - m_window_start : 0;
+  m_window_start = now;
+  m_window_length = window;
+
+  OvmsMutexLock lock(&m_mutex);
+  for (auto& it : m_tasks)
+    it.second.seen = false;
+  for (UBaseType_t i = 0; i < num; i++)
+    {
+    auto it = m_tasks.find(status[i].xHandle);
+    if (it == m_tasks.end())
+      {
+      OvmsProfileTask& task = m_tasks[status[i].xHandle];
+      task.runtime = status[i].ulRunTimeCounter;
+      task.load = 0;
+      task.load_max = 0;
+      it = m_tasks.find(status[i].xHandle);
+      }
+    else
+      {
+      OvmsProfileTask& task = it->second;
+#if configGENERATE_RUN_TIME_STATS
+      // Run time counter: esp_timer [us], wraps after ~71 minutes
+      uint32_t delta = status[i].ulRunTimeCounter - task.runtime;
+      task.load = (window) ? ((uint64_t)delta * 1000 + window/2) / window : 0;
+      if (task.load > task.load_max) task.load_max = task.load;
+#endif
+      task.runtime = status[i].ulRunTimeCounter;
+      }
+    OvmsProfileTask& task = it->second;
+    task.name = status[i].pcTaskName;
+    task.priority = status[i].uxCurrentPriority;
+    task.core = xTaskGetAffinity(status[i].xHandle);
+    task.stack_free = status[i].usStackHighWaterMark;
+    task.seen = true;
+    }
+  for (auto it = m_tasks.begin(); it != m_tasks.end(); )
+    {
+    if (it->second.seen)
+      ++it;
+    else
+      it = m_tasks.erase(it);
+    }
+
+  free(status);
+#endif // configUSE_TRACE_FACILITY
+  }
+
+int OvmsProfiler::GetTaskLoad(TaskHandle_t task)
+  {
+#if configGENERATE_RUN_TIME_STATS
+  OvmsMutexLock lock(&m_mutex);
+  auto it = m_tasks.find(task);
+  if (m_window_length && it != m_tasks.end())
+    return it->second.load;
+#endif
+  return -1;
+  }
+
+std::vector<float> OvmsProfiler::GetCoreLoads()
+  {
+  std::vector<float> loads;
+#if configGENERATE_RUN_TIME_STATS
+  OvmsMutexLock lock(&m_mutex);
+  if (m_window_length == 0)
+    return loads;
+  for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+    auto it = m_tasks.find(xTaskGetIdleTaskHandleForCPU(core));
+    if (it != m_tasks.end())
+      loads.push_back(100.0 - MIN(it->second.load, 1000) / 10.0);
+    }
+#endif
+  return loads;
+  }
+
+void OvmsProfiler::UpdateMetrics()
+  {
+  if (!m_metric_cpu)
+    return;
+
+  std::vector<float> loads = GetCoreLoads();
+  std::string tasklist, calllist;
+  char buf[24];
+
+    {
+    // Metrics are set outside the lock, listeners may call into the profiler
+    OvmsMutexLock lock(&m_mutex);
+
+#if configGENERATE_RUN_TIME_STATS
+    // Top tasks by CPU load, idle tasks excluded:
+    std::vector<OvmsProfileTask*> tasks;
+    for (auto& it : m_tasks)
+      {
+      if (it.second.load > 0 && it.second.name.compare(0, 4, "IDLE") != 0)
+        tasks.push_back(&it.second);
+      }
+    std::sort(tasks.begin(), tasks.end(),
+      [](OvmsProfileTask* a, OvmsProfileTask* b) { return a->load > b->load; });
+    for (int i = 0; i < (int)tasks.size() && i < PROFILER_TOP; i++)
+      {
+      if (i) tasklist.append(",");
+      snprintf(buf, sizeof(buf), ":%.1f", tasks[i]->load / 10.0);
+      tasklist.append(tasks[i]->name);
+      tasklist.append(buf);
+      }
+#endif
+
+    // Top callbacks by time spent in the last window:
+    std::vector<OvmsProfileEntry*> entries;
+    for (auto entry : m_entries)
+      {
+      if (entry->m_last_total > 0)
+        entries.push_back(entry);
+      }
+    std::sort(entries.begin(), entries.end(),
+      [](OvmsProfileEntry* a, OvmsProfileEntry* b) { return a->m_last_total > b->m_last_total; });
+    for (int i = 0; i < (int)entries.size() && i < PROFILER_TOP; i++)
+      {
+      if (i) calllist.append(",");
+      calllist.append(entries[i]->m_caller);
+      if (!entries[i]->m_detail.empty())
+        {
+        calllist.append("@");
+        calllist.append(entries[i]->m_detail);
+        }
+      snprintf(buf, sizeof(buf), ":%.1f", entries[i]->m_last_total / 1000.0);
+      calllist.append(buf);
+      }
+    }
+
+  if (!loads.empty())
+    m_metric_cpu->SetValue(loads);
+#if configGENERATE_RUN_TIME_STATS
+  m_metric_tasks->SetValue(tasklist);
+#endif
+  m_metric_callbacks->SetValue(calllist);
+  }
+
+void OvmsProfiler::Reset()
+  {
+  OvmsMutexLock lock(&m_mutex);
+  for (auto entry : m_entries)
+    entry->Reset();
+  for (auto pq : m_queues)
+    pq->m_max = 0;
+  for (auto& it : m_tasks)
+    it.second.load_max = 0;
+  }
+
+void OvmsProfiler::Output(OvmsWriter* writer, int verbosity)
+  {
+#ifndef CONFIG_OVMS_SYS_PROFILER
+  writer->puts("Profiler not enabled (CONFIG_OVMS_SYS_PROFILER)");
+#else
+  OvmsMutexLock lock(&m_mutex);
+
+  // Tasks:
+#if configGENERATE_RUN_TIME_STATS
+  if (m_window_length == 0)
+    {
+    writer->printf("Tasks: first window of %d seconds not yet complete\n", m_window);
+    }
+  else
+    {
+    writer->printf("Tasks (CPU time in last %.1f seconds):\n", m_window_length / 1000000.0);
+    writer->printf("  %-16s C# PRI   CPU%%   Max%%  Stack free\n", "Name");
+    }
+#else
+  writer->puts("Tasks (CPU time needs CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS):");
+  writer->printf("  %-16s C# PRI   CPU%%   Max%%  Stack free\n", "Name");
+#endif
+  std::vector<OvmsProfileTask*> tasks;
+  for (auto& it : m_tasks)
+    tasks.push_back(&it.second);
+  std::sort(tasks.begin(), tasks.end(),
+    [](OvmsProfileTask* a, OvmsProfileTask* b) { return (a->load != b->load) ? (a->load > b->load) : (a->name < b->name); });
+  for (auto task : tasks)
+    {
+    writer->printf("  %-16s  %c %3u %5.1f%% %5.1f%%  %10u\n",
+      task->name.c_str(), (task->core == tskNO_AFFINITY) ? '*' : '0'+task->core, task->priority,
+      task->load / 10.0, task->load_max / 10.0, task->stack_free);
+    }
+
+  // Queues:
+  writer->printf("Queues:\n  %-16s  Size   Max\n", "Name");
+  for (auto pq : m_queues)
+    writer->printf("  %-16s %5u %5u\n", pq->m_name, pq->m_size, pq->m_max);
+
+  // Callbacks:
+  std::vector<OvmsProfileEntry*> entries;
+  for (auto entry : m_entries)
+    {
+    if (entry->m_count)
+      entries.push_back(entry);
+    }
+  std::sort(entries.begin(), entries.end(),
+    [](OvmsProfileEntry* a, OvmsProfileEntry* b) { return a->m_total > b->m_total; });
+  writer->printf("Callbacks:\n  %-6s %-16s %-20s %8s %8s %8s %10s %8s\n",
+    "Type", "Caller", "Event/metric", "Count", "Avg(us)", "Max(us)", "Total(ms)", "Last(ms)");
+  for (auto entry : entries)
+    {
+    writer->printf("  %-6s %-16s %-20s %8u %8u %8u %10.1f %8.1f\n",
+      entry->m_type, entry->m_caller.c_str(), entry->m_detail.c_str(), entry->m_count,
+      (uint32_t)(entry->m_total / entry->m_count), entry->m_max,
+      entry->m_total / 1000.0, entry->m_last_total / 1000.0);
+    }
+#endif // CONFIG_OVMS_SYS_PROFILER
+  }
+
+class OvmsProfilerInit
+  {
+  public:
+    OvmsProfilerInit()
+      {
+      ESP_LOGI(TAG, "Initialising PROFILER (1900)");
+      MyProfiler.Init();
+      }
+  } MyOvmsProfilerInit __attribute__ ((init_priority (1900)));
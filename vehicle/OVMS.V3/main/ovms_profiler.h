@@ -0,0 +1,186 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Task & callback profiler
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __OVMS_PROFILER_H__
+#define __OVMS_PROFILER_H__
+
+#include <stdint.h>
+#include <string>
+#include <list>
+#include <map>
+#include <vector>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "ovms.h"
+#include "ovms_mutex.h"
+
+class OvmsWriter;
+class OvmsMetricString;
+template <typename ElemType, class Allocator> class OvmsMetricVector;
+
+/**
+ * OvmsProfileEntry: duration statistics of a callback (event handler,
+ *  metric listener, CAN frame callback), identified by type, caller and
+ *  detail (event / metric / bus). Entries are kept when the callback is
+ *  deregistered, so a reregistration by the same caller continues them.
+ */
+class OvmsProfileEntry : public ExternalRamAllocated
+  {
+  public:
+    OvmsProfileEntry(const char* type, const std::string& caller, const std::string& detail);
+
+  public:
+    inline void Add(uint32_t duration)
+      {
+      m_count++;
+      m_total += duration;
+      m_window_total += duration;
+      if (duration > m_max) m_max = duration;
+      if (duration > m_window_max) m_window_max = duration;
+      }
+    void Reset();
+
+  public:
+    const char* m_type;
+    std::string m_caller;
+    std::string m_detail;
+    uint32_t m_count;
+    uint64_t m_total;                   // [us]
+    uint32_t m_max;                     // [us]
+    uint32_t m_window_total;            // [us] current window
+    uint32_t m_window_max;              // [us] current window
+    uint32_t m_last_total;              // [us] last window
+    uint32_t m_last_max;                // [us] last window
+  };
+
+typedef std::list<OvmsProfileEntry*> OvmsProfileEntryList;
+
+/**
+ * OvmsProfileTimer: times the scope it lives in, e.g.
+ *    OvmsProfileTimer pt(entry->m_profile);
+ *    entry->m_callback(...);
+ */
+#ifdef CONFIG_OVMS_SYS_PROFILER
+class OvmsProfileTimer
+  {
+  public:
+    inline OvmsProfileTimer(OvmsProfileEntry* entry)
+      : m_entry(entry), m_start(esp_timer_get_time()) {}
+    inline ~OvmsProfileTimer()
+      {
+      if (m_entry) m_entry->Add(esp_timer_get_time() - m_start);
+      }
+  protected:
+    OvmsProfileEntry* m_entry;
+    int64_t m_start;
+  };
+#else
+class OvmsProfileTimer
+  {
+  public:
+    inline OvmsProfileTimer(OvmsProfileEntry* entry) {}
+  };
+#endif // CONFIG_OVMS_SYS_PROFILER
+
+/**
+ * OvmsProfileQueue: fill level maximum of a queue, sampled by the
+ *  consumer on each receive (including the message just received)
+ *  and by the profiler every second.
+ */
+class OvmsProfileQueue : public ExternalRamAllocated
+  {
+  public:
+    OvmsProfileQueue(const char* name, QueueHandle_t queue);
+
+  public:
+    inline void Sample(UBaseType_t received=0)
+      {
+      UBaseType_t fill = uxQueueMessagesWaiting(m_queue) + received;
+      if (fill > m_max) m_max = fill;
+      }
+
+  public:
+    const char* m_name;
+    QueueHandle_t m_queue;
+    UBaseType_t m_size;
+    UBaseType_t m_max;
+  };
+
+typedef std::list<OvmsProfileQueue*> OvmsProfileQueueList;
+
+typedef struct
+  {
+  std::string name;
+  uint32_t runtime;                     // [us] FreeRTOS run time counter
+  uint32_t load;                        // [0.1%] CPU time in last window
+  uint32_t load_max;                    // [0.1%] max window load
+  uint32_t stack_free;                  // [bytes] stack high water mark
+  UBaseType_t priority;
+  BaseType_t core;
+  bool seen;
+  } OvmsProfileTask;
+
+typedef std::map<TaskHandle_t, OvmsProfileTask> OvmsProfileTaskMap;
+
+class OvmsProfiler
+  {
+  public:
+    OvmsProfiler();
+    ~OvmsProfiler();
+
+  public:
+    OvmsProfileEntry* GetEntry(const char* type, const std::string& caller, const std::string& detail);
+    OvmsProfileQueue* RegisterQueue(const char* name, QueueHandle_t queue);
+    void Init();
+    void Ticker(std::string event, void* data);
+    void Reset();
+    int GetTaskLoad(TaskHandle_t task);
+    std::vector<float> GetCoreLoads();
+    void Output(OvmsWriter* writer, int verbosity);
+
+  protected:
+    void SampleTasks();
+    void UpdateMetrics();
+
+  protected:
+    OvmsMutex m_mutex;
+    OvmsProfileEntryList m_entries;
+    OvmsProfileQueueList m_queues;
+    OvmsProfileTaskMap m_tasks;
+    int m_window;                       // [s] task sampling window
+    int m_window_timer;
+    int64_t m_window_start;             // [us] esp_timer
+    uint32_t m_window_length;           // [us] last window
+    OvmsMetricVector<float, std::allocator<float>>* m_metric_cpu;
+    OvmsMetricString* m_metric_tasks;
+    OvmsMetricString* m_metric_callbacks;
+  };
+
+extern OvmsProfiler MyProfiler;
+
+#endif //#ifndef __OVMS_PROFILER_H__
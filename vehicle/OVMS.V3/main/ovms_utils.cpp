@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <dirent.h>
 #include "ovms_utils.h"
 
@@ -150,7 +151,7 @@ std::string mp_encode(const std::string text)
   std::string res;
   char lc = 0;
   res.reserve(text.length());
-  for (int i=0; i<text.length(); i++)
+  for (size_t i=0; i<text.length(); i++)
     {
     if (text[i] == '\n')
       {
@@ -182,7 +183,7 @@ extram::string mp_encode(const extram::string text)
   extram::string res;
   char lc = 0;
   res.reserve(text.length());
-  for (int i=0; i<text.length(); i++)
+  for (size_t i=0; i<text.length(); i++)
     {
     if (text[i] == '\n')
       {
@@ -211,7 +212,7 @@ extram::string stripcr(const extram::string& text)
   {
   extram::string res;
   res.reserve(text.length());
-  for (int i = 0; i < text.length(); i++)
+  for (size_t i = 0; i < text.length(); i++)
     {
     if (text[i] != '\r' || (i < text.length()-1 && text[i+1] != '\n'))
       res += text[i];
@@ -260,7 +261,7 @@ int FormatHexDump(char** bufferp, const char* data, size_t rlength, size_t colsi
 
     char *p = *bufferp;
     const char *os = s;
-    for (int k=0;k<colsize;k++)
+    for (size_t k=0;k<colsize;k++)
       {
       if (k<rlength)
         {
@@ -276,7 +277,7 @@ int FormatHexDump(char** bufferp, const char* data, size_t rlength, size_t colsi
     sprintf(p,"| ");
     p += 2;
     s = os;
-    for (int k=0;k<colsize;k++)
+    for (size_t k=0;k<colsize;k++)
       {
       if (k<rlength)
         {
@@ -436,7 +437,7 @@ bool path_exists(const std::string path)
 std::string mqtt_topic(const std::string text)
   {
   std::string buf;
-  for (int i=0; i<text.size(); i++)
+  for (size_t i=0; i<text.size(); i++)
     {
     switch(text[i])
       {
@@ -121,7 +121,7 @@ template <class src_string>
 std::string json_encode(const src_string text)
   {
   std::string buf;
-  for (int i=0; i<text.size(); i++)
+  for (size_t i=0; i<text.size(); i++)
     {
     switch(text[i])
       {
@@ -281,7 +281,10 @@ void test_can(int verbosity, OvmsWriter* writer, OvmsCommand* cmd, int argc, con
     if (tx)
       can->Write(&frame, pdMS_TO_TICKS(10));
     else
-      MyCan.IncomingFrame(&frame);
+      {
+      frame.timestamp = CAN_Timestamp();
+      MyCan.InjectFrame(&frame, portMAX_DELAY);
+      }
     }
 
   elapsed = esp_timer_get_time() - started;
@@ -0,0 +1,248 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: DBC tokeniser (without lex)
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "dbc_tokeniser.hpp"
+#include "dbc_parser.hpp"
+
+struct dbc_host_buffer
+  {
+  std::string input;
+  size_t pos;
+  };
+
+static dbc_host_buffer s_buffer;
+static std::string s_text;
+char* yytext = NULL;
+int yylineno = 1;
+
+static const struct { const char* name; int token; } s_keywords[] =
+  {
+  { "VERSION", T_VERSION },
+  { "BO_", T_BO },
+  { "BS_", T_BS },
+  { "BU_", T_BU },
+  { "SG_", T_SG },
+  { "EV_", T_EV },
+  { "SIG_VALTYPE_", T_SIG_VALTYPE },
+  { "NS_", T_NS },
+  { "INT", T_INT },
+  { "FLOAT", T_FLOAT },
+  { "NAN", T_NAN },
+  { "STRING", T_STRING },
+  { "ENUM", T_ENUM },
+  { "HEX", T_HEX },
+  { "NS_DESC_", T_NS_DESC },
+  { "CM_", T_CM },
+  { "BA_DEF_", T_BA_DEF },
+  { "BA_", T_BA },
+  { "VAL_", T_VAL },
+  { "CAT_DEF_", T_CAT_DEF },
+  { "CAT_", T_CAT },
+  { "FILTER", T_FILTER },
+  { "BA_DEF_DEF_", T_BA_DEF_DEF },
+  { "EV_DATA_", T_EV_DATA },
+  { "ENVVAR_DATA_", T_ENVVAR_DATA },
+  { "SGTYPE_", T_SGTYPE },
+  { "SGTYPE_VAL_", T_SGTYPE_VAL },
+  { "BA_DEF_SGTYPE_", T_BA_DEF_SGTYPE },
+  { "BA_SGTYPE_", T_BA_SGTYPE },
+  { "SIG_TYPE_REF_", T_SIG_TYPE_REF },
+  { "VAL_TABLE_", T_VAL_TABLE },
+  { "SIG_GROUP_", T_SIG_GROUP },
+  { "SIGTYPE_VALTYPE_", T_SIGTYPE_VALTYPE },
+  { "BO_TX_BU_", T_BO_TX_BU },
+  { "BA_DEF_REL_", T_BA_DEF_REL },
+  { "BA_REL_", T_BA_REL },
+  { "BA_DEF_DEF_REL_", T_BA_DEF_DEF_REL },
+  { "BU_SG_REL_", T_BU_SG_REL },
+  { "BU_EV_REL_", T_BU_EV_REL },
+  { "BU_BO_REL_", T_BU_BO_REL },
+  { "SG_MUL_VAL_", T_SG_MUL_VAL },
+  };
+
+static int dbc_host_token(size_t start, size_t end, int token)
+  {
+  s_text = s_buffer.input.substr(start, end - start);
+  yytext = (char*)s_text.c_str();
+  s_buffer.pos = end;
+  return token;
+  }
+
+// Length of the number at pos: [-+]?[0-9]+(\.[0-9]+)?([eE][-+]?[0-9]+)?
+//  or 0x[0-9A-Fa-f]+, 0 if none; *isfloat tells the rule that matched
+static size_t dbc_host_number(const std::string& s, size_t pos, bool* isfloat)
+  {
+  size_t p = pos;
+  *isfloat = false;
+  if (s.compare(p, 2, "0x") == 0 && p + 2 < s.size() && isxdigit((unsigned char)s[p+2]))
+    {
+    for (p += 2; p < s.size() && isxdigit((unsigned char)s[p]); p++);
+    return p - pos;
+    }
+  if (p < s.size() && (s[p] == '-' || s[p] == '+')) p++;
+  if (p >= s.size() || !isdigit((unsigned char)s[p])) return 0;
+  while (p < s.size() && isdigit((unsigned char)s[p])) p++;
+  if (p + 1 < s.size() && s[p] == '.' && isdigit((unsigned char)s[p+1]))
+    {
+    for (p++; p < s.size() && isdigit((unsigned char)s[p]); p++);
+    *isfloat = true;
+    }
+  if (p < s.size() && (s[p] == 'e' || s[p] == 'E'))
+    {
+    size_t e = p + 1;
+    if (e < s.size() && (s[e] == '-' || s[e] == '+')) e++;
+    if (e < s.size() && isdigit((unsigned char)s[e]))
+      {
+      for (p = e; p < s.size() && isdigit((unsigned char)s[p]); p++);
+      *isfloat = true;
+      }
+    }
+  return p - pos;
+  }
+
+int yylex(void)
+  {
+  const std::string& s = s_buffer.input;
+  size_t& pos = s_buffer.pos;
+
+  // whitespace, newlines & comments:
+  while (pos < s.size())
+    {
+    if (s[pos] == '\n')
+      {
+      yylineno++;
+      pos++;
+      }
+    else if (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\r')
+      pos++;
+    else if (s.compare(pos, 2, "//") == 0)
+      {
+      size_t eol = s.find('\n', pos);
+      pos = (eol == std::string::npos) ? s.size() : eol;
+      }
+    else
+      break;
+    }
+  if (pos >= s.size())
+    return 0;
+
+  size_t start = pos;
+  char c = s[pos];
+
+  // keywords & identifiers: a keyword matches the whole identifier
+  if (isalpha((unsigned char)c) || c == '_')
+    {
+    size_t end = pos + 1;
+    while (end < s.size() && (isalnum((unsigned char)s[end]) || s[end] == '_' || s[end] == '.'))
+      end++;
+    std::string id = s.substr(start, end - start);
+    for (const auto& kw : s_keywords)
+      {
+      if (id == kw.name)
+        return dbc_host_token(start, end, kw.token);
+      }
+    if (id.size() == 18 && id.compare(0, 17, "DUMMY_NODE_VECTOR") == 0 && id[17] >= '0' && id[17] <= '3')
+      {
+      yylval.number = id[17] - '0';
+      return dbc_host_token(start, end, T_DUMMY_NODE_VECTOR);
+      }
+    yylval.string = strdup(id.c_str());
+    return dbc_host_token(start, end, T_ID);
+    }
+
+  // strings: quotes removed, escapes kept
+  if (c == '"')
+    {
+    size_t end = pos + 1;
+    while (end < s.size() && s[end] != '"')
+      end += (s[end] == '\\' && end + 1 < s.size()) ? 2 : 1;
+    if (end < s.size())
+      {
+      yylval.string = strdup(s.substr(start + 1, end - start - 1).c_str());
+      return dbc_host_token(start, end + 1, T_STRING_VAL);
+      }
+    }
+
+  // numbers: the decimal & hexadecimal rules win over the float rule on equal length
+  bool isfloat;
+  size_t len = dbc_host_number(s, pos, &isfloat);
+  if (len)
+    {
+    int token = dbc_host_token(start, start + len, isfloat ? T_DOUBLE_VAL : T_INT_VAL);
+    if (isfloat)
+      yylval.double_val = strtod(yytext, NULL);
+    else if (s_text.compare(0, 2, "0x") == 0)
+      yylval.number = strtol(yytext, NULL, 16);
+    else
+      yylval.number = atoll(yytext);
+    return token;
+    }
+
+  switch (c)
+    {
+    case ':': return dbc_host_token(start, start + 1, T_COLON);
+    case ';': return dbc_host_token(start, start + 1, T_SEMICOLON);
+    case '|': return dbc_host_token(start, start + 1, T_SEP);
+    case ',': return dbc_host_token(start, start + 1, T_COMMA);
+    case '@': return dbc_host_token(start, start + 1, T_AT);
+    case '+': return dbc_host_token(start, start + 1, T_PLUS);
+    case '-': return dbc_host_token(start, start + 1, T_MINUS);
+    case '[': return dbc_host_token(start, start + 1, T_BOX_OPEN);
+    case ']': return dbc_host_token(start, start + 1, T_BOX_CLOSE);
+    case '(': return dbc_host_token(start, start + 1, T_PAR_OPEN);
+    case ')': return dbc_host_token(start, start + 1, T_PAR_CLOSE);
+    default:  return dbc_host_token(start, start + 1, (unsigned char)c);
+    }
+  }
+
+void yyrestart(FILE* input_file)
+  {
+  s_buffer.input.clear();
+  s_buffer.pos = 0;
+  yylineno = 1;
+  char buf[512];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), input_file)) > 0)
+    s_buffer.input.append(buf, n);
+  }
+
+YY_BUFFER_STATE yy_scan_bytes(const char* bytes, int len)
+  {
+  s_buffer.input.assign(bytes, len);
+  s_buffer.pos = 0;
+  yylineno = 1;
+  return &s_buffer;
+  }
+
+void yy_delete_buffer(YY_BUFFER_STATE buffer)
+  {
+  buffer->input.clear();
+  buffer->pos = 0;
+  }
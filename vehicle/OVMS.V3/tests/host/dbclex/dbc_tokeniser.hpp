@@ -0,0 +1,50 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: DBC tokeniser (without lex)
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_DBC_TOKENISER_HPP__
+#define __SHIM_DBC_TOKENISER_HPP__
+
+#include <stdio.h>
+
+/**
+ * Stand-in for the lex generated DBC tokeniser (components/dbc/src/
+ *  dbc_tokeniser.l), used by the host build if lex is not installed.
+ *  It implements the token rules of dbc_tokeniser.l, so the yacc
+ *  generated parser and dbc.cpp run unmodified. Only the part of the
+ *  lex interface used by the parser and dbcfile is provided.
+ */
+
+typedef struct dbc_host_buffer* YY_BUFFER_STATE;
+
+extern char* yytext;
+extern int yylineno;
+
+int yylex(void);
+void yyrestart(FILE* input_file);
+YY_BUFFER_STATE yy_scan_bytes(const char* bytes, int len);
+void yy_delete_buffer(YY_BUFFER_STATE buffer);
+
+#endif //#ifndef __SHIM_DBC_TOKENISER_HPP__
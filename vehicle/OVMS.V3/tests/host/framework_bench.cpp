@@ -0,0 +1,454 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host tests: framework benchmarks
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <math.h>
+#include <sched.h>
+#include <string>
+#include <vector>
+#include <string.h>
+#include "esp_log.h"
+#include "hosttest.h"
+#include "ovms_command.h"
+#include "ovms_config.h"
+#include "ovms_events.h"
+#include "ovms_metrics.h"
+#include "vehicle.h"
+#include "vcan.h"
+#include "simcom.h"
+#include "cansignal.h"
+#ifdef HOSTTEST_DBC
+#include "dbc.h"
+#endif
+
+/**
+ * Benchmarks of the framework hot paths running on the host shims:
+ *  metric updates (with & without listeners), event dispatch,
+ *  CAN frame fan-out to callbacks & listeners, log throughput, CAN signal
+ *  extraction & DBC decoding and NMEA sentence processing.
+ *
+ * Absolute numbers depend on the host, use them to compare variants and
+ * to check for regressions, not as module figures.
+ */
+
+static vcan* s_can1;
+
+// Wait for space in a queue without the sleep latency of hosttest_wait():
+static void wait_queue_space(QueueHandle_t queue)
+  {
+  while (uxQueueSpacesAvailable(queue) == 0)
+    sched_yield();
+  }
+
+class BenchVehicle : public OvmsVehicle
+  {
+  };
+
+static void bench_metrics()
+  {
+  const long count = 1000000;
+  OvmsMetricFloat* metric = new OvmsMetricFloat("bench.value");
+  int calls = 0;
+  printf("Metric updates (SetValue on change):\n");
+
+  BENCH("no listeners", count, metric->SetValue((float)(_i & 1023)));
+
+  MyMetrics.RegisterListener("bench", "bench.value", [&](OvmsMetric* m) { calls++; });
+  BENCH("immediate listener on metric", count, metric->SetValue((float)(_i & 1023)));
+  MyMetrics.DeregisterListener("bench");
+
+  MyMetrics.RegisterListener("bench", "v.b.soc", [&](OvmsMetric* m) { calls++; });
+  BENCH("immediate listener on other metric", count, metric->SetValue((float)(_i & 1023)));
+  MyMetrics.DeregisterListener("bench");
+
+  MyMetrics.RegisterListener("bench", "*", [&](OvmsMetric* m) { calls++; }, true);
+  BENCH("deferred \"*\" listener", count, metric->SetValue((float)(_i & 1023)));
+  MyMetrics.DeregisterListener("bench");
+
+  MyMetrics.RegisterListener("bench", "*", [&](OvmsMetric* m) { calls++; });
+  BENCH("immediate \"*\" listener", count, metric->SetValue((float)(_i & 1023)));
+  MyMetrics.DeregisterListener("bench");
+
+  BenchVehicle* vehicle = new BenchVehicle();
+  BENCH("vehicle module loaded", count, metric->SetValue((float)(_i & 1023)));
+  delete vehicle;
+
+  hosttest_use(calls);
+  }
+
+static void bench_events()
+  {
+  const int count = 50000;
+  std::atomic_int received(0);
+  printf("Event dispatch (signal to delivery):\n");
+
+  for (int handlers : { 1, 10 })
+    {
+    for (int h = 0; h < handlers; h++)
+      MyEvents.RegisterEvent("bench", "bench.event", [&](std::string event, void* data) { received++; });
+    received = 0;
+    double start = hosttest_now();
+    for (int i = 0; i < count; i++)
+      {
+      wait_queue_space(MyEvents.m_taskqueue);
+      MyEvents.SignalEvent("bench.event", NULL);
+      }
+    CHECK(hosttest_wait([&]{ return received == count * handlers; }, 30));
+    double time = hosttest_now() - start;
+    char name[50];
+    snprintf(name, sizeof(name), "%d handler(s)", handlers);
+    printf("  %-40s %10.1f ns/event\n", name, time * 1e9 / count);
+    MyEvents.DeregisterEvent("bench");
+    }
+  }
+
+/**
+ * Frame fan-out: frames injected on the virtual bus pass the CAN RX task
+ *  to the callbacks and listeners. Injection is flow controlled, so the
+ *  results show the delivery throughput without losses.
+ */
+static CanListenerRing s_ring;
+static std::atomic_int s_ringcount;
+static QueueHandle_t s_queue;
+static std::atomic_int s_queuecount;
+
+static void ring_task(void* arg)
+  {
+  CAN_frame_t frame;
+  while (1)
+    {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (s_ring.Pop(&frame))
+      s_ringcount++;
+    }
+  }
+
+static void queue_task(void* arg)
+  {
+  CAN_frame_t frame;
+  while (1)
+    {
+    if (xQueueReceive(s_queue, &frame, portMAX_DELAY) == pdTRUE)
+      s_queuecount++;
+    }
+  }
+
+static void bench_can_run(const char* name, int count, bool ring, bool queue)
+  {
+  std::atomic_int callback(0);
+  uint8_t data[8] = { 0 };
+  s_ringcount = 0;
+  s_queuecount = 0;
+  uint32_t overflows = s_can1->m_status.rxring_overflow + s_can1->m_status.listener_overflow;
+  double start = hosttest_now();
+  MyCan.RegisterCallback("bench", [&](const CAN_frame_t* frame) { callback++; });
+  for (int i = 0; i < count; i++)
+    {
+    memcpy(data, &i, 4);
+    while (s_can1->m_rxring.FreeSpace() == 0
+      || (ring && s_ring.FreeSpace() <= CONFIG_OVMS_HW_CAN_RX_RING_SIZE)
+      || (queue && uxQueueSpacesAvailable(s_queue) <= CONFIG_OVMS_HW_CAN_RX_RING_SIZE))
+      sched_yield();
+    s_can1->Inject(0x123, 8, data);
+    }
+  CHECK(hosttest_wait([&]{ return callback == count
+    && (!ring || s_ringcount == count) && (!queue || s_queuecount == count); }, 30));
+  double time = hosttest_now() - start;
+  MyCan.DeregisterCallback("bench");
+  CHECK_EQ(s_can1->m_status.rxring_overflow + s_can1->m_status.listener_overflow, overflows);
+  printf("  %-40s %10.1f ns/frame\n", name, time * 1e9 / count);
+  }
+
+static void bench_can()
+  {
+  const int count = 200000;
+  printf("CAN frame fan-out (inject to delivery):\n");
+  s_can1->Start(CAN_MODE_LISTEN, CAN_SPEED_500KBPS);
+
+  bench_can_run("callback", count, false, false);
+
+  TaskHandle_t ringtask;
+  xTaskCreatePinnedToCore(ring_task, "bench ring", 4096, NULL, 5, &ringtask, 1);
+  MyCan.RegisterListener(&s_ring, ringtask);
+  bench_can_run("callback + ring listener", count, true, false);
+
+  s_queue = xQueueCreate(4*CONFIG_OVMS_HW_CAN_RX_RING_SIZE, sizeof(CAN_frame_t));
+  TaskHandle_t queuetask;
+  xTaskCreatePinnedToCore(queue_task, "bench queue", 4096, NULL, 5, &queuetask, 1);
+  MyCan.RegisterListener(s_queue);
+  bench_can_run("callback + ring + queue listener", count, true, true);
+
+  MyCan.DeregisterListener(s_queue);
+  MyCan.DeregisterListener(&s_ring);
+  vTaskDelete(queuetask);
+  vTaskDelete(ringtask);
+  s_can1->Stop();
+  }
+
+/**
+ * Log throughput: ESP_LOGx calls via the console log hook into the log
+ *  file writer, in text and structured mode. The caller side cost is
+ *  measured, the file shows how many lines the writer task could keep.
+ */
+static int bench_vprintf(const char* fmt, va_list args)
+  {
+  return MyCommandApp.Log(fmt, args);
+  }
+
+static int count_lines(const char* path, const char* match)
+  {
+  FILE* f = fopen(path, "r");
+  if (!f) return -1;
+  char line[256];
+  int n = 0;
+  while (fgets(line, sizeof(line), f))
+    if (strstr(line, match)) n++;
+  fclose(f);
+  return n;
+  }
+
+static void bench_log_run(const char* name, const char* structured, int count, int pause)
+  {
+  MyConfig.SetParamValue("log", "structured", structured);
+  unlink("/store/bench.log");
+  MyConfig.SetParamValue("log", "file.path", "/store/bench.log");
+  usleep(100000);
+
+  double start = hosttest_now();
+  for (int i = 0; i < count; i++)
+    {
+    ESP_LOGW("bench", "log line %d, value %.2f, state %s", i, i * 0.5, (i & 1) ? "on" : "off");
+    if (pause && (i % pause) == pause-1)
+      usleep(1000);
+    }
+  double time = hosttest_now() - start;
+
+  // Close the file to flush all lines:
+  usleep(200000);
+  MyConfig.SetParamValue("log", "file.path", "/store/bench.tmp");
+  usleep(100000);
+  int lines = count_lines("/store/bench.log", "log line");
+  printf("  %-40s %10.1f ns/line, %d/%d lines written\n", name, time * 1e9 / count, lines, count);
+  }
+
+static void bench_log()
+  {
+  printf("Log throughput (ESP_LOGW to log file):\n");
+  esp_log_set_vprintf(bench_vprintf);
+  esp_log_level_set("*", ESP_LOG_INFO);
+  MyCommandApp.ConfigureLogging();
+  MyConfig.SetParamValue("log", "file.syncperiod", "-1");
+  MyConfig.SetParamValue("log", "file.maxsize", "0");
+  MyConfig.SetParamValueBool("log", "file.enable", true);
+
+  bench_log_run("text, burst", "no", 20000, 0);
+  bench_log_run("structured, burst", "yes", 20000, 0);
+  bench_log_run("text, paced (pause every 100 lines)", "no", 20000, 100);
+  bench_log_run("structured, paced (pause every 100 lines)", "yes", 20000, 100);
+
+  MyConfig.SetParamValueBool("log", "file.enable", false);
+  esp_log_level_set("*", ESP_LOG_WARN);
+  }
+
+// Battery status frame used by the signal extraction benchmark:
+//  SG_ Voltage : 0|16@1+ (0.01,0)
+//  SG_ Current : 16|16@1- (0.1,0)
+//  SG_ SOC : 39|10@0+ (0.1,0)
+//  SG_ Temp : 48|8@1+ (1,-40)
+static constexpr cansignal sig_voltage(0, 16, CAN_SIG_INTEL, false, 0.01);
+static constexpr cansignal sig_current(16, 16, CAN_SIG_INTEL, true, 0.1);
+static constexpr cansignal sig_soc(39, 10, CAN_SIG_MOTOROLA, false, 0.1);
+static constexpr cansignal sig_temp(48, 8, CAN_SIG_INTEL, false, 1, -40);
+
+static float decode_bytes(const uint8_t* d)
+  {
+  return ((d[0] | (d[1] << 8)) * 0.01f)
+    + ((int16_t)(d[2] | (d[3] << 8)) * 0.1f)
+    + (((d[4] << 2) | (d[5] >> 6)) * 0.1f)
+    + (d[6] - 40.0f);
+  }
+
+static float decode_canbitset(uint8_t* d)
+  {
+  canbitset<uint64_t> bits(d, 8);
+  return (__builtin_bswap16(bits.get(0, 15)) * 0.01f)
+    + ((int16_t)__builtin_bswap16(bits.get(16, 31)) * 0.1f)
+    + (bits.get(32, 41) * 0.1f)
+    + (bits.get(48, 55) - 40.0f);
+  }
+
+static float decode_cansignal(const CAN_frame_t* frame)
+  {
+  canpayload payload(frame);
+  return payload.Get(sig_voltage) + payload.Get(sig_current)
+    + payload.Get(sig_soc) + payload.Get(sig_temp);
+  }
+
+static float decode_cansignal(const CAN_frame_t* frame, const cansignal* sig)
+  {
+  canpayload payload(frame);
+  return payload.Get(sig[0]) + payload.Get(sig[1])
+    + payload.Get(sig[2]) + payload.Get(sig[3]);
+  }
+
+static void bench_signals()
+  {
+  const int count = 1000000;
+  printf("CAN signal extraction (4 signals per frame, Intel & Motorola):\n");
+
+  // 64 frames of pseudo random data, so the results can't be precomputed:
+  CAN_frame_t frames[64];
+  uint32_t seed = 12345;
+  memset(frames, 0, sizeof(frames));
+  for (int i = 0; i < 64; i++)
+    {
+    frames[i].MsgID = 0x123;
+    frames[i].FIR.B.DLC = 8;
+    for (int j = 0; j < 8; j++)
+      {
+      seed = seed * 1103515245 + 12345;
+      frames[i].data.u8[j] = seed >> 16;
+      }
+    }
+
+  // Runtime descriptors, as built by the DBC decoder:
+  std::vector<cansignal> sigs;
+  sigs.push_back(cansignal(0, 16, CAN_SIG_INTEL, false, 0.01));
+  sigs.push_back(cansignal(16, 16, CAN_SIG_INTEL, true, 0.1));
+  sigs.push_back(cansignal(39, 10, CAN_SIG_MOTOROLA, false, 0.1));
+  sigs.push_back(cansignal(48, 8, CAN_SIG_INTEL, false, 1, -40));
+
+#ifdef HOSTTEST_DBC
+  static const char source[] =
+    "VERSION \"\"\n"
+    "BU_: BMS\n"
+    "BO_ 291 Battery: 8 BMS\n"
+    " SG_ Voltage : 0|16@1+ (0.01,0) [0|655.35] \"V\" Vector__XXX\n"
+    " SG_ Current : 16|16@1- (0.1,0) [-3276.8|3276.7] \"A\" Vector__XXX\n"
+    " SG_ SOC : 39|10@0+ (0.1,0) [0|100] \"%\" Vector__XXX\n"
+    " SG_ Temp : 48|8@1+ (1,-40) [-40|215] \"C\" Vector__XXX\n";
+  dbcfile dbc;
+  CHECK(dbc.LoadString(source, strlen(source)));
+  dbcMessage* msg = dbc.m_messages.FindMessage(291);
+  CHECK(msg != NULL);
+  dbcSignal* dsig[4] =
+    {
+    msg->FindSignal("Voltage"), msg->FindSignal("Current"),
+    msg->FindSignal("SOC"), msg->FindSignal("Temp")
+    };
+  for (int i = 0; i < 4; i++)
+    CHECK(dsig[i] != NULL);
+#endif // HOSTTEST_DBC
+
+  // All variants must agree:
+  for (int i = 0; i < 64; i++)
+    {
+    float ref = decode_bytes(frames[i].data.u8);
+    CHECK(fabsf(decode_canbitset(frames[i].data.u8) - ref) < 0.01f);
+    CHECK(fabsf(decode_cansignal(&frames[i]) - ref) < 0.01f);
+    CHECK(fabsf(decode_cansignal(&frames[i], sigs.data()) - ref) < 0.01f);
+#ifdef HOSTTEST_DBC
+    double sum = 0;
+    for (int j = 0; j < 4; j++)
+      sum += dsig[j]->Decode(frames[i]).GetDouble();
+    CHECK(fabs(sum - ref) < 0.01);
+#endif // HOSTTEST_DBC
+    }
+
+  BENCH("hand written byte access", count,
+    { hosttest_use(decode_bytes(frames[_i & 63].data.u8)); });
+  BENCH("canbitset<uint64_t>", count,
+    { hosttest_use(decode_canbitset(frames[_i & 63].data.u8)); });
+  BENCH("canpayload, static constexpr cansignal", count,
+    { hosttest_use(decode_cansignal(&frames[_i & 63])); });
+  BENCH("canpayload, runtime cansignal", count,
+    { hosttest_use(decode_cansignal(&frames[_i & 63], sigs.data())); });
+#ifdef HOSTTEST_DBC
+  BENCH("dbcSignal::Decode(frame) per signal", count,
+    {
+    double sum = 0;
+    for (int j = 0; j < 4; j++)
+      sum += dsig[j]->Decode(frames[_i & 63]).GetDouble();
+    hosttest_use(sum);
+    });
+  BENCH("dbcSignal::Decode(payload), one load", count,
+    {
+    canpayload payload(&frames[_i & 63]);
+    double sum = 0;
+    for (int j = 0; j < 4; j++)
+      sum += dsig[j]->Decode(payload).GetDouble();
+    hosttest_use(sum);
+    });
+#endif // HOSTTEST_DBC
+  }
+
+static void bench_nmea()
+  {
+  const int count = 200000;
+  simcom* modem = new simcom("nmeabench", 0, 115200, 0, 0, 0, 0);
+  GsmNMEA* nmea = &modem->m_nmea;
+  printf("NMEA sentences (1 Hz GNS + RMC, position changing):\n");
+
+  // Sentences as sent by the modem once per second, with the time field
+  //  and the position changing every sentence:
+  std::vector<std::string> lines;
+  for (int i = 0; i < 100; i++)
+    {
+    char body[128];
+    snprintf(body, sizeof(body), i & 1
+      ? "GPRMC,0853%02d.0,A,5118.%06d,N,00723.%06d,E,%d.0,265.5,181026,,,A"
+      : "GNGNS,0853%02d.0,5118.%06d,N,00723.%06d,E,AA,12,0.9,321.3,47.0,,",
+      i / 2 % 60, 138139 + i * 17, 398844 + i * 23, i % 90);
+    uint8_t cs = 0;
+    for (char* p = body; *p; p++)
+      cs ^= *p;
+    char line[sizeof(body) + 4];
+    snprintf(line, sizeof(line), "$%s*%02X", body, cs);
+    lines.push_back(line);
+    }
+
+  GsmNMEASentence s;
+  BENCH("parse & verify checksum", count,
+    { const std::string& l = lines[_i % 100]; hosttest_use(s.Parse(l.data(), l.size())); });
+  BENCH("parse & update metrics", count,
+    { const std::string& l = lines[_i % 100]; nmea->IncomingLine(l.data(), l.size()); });
+  CHECK_EQ(nmea->m_badsentences, 0u);
+
+  delete modem;
+  }
+
+extern "C" void app_main(void)
+  {
+  MyConfig.mount();
+  s_can1 = new vcan("can1");
+
+  bench_metrics();
+  bench_events();
+  bench_can();
+  bench_log();
+  bench_signals();
+  bench_nmea();
+  }
@@ -0,0 +1,1694 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host tests: framework on POSIX shims
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "hosttest.h"
+#include "ovms.h"
+#include "ovms_config.h"
+#include "ovms_http.h"
+#include "ovms_events.h"
+#include "ovms_metrics.h"
+#include "ovms_notify.h"
+#include "log_record.h"
+#include "string_writer.h"
+#include "esp_log.h"
+#include "metrics_standard.h"
+#include "vehicle.h"
+#include "vcan.h"
+#include "canreplay.h"
+#include "buffered_shell.h"
+#include "mcp2515.h"
+#include "obd2ecu.h"
+#include "simcom.h"
+#include "gsmmux_traffic.h"
+#include "ovms_ota.h"
+#ifdef HOSTTEST_DBC
+#include "dbc.h"
+#endif
+
+/**
+ * Functional tests of the framework running on the host shims:
+ *  configuration store, events, metric listeners, notifications & spool,
+ *  the log recorder, CAN frame delivery (callbacks, queue & ring
+ *  listeners) via the virtual CAN driver, the MCP2515 driver against a
+ *  simulated chip, the vehicle poller against a simulated ECU, the OBDII
+ *  ECU against a simulated dongle, the BMS cell history, vehicle state
+ *  events, the GSM MUX with sample modem traffic, the NMEA parser, the
+ *  OTA delta patch applier, the HTTP client against a local server
+ *  stand-in and the DBC parser & signal decoding.
+ */
+
+static vcan* s_can1;
+static vcan* s_ecu;
+
+static void test_config()
+  {
+  std::atomic_int changed(0);
+  MyEvents.RegisterEvent("test", "config.changed", [&changed](std::string event, void* data)
+    {
+    OvmsConfigParam* param = (OvmsConfigParam*) data;
+    if (param && param->GetName() == "vehicle") changed++;
+    });
+
+  MyConfig.SetParamValue("vehicle", "id", "HOSTTEST");
+  MyConfig.SetParamValueInt("vehicle", "minsoc", 42);
+  CHECK(MyConfig.GetParamValue("vehicle", "id") == "HOSTTEST");
+  CHECK_EQ(MyConfig.GetParamValueInt("vehicle", "minsoc"), 42);
+  CHECK(hosttest_wait([&]{ return changed == 2; }));
+
+  // Persisted in the store:
+  FILE* f = fopen("/store/ovms_config/vehicle", "r");
+  CHECK(f != NULL);
+  char buf[200];
+  size_t len = fread(buf, 1, sizeof(buf)-1, f);
+  buf[len] = 0;
+  fclose(f);
+  CHECK(strstr(buf, "id\tHOSTTEST\n") != NULL);
+
+  MyEvents.DeregisterEvent("test");
+  printf("  config: ok\n");
+  }
+
+static void test_events()
+  {
+  std::vector<int> seen;
+  OvmsMutex mutex;
+  MyEvents.RegisterEvent("test", "test.event", [&](std::string event, void* data)
+    {
+    OvmsMutexLock lock(&mutex);
+    seen.push_back(*(int*)data);
+    });
+
+  // Signalled events are delivered in order by the events task, the data
+  //  is copied if a length is given. The event queue does not block, so
+  //  the test waits for space (events are dropped on overflow):
+  for (int i = 0; i < 100; i++)
+    {
+    CHECK(hosttest_wait([]{ return uxQueueSpacesAvailable(MyEvents.m_taskqueue) > 0; }));
+    MyEvents.SignalEvent("test.event", &i, sizeof(i));
+    }
+  CHECK(hosttest_wait([&]{ OvmsMutexLock lock(&mutex); return seen.size() == 100; }));
+  for (int i = 0; i < 100; i++)
+    CHECK_EQ(seen[i], i);
+
+  MyEvents.DeregisterEvent("test");
+  int i = 100;
+  MyEvents.SignalEvent("test.event", &i, sizeof(i));
+  usleep(50000);
+  CHECK_EQ(seen.size(), 100u);
+  printf("  events: ok\n");
+  }
+
+static void test_metrics()
+  {
+  OvmsMetricFloat* soc = StandardMetrics.ms_v_bat_soc;
+  int immediate = 0;
+  std::atomic_int deferred(0);
+  MyMetrics.RegisterListener("test", "v.b.soc", [&](OvmsMetric* m) { immediate++; });
+  MyMetrics.RegisterListener("test.deferred", "*", [&](OvmsMetric* m)
+    {
+    if (m == soc) deferred++;
+    }, true);
+
+  // Immediate listeners are called by SetValue(), only on changes:
+  soc->SetValue(50);
+  soc->SetValue(50);
+  soc->SetValue(51.5);
+  CHECK_EQ(immediate, 2);
+  CHECK(soc->AsString() == "51.5");
+  CHECK_EQ(soc->AsInt(), 51);
+
+  // Deferred listeners are called once per second for all changes:
+  MyEvents.SignalEvent("ticker.1", NULL);
+  CHECK(hosttest_wait([&]{ return deferred == 1; }));
+  usleep(50000);
+  CHECK_EQ(deferred, 1);
+
+  MyMetrics.DeregisterListener("test");
+  MyMetrics.DeregisterListener("test.deferred");
+  soc->SetValue(60);
+  CHECK_EQ(immediate, 2);
+
+  // Fixed point vectors saturate at the StoreType range:
+  OvmsMetricFixedVector<uint16_t,3>* cv = StandardMetrics.ms_v_bat_cell_voltage;
+  float volts[3] = { 3.912, 70.0, -0.5 };
+  cv->SetElemValues(0, 3, volts);
+  CHECK(cv->AsString() == "3.912,65.535,0");
+  CHECK(cv->GetElemValue(1) == 65.535f);
+  cv->ClearValue();
+  printf("  metrics: ok\n");
+  }
+
+static void test_notify()
+  {
+  std::atomic_int received(0);
+  std::string text;
+  size_t reader = MyNotify.RegisterReader("test", COMMAND_RESULT_NORMAL,
+    [&](OvmsNotifyType* type, OvmsNotifyEntry* entry)
+    {
+    if (strcmp(entry->GetSubType(), "host.test") == 0)
+      {
+      text = entry->GetValue().c_str();
+      received++;
+      }
+    return true;
+    });
+  MyNotify.NotifyStringf("info", "host.test", "hello %d", 42);
+  CHECK(hosttest_wait([&]{ return received == 1; }));
+  CHECK(text == "hello 42");
+  MyNotify.ClearReader(reader);
+  printf("  notify: ok\n");
+  }
+
+/**
+ * Notification spool:
+ *  - entries from a previous boot stay spooled until a reader registers
+ *  - a full spool drops the oldest entries, RAM use stays bounded while
+ *    loaded entries are pending
+ */
+static void spool_write_record(FILE* f, uint32_t id, const char* subtype, const char* value)
+  {
+  OvmsNotifySpoolRecord_t rec = {};
+  rec.size = sizeof(rec) + strlen(subtype) + 1 + strlen(value);
+  rec.id = id;
+  fwrite(&rec, sizeof(rec), 1, f);
+  fwrite(subtype, strlen(subtype) + 1, 1, f);
+  fwrite(value, strlen(value), 1, f);
+  }
+
+static void test_notify_spool()
+  {
+  // Spool file left by a previous boot:
+  mkdir("/store/notify", 0755);
+  FILE* f = fopen("/store/notify/spooltest.spool", "wb");
+  CHECK(f != NULL);
+  OvmsNotifySpoolHeader_t hdr = {};
+  memcpy(hdr.magic, NOTIFY_SPOOL_MAGIC, 4);
+  hdr.bootid = MyNotify.m_bootid ^ 1;
+  hdr.commit = sizeof(hdr);
+  fwrite(&hdr, sizeof(hdr), 1, f);
+  for (int i = 1; i <= 3; i++)
+    spool_write_record(f, i, "host.spool", "from last boot");
+  fclose(f);
+
+  MyNotify.RegisterType("spooltest");
+  OvmsNotifyType* mt = MyNotify.GetType("spooltest");
+  CHECK(mt->m_spool->Open()); // as on config.mounted
+  mt->Refill();
+  CHECK(mt->m_entries.empty());
+  CHECK_EQ(mt->m_spool->m_count, 3u);
+
+  // Reader registers: entries are loaded on its first read
+  std::atomic_int online(0);
+  size_t reader = MyNotify.RegisterReader("test", COMMAND_RESULT_NORMAL,
+    [&](OvmsNotifyType* type, OvmsNotifyEntry* entry) { return online != 0; },
+    false, NULL, true);
+  int read = 0;
+  for (OvmsNotifyEntry* e; (e = mt->FirstUnreadEntry(reader, 0)) != NULL; read++)
+    {
+    CHECK(e->GetValue() == "from last boot");
+    mt->MarkRead(reader, e);
+    }
+  CHECK_EQ(read, 3);
+  CHECK(mt->m_spool->IsEmpty());
+
+  // Reader offline, small budgets: RAM fills, then the spool
+  size_t ram = MyNotify.m_spool_ram, size = MyNotify.m_spool_size;
+  MyNotify.m_spool_ram = 1024;
+  MyNotify.m_spool_size = 4096;
+  char value[100];
+  memset(value, 'x', sizeof(value)-1);
+  value[sizeof(value)-1] = 0;
+  for (int i = 0; i < 20; i++)
+    MyNotify.NotifyString("spooltest", "host.spool", value);
+  CHECK(mt->m_spool->m_count > 0);
+  CHECK_EQ(mt->m_spool->m_dropped, 0u);
+
+  // Read some: loaded entries are pending in RAM, then fill the spool:
+  for (int i = 0; i < 5; i++)
+    mt->MarkRead(reader, mt->FirstUnreadEntry(reader, 0));
+  CHECK(!mt->m_spool->m_loaded.empty());
+  size_t ramsize = mt->m_ramsize;
+  for (int i = 0; i < 500; i++)
+    MyNotify.NotifyString("spooltest", "host.spool", value);
+  CHECK(mt->m_spool->m_dropped > 0);
+  CHECK(mt->m_spool->m_end <= MyNotify.m_spool_size);
+  CHECK(mt->m_ramsize <= ramsize);
+
+  // Drain: all kept entries are delivered in order
+  uint32_t lastid = 0;
+  read = 0;
+  for (OvmsNotifyEntry* e; (e = mt->FirstUnreadEntry(reader, 0)) != NULL; read++)
+    {
+    CHECK(e->m_id > lastid);
+    lastid = e->m_id;
+    mt->MarkRead(reader, e);
+    }
+  CHECK_EQ(read + 5 + mt->m_spool->m_dropped, 520u);
+  CHECK(mt->m_entries.empty());
+  CHECK(mt->m_spool->IsEmpty());
+
+  MyNotify.m_spool_ram = ram;
+  MyNotify.m_spool_size = size;
+  MyNotify.ClearReader(reader);
+  printf("  notify spool: ok\n");
+  }
+
+// Put a text record "line <n>" padded to a varying length:
+static void recorder_put(LogRecorder* recorder, int n)
+  {
+  char text[64];
+  snprintf(text, sizeof(text), "line %d %.*s", n, n % 37, "-------------------------------------");
+  uint8_t rec[LOGRECORD_MAXSIZE];
+  recorder->Put(rec, LogRecordPackText(rec, sizeof(rec), text));
+  }
+
+static int recorder_line(const uint8_t* rec)
+  {
+  int n = -1;
+  sscanf((const char*) rec + 4, "line %d", &n);
+  return n;
+  }
+
+static void test_log_recorder()
+  {
+  LogRecorder* recorder = new LogRecorder();
+  CHECK(recorder->Init(4096));
+  uint8_t rec[LOGRECORD_MAXSIZE];
+
+  // Wrapped buffer: the cursor starts at the requested record
+  for (int i = 0; i < 1000; i++)
+    recorder_put(recorder, i);
+  CHECK_EQ(recorder->GetTotal(), 1000u);
+  uint32_t count = recorder->GetCount();
+  CHECK(count > 10 && count < 1000);
+  LogRecorder::cursor_t cur = recorder->Cursor(10);
+  CHECK_EQ(cur.seq, 990u);
+  int n = 990;
+  for (size_t len; (len = recorder->Read(cur, rec, sizeof(rec))) > 0; n++)
+    CHECK_EQ(recorder_line(rec), n);
+  CHECK_EQ(n, 1000);
+  cur = recorder->Cursor(0);
+  CHECK_EQ(recorder->Read(cur, rec, sizeof(rec)), 0u);
+  cur = recorder->Cursor(100000);
+  n = 1000 - count;
+  for (size_t len; (len = recorder->Read(cur, rec, sizeof(rec))) > 0; n++)
+    CHECK_EQ(recorder_line(rec), n);
+  CHECK_EQ(n, 1000);
+
+  // Concurrent writer: reads stay in order, overwritten records are skipped
+  std::atomic_bool stop(false);
+  std::thread writer([&]()
+    {
+    for (int i = 1000; !stop; i++)
+      recorder_put(recorder, i);
+    });
+  for (int pass = 0; pass < 200; pass++)
+    {
+    cur = recorder->Cursor(pass % 50 + 1);
+    int last = -1;
+    for (int reads = 0; reads < 200 && recorder->Read(cur, rec, sizeof(rec)) > 0; reads++)
+      {
+      int line = recorder_line(rec);
+      CHECK(line > last);
+      CHECK_EQ((uint32_t)line + 1, cur.seq);
+      last = line;
+      }
+    }
+  stop = true;
+  writer.join();
+
+  delete recorder;
+  printf("  log recorder: ok\n");
+  }
+
+/**
+ * Log file writer: system shutdown writes the queued lines and syncs the
+ *  file, also if periodic syncs are disabled.
+ */
+static int logfile_vprintf(const char* fmt, va_list args)
+  {
+  return MyCommandApp.Log(fmt, args);
+  }
+
+static std::string logfile_status()
+  {
+  StringWriter status;
+  MyCommandApp.ShowLogStatus(COMMAND_RESULT_NORMAL, &status);
+  return status;
+  }
+
+static int logfile_lines(const char* path, const char* match)
+  {
+  FILE* f = fopen(path, "r");
+  if (!f) return -1;
+  char line[256];
+  int n = 0;
+  while (fgets(line, sizeof(line), f))
+    if (strstr(line, match)) n++;
+  fclose(f);
+  return n;
+  }
+
+static void test_logfile()
+  {
+  vprintf_like_t vprintf = esp_log_set_vprintf(logfile_vprintf);
+  MyCommandApp.ConfigureLogging();
+  MyConfig.SetParamValue("log", "file.syncperiod", "-1");
+  MyConfig.SetParamValue("log", "file.path", "/store/test.log");
+  MyConfig.SetParamValueBool("log", "file.enable", true);
+  CHECK(hosttest_wait([]{ return logfile_status().find("Log file: /store/test.log") != std::string::npos; }));
+  CHECK(logfile_status().find(", 0 syncs") != std::string::npos);
+
+  for (int i = 0; i < 100; i++)
+    ESP_LOGW("logtest", "shutdown line %d", i);
+  MyEvents.SignalEvent("system.shuttingdown", NULL);
+  CHECK(hosttest_wait([]{ return logfile_status().find(", 1 syncs") != std::string::npos; }));
+  CHECK_EQ(logfile_lines("/store/test.log", "shutdown line"), 100);
+
+  MyConfig.SetParamValueBool("log", "file.enable", false);
+  CHECK(MyCommandApp.SetLogfile(""));
+  CHECK(logfile_status().find("Log file: inactive") != std::string::npos);
+  esp_log_set_vprintf(vprintf);
+  printf("  log file: ok\n");
+  }
+
+static void test_can()
+  {
+  const int count = 1000;
+  std::atomic_int callback(0), ringcount(0);
+  MyCan.RegisterCallback("test", [&](const CAN_frame_t* frame)
+    {
+    if (frame->origin == s_can1 && frame->MsgID == 0x123) callback++;
+    });
+
+  // Ring listener task:
+  static CanListenerRing ring;
+  static std::atomic_int* ringcount_p;
+  static std::atomic_int ringerrors;
+  ringcount_p = &ringcount;
+  TaskHandle_t task;
+  xTaskCreatePinnedToCore([](void* arg)
+    {
+    CAN_frame_t frame;
+    uint32_t expect[2] = { 0, 0 };   // per frame source (id 0x124 / 0x123)
+    while (1)
+      {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      while (ring.Pop(&frame))
+        {
+        if (frame.data.u32[0] != expect[frame.MsgID & 1]++) ringerrors++;
+        (*ringcount_p)++;
+        }
+      }
+    }, "test ring", 4096, NULL, 5, &task, 1);
+  MyCan.RegisterListener(&ring, task);
+
+  // Frames are lost if the CAN RX task or the listener cannot keep up,
+  //  like on the module. The test injects with flow control, so all frames
+  //  must be delivered in order:
+  uint8_t data[8] = { 0 };
+  for (uint32_t i = 0; i < count; i++)
+    {
+    memcpy(data, &i, 4);
+    CHECK(hosttest_wait([&]{ return s_can1->m_rxring.FreeSpace() > 0
+      && ring.FreeSpace() > CONFIG_OVMS_HW_CAN_LISTENER_RING_SIZE/2; }));
+    CHECK(s_can1->Inject(0x123, 8, data));
+    }
+  CHECK(hosttest_wait([&]{ return ringcount == count && callback == count; }));
+  CHECK_EQ(ringerrors, 0);
+  CHECK_EQ(s_can1->m_status.packets_rx, (uint32_t)count);
+  CHECK_EQ(s_can1->m_status.rxring_overflow, 0);
+  CHECK_EQ(s_can1->m_status.listener_overflow, 0);
+
+  // Frames injected by another task (like "can rx" or a simulation) pass
+  //  the CAN RX task, so the ring keeps a single producer:
+  std::thread injector([&]()
+    {
+    CAN_frame_t frame = {};
+    frame.origin = s_can1;
+    frame.FIR.B.DLC = 8;
+    frame.MsgID = 0x124;
+    for (uint32_t i = 0; i < count; i++)
+      {
+      frame.data.u32[0] = i;
+      // flow control like canreplay, leaving queue space for the driver:
+      while (ring.FreeSpace() <= CONFIG_OVMS_HW_CAN_LISTENER_RING_SIZE/2
+        || uxQueueMessagesWaiting(MyCan.m_rxqueue) >= CONFIG_OVMS_HW_CAN_RX_QUEUE_SIZE/2)
+        usleep(100);
+      CHECK(MyCan.InjectFrame(&frame, portMAX_DELAY));
+      }
+    });
+  for (uint32_t i = count; i < 2*count; i++)
+    {
+    memcpy(data, &i, 4);
+    CHECK(hosttest_wait([&]{ return s_can1->m_rxring.FreeSpace() > 0
+      && ring.FreeSpace() > CONFIG_OVMS_HW_CAN_LISTENER_RING_SIZE/2; }));
+    CHECK(s_can1->Inject(0x123, 8, data));
+    }
+  injector.join();
+  CHECK(hosttest_wait([&]{ return ringcount == 3*count && callback == 2*count; }));
+  CHECK_EQ(ringerrors, 0);
+  CHECK_EQ(s_can1->m_status.listener_overflow, 0);
+
+  MyCan.DeregisterListener(&ring);
+  MyCan.DeregisterCallback("test");
+  vTaskDelete(task);
+  printf("  can: ok\n");
+  }
+
+/**
+ * CAN replay: CRTD parsing across read chunks, takeover of the bus name,
+ *  poll requests answered from the recorded responses, and reuse of the
+ *  replay bus by the next replay.
+ */
+static std::string host_command(const char* command)
+  {
+  BufferedShell* bs = new BufferedShell(false, COMMAND_RESULT_NORMAL);
+  bs->SetSecure(true);
+  bs->ProcessChars(command, strlen(command));
+  bs->ProcessChar('\n');
+  std::string output;
+  bs->Dump(output);
+  delete bs;
+  return output;
+  }
+
+static void canreplay_write(canbus* bus, uint32_t id, std::vector<uint8_t> data)
+  {
+  CAN_frame_t frame = {};
+  frame.origin = bus;
+  frame.FIR.B.FF = CAN_frame_std;
+  frame.FIR.B.DLC = 8;
+  frame.MsgID = id;
+  memset(frame.data.u8, 0x55, 8);
+  memcpy(frame.data.u8, data.data(), data.size());
+  bus->Write(&frame);
+  }
+
+static void test_canreplay()
+  {
+  const int count = 300;
+  FILE* f = fopen("/store/replay.crtd", "w");
+  CHECK(f != NULL);
+  fprintf(f, "1000.000000 CXX OVMS\n# comment\n");
+  // recorded polls: single frame & multi frame response (VIN)
+  fprintf(f, "1000.0001 1T11 7df 02 01 0d 55 55 55 55 55\n");
+  fprintf(f, "1000.0002 1R11 7e8 03 41 0d 32 aa aa aa aa\n");
+  fprintf(f, "1000.0003 1T11 7e0 03 22 f1 90 55 55 55 55\n");
+  fprintf(f, "1000.0004 1R11 7e8 10 14 62 f1 90 57 56 57\n");
+  fprintf(f, "1000.0005 1R11 7e8 21 5a 5a 5a 31 4b 5a 31\n");
+  fprintf(f, "1000.0006 1R11 7e8 22 41 42 43 44 45 46 47\n");
+  for (int i = 0; i < count; i++)
+    {
+    fprintf(f, "%d.%02d 1R11 100 %02x %02x 00 00\n", 1001 + i/100, i%100, i & 0xff, i >> 8);
+    if (i % 50 == 0)
+      fprintf(f, "%d.%02d 2R11 200 01\n", 1001 + i/100, i%100);
+    }
+  fclose(f);
+
+  std::mutex mutex;
+  std::vector<CAN_frame_t> answers;
+  std::atomic_int frames(0), errors(0);
+  MyCan.RegisterCallback("test.replay", [&](const CAN_frame_t* frame)
+    {
+    if (frame->origin != MyCanReplay)
+      return;
+    if (frame->MsgID == 0x100)
+      {
+      if (frame->data.u8[0] + (frame->data.u8[1] << 8) != frames++) errors++;
+      }
+    else if (frame->MsgID == 0x7e8)
+      {
+      std::lock_guard<std::mutex> lock(mutex);
+      answers.push_back(*frame);
+      }
+    else
+      errors++;
+    });
+
+  // Start: the replay bus takes over the name, frames keep their order:
+  s_can1->Start(CAN_MODE_ACTIVE, CAN_SPEED_500KBPS);
+  CHECK(host_command("can replay start can1 /store/missing.crtd 0").find("Error") != std::string::npos);
+  CHECK(MyPcpApp.FindDeviceByName("can1") == s_can1);
+  CHECK(host_command("can replay start can1 /store/replay.crtd 0").find("started") != std::string::npos);
+  canreplay* replay = MyCanReplay;
+  CHECK(replay != NULL);
+  CHECK(MyPcpApp.FindDeviceByName("can1") == replay);
+  CHECK(hosttest_wait([&]{ return !replay->IsRunning() && frames == count; }));
+  CHECK_EQ(errors, 0);
+  CHECK_EQ(replay->m_frames_read, (uint32_t)(count + 6));
+  CHECK_EQ(replay->m_frames_learned, 4u);
+  CHECK_EQ(replay->m_frames_replayed, (uint32_t)count);
+
+  // Polls: single frame, multi frame on flow control, unknown request:
+  canreplay_write(replay, 0x7df, { 0x02, 0x01, 0x0d });
+  CHECK(hosttest_wait([&]{ std::lock_guard<std::mutex> lock(mutex); return answers.size() == 1; }));
+  canreplay_write(replay, 0x7e0, { 0x03, 0x22, 0xf1, 0x90 });
+  CHECK(hosttest_wait([&]{ std::lock_guard<std::mutex> lock(mutex); return answers.size() == 2; }));
+  canreplay_write(replay, 0x7e0, { 0x30, 0x00, 0x00 });
+  CHECK(hosttest_wait([&]{ std::lock_guard<std::mutex> lock(mutex); return answers.size() == 4; }));
+  canreplay_write(replay, 0x7df, { 0x02, 0x01, 0x0c });
+  usleep(50000);
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK_EQ(answers.size(), 4u);
+    CHECK(answers[0].data.u8[1] == 0x41 && answers[0].data.u8[3] == 0x32);
+    CHECK(answers[1].data.u8[0] == 0x10 && answers[2].data.u8[0] == 0x21);
+    CHECK(answers[3].data.u8[0] == 0x22 && answers[3].data.u8[7] == 0x47);
+    }
+  CHECK_EQ(replay->m_polls_answered, 2u);
+  CHECK_EQ(replay->m_polls_unanswered, 1u);
+
+  // Stop: the name returns to the physical bus, the replay bus is kept
+  //  for frames still queued & reused by the next replay:
+  CHECK(host_command("can replay stop").find("CAN replay stopped.") != std::string::npos);
+  CHECK(MyCanReplay == NULL);
+  CHECK(MyPcpApp.FindDeviceByName("can1") == s_can1);
+  frames = 0;
+  CHECK(host_command("can replay start can1 /store/replay.crtd 0").find("started") != std::string::npos);
+  CHECK(MyCanReplay == replay);
+  CHECK(hosttest_wait([&]{ return !replay->IsRunning() && frames == count; }));
+  CHECK_EQ(replay->m_frames_replayed, (uint32_t)count);
+  CHECK_EQ(replay->m_polls_answered, 0u);
+  CHECK(host_command("can replay stop").find("CAN replay stopped.") != std::string::npos);
+  CHECK(MyPcpApp.FindDeviceByName("can1") == s_can1);
+  CHECK_EQ(errors, 0);
+
+  MyCan.DeregisterCallback("test.replay");
+  s_can1->Start(CAN_MODE_LISTEN, CAN_SPEED_500KBPS);
+  printf("  can replay: ok\n");
+  }
+
+/**
+ * MCP2515 driver against a simulated chip on the host SPI bus:
+ *  registers, RX buffers 0/1 with rollover, READ RX BUFFER clearing the
+ *  RXnIF flag, and the INT line (active while enabled flags are set).
+ */
+class Mcp2515Sim : public spi_nodma_device_t
+  {
+  public:
+    Mcp2515Sim(int intpin) : m_intpin(intpin)
+      {
+      memset(m_reg, 0, sizeof(m_reg));
+      }
+
+  public:
+    // Receive frames from the bus, all before the driver can read one:
+    void Receive(const std::vector<uint32_t>& ids)
+      {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (uint32_t id : ids)
+        {
+        uint8_t& intf = m_reg[0x2c];
+        int n;
+        if (!(intf & 0x01))
+          n = 0;
+        else if ((m_reg[0x60] & 0x04) && !(intf & 0x02))
+          n = 1;  // rollover
+        else
+          {
+          m_reg[0x2d] |= 0x80;  // RX1OVR
+          intf |= 0x20;         // ERRIF
+          continue;
+          }
+        uint8_t* rxb = &m_reg[n ? 0x71 : 0x61];
+        memset(rxb, 0, 13);
+        rxb[0] = id >> 3;
+        rxb[1] = (id & 7) << 5;
+        rxb[4] = 8;
+        memcpy(rxb + 5, &id, 4);
+        intf |= (1 << n);
+        }
+      UpdateInt();
+      }
+
+    void Transfer(uint8_t* buf, int txlen, int rxlen)
+      {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      uint8_t* rx = buf + txlen;
+      uint8_t cmd = buf[0];
+      if (cmd == CMD_RESET)
+        memset(m_reg, 0, sizeof(m_reg));
+      else if (cmd == CMD_WRITE)
+        {
+        for (int i = 2; i < txlen; i++)
+          m_reg[(buf[1] + i - 2) & 0xff] = buf[i];
+        }
+      else if (cmd == CMD_READ)
+        {
+        for (int i = 0; i < rxlen; i++)
+          rx[i] = m_reg[(buf[1] + i) & 0xff];
+        }
+      else if (cmd == CMD_BITMODIFY)
+        m_reg[buf[1]] = (m_reg[buf[1]] & ~buf[2]) | (buf[3] & buf[2]);
+      else if ((cmd & 0b11111001) == CMD_READ_RXBUF)
+        {
+        int n = (cmd >> 2) & 1;
+        memcpy(rx, &m_reg[n ? 0x71 : 0x61], (rxlen < 13) ? rxlen : 13);
+        m_reg[0x2c] &= ~(1 << n);
+        }
+      UpdateInt();
+      }
+
+  protected:
+    void UpdateInt()
+      {
+      gpio_host_set_level(m_intpin, (m_reg[0x2c] & m_reg[0x2b]) ? 0 : 1);
+      }
+
+  public:
+    int m_intpin;
+    std::mutex m_mutex;
+    uint8_t m_reg[256];
+  };
+
+static void test_mcp2515()
+  {
+  const int cspin = 100, intpin = 101;
+  Mcp2515Sim* chip = new Mcp2515Sim(intpin);
+  spi_nodma_host_attach(cspin, chip);
+  spi* bus = new spi("spi.host", -1, -1, -1);
+  mcp2515* can = new mcp2515("can.mcp", bus, VSPI_NODMA_HOST, 1000000, cspin, intpin);
+
+  std::mutex mutex;
+  std::vector<uint32_t> rx, expect;
+  MyCan.RegisterCallback("test", [&](const CAN_frame_t* frame)
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (frame->origin == can) rx.push_back(frame->MsgID);
+    });
+  can->Start(CAN_MODE_LISTEN, CAN_SPEED_500KBPS);
+
+  uint32_t id = 0x100;
+  auto receive = [&](int count, int deliver)
+    {
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < count; i++, id++)
+      {
+      ids.push_back(id);
+      if (i < deliver) expect.push_back(id);
+      }
+    chip->Receive(ids);
+    CHECK(hosttest_wait([&]{ std::lock_guard<std::mutex> lock(mutex); return rx.size() == expect.size(); }));
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(rx == expect);
+    };
+
+  // A single frame (RX buffer 0 only), then A → RXB0 & B → RXB1 before
+  //  the driver reads: A must be delivered first.
+  receive(1, 1);
+  receive(2, 2);
+  receive(2, 2);
+  for (int i = 0; i < 100; i++)
+    receive(1 + (i % 3 == 0), 1 + (i % 3 == 0));
+  CHECK_EQ(can->m_status.rxbuf_overflow, 0u);
+
+  // Both buffers full: the third frame is lost and counted
+  receive(3, 2);
+  CHECK_EQ(can->m_status.rxbuf_overflow, 1u);
+  receive(1, 1);
+  CHECK(can->m_rx_dualreads >= 3);
+
+  MyCan.DeregisterCallback("test");
+  can->SetPowerMode(Off);
+  spi_nodma_host_attach(cspin, NULL);
+  printf("  mcp2515: ok\n");
+  }
+
+/**
+ * Vehicle poller against a simulated ECU on the other end of the bus:
+ *  - 0x7e0/0x7e8 extended PID 0x1234 (single frame)
+ *  - 0x7e0/0x7e8 group 0x01 (ISO-TP multi frame with flow control)
+ */
+class TestVehicle : public OvmsVehicle
+  {
+  public:
+    TestVehicle()
+      {
+      static const poll_pid_t plist[] =
+        {
+        { 0x7e0, 0x7e8, VEHICLE_POLL_TYPE_OBDIIEXTENDED, 0x1234, { 1, 1, 1, 1 } },
+        { 0x7e0, 0x7e8, VEHICLE_POLL_TYPE_OBDIIGROUP, 0x01, { 1, 1, 1, 1 } },
+        { 0, 0, 0, 0, { 0, 0, 0, 0 } }
+        };
+      RegisterCanBus(1, CAN_MODE_ACTIVE, CAN_SPEED_500KBPS);
+      PollSetPidList(m_can1, plist);
+      PollSetState(0);
+      }
+
+  protected:
+    void IncomingPollReply(canbus* bus, uint16_t type, uint16_t pid, uint8_t* data, uint8_t length, uint16_t mlremain)
+      {
+      OvmsMutexLock lock(&m_mutex);
+      if (type == VEHICLE_POLL_TYPE_OBDIIEXTENDED && pid == 0x1234)
+        m_ext.assign(data, data+length);
+      else if (type == VEHICLE_POLL_TYPE_OBDIIGROUP && pid == 0x01)
+        {
+        m_group.insert(m_group.end(), data, data+length);
+        if (mlremain == 0) m_group_done++;
+        }
+      }
+
+  public:
+    OvmsMutex m_mutex;
+    std::vector<uint8_t> m_ext;
+    std::vector<uint8_t> m_group;
+    int m_group_done = 0;
+  };
+
+static void ecu_respond(const CAN_frame_t* frame)
+  {
+  static int ml_pending = 0;
+  if (frame->origin != s_ecu || frame->MsgID != 0x7e0)
+    return;
+  const uint8_t* d = frame->data.u8;
+  CAN_frame_t rsp;
+  memset(&rsp, 0, sizeof(rsp));
+  rsp.MsgID = 0x7e8;
+  rsp.FIR.B.DLC = 8;
+  if (d[0] == 0x03 && d[1] == 0x22)
+    {
+    uint8_t r[8] = { 0x07, 0x62, d[2], d[3], 0xde, 0xad, 0xbe, 0xef };
+    memcpy(rsp.data.u8, r, 8);
+    s_ecu->Write(&rsp);
+    }
+  else if (d[0] == 0x02 && d[1] == 0x21)
+    {
+    // first frame: length 2+18, 4 data bytes 0..3
+    uint8_t r[8] = { 0x10, 20, 0x61, d[2], 0, 1, 2, 3 };
+    memcpy(rsp.data.u8, r, 8);
+    ml_pending = 1;
+    s_ecu->Write(&rsp);
+    }
+  else if (d[0] == 0x30 && ml_pending)
+    {
+    // consecutive frames: data bytes 4..17
+    ml_pending = 0;
+    for (int sn = 1, b = 4; b < 18; sn++)
+      {
+      rsp.data.u8[0] = 0x20 | sn;
+      for (int k = 1; k < 8; k++)
+        rsp.data.u8[k] = (b < 18) ? b++ : 0;
+      s_ecu->Write(&rsp);
+      }
+    }
+  }
+
+static void test_poller()
+  {
+  MyCan.RegisterCallback("test.ecu", ecu_respond);
+  TestVehicle* vehicle = new TestVehicle();
+  CHECK(vehicle->m_can1 == s_can1);
+
+  // Each ticker.1 sends the next due request:
+  for (int i = 0; i < 10; i++)
+    {
+    MyEvents.SignalEvent("ticker.1", NULL);
+    usleep(20000);
+    OvmsMutexLock lock(&vehicle->m_mutex);
+    if (!vehicle->m_ext.empty() && vehicle->m_group_done) break;
+    }
+
+    {
+    OvmsMutexLock lock(&vehicle->m_mutex);
+    CHECK_EQ(vehicle->m_ext.size(), 4u);
+    CHECK_EQ(vehicle->m_ext[0], 0xde);
+    CHECK_EQ(vehicle->m_ext[3], 0xef);
+    CHECK(vehicle->m_group_done >= 1);
+    CHECK(vehicle->m_group.size() >= 18u);
+    for (int i = 0; i < 18; i++)
+      CHECK_EQ(vehicle->m_group[i], i);
+    }
+
+  MyCan.DeregisterCallback("test.ecu");
+  delete vehicle;
+  printf("  poller: ok\n");
+  }
+
+/**
+ * OBDII ECU: s_ecu plays the OBD dongle, the ECU answers on can1.
+ *  PID data has the J1979 size, also in multi-PID responses.
+ */
+static OvmsMutex s_obd_mutex;
+static std::vector<std::vector<uint8_t>> s_obd_rx;
+
+static void obd_receive(const CAN_frame_t* frame)
+  {
+  if (frame->origin != s_ecu || frame->MsgID != 0x7e8)
+    return;
+  OvmsMutexLock lock(&s_obd_mutex);
+  s_obd_rx.push_back(std::vector<uint8_t>(frame->data.u8, frame->data.u8 + 8));
+  }
+
+static std::vector<uint8_t> obd_request(uint32_t id, std::vector<uint8_t> data)
+  {
+    {
+    OvmsMutexLock lock(&s_obd_mutex);
+    s_obd_rx.clear();
+    }
+  data.resize(8, 0x55);
+  CAN_frame_t frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.MsgID = id;
+  frame.FIR.B.DLC = 8;
+  memcpy(frame.data.u8, data.data(), 8);
+  s_ecu->Write(&frame);
+  bool received = hosttest_wait([]
+    {
+    OvmsMutexLock lock(&s_obd_mutex);
+    return !s_obd_rx.empty();
+    }, 1.0);
+  OvmsMutexLock lock(&s_obd_mutex);
+  return (received) ? s_obd_rx[0] : std::vector<uint8_t>();
+  }
+
+static void test_obd2ecu()
+  {
+  typedef std::vector<uint8_t> bytes;
+  OvmsMetricInt* fuelsys = MyMetrics.InitInt("test.obd.fuelsys", 0, 0x0200);
+  OvmsMetricInt* obdstd = MyMetrics.InitInt("test.obd.std", 0, 1);
+  MyConfig.SetParamValue("obd2ecu.map", "3", "test.obd.fuelsys");
+  MyConfig.SetParamValue("obd2ecu.map", "28", "test.obd.std");
+  MyConfig.SetParamValueInt("obd2ecu", "cache.time", 0);
+  StandardMetrics.ms_v_bat_soc->SetValue(50);
+  StandardMetrics.ms_v_pos_speed->SetValue(88);
+  MyCan.RegisterCallback("test.obd", obd_receive);
+  obd2ecu* ecu = new obd2ecu("OBD2ECU", s_can1);
+
+  // Single PIDs: 2 bytes fuel system status, 1 byte OBD standard:
+  CHECK(obd_request(0x7df, { 0x02, 0x01, 0x03 }) == bytes({ 0x04, 0x41, 0x03, 0x02, 0x00, 0x55, 0x55, 0x55 }));
+  CHECK(obd_request(0x7df, { 0x02, 0x01, 0x1c }) == bytes({ 0x03, 0x41, 0x1c, 0x01, 0x55, 0x55, 0x55, 0x55 }));
+  CHECK(obd_request(0x7df, { 0x02, 0x01, 0x12 }) == bytes({ 0x03, 0x41, 0x12, 0x00, 0x55, 0x55, 0x55, 0x55 }));
+
+  // Unimplemented PIDs are answered with zeros of their size, also in between:
+  CHECK(obd_request(0x7df, { 0x03, 0x01, 0x13, 0x0d }) == bytes({ 0x05, 0x41, 0x13, 0x00, 0x0d, 0x58, 0x55, 0x55 }));
+
+  // Multi-PID response: first frame + consecutive frame after flow control:
+  CHECK(obd_request(0x7df, { 0x04, 0x01, 0x04, 0x03, 0x0d }) == bytes({ 0x10, 0x08, 0x41, 0x04, 0x7f, 0x03, 0x02, 0x00 }));
+  CHECK(obd_request(0x7e0, { 0x30, 0x00, 0x00 }) == bytes({ 0x21, 0x0d, 0x58, 0x55, 0x55, 0x55, 0x55, 0x55 }));
+
+  MyCan.DeregisterCallback("test.obd");
+  delete ecu;
+  MyConfig.DeleteInstance("obd2ecu.map", "3");
+  MyConfig.DeleteInstance("obd2ecu.map", "28");
+  fuelsys->SetValue(0);
+  obdstd->SetValue(0);
+  s_can1->Start(CAN_MODE_LISTEN, CAN_SPEED_500KBPS);
+  printf("  obd2ecu: ok\n");
+  }
+
+/**
+ * BMS cell history: resizing before or after the cell arrangement
+ *  reallocates & clears the history, size 0 disables it.
+ */
+class BmsVehicle : public OvmsVehicle
+  {
+  public:
+    BmsVehicle()
+      {
+      BmsSetCellArrangementVoltage(4, 2);
+      }
+    void AddSet(float base)
+      {
+      float v[4] = { base, base + 0.01f, base + 0.02f, base + 0.03f };
+      BmsSetCellVoltages(0, 4, v);
+      }
+    using OvmsVehicle::BmsSetCellHistorySize;
+  };
+
+static void test_bms()
+  {
+  BmsVehicle* vehicle = new BmsVehicle();
+  float values[16];
+  for (int i = 0; i < 3; i++)
+    vehicle->AddSet(3.7 + i * 0.01);
+  CHECK_EQ(vehicle->BmsGetCellHistoryVoltage(1, values, 16), 3);
+  CHECK(fabsf(values[0] - 3.73f) < 0.0005f);
+
+  // Shrink after the arrangement: history cleared, ring wraps at the new size:
+  vehicle->BmsSetCellHistorySize(2);
+  CHECK_EQ(vehicle->BmsGetCellHistoryVoltage(1, values, 16), 0);
+  for (int i = 0; i < 5; i++)
+    vehicle->AddSet(3.6 + i * 0.01);
+  CHECK_EQ(vehicle->BmsGetCellHistoryVoltage(1, values, 16), 2);
+  CHECK(fabsf(values[0] - 3.65f) < 0.0005f);
+  CHECK(fabsf(values[1] - 3.64f) < 0.0005f);
+
+  // Grow: no overflow of the previous allocation:
+  vehicle->BmsSetCellHistorySize(32);
+  for (int i = 0; i < 40; i++)
+    vehicle->AddSet(3.5 + (i % 10) * 0.01);
+  CHECK_EQ(vehicle->BmsGetCellHistoryVoltage(3, values, 16), 16);
+
+  // Module level voltages above 32.767 V are kept, out of range values clamped:
+  vehicle->AddSet(40.0);
+  CHECK_EQ(vehicle->BmsGetCellHistoryVoltage(3, values, 1), 1);
+  CHECK(fabsf(values[0] - 40.03f) < 0.0005f);
+  vehicle->AddSet(70.0);
+  CHECK_EQ(vehicle->BmsGetCellHistoryVoltage(0, values, 1), 1);
+  CHECK(fabsf(values[0] - 65.535f) < 0.0005f);
+  vehicle->AddSet(-1.0);
+  CHECK_EQ(vehicle->BmsGetCellHistoryVoltage(0, values, 1), 1);
+  CHECK(values[0] == 0);
+
+  // Disable: sets are still processed, no history:
+  vehicle->BmsSetCellHistorySize(0);
+  vehicle->AddSet(3.7);
+  vehicle->AddSet(3.8);
+  CHECK_EQ(vehicle->BmsGetCellHistoryVoltage(0, values, 16), 0);
+  CHECK(vehicle->BmsGetCellDriftVoltage(0) == 0);
+
+  delete vehicle;
+  printf("  bms history: ok\n");
+  }
+
+/**
+ * Vehicle state events: the standard metrics handled by the vehicle
+ *  module still raise their hooks with per metric listeners, metrics
+ *  added by the vehicle module reach its MetricModified() override.
+ */
+class EventVehicle : public OvmsVehicle
+  {
+  public:
+    int m_on = 0, m_off = 0, m_charge = 0, m_soc = 0;
+    EventVehicle()
+      {
+      ListenMetric(StandardMetrics.ms_v_bat_soc);
+      }
+  protected:
+    void MetricModified(OvmsMetric* metric)
+      {
+      if (metric == StandardMetrics.ms_v_bat_soc)
+        m_soc++;
+      else
+        OvmsVehicle::MetricModified(metric);
+      }
+    void NotifiedVehicleOn() { m_on++; }
+    void NotifiedVehicleOff() { m_off++; }
+    void NotifiedVehicleChargeState(const char* s) { m_charge++; }
+  };
+
+static void test_vehicle_events()
+  {
+  EventVehicle* vehicle = new EventVehicle();
+  StandardMetrics.ms_v_env_on->SetValue(true);
+  StandardMetrics.ms_v_env_on->SetValue(false);
+  StandardMetrics.ms_v_charge_state->SetValue("charging");
+  StandardMetrics.ms_v_bat_soc->SetValue(-1);
+  StandardMetrics.ms_v_bat_soc->SetValue(42);
+  CHECK_EQ(vehicle->m_on, 1);
+  CHECK_EQ(vehicle->m_off, 1);
+  CHECK_EQ(vehicle->m_charge, 1);
+  CHECK_EQ(vehicle->m_soc, 2);
+  delete vehicle;
+  StandardMetrics.ms_v_bat_soc->SetValue(43);
+  printf("  vehicle events: ok\n");
+  }
+
+/**
+ * GSM MUX & modem driver: the sample traffic fed in chunks of any size opens
+ *  all channels and reaches the channel consumers. In NetMode PPP data is
+ *  passed to PPP from the frame (not buffered) unless older data is queued
+ *  in the channel. An NMEA line exceeding the channel buffer is truncated,
+ *  counted and dropped, a frame with a bad end flag is dropped without
+ *  losing the following frames.
+ */
+static void gsmmux_feed(GsmMux* mux, OvmsBuffer* rx, const uint8_t* data, size_t len, size_t chunk)
+  {
+  for (size_t pos = 0; pos < len; )
+    {
+    size_t n = std::min(std::min(chunk, len - pos), rx->FreeSpace());
+    rx->Push((uint8_t*)data + pos, n);
+    mux->Process(rx);
+    pos += n;
+    }
+  }
+
+static void gsmmux_feed(GsmMux* mux, OvmsBuffer* rx, const std::string& data)
+  {
+  gsmmux_feed(mux, rx, (const uint8_t*)data.data(), data.size(), 64);
+  }
+
+static unsigned int gsmmux_ppp_input(simcom* modem, std::string* data)
+  {
+  u8_t* input;
+  size_t len;
+  unsigned int calls = pppos_host_take_input(modem->m_ppp.m_ppp, &input, &len);
+  data->assign(input ? (const char*)input : "", len);
+  free(input);
+  return calls;
+  }
+
+// Frame <payload> for <channel> as the modem would (UIH), using the MUX transmitter
+static std::string gsmmux_frame(simcom* modem, int channel, const std::string& payload)
+  {
+  uint8_t buf[256];
+  while (uart_host_get_tx(0, buf, sizeof(buf)) > 0)
+    ;
+  modem->m_mux.tx(channel, payload.data(), payload.size());
+  std::string frame(payload.size() + 8, 0);
+  frame.resize(uart_host_get_tx(0, (uint8_t*)&frame[0], frame.size()));
+  return frame;
+  }
+
+static void test_gsmmux()
+  {
+  CHECK(getenv("XFAIL") == NULL);
+  simcom* modem = new simcom("gsmtest", 0, 115200, 0, 0, 0, 0);
+  GsmMux* mux = &modem->m_mux;
+  GsmNMEA* nmea = &modem->m_nmea;
+  OvmsBuffer rx(SIMCOM_BUF_SIZE);
+  std::string data, ppp;
+
+  // NetMode, as entered by the modem task:
+  modem->m_state1 = simcom::NetMode;
+  modem->m_ppp.Initialise();
+  CHECK(modem->m_ppp.m_ppp != NULL);
+
+  for (size_t chunk : { (size_t)1, (size_t)7, (size_t)64, sizeof(gsmmux_traffic) })
+    {
+    mux->Start();
+    modem->m_sq = 99;
+    modem->m_netreg = simcom::NotRegistered;
+    uint32_t sentences = nmea->m_sentences;
+    gsmmux_feed(mux, &rx, gsmmux_traffic, sizeof(gsmmux_traffic), chunk);
+    CHECK(mux->IsMuxUp());
+    CHECK_EQ(mux->m_rxframecount, (uint32_t)GSMMUX_TRAFFIC_FRAMES);
+    CHECK_EQ(mux->m_framingerrors, 0u);
+    CHECK_EQ(nmea->m_sentences - sentences, 3u);
+    CHECK_EQ(nmea->m_badsentences, 0u);
+    CHECK_EQ(modem->m_sq, 17);
+    CHECK_EQ(modem->m_netreg, simcom::RegisteredHome);
+    // Both PPP frames passed on directly:
+    CHECK_EQ(gsmmux_ppp_input(modem, &data), 2u);
+    CHECK_EQ(mux->m_channels[GSM_MUX_CHAN_DATA]->m_buffer.UsedSpace(), 0u);
+    CHECK_EQ(data.size(), (size_t)GSMMUX_TRAFFIC_DATASIZE);
+    for (int i = 0; i < 300; i++)
+      CHECK_EQ((uint8_t)data[data.size() - 300 + i], (uint8_t)(i * 7 + 3));
+    CHECK_EQ(mux->m_rxoverflows, 0u);
+    if (ppp.empty())
+      ppp = data;
+    CHECK(data == ppp);
+    mux->Stop();
+    }
+
+  // Older data queued in the data channel: the PPP frames follow it
+  mux->Start();
+  mux->m_channels[GSM_MUX_CHAN_DATA]->m_buffer.Push((uint8_t*)"queued", 6);
+  gsmmux_feed(mux, &rx, gsmmux_traffic, sizeof(gsmmux_traffic), 64);
+  CHECK(gsmmux_ppp_input(modem, &data) >= 2);
+  CHECK(data == "queued" + ppp);
+  CHECK_EQ(mux->m_channels[GSM_MUX_CHAN_DATA]->m_buffer.UsedSpace(), 0u);
+
+  // NMEA line longer than the channel buffer: the buffer keeps the line
+  //  start, the line is dropped and the next lines are parsed again
+  GsmMuxChannel* chan = mux->m_channels[GSM_MUX_CHAN_NMEA];
+  size_t size = chan->m_buffer.Size();
+  std::string longline = "$GPXXX," + std::string(size, '1');
+  gsmmux_feed(mux, &rx, gsmmux_frame(modem, GSM_MUX_CHAN_NMEA, longline));
+  CHECK_EQ(mux->m_rxoverflows, 1u);
+  CHECK_EQ(chan->m_overflows, (uint32_t)(longline.size() - size));
+  CHECK_EQ(chan->m_buffer.UsedSpace(), 0u);
+  uint32_t sentences = nmea->m_sentences;
+  gsmmux_feed(mux, &rx, gsmmux_frame(modem, GSM_MUX_CHAN_NMEA, "*00\r\n"));
+  gsmmux_feed(mux, &rx, gsmmux_traffic, sizeof(gsmmux_traffic), 64);
+  CHECK_EQ(mux->m_rxoverflows, 1u);
+  CHECK_EQ(nmea->m_sentences - sentences, 3u);
+  CHECK_EQ(nmea->m_badsentences, 0u);
+  CHECK_EQ(gsmmux_ppp_input(modem, &data), 2u);
+  mux->Stop();
+
+  // Bad end flag on the +CSQ response frame: resync to the next frame
+  static const uint8_t csq[] = { 0xf9, 0x11, 0xff, 0x2b };
+  std::string traffic((const char*)gsmmux_traffic, sizeof(gsmmux_traffic));
+  size_t end = traffic.find(std::string((const char*)csq, sizeof(csq))) + 26;
+  CHECK_EQ((uint8_t)traffic[end], 0xf9);
+  traffic[end] = 0;
+  mux->Start();
+  modem->m_sq = 99;
+  modem->m_netreg = simcom::NotRegistered;
+  sentences = nmea->m_sentences;
+  gsmmux_feed(mux, &rx, traffic.substr(0, end + 1));
+  CHECK_EQ(mux->m_framingerrors, 2u); // end flag mismatch & bad flag byte skipped
+  gsmmux_feed(mux, &rx, traffic.substr(end + 1));
+  CHECK_EQ(mux->m_rxframecount, (uint32_t)GSMMUX_TRAFFIC_FRAMES - 1);
+  CHECK_EQ(modem->m_sq, 99);
+  CHECK_EQ(modem->m_netreg, simcom::RegisteredHome);
+  CHECK_EQ(nmea->m_sentences - sentences, 3u);
+  CHECK_EQ(gsmmux_ppp_input(modem, &data), 2u);
+  CHECK(data == ppp);
+  mux->Stop();
+
+  delete modem;
+  printf("  gsm mux: ok\n");
+  }
+
+/**
+ * NMEA parser: known sentences, generated fixes against a strtod based
+ *  reference conversion, and mutated sentences (no crash, a sentence is
+ *  only accepted with a matching checksum).
+ */
+static std::string nmea_make(const std::string& body)
+  {
+  uint8_t cs = 0;
+  for (char c : body)
+    cs ^= c;
+  char sum[8];
+  snprintf(sum, sizeof(sum), "*%02X", cs);
+  return "$" + body + sum;
+  }
+
+static std::string nmea_coord_field(double deg, int degdigits)
+  {
+  char buf[32];
+  double a = fabs(deg);
+  int d = (int)a;
+  snprintf(buf, sizeof(buf), "%0*d%09.6f", degdigits, d, (a - d) * 60);
+  if (buf[degdigits] == '6' && buf[degdigits+1] == '0') // rounded up to 60 minutes
+    snprintf(buf, sizeof(buf), "%0*d%09.6f", degdigits, d + 1, 0.0);
+  return buf;
+  }
+
+static double nmea_coord_ref(const std::string& field)
+  {
+  double v = strtod(field.c_str(), NULL);
+  return floor(v / 100) + fmod(v, 100) / 60;
+  }
+
+static bool nmea_near(double a, double b, double tol)
+  {
+  return fabs(a - b) <= tol * std::max(1.0, fabs(b));
+  }
+
+static bool nmea_checksum_ok(const std::string& line)
+  {
+  size_t star = line.find('*');
+  if (star == std::string::npos || star + 2 >= line.size())
+    return false;
+  uint8_t cs = 0;
+  for (size_t i = 1; i < star; i++)
+    cs ^= line[i];
+  return strtoul(line.substr(star + 1, 2).c_str(), NULL, 16) == cs
+    && isxdigit(line[star+1]) && isxdigit(line[star+2]);
+  }
+
+static void test_nmea()
+  {
+  simcom* modem = new simcom("nmeatest", 0, 115200, 0, 0, 0, 0);
+  GsmNMEA* nmea = &modem->m_nmea;
+  GsmNMEASentence s;
+
+  // Known sentences:
+  std::string gns = "$GNGNS,085320.0,5118.138139,N,00723.398844,E,AA,12,0.9,321.3,47.0,,*6E";
+  CHECK(s.Parse(gns.data(), gns.size()));
+  CHECK_EQ(s.count, 13);
+  CHECK(std::string(s.Field(0), s.FieldLen(0)) == "$GNGNS");
+  CHECK(std::string(s.Field(2), s.FieldLen(2)) == "5118.138139");
+  CHECK_EQ(s.FieldLen(11), 0u);
+  CHECK_EQ(s.FieldLen(13), 0u);
+  std::string rmc = "$GPRMC,085320.0,A,5118.138139,N,00723.398844,E,0.0,265.5,101217,,,A*62";
+  CHECK(s.Parse(rmc.data(), rmc.size()));
+  std::string lower = gns.substr(0, gns.size() - 1) + "e";
+  CHECK(s.Parse(lower.data(), lower.size()));
+  for (const char* bad : {
+      "$GNGNS,085320.0,5118.138139,N,00723.398844,E,AA,12,0.9,321.3,47.0,,*6F", // checksum
+      "$GNGNS,085320.0,5118.138139,N,00723.398844,E,AA,12,0.9,321.3,47.0,,6E",  // no '*'
+      "$GNGNS,085320.0,5118.138139,N,00723.398844,E,AA,12,0.9,321.3,47.0,,*6",  // short sum
+      "GNGNS,085320.0,5118.138139,N,00723.398844,E,AA,12,0.9,321.3,47.0,,*6E",  // no '$'
+      "$GP*00" })
+    CHECK(!s.Parse(bad, strlen(bad)));
+  std::string fields = nmea_make("GPXXX" + std::string(NMEA_MAXFIELDS, ','));
+  CHECK(!s.Parse(fields.data(), fields.size()));
+  std::string longline = nmea_make("GPXXX," + std::string(NMEA_MAXLEN, '1'));
+  CHECK(!s.Parse(longline.data(), longline.size()));
+
+  // Generated fixes:
+  std::mt19937 rng(4711);
+  std::uniform_real_distribution<double> lat(-89.9, 89.9), lon(-179.9, 179.9), val(0, 999.9);
+  uint32_t sentences = nmea->m_sentences;
+  for (int i = 0; i < 5000; i++)
+    {
+    double la = lat(rng), lo = lon(rng), alt = val(rng), speed = val(rng), dir = val(rng) * 0.36;
+    char body[160];
+    std::string laf = nmea_coord_field(la, 2), lof = nmea_coord_field(lo, 3);
+    snprintf(body, sizeof(body), "GNGNS,%02d%02d%02d.0,%s,%c,%s,%c,AA,%d,%.1f,%.1f,47.0,,",
+      i / 3600 % 24, i / 60 % 60, i % 60, laf.c_str(), (la < 0) ? 'S' : 'N', lof.c_str(),
+      (lo < 0) ? 'W' : 'E', i % 20, (i % 50) / 10.0, alt);
+    std::string line = nmea_make(body);
+    nmea->IncomingLine(line.data(), line.size());
+    snprintf(body, sizeof(body), "GPRMC,%02d%02d%02d.0,A,%s,%c,%s,%c,%.3f,%.2f,181026,,,A",
+      i / 3600 % 24, i / 60 % 60, i % 60, laf.c_str(), (la < 0) ? 'S' : 'N', lof.c_str(),
+      (lo < 0) ? 'W' : 'E', speed, dir);
+    line = nmea_make(body);
+    nmea->IncomingLine(line.data(), line.size());
+
+    double rla = nmea_coord_ref(laf) * ((la < 0) ? -1 : 1);
+    double rlo = nmea_coord_ref(lof) * ((lo < 0) ? -1 : 1);
+    CHECK(nmea_near(StdMetrics.ms_v_pos_latitude->AsFloat(), rla, 1e-6));
+    CHECK(nmea_near(StdMetrics.ms_v_pos_longitude->AsFloat(), rlo, 1e-6));
+    CHECK(nmea_near(StdMetrics.ms_v_pos_altitude->AsFloat(), round(alt * 10) / 10, 1e-6));
+    CHECK_EQ(StdMetrics.ms_v_pos_satcount->AsInt(), i % 20);
+    CHECK(nmea_near(StdMetrics.ms_v_pos_gpsspeed->AsFloat(), round(speed * 1000) / 1000 * 1.852, 1e-5));
+    CHECK(nmea_near(StdMetrics.ms_v_pos_direction->AsFloat(), round(dir * 100) / 100, 1e-6));
+    }
+  CHECK_EQ(nmea->m_sentences - sentences, 10000u);
+  CHECK(StdMetrics.ms_v_pos_gpslock->AsBool());
+
+  // Mutated sentences:
+  std::vector<std::string> seeds = { gns, rmc, nmea_make("GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20") };
+  const char alphabet[] = "$*,.0123456789ABCDEFNSWEabcdef\r\n\x00\xff";
+  for (int i = 0; i < 200000; i++)
+    {
+    std::string line = seeds[i % seeds.size()];
+    if (i & 1)
+      {
+      // single substitution in the checksummed part: always rejected
+      size_t p = 1 + rng() % (line.find('*') - 1);
+      char c;
+      do c = alphabet[rng() % (sizeof(alphabet) - 1)]; while (c == line[p] || c == '*');
+      line[p] = c;
+      CHECK(!s.Parse(line.data(), line.size()));
+      }
+    else
+      {
+      // random edits: accepted only with a consistent checksum
+      for (int n = 1 + rng() % 4; n > 0; n--)
+        {
+        size_t p = rng() % (line.size() + 1);
+        char c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        switch (rng() % 3)
+          {
+          case 0: if (p < line.size()) line[p] = c; break;
+          case 1: line.insert(p, 1, c); break;
+          case 2: line.erase(p, 1 + rng() % 8); break;
+          }
+        }
+      if (s.Parse(line.data(), line.size()))
+        {
+        CHECK(nmea_checksum_ok(line));
+        CHECK(s.count >= 1 && s.count <= NMEA_MAXFIELDS);
+        }
+      }
+    nmea->IncomingLine(line.data(), line.size());
+    }
+  CHECK(nmea->m_badsentences > 100000);
+
+  delete modem;
+  printf("  nmea: ok\n");
+  }
+
+/**
+ * OTA delta patch: two sample images (the new one with an insert, a delete,
+ *  scattered edits and a new tail) patched in feeds of any size, and
+ *  broken patches rejected before touching the update partition where
+ *  possible.
+ */
+class OtaPatchBuilder
+  {
+  public:
+    OtaPatchBuilder(const std::string& source) : m_source(source) {}
+    void Copy(uint32_t offset, uint32_t len)
+      {
+      m_ops += '\x01' + Varint(offset) + Varint(len);
+      m_target += m_source.substr(offset, len);
+      }
+    void Data(const std::string& data)
+      {
+      m_ops += '\x02' + Varint(data.size()) + data;
+      m_target += data;
+      }
+    std::string Patch(uint32_t targetsize = 0)
+      {
+      std::string hdr = OTA_DELTA_MAGIC + Le32(m_source.size()) + MD5(m_source)
+        + Le32(targetsize ? targetsize : m_target.size()) + MD5(m_target);
+      return hdr + m_ops + '\x00';
+      }
+    static std::string Varint(uint32_t n)
+      {
+      std::string v;
+      for (; n >= 0x80; n >>= 7)
+        v += (char)(0x80 | (n & 0x7f));
+      return v + (char)n;
+      }
+    static std::string Le32(uint32_t n)
+      {
+      return std::string({ (char)n, (char)(n >> 8), (char)(n >> 16), (char)(n >> 24) });
+      }
+    static std::string MD5(const std::string& data)
+      {
+      OVMS_MD5_CTX ctx;
+      uint8_t md5[OVMS_MD5_SIZE];
+      OVMS_MD5_Init(&ctx);
+      OVMS_MD5_Update(&ctx, (const uint8_t*)data.data(), data.size());
+      OVMS_MD5_Final(md5, &ctx);
+      return std::string((const char*)md5, sizeof(md5));
+      }
+
+  public:
+    const std::string& m_source;
+    std::string m_ops;
+    std::string m_target;
+  };
+
+static const esp_partition_t s_ota_running = { 0, 0x10, 0x010000, 0x40000, "ota_0", false };
+static const esp_partition_t s_ota_update  = { 0, 0x11, 0x050000, 0x40000, "ota_1", false };
+
+static std::string ota_read(const esp_partition_t* partition, size_t size)
+  {
+  std::string data(size, 0);
+  CHECK(esp_partition_read(partition, 0, &data[0], size) == ESP_OK);
+  return data;
+  }
+
+static void ota_flash(const esp_partition_t* partition, const std::string& image)
+  {
+  CHECK(esp_partition_erase_range(partition, 0, partition->size) == ESP_OK);
+  CHECK(esp_partition_write(partition, 0, image.data(), image.size()) == ESP_OK);
+  }
+
+// Apply patch in feeds of <chunk> bytes, returns NULL or the error:
+static const char* ota_apply(const std::string& patch, size_t chunk)
+  {
+  OvmsOTAStream stream(&s_ota_update);
+  OvmsOTAPatch applier(&s_ota_running, &stream);
+  bool ok = true;
+  for (size_t pos = 0; ok && pos < patch.size(); pos += chunk)
+    ok = applier.Feed((const uint8_t*)patch.data() + pos, std::min(chunk, patch.size() - pos));
+  if (ok)
+    ok = applier.Finish();
+  return ok ? NULL : applier.GetError();
+  }
+
+static void test_ota_patch()
+  {
+  std::mt19937 rng(4711);
+  std::string oldimg(150000, 0);
+  for (size_t i = 0; i < oldimg.size(); i++)
+    oldimg[i] = (i % 4096 < 3000) ? (char)rng() : (char)(i >> 4); // code & tables
+  std::string edit(64, 'x');
+
+  OtaPatchBuilder pb(oldimg);
+  pb.Copy(0, 20000);
+  pb.Data(std::string(1000, 'i'));                      // insert
+  pb.Copy(20000, 40000);
+  for (uint32_t pos = 63000; pos < 140000; pos += 7000) // delete & edits
+    {
+    pb.Copy(pos, 6990);
+    pb.Data(edit.substr(0, 1 + pos % 9));
+    }
+  pb.Data(std::string(5000, 't'));                      // new tail
+  std::string patch = pb.Patch();
+  const std::string& newimg = pb.m_target;
+  CHECK(patch.size() < newimg.size() / 10);
+
+  ota_flash(&s_ota_running, oldimg);
+  for (size_t chunk : { (size_t)1, (size_t)13, (size_t)4096, patch.size() })
+    {
+    ota_flash(&s_ota_update, std::string(16, 'u'));
+    CHECK(ota_apply(patch, chunk) == NULL);
+    CHECK(ota_read(&s_ota_update, newimg.size()) == newimg);
+    }
+
+  // Broken patches, the update partition must not be erased:
+  ota_flash(&s_ota_update, std::string(16, 'u'));
+  std::string wrongsrc = patch;
+  wrongsrc[10] ^= 1;
+  CHECK(strcmp(ota_apply(wrongsrc, 4096), "patch does not match the running firmware") == 0);
+  CHECK(strcmp(ota_apply(pb.Patch(s_ota_update.size + 1), 4096), "patch target does not fit the update partition") == 0);
+  CHECK(ota_read(&s_ota_update, 16) == std::string(16, 'u'));
+
+  // Broken patches detected while patching:
+  std::string hdr = patch.substr(0, OTA_DELTA_HEADERSIZE);
+  CHECK(strcmp(ota_apply(hdr + "\x01\x80\x80\x80\x80\x10\x01", 1), "invalid patch varint") == 0);
+  CHECK(strcmp(ota_apply(hdr + "\x02\x80\x80\x80\x80\x81\x01", 1), "invalid patch varint") == 0);
+  CHECK(strcmp(ota_apply(hdr + "\x01" + OtaPatchBuilder::Varint(149999) + "\x02", 7), "invalid patch copy range") == 0);
+  CHECK(strcmp(ota_apply(hdr + "\x03", 7), "invalid patch operation") == 0);
+  CHECK(strcmp(ota_apply(patch.substr(0, patch.size() - 1), 4096), "patch incomplete") == 0);
+  CHECK(strcmp(ota_apply(patch + '\x00', 4096), "data after end of patch") == 0);
+  OtaPatchBuilder big(oldimg);
+  big.Copy(0, 100000);
+  CHECK(strcmp(ota_apply(big.Patch(50000), 4096), "patch output exceeds target size") == 0);
+  for (int i = 0; i < 200; i++)
+    {
+    std::string broken = patch;
+    broken[OTA_DELTA_HEADERSIZE + rng() % (broken.size() - OTA_DELTA_HEADERSIZE)] ^= 1 << (rng() % 8);
+    CHECK(ota_apply(broken, 4096) != NULL);
+    }
+
+  printf("  ota patch: ok\n");
+  }
+
+/**
+ * HTTP client against a local server stand-in:
+ *  /ka       keep-alive, Content-Length body
+ *  /chunked  keep-alive, chunked body
+ *  /continue keep-alive, interim 1xx responses before the final one
+ *  /close    HTTP/1.0, body delimited by connection close
+ * The server counts accepted & closed (by the client) connections.
+ */
+static std::atomic_int s_http_accepted(0), s_http_closed(0);
+
+static void http_serve(int sock)
+  {
+  std::string req;
+  char buf[1024];
+  while (1)
+    {
+    size_t end = req.find("\r\n\r\n");
+    if (end == std::string::npos)
+      {
+      ssize_t n = recv(sock, buf, sizeof(buf), 0);
+      if (n <= 0)
+        {
+        s_http_closed++;
+        break;
+        }
+      req.append(buf, n);
+      continue;
+      }
+    std::string path = req.substr(req.find(' ') + 1);
+    path = path.substr(0, path.find(' '));
+    req.erase(0, end + 4);
+    std::string rsp;
+    if (path == "/ka")
+      rsp = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello";
+    else if (path == "/chunked")
+      rsp = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+            "3\r\nhel\r\n7;ext=1\r\nlo\nworl\r\n2\r\nd\n\r\n0\r\n\r\n";
+    else if (path == "/continue")
+      rsp = "HTTP/1.1 100 Continue\r\n\r\n"
+            "HTTP/1.1 103 Early Hints\r\nLink: </ka>; rel=preload\r\n\r\n"
+            "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello";
+    else
+      rsp = "HTTP/1.0 200 OK\r\n\r\nbye\n";
+    send(sock, rsp.data(), rsp.size(), 0);
+    if (path == "/close")
+      break;
+    }
+  close(sock);
+  }
+
+static int http_server_start()
+  {
+  int lsock = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  CHECK(bind(lsock, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+  CHECK(listen(lsock, 8) == 0);
+  socklen_t len = sizeof(addr);
+  getsockname(lsock, (struct sockaddr*)&addr, &len);
+  std::thread([lsock]
+    {
+    int sock;
+    while ((sock = accept(lsock, NULL, NULL)) >= 0)
+      {
+      s_http_accepted++;
+      std::thread(http_serve, sock).detach();
+      }
+    }).detach();
+  return ntohs(addr.sin_port);
+  }
+
+static void test_http()
+  {
+  char base[40];
+  snprintf(base, sizeof(base), "http://127.0.0.1:%d", http_server_start());
+  std::string url(base);
+
+  // Sequential requests share one connection:
+  for (int i = 0; i < 3; i++)
+    {
+    OvmsHttpClient http(url + "/ka");
+    CHECK_EQ(http.ResponseCode(), 200);
+    CHECK_EQ(http.IsReused(), i > 0);
+    char body[10];
+    CHECK_EQ(http.BodyRead(body, sizeof(body)), 5u);
+    CHECK(memcmp(body, "hello", 5) == 0);
+    }
+  CHECK_EQ(s_http_accepted, 1);
+
+    {
+    OvmsHttpClient http(url + "/chunked");
+    CHECK(http.IsReused());
+    CHECK(http.BodyReadLine() == "hello");
+    CHECK(http.BodyReadLine() == "world");
+    CHECK(http.BodyHasLine() < 0);
+    }
+
+  // Interim responses are skipped:
+    {
+    OvmsHttpClient http(url + "/continue");
+    CHECK(http.IsReused());
+    CHECK_EQ(http.ResponseCode(), 200);
+    char body[10];
+    CHECK_EQ(http.BodyRead(body, sizeof(body)), 5u);
+    CHECK(memcmp(body, "hello", 5) == 0);
+    }
+
+  // Close delimited bodies are not pooled:
+    {
+    OvmsHttpClient http(url + "/close");
+    CHECK(http.IsReused());
+    CHECK(http.BodyReadLine() == "bye");
+    }
+    {
+    OvmsHttpClient http(url + "/ka");
+    CHECK(!http.IsReused());
+    char body[10];
+    CHECK_EQ(http.BodyRead(body, sizeof(body)), 5u);
+    }
+  CHECK_EQ(s_http_accepted, 2);
+
+  // The reaper closes expired idle connections on the next ticker.10:
+  MyEvents.SignalEvent("ticker.10", NULL);
+  usleep(50000);
+  CHECK_EQ(s_http_closed, 0);
+  monotonictime += OVMS_HTTP_KEEPALIVE + 1;
+  MyEvents.SignalEvent("ticker.10", NULL);
+  CHECK(hosttest_wait([]{ return s_http_closed == 1; }));
+
+  // …and all idle connections when the network goes down:
+    {
+    OvmsHttpClient http(url + "/ka");
+    CHECK(!http.IsReused());
+    char body[10];
+    CHECK_EQ(http.BodyRead(body, sizeof(body)), 5u);
+    }
+  CHECK_EQ(s_http_accepted, 3);
+  MyEvents.SignalEvent("network.down", NULL);
+  CHECK(hosttest_wait([]{ return s_http_closed == 2; }));
+
+  printf("  http: ok\n");
+  }
+
+#ifdef HOSTTEST_DBC
+/**
+ * DBC: the parsed byte order ("@1" Intel, "@0" Motorola) selects the
+ *  extraction of Decode() and is written back unchanged.
+ */
+static void test_dbc()
+  {
+  static const char source[] =
+    "VERSION \"\"\n"
+    "BU_: ECU\n"
+    "BO_ 291 Test: 8 ECU\n"
+    " SG_ Speed : 0|16@1+ (0.1,0) [0|6553.5] \"km/h\" Vector__XXX\n"
+    " SG_ Torque : 23|12@0- (1,0) [-2048|2047] \"Nm\" Vector__XXX\n";
+  dbcfile dbc;
+  CHECK(dbc.LoadString(source, strlen(source)));
+  dbcMessage* msg = dbc.m_messages.FindMessage(291);
+  CHECK(msg != NULL);
+  dbcSignal* speed = msg->FindSignal("Speed");
+  dbcSignal* torque = msg->FindSignal("Torque");
+  CHECK(speed != NULL && torque != NULL);
+  CHECK_EQ(speed->GetByteOrder(), DBC_BYTEORDER_LITTLE_ENDIAN);
+  CHECK_EQ(torque->GetByteOrder(), DBC_BYTEORDER_BIG_ENDIAN);
+  CHECK_EQ(speed->GetCanSignal().order, CAN_SIG_INTEL);
+  CHECK_EQ(torque->GetCanSignal().order, CAN_SIG_MOTOROLA);
+
+  CAN_frame_t frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.MsgID = 291;
+  frame.FIR.B.DLC = 8;
+  static const uint8_t data[8] = { 0x34, 0x12, 0xfe, 0xdc, 0, 0, 0, 0 };
+  memcpy(frame.data.u8, data, 8);
+  CHECK(fabs(speed->Decode(frame).GetDouble() - 466.0) < 1e-9);   // 0x1234 * 0.1
+  CHECK_EQ(torque->Decode(frame).GetDouble(), -19.0);             // 0xfed, 12 bit signed
+
+  std::string out;
+  dbc.WriteFile([](void* param, const char* text) { ((std::string*)param)->append(text); }, &out);
+  CHECK(out.find("SG_ Speed : 0|16@1+ ") != std::string::npos);
+  CHECK(out.find("SG_ Torque : 23|12@0- ") != std::string::npos);
+  printf("  dbc: ok\n");
+  }
+#endif // HOSTTEST_DBC
+
+extern "C" void app_main(void)
+  {
+  MyConfig.mount();
+  MyConfig.RegisterParam("vehicle", "Vehicle", true, true);
+
+  s_can1 = new vcan("can1");
+  s_ecu = new vcan("ecu");
+  s_can1->Connect(s_ecu);
+  s_ecu->Connect(s_can1);
+  s_ecu->Start(CAN_MODE_ACTIVE, CAN_SPEED_500KBPS);
+
+  printf("Framework tests:\n");
+  test_config();
+  test_events();
+  test_metrics();
+  test_notify();
+  test_notify_spool();
+  test_log_recorder();
+  test_logfile();
+  s_can1->Start(CAN_MODE_LISTEN, CAN_SPEED_500KBPS);
+  test_can();
+  test_canreplay();
+  test_mcp2515();
+  test_poller();
+  test_obd2ecu();
+  test_bms();
+  test_vehicle_events();
+  test_gsmmux();
+  test_nmea();
+  test_ota_patch();
+  test_http();
+#ifdef HOSTTEST_DBC
+  test_dbc();
+#endif // HOSTTEST_DBC
+  printf("All tests passed.\n");
+  }
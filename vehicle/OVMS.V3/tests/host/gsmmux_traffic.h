@@ -0,0 +1,113 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host tests: GSM MUX traffic sample
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __GSMMUX_TRAFFIC_H__
+#define __GSMMUX_TRAFFIC_H__
+
+#include <stdint.h>
+
+/**
+ * GSM 07.10 MUX traffic in the form received from a SIM7600 modem on the
+ *  UART (basic option, UIH frames with P/F set): the AT+CMUX response, the
+ *  channel opening responses and UIH frames on the NMEA, data & command
+ *  channels.
+ *  The 300 byte data frame carries the byte sequence (i*7+3) & 0xff.
+ */
+
+static const uint8_t gsmmux_traffic[] =
+  {
+  // command echo & response before the MUX start
+  0x41, 0x54, 0x2b, 0x43, 0x4d, 0x55, 0x58, 0x3d, 0x30, 0x0d, 0x0d, 0x0a, 0x4f, 0x4b, 0x0d, 0x0a,
+  // UA: channel #0 open
+  0xf9, 0x03, 0x73, 0x01, 0xd7, 0xf9,
+  // UA: channel #1 open
+  0xf9, 0x07, 0x73, 0x01, 0x15, 0xf9,
+  // UA: channel #2 open
+  0xf9, 0x0b, 0x73, 0x01, 0x92, 0xf9,
+  // UA: channel #3 open
+  0xf9, 0x0f, 0x73, 0x01, 0x50, 0xf9,
+  // UA: channel #4 open
+  0xf9, 0x13, 0x73, 0x01, 0x5d, 0xf9,
+  // #4: AT response
+  0xf9, 0x11, 0xff, 0x2b, 0x0d, 0x0a, 0x2b, 0x43, 0x53, 0x51, 0x3a, 0x20, 0x31, 0x37, 0x2c, 0x39,
+  0x39, 0x0d, 0x0a, 0x0d, 0x0a, 0x4f, 0x4b, 0x0d, 0x0a, 0xde, 0xf9,
+  // #1: NMEA
+  0xf9, 0x05, 0xff, 0x8d, 0x24, 0x47, 0x50, 0x47, 0x53, 0x56, 0x2c, 0x33, 0x2c, 0x31, 0x2c, 0x31,
+  0x31, 0x2c, 0x31, 0x30, 0x2c, 0x36, 0x33, 0x2c, 0x31, 0x33, 0x37, 0x2c, 0x31, 0x37, 0x2c, 0x30,
+  0x37, 0x2c, 0x36, 0x31, 0x2c, 0x30, 0x39, 0x38, 0x2c, 0x31, 0x35, 0x2c, 0x30, 0x35, 0x2c, 0x35,
+  0x39, 0x2c, 0x32, 0x39, 0x30, 0x2c, 0x32, 0x30, 0x2c, 0x30, 0x38, 0x2c, 0x35, 0x34, 0x2c, 0x31,
+  0x35, 0x37, 0x2c, 0x33, 0x30, 0x2a, 0x37, 0x30, 0x0d, 0x0a, 0xaa, 0xf9,
+  // #1: NMEA
+  0xf9, 0x05, 0xff, 0x2c, 0x01, 0x24, 0x47, 0x4e, 0x47, 0x4e, 0x53, 0x2c, 0x31, 0x32, 0x30, 0x35,
+  0x32, 0x36, 0x2e, 0x30, 0x30, 0x2c, 0x34, 0x38, 0x30, 0x37, 0x2e, 0x30, 0x33, 0x38, 0x30, 0x30,
+  0x30, 0x2c, 0x4e, 0x2c, 0x30, 0x31, 0x31, 0x33, 0x31, 0x2e, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30,
+  0x2c, 0x45, 0x2c, 0x41, 0x41, 0x4e, 0x2c, 0x31, 0x34, 0x2c, 0x30, 0x2e, 0x38, 0x2c, 0x35, 0x34,
+  0x35, 0x2e, 0x34, 0x2c, 0x34, 0x37, 0x2e, 0x30, 0x2c, 0x2c, 0x2c, 0x56, 0x2a, 0x36, 0x32, 0x0d,
+  0x0a, 0x24, 0x47, 0x50, 0x52, 0x4d, 0x43, 0x2c, 0x31, 0x32, 0x30, 0x35, 0x32, 0x36, 0x2e, 0x30,
+  0x30, 0x2c, 0x41, 0x2c, 0x34, 0x38, 0x30, 0x37, 0x2e, 0x30, 0x33, 0x38, 0x30, 0x30, 0x30, 0x2c,
+  0x4e, 0x2c, 0x30, 0x31, 0x31, 0x33, 0x31, 0x2e, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2c, 0x45,
+  0x2c, 0x30, 0x2e, 0x30, 0x2c, 0x38, 0x34, 0x2e, 0x34, 0x2c, 0x31, 0x38, 0x31, 0x30, 0x32, 0x36,
+  0x2c, 0x2c, 0x2c, 0x41, 0x2c, 0x56, 0x2a, 0x31, 0x30, 0x0d, 0x0a, 0x7b, 0xf9,
+  // #2: PPP LCP request (payload contains 0xF9)
+  0xf9, 0x09, 0xff, 0x45, 0x7e, 0xff, 0x7d, 0x23, 0xc0, 0x21, 0x7d, 0x21, 0x7d, 0x21, 0x7d, 0x20,
+  0x7d, 0x34, 0x7d, 0x22, 0x7d, 0x26, 0x7d, 0x20, 0x7d, 0x20, 0x7d, 0x20, 0x7d, 0x20, 0x7d, 0x25,
+  0x7d, 0x26, 0xf9, 0x3a, 0x51, 0x7e, 0xb3, 0xf9,
+  // #2: PPP data, 300 bytes (two byte length field)
+  0xf9, 0x09, 0xff, 0x58, 0x02, 0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49,
+  0x50, 0x57, 0x5e, 0x65, 0x6c, 0x73, 0x7a, 0x81, 0x88, 0x8f, 0x96, 0x9d, 0xa4, 0xab, 0xb2, 0xb9,
+  0xc0, 0xc7, 0xce, 0xd5, 0xdc, 0xe3, 0xea, 0xf1, 0xf8, 0xff, 0x06, 0x0d, 0x14, 0x1b, 0x22, 0x29,
+  0x30, 0x37, 0x3e, 0x45, 0x4c, 0x53, 0x5a, 0x61, 0x68, 0x6f, 0x76, 0x7d, 0x84, 0x8b, 0x92, 0x99,
+  0xa0, 0xa7, 0xae, 0xb5, 0xbc, 0xc3, 0xca, 0xd1, 0xd8, 0xdf, 0xe6, 0xed, 0xf4, 0xfb, 0x02, 0x09,
+  0x10, 0x17, 0x1e, 0x25, 0x2c, 0x33, 0x3a, 0x41, 0x48, 0x4f, 0x56, 0x5d, 0x64, 0x6b, 0x72, 0x79,
+  0x80, 0x87, 0x8e, 0x95, 0x9c, 0xa3, 0xaa, 0xb1, 0xb8, 0xbf, 0xc6, 0xcd, 0xd4, 0xdb, 0xe2, 0xe9,
+  0xf0, 0xf7, 0xfe, 0x05, 0x0c, 0x13, 0x1a, 0x21, 0x28, 0x2f, 0x36, 0x3d, 0x44, 0x4b, 0x52, 0x59,
+  0x60, 0x67, 0x6e, 0x75, 0x7c, 0x83, 0x8a, 0x91, 0x98, 0x9f, 0xa6, 0xad, 0xb4, 0xbb, 0xc2, 0xc9,
+  0xd0, 0xd7, 0xde, 0xe5, 0xec, 0xf3, 0xfa, 0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39,
+  0x40, 0x47, 0x4e, 0x55, 0x5c, 0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2, 0xa9,
+  0xb0, 0xb7, 0xbe, 0xc5, 0xcc, 0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6, 0xfd, 0x04, 0x0b, 0x12, 0x19,
+  0x20, 0x27, 0x2e, 0x35, 0x3c, 0x43, 0x4a, 0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89,
+  0x90, 0x97, 0x9e, 0xa5, 0xac, 0xb3, 0xba, 0xc1, 0xc8, 0xcf, 0xd6, 0xdd, 0xe4, 0xeb, 0xf2, 0xf9,
+  0x00, 0x07, 0x0e, 0x15, 0x1c, 0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69,
+  0x70, 0x77, 0x7e, 0x85, 0x8c, 0x93, 0x9a, 0xa1, 0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9,
+  0xe0, 0xe7, 0xee, 0xf5, 0xfc, 0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49,
+  0x50, 0x57, 0x5e, 0x65, 0x6c, 0x73, 0x7a, 0x81, 0x88, 0x8f, 0x96, 0x9d, 0xa4, 0xab, 0xb2, 0xb9,
+  0xc0, 0xc7, 0xce, 0xd5, 0xdc, 0xe3, 0xea, 0xf1, 0xf8, 0xff, 0x06, 0x0d, 0x14, 0x1b, 0x22, 0x29,
+  0x30, 0x82, 0xf9,
+  // #4: unsolicited result
+  0xf9, 0x11, 0xff, 0x19, 0x0d, 0x0a, 0x2b, 0x43, 0x52, 0x45, 0x47, 0x3a, 0x20, 0x31, 0x0d, 0x0a,
+  0x19, 0xf9,
+  };
+
+// Channel payload contained in the sample:
+#define GSMMUX_TRAFFIC_FRAMES     11
+#define GSMMUX_TRAFFIC_NMEA       \
+  "$GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30*70\r\n" \
+  "$GNGNS,120526.00,4807.038000,N,01131.000000,E,AAN,14,0.8,545.4,47.0,,,V*62\r\n" \
+  "$GPRMC,120526.00,A,4807.038000,N,01131.000000,E,0.0,84.4,181026,,,A,V*10\r\n"
+#define GSMMUX_TRAFFIC_CMD        "\r\n+CSQ: 17,99\r\n\r\nOK\r\n\r\n+CREG: 1\r\n"
+#define GSMMUX_TRAFFIC_DATASIZE   334     // 34 bytes LCP + 300 bytes sequence
+
+#endif //#ifndef __GSMMUX_TRAFFIC_H__
@@ -0,0 +1,87 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host tests: check & benchmark helpers
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __HOSTTEST_H__
+#define __HOSTTEST_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * Minimal check & benchmark helpers for the host tests (tests/host).
+ *  CHECK() aborts the test program with a message on failure, so a test
+ *  passes if it runs to the end (exit code 0). Like the normal exit (see
+ *  shim/main.cpp), a failure exits without running static destructors, as
+ *  framework tasks may still be active.
+ */
+
+#define CHECK_FAIL(...) \
+  do { fprintf(stderr, __VA_ARGS__); fflush(stdout); _exit(1); } while (0)
+
+#define CHECK(cond) \
+  do { if (!(cond)) CHECK_FAIL("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); } while (0)
+
+#define CHECK_EQ(a, b) \
+  do { if (!((a) == (b))) CHECK_FAIL("%s:%d: CHECK failed: %s == %s\n", __FILE__, __LINE__, #a, #b); } while (0)
+
+inline double hosttest_now()
+  {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+  }
+
+// Wait for a condition set by another task, returns false on timeout:
+template <typename Pred> inline bool hosttest_wait(Pred pred, double timeout=5.0)
+  {
+  double end = hosttest_now() + timeout;
+  while (!pred())
+    {
+    if (hosttest_now() > end) return false;
+    usleep(100);
+    }
+  return true;
+  }
+
+// BENCH(name, count, code): run code count times, print the time per iteration
+#define BENCH(name, count, code) \
+  do { \
+    double _start = hosttest_now(); \
+    for (long _i = 0; _i < (long)(count); _i++) { code; } \
+    double _time = hosttest_now() - _start; \
+    printf("  %-40s %10.1f ns/op\n", name, _time * 1e9 / (count)); \
+  } while (0)
+
+// Keep the compiler from optimizing benchmark results away:
+template <typename T> inline void hosttest_use(const T& value)
+  {
+  asm volatile("" : : "g"(&value) : "memory");
+  }
+
+#endif //#ifndef __HOSTTEST_H__
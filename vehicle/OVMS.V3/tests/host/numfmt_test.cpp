@@ -0,0 +1,211 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host tests: number formatting
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <math.h>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include "hosttest.h"
+#include "ovms_numfmt.h"
+
+/**
+ * Equivalence tests of the number formatters & parsers against printf /
+ * strtod, and benchmarks against printf and std::ostringstream.
+ */
+
+static std::mt19937_64 s_rng(4711);
+static long s_checked = 0;
+
+static void check_fixed(double value, int precision)
+  {
+  char buf[NUMFMT_BUFSIZE], ref[NUMFMT_BUFSIZE];
+  char* end = num_format_fixed(buf, value, precision);
+  snprintf(ref, sizeof(ref), "%.*f", precision, value);
+  if (strcmp(buf, ref) != 0)
+    {
+    fprintf(stderr, "num_format_fixed(%.17g, %d): '%s' != '%s'\n", value, precision, buf, ref);
+    exit(1);
+    }
+  CHECK_EQ(end, buf + strlen(buf));
+  s_checked++;
+  }
+
+static void check_general(double value, int digits)
+  {
+  char buf[NUMFMT_BUFSIZE], ref[NUMFMT_BUFSIZE];
+  char* end = num_format_general(buf, value, digits);
+  snprintf(ref, sizeof(ref), "%.*g", digits, value);
+  if (strcmp(buf, ref) != 0)
+    {
+    fprintf(stderr, "num_format_general(%.17g, %d): '%s' != '%s'\n", value, digits, buf, ref);
+    exit(1);
+    }
+  CHECK_EQ(end, buf + strlen(buf));
+  s_checked++;
+  }
+
+static void check_shortest(float value)
+  {
+  char buf[NUMFMT_BUFSIZE];
+  num_format_shortest(buf, value);
+  float check = strtof(buf, NULL);
+  if (check != value)
+    {
+    fprintf(stderr, "num_format_shortest(%.9g): '%s' does not parse back\n", value, buf);
+    exit(1);
+    }
+  s_checked++;
+  }
+
+static void check_parse(const char* str)
+  {
+  double value;
+  char* refend;
+  double ref = strtod(str, &refend);
+  const char* end = num_parse_double(str, &value);
+  if (value != ref || end != refend)
+    {
+    fprintf(stderr, "num_parse_double('%s'): %.17g != %.17g\n", str, value, ref);
+    exit(1);
+    }
+  s_checked++;
+  }
+
+static void test_known()
+  {
+  char buf[NUMFMT_BUFSIZE];
+  num_format_fixed(buf, 874.105, 2);      // 874.10500000000001818…
+  CHECK(strcmp(buf, "874.11") == 0);
+  num_format_fixed(buf, 1.005, 2);        // 1.00499999999999989…
+  CHECK(strcmp(buf, "1.00") == 0);
+  num_format_fixed(buf, 0.125, 2);        // exact tie: half to even
+  CHECK(strcmp(buf, "0.12") == 0);
+  num_format_fixed(buf, 2.5, 0);
+  CHECK(strcmp(buf, "2") == 0);
+  num_format_fixed(buf, -0.001, 2);
+  CHECK(strcmp(buf, "-0.00") == 0);
+  num_format_general(buf, 874.105, 5);
+  CHECK(strcmp(buf, "874.11") == 0);
+  num_format_scaled(buf, 12345, 3);
+  CHECK(strcmp(buf, "12.345") == 0);
+  num_format_scaled(buf, -12345, 3, 1);
+  CHECK(strcmp(buf, "-12.3") == 0);
+  num_format_scaled(buf, 1200, 3, 5);
+  CHECK(strcmp(buf, "1.20000") == 0);
+  }
+
+static void test_equivalence(int count)
+  {
+  std::uniform_real_distribution<double> mant(1.0, 10.0);
+  std::uniform_int_distribution<int> exp10(-6, 9);
+  std::uniform_int_distribution<int> prec(0, 6);
+  std::uniform_int_distribution<int> digits(1, 17);
+  std::uniform_int_distribution<int64_t> decimal(0, 99999999);
+  char str[NUMFMT_BUFSIZE];
+
+  for (int i = 0; i < count; i++)
+    {
+    // random magnitudes, as double and as float (metric values are floats):
+    double d = mant(s_rng) * pow(10, exp10(s_rng)) * ((i & 1) ? -1 : 1);
+    float f = (float) d;
+    check_fixed(d, prec(s_rng));
+    check_fixed(f, prec(s_rng));
+    check_general(d, digits(s_rng));
+    check_general(f, 1 + i % 9);
+    check_shortest(f);
+
+    // decimal ties (…5 at precision+1), the double rounding case:
+    int p = prec(s_rng);
+    int64_t k = decimal(s_rng) * 10 + 5;
+    double tie = (double) k / pow(10, p+1);
+    check_fixed(tie, p);
+    check_fixed((float) tie, p);
+    check_general(tie, 1 + i % 9);
+
+    // parser: formatted decimals & exponents
+    snprintf(str, sizeof(str), "%.*f", p, d);
+    check_parse(str);
+    snprintf(str, sizeof(str), "%.*e", p, d);
+    check_parse(str);
+    }
+
+  // small integers & their halves:
+  for (int i = -2000; i <= 2000; i++)
+    {
+    for (int p = 0; p < 4; p++)
+      {
+      check_fixed(i / 2.0, p);
+      check_fixed(i / 8.0, p);
+      check_general(i / 2.0, p+1);
+      }
+    check_shortest(i / 10.0f);
+    }
+  }
+
+static void bench()
+  {
+  const int count = 200000;
+  std::vector<float> values(count);
+  std::uniform_real_distribution<float> dist(-1000, 1000);
+  for (auto& v : values) v = dist(s_rng);
+  char buf[NUMFMT_BUFSIZE];
+  std::ostringstream ss;
+
+  printf("Benchmark (%d floats):\n", count);
+  BENCH("fixed 2: num_format_fixed", count, { num_format_fixed(buf, values[_i], 2); hosttest_use(buf); });
+  BENCH("fixed 2: snprintf", count, { snprintf(buf, sizeof(buf), "%.2f", values[_i]); hosttest_use(buf); });
+  BENCH("fixed 2: ostringstream", count,
+    { ss.str(""); ss << std::fixed << std::setprecision(2) << values[_i]; hosttest_use(ss); });
+  BENCH("general 6: num_format_general", count, { num_format_general(buf, values[_i]); hosttest_use(buf); });
+  BENCH("general 6: snprintf", count, { snprintf(buf, sizeof(buf), "%g", values[_i]); hosttest_use(buf); });
+  BENCH("general 6: ostringstream", count,
+    { std::ostringstream os; os << values[_i]; hosttest_use(os); });
+  BENCH("shortest: num_format_shortest", count, { num_format_shortest(buf, values[_i]); hosttest_use(buf); });
+
+  std::vector<std::string> strings(count);
+  for (int i = 0; i < count; i++)
+    {
+    num_format_fixed(buf, values[i], 3);
+    strings[i] = buf;
+    }
+  double d;
+  BENCH("parse: num_parse_double", count, { num_parse_double(strings[_i].c_str(), &d); hosttest_use(d); });
+  BENCH("parse: strtod", count, { d = strtod(strings[_i].c_str(), NULL); hosttest_use(d); });
+  BENCH("parse: istringstream", count,
+    { std::istringstream is(strings[_i]); is >> d; hosttest_use(d); });
+  }
+
+int main(int argc, char* argv[])
+  {
+  printf("numfmt:\n");
+  test_known();
+  test_equivalence(100000);
+  printf("  %ld conversions checked against printf/strtod\n", s_checked);
+  bench();
+  printf("numfmt: OK\n");
+  return 0;
+  }
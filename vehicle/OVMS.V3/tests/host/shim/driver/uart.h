@@ -0,0 +1,117 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: ESP-IDF UART driver
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_DRIVER_UART_H__
+#define __SHIM_DRIVER_UART_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+/**
+ * The host UART has no receiver: uart_read_bytes() returns no data, the
+ *  tests feed the modem data to the MUX directly. Data written is kept per
+ *  port for the test to fetch with uart_host_get_tx().
+ */
+
+typedef int uart_port_t;
+
+typedef enum
+  {
+  UART_DATA,
+  UART_BREAK,
+  UART_BUFFER_FULL,
+  UART_FIFO_OVF,
+  UART_FRAME_ERR,
+  UART_PARITY_ERR,
+  UART_DATA_BREAK,
+  UART_PATTERN_DET,
+  UART_EVENT_MAX
+  } uart_event_type_t;
+
+typedef struct
+  {
+  uart_event_type_t type;
+  size_t size;
+  } uart_event_t;
+
+typedef enum
+  {
+  UART_DATA_5_BITS = 0,
+  UART_DATA_6_BITS = 1,
+  UART_DATA_7_BITS = 2,
+  UART_DATA_8_BITS = 3
+  } uart_word_length_t;
+
+typedef enum
+  {
+  UART_PARITY_DISABLE = 0,
+  UART_PARITY_EVEN = 2,
+  UART_PARITY_ODD = 3
+  } uart_parity_t;
+
+typedef enum
+  {
+  UART_STOP_BITS_1 = 1,
+  UART_STOP_BITS_1_5 = 2,
+  UART_STOP_BITS_2 = 3
+  } uart_stop_bits_t;
+
+typedef enum
+  {
+  UART_HW_FLOWCTRL_DISABLE = 0,
+  UART_HW_FLOWCTRL_RTS = 1,
+  UART_HW_FLOWCTRL_CTS = 2,
+  UART_HW_FLOWCTRL_CTS_RTS = 3
+  } uart_hw_flowcontrol_t;
+
+typedef struct
+  {
+  int baud_rate;
+  uart_word_length_t data_bits;
+  uart_parity_t parity;
+  uart_stop_bits_t stop_bits;
+  uart_hw_flowcontrol_t flow_ctrl;
+  uint8_t rx_flow_ctrl_thresh;
+  bool use_ref_tick;
+  } uart_config_t;
+
+esp_err_t uart_param_config(uart_port_t uart_num, const uart_config_t* uart_config);
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size,
+  int queue_size, QueueHandle_t* uart_queue, int intr_alloc_flags);
+esp_err_t uart_driver_delete(uart_port_t uart_num);
+esp_err_t uart_set_pin(uart_port_t uart_num, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num);
+int uart_read_bytes(uart_port_t uart_num, uint8_t* buf, uint32_t length, TickType_t ticks_to_wait);
+int uart_write_bytes(uart_port_t uart_num, const char* src, size_t size);
+esp_err_t uart_flush(uart_port_t uart_num);
+esp_err_t uart_get_buffered_data_len(uart_port_t uart_num, size_t* size);
+
+// Host: fetch (and remove) up to <size> bytes written to the port
+size_t uart_host_get_tx(uart_port_t uart_num, uint8_t* buf, size_t size);
+
+#endif //#ifndef __SHIM_DRIVER_UART_H__
@@ -0,0 +1,501 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: ESP-IDF system services
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp_ota_ops.h"
+#include "driver/gpio.h"
+#include "driver/uart.h"
+#include "spi_master_nodma.h"
+#include "rom/rtc.h"
+#include "rom/ets_sys.h"
+#include "lwip/pppapi.h"
+
+static int64_t shim_monotonic_us()
+  {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+  }
+
+int64_t esp_timer_get_time(void)
+  {
+  // Note: function static, static constructors may call this before main()
+  static const int64_t start = shim_monotonic_us();
+  return shim_monotonic_us() - start;
+  }
+
+
+/***************************************************************************
+ * Logging
+ */
+
+static int s_log_level = -1;
+static vprintf_like_t s_log_vprintf = NULL;
+static pthread_mutex_t s_log_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int shim_log_vprintf(const char* fmt, va_list args)
+  {
+  return vfprintf(stderr, fmt, args);
+  }
+
+void esp_log_level_set(const char* tag, esp_log_level_t level)
+  {
+  // Only the global level is supported on the host:
+  if (strcmp(tag, "*") == 0)
+    s_log_level = level;
+  }
+
+vprintf_like_t esp_log_set_vprintf(vprintf_like_t func)
+  {
+  pthread_mutex_lock(&s_log_mutex);
+  vprintf_like_t prev = s_log_vprintf ? s_log_vprintf : shim_log_vprintf;
+  s_log_vprintf = func;
+  pthread_mutex_unlock(&s_log_mutex);
+  return prev;
+  }
+
+uint32_t esp_log_timestamp(void)
+  {
+  return esp_timer_get_time() / 1000;
+  }
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...)
+  {
+  if (s_log_level < 0)
+    {
+    const char* env = getenv("OVMS_LOG_LEVEL");
+    s_log_level = env ? atoi(env) : ESP_LOG_WARN;
+    }
+  if (level > s_log_level)
+    return;
+  va_list args;
+  va_start(args, format);
+  pthread_mutex_lock(&s_log_mutex);
+  vprintf_like_t func = s_log_vprintf ? s_log_vprintf : shim_log_vprintf;
+  pthread_mutex_unlock(&s_log_mutex);
+  func(format, args);
+  va_end(args);
+  }
+
+
+/***************************************************************************
+ * System
+ */
+
+uint32_t esp_random(void)
+  {
+  static bool seeded = false;
+  if (!seeded)
+    {
+    srandom(time(NULL));
+    seeded = true;
+    }
+  return (uint32_t)random() ^ ((uint32_t)random() << 16);
+  }
+
+void esp_restart(void)
+  {
+  fprintf(stderr, "esp_restart() called, exiting\n");
+  exit(1);
+  }
+
+uint32_t esp_get_free_heap_size(void)
+  {
+  return 0;
+  }
+
+esp_err_t esp_efuse_mac_get_default(uint8_t* mac)
+  {
+  static const uint8_t host_mac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+  memcpy(mac, host_mac, 6);
+  return ESP_OK;
+  }
+
+RESET_REASON rtc_get_reset_reason(int cpu_no)
+  {
+  return POWERON_RESET;
+  }
+
+void ets_delay_us(uint32_t us)
+  {
+  usleep(us);
+  }
+
+
+/***************************************************************************
+ * GPIO
+ */
+
+typedef struct
+  {
+  int level;
+  gpio_int_type_t intr_type;
+  gpio_isr_t isr;
+  void* arg;
+  } shim_gpio_t;
+
+static std::map<gpio_num_t, shim_gpio_t> s_gpio;
+static pthread_mutex_t s_gpio_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static shim_gpio_t& shim_gpio(gpio_num_t gpio_num)
+  {
+  auto k = s_gpio.find(gpio_num);
+  if (k == s_gpio.end())
+    k = s_gpio.insert(std::make_pair(gpio_num, shim_gpio_t { 1, GPIO_INTR_DISABLE, NULL, NULL })).first;
+  return k->second;
+  }
+
+int gpio_get_level(gpio_num_t gpio_num)
+  {
+  pthread_mutex_lock(&s_gpio_mutex);
+  int level = shim_gpio(gpio_num).level;
+  pthread_mutex_unlock(&s_gpio_mutex);
+  return level;
+  }
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type)
+  {
+  pthread_mutex_lock(&s_gpio_mutex);
+  shim_gpio(gpio_num).intr_type = intr_type;
+  pthread_mutex_unlock(&s_gpio_mutex);
+  return ESP_OK;
+  }
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void* args)
+  {
+  pthread_mutex_lock(&s_gpio_mutex);
+  shim_gpio(gpio_num).isr = isr_handler;
+  shim_gpio(gpio_num).arg = args;
+  pthread_mutex_unlock(&s_gpio_mutex);
+  return ESP_OK;
+  }
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+  {
+  return gpio_isr_handler_add(gpio_num, NULL, NULL);
+  }
+
+void gpio_host_set_level(gpio_num_t gpio_num, int level)
+  {
+  pthread_mutex_lock(&s_gpio_mutex);
+  shim_gpio_t& gpio = shim_gpio(gpio_num);
+  bool raise = false;
+  switch (gpio.intr_type)
+    {
+    case GPIO_INTR_POSEDGE:     raise = (!gpio.level && level); break;
+    case GPIO_INTR_NEGEDGE:     raise = (gpio.level && !level); break;
+    case GPIO_INTR_ANYEDGE:     raise = (gpio.level != level); break;
+    case GPIO_INTR_LOW_LEVEL:   raise = !level; break;
+    case GPIO_INTR_HIGH_LEVEL:  raise = level; break;
+    default:                    break;
+    }
+  gpio.level = level;
+  gpio_isr_t isr = gpio.isr;
+  void* arg = gpio.arg;
+  pthread_mutex_unlock(&s_gpio_mutex);
+  if (raise && isr)
+    isr(arg);
+  }
+
+
+/***************************************************************************
+ * SPI (spinodma driver)
+ */
+
+static std::map<int, spi_nodma_device_t*> s_spi_devices;
+
+void spi_nodma_host_attach(int cspin, spi_nodma_device_t* device)
+  {
+  if (device)
+    s_spi_devices[cspin] = device;
+  else
+    s_spi_devices.erase(cspin);
+  }
+
+esp_err_t spi_nodma_bus_add_device(spi_nodma_host_device_t host, spi_nodma_bus_config_t* bus_config,
+                                   spi_nodma_device_interface_config_t* dev_config, spi_nodma_device_handle_t* handle)
+  {
+  auto k = s_spi_devices.find(dev_config->spics_io_num);
+  if (k == s_spi_devices.end())
+    return ESP_ERR_NOT_FOUND;
+  *handle = k->second;
+  return ESP_OK;
+  }
+
+esp_err_t spi_nodma_device_transmit(spi_nodma_device_handle_t handle, spi_nodma_transaction_t* trans_desc, TickType_t ticks_to_wait)
+  {
+  // spi::spi_cmd() transmits & receives in the same buffer:
+  if (!handle || trans_desc->tx_buffer != trans_desc->rx_buffer)
+    return ESP_ERR_INVALID_ARG;
+  int rxlen = trans_desc->rxlength / 8;
+  int txlen = trans_desc->length / 8 - rxlen;
+  handle->Transfer((uint8_t*) trans_desc->rx_buffer, txlen, rxlen);
+  return ESP_OK;
+  }
+
+
+/***************************************************************************
+ * Flash partitions & OTA
+ */
+
+static std::vector<uint8_t> s_flash;
+static std::map<esp_ota_handle_t, std::pair<const esp_partition_t*, size_t>> s_ota;
+static esp_ota_handle_t s_ota_next = 1;
+
+static uint8_t* shim_flash(const esp_partition_t* partition, size_t offset)
+  {
+  if (s_flash.size() < partition->address + partition->size)
+    s_flash.resize(partition->address + partition->size, 0xff);
+  return &s_flash[partition->address + offset];
+  }
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size)
+  {
+  if (src_offset > partition->size || size > partition->size - src_offset)
+    return ESP_ERR_INVALID_SIZE;
+  memcpy(dst, shim_flash(partition, src_offset), size);
+  return ESP_OK;
+  }
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset, const void* src, size_t size)
+  {
+  if (dst_offset > partition->size || size > partition->size - dst_offset)
+    return ESP_ERR_INVALID_SIZE;
+  uint8_t* flash = shim_flash(partition, dst_offset);
+  for (size_t i = 0; i < size; i++)
+    flash[i] &= ((const uint8_t*)src)[i]; // NOR flash: bits can only be cleared
+  return ESP_OK;
+  }
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, uint32_t start_addr, uint32_t size)
+  {
+  if (start_addr > partition->size || size > partition->size - start_addr)
+    return ESP_ERR_INVALID_SIZE;
+  if (start_addr % SPI_FLASH_SEC_SIZE || size % SPI_FLASH_SEC_SIZE)
+    return ESP_ERR_INVALID_ARG;
+  memset(shim_flash(partition, start_addr), 0xff, size);
+  return ESP_OK;
+  }
+
+esp_err_t esp_ota_begin(const esp_partition_t* partition, size_t image_size, esp_ota_handle_t* out_handle)
+  {
+  esp_err_t err = (image_size == OTA_SIZE_UNKNOWN)
+    ? esp_partition_erase_range(partition, 0, partition->size)
+    : esp_partition_erase_range(partition, 0, (image_size / SPI_FLASH_SEC_SIZE + 1) * SPI_FLASH_SEC_SIZE);
+  if (err != ESP_OK)
+    return err;
+  *out_handle = s_ota_next++;
+  s_ota[*out_handle] = std::make_pair(partition, (size_t)0);
+  return ESP_OK;
+  }
+
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void* data, size_t size)
+  {
+  auto k = s_ota.find(handle);
+  if (k == s_ota.end())
+    return ESP_ERR_INVALID_ARG;
+  esp_err_t err = esp_partition_write(k->second.first, k->second.second, data, size);
+  if (err == ESP_OK)
+    k->second.second += size;
+  return err;
+  }
+
+esp_err_t esp_ota_end(esp_ota_handle_t handle)
+  {
+  return s_ota.erase(handle) ? ESP_OK : ESP_ERR_NOT_FOUND;
+  }
+
+
+/***************************************************************************
+ * UART
+ */
+
+typedef struct
+  {
+  QueueHandle_t queue;
+  std::string tx;
+  } shim_uart_t;
+
+static std::map<uart_port_t, shim_uart_t> s_uart;
+static pthread_mutex_t s_uart_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+esp_err_t uart_param_config(uart_port_t uart_num, const uart_config_t* uart_config)
+  {
+  return ESP_OK;
+  }
+
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size,
+  int queue_size, QueueHandle_t* uart_queue, int intr_alloc_flags)
+  {
+  pthread_mutex_lock(&s_uart_mutex);
+  shim_uart_t& uart = s_uart[uart_num];
+  if (!uart.queue)
+    uart.queue = xQueueCreate(queue_size, sizeof(uart_event_t));
+  if (uart_queue)
+    *uart_queue = uart.queue;
+  pthread_mutex_unlock(&s_uart_mutex);
+  return ESP_OK;
+  }
+
+esp_err_t uart_driver_delete(uart_port_t uart_num)
+  {
+  pthread_mutex_lock(&s_uart_mutex);
+  auto k = s_uart.find(uart_num);
+  if (k != s_uart.end())
+    {
+    vQueueDelete(k->second.queue);
+    s_uart.erase(k);
+    }
+  pthread_mutex_unlock(&s_uart_mutex);
+  return ESP_OK;
+  }
+
+esp_err_t uart_set_pin(uart_port_t uart_num, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num)
+  {
+  return ESP_OK;
+  }
+
+int uart_read_bytes(uart_port_t uart_num, uint8_t* buf, uint32_t length, TickType_t ticks_to_wait)
+  {
+  return 0;
+  }
+
+int uart_write_bytes(uart_port_t uart_num, const char* src, size_t size)
+  {
+  pthread_mutex_lock(&s_uart_mutex);
+  s_uart[uart_num].tx.append(src, size);
+  pthread_mutex_unlock(&s_uart_mutex);
+  return size;
+  }
+
+esp_err_t uart_flush(uart_port_t uart_num)
+  {
+  return ESP_OK;
+  }
+
+esp_err_t uart_get_buffered_data_len(uart_port_t uart_num, size_t* size)
+  {
+  *size = 0;
+  return ESP_OK;
+  }
+
+size_t uart_host_get_tx(uart_port_t uart_num, uint8_t* buf, size_t size)
+  {
+  pthread_mutex_lock(&s_uart_mutex);
+  std::string& tx = s_uart[uart_num].tx;
+  size = std::min(size, tx.size());
+  memcpy(buf, tx.data(), size);
+  tx.erase(0, size);
+  pthread_mutex_unlock(&s_uart_mutex);
+  return size;
+  }
+
+
+/***************************************************************************
+ * PPP (lwIP)
+ */
+
+char* ipaddr_ntoa(const ip_addr_t* addr)
+  {
+  static char buf[16];
+  const u8_t* a = (const u8_t*)&addr->addr;
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", a[0], a[1], a[2], a[3]);
+  return buf;
+  }
+
+ppp_pcb* pppapi_pppos_create(struct netif* pppif, pppos_output_cb_fn output_cb,
+  ppp_link_status_cb_fn link_status_cb, void* ctx_cb)
+  {
+  ppp_pcb* pcb = (ppp_pcb*)calloc(1, sizeof(ppp_pcb));
+  pcb->netif = pppif;
+  pcb->output_cb = output_cb;
+  pcb->link_status_cb = link_status_cb;
+  pcb->ctx_cb = ctx_cb;
+  return pcb;
+  }
+
+err_t pppapi_set_default(ppp_pcb* pcb)
+  {
+  return 0;
+  }
+
+void pppapi_set_auth(ppp_pcb* pcb, u8_t authtype, const char* user, const char* passwd)
+  {
+  }
+
+err_t ppp_connect(ppp_pcb* pcb, u16_t holdoff)
+  {
+  return 0;
+  }
+
+err_t pppapi_connect(ppp_pcb* pcb, u16_t holdoff)
+  {
+  return 0;
+  }
+
+err_t pppapi_close(ppp_pcb* pcb, u8_t nocarrier)
+  {
+  return 0;
+  }
+
+err_t pppapi_free(ppp_pcb* pcb)
+  {
+  free(pcb->input);
+  free(pcb);
+  return 0;
+  }
+
+err_t pppos_input_tcpip(ppp_pcb* ppp, u8_t* s, int l)
+  {
+  ppp->input = (u8_t*)realloc(ppp->input, ppp->inputlen + l);
+  memcpy(ppp->input + ppp->inputlen, s, l);
+  ppp->inputlen += l;
+  ppp->inputcalls++;
+  return 0;
+  }
+
+unsigned int pppos_host_take_input(ppp_pcb* ppp, u8_t** data, size_t* len)
+  {
+  unsigned int calls = ppp->inputcalls;
+  *data = ppp->input;
+  *len = ppp->inputlen;
+  ppp->input = NULL;
+  ppp->inputlen = 0;
+  ppp->inputcalls = 0;
+  return calls;
+  }
@@ -0,0 +1,73 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: ESP-IDF system events
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_ESP_EVENT_H__
+#define __SHIM_ESP_EVENT_H__
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum
+  {
+  SYSTEM_EVENT_WIFI_READY = 0,
+  SYSTEM_EVENT_SCAN_DONE,
+  SYSTEM_EVENT_STA_START,
+  SYSTEM_EVENT_STA_STOP,
+  SYSTEM_EVENT_STA_CONNECTED,
+  SYSTEM_EVENT_STA_DISCONNECTED,
+  SYSTEM_EVENT_STA_AUTHMODE_CHANGE,
+  SYSTEM_EVENT_STA_GOT_IP,
+  SYSTEM_EVENT_STA_LOST_IP,
+  SYSTEM_EVENT_STA_WPS_ER_SUCCESS,
+  SYSTEM_EVENT_STA_WPS_ER_FAILED,
+  SYSTEM_EVENT_STA_WPS_ER_TIMEOUT,
+  SYSTEM_EVENT_STA_WPS_ER_PIN,
+  SYSTEM_EVENT_AP_START,
+  SYSTEM_EVENT_AP_STOP,
+  SYSTEM_EVENT_AP_STACONNECTED,
+  SYSTEM_EVENT_AP_STADISCONNECTED,
+  SYSTEM_EVENT_AP_PROBEREQRECVED,
+  SYSTEM_EVENT_AP_STA_GOT_IP6,
+  SYSTEM_EVENT_ETH_START,
+  SYSTEM_EVENT_ETH_STOP,
+  SYSTEM_EVENT_ETH_CONNECTED,
+  SYSTEM_EVENT_ETH_DISCONNECTED,
+  SYSTEM_EVENT_ETH_GOT_IP,
+  SYSTEM_EVENT_MAX
+  } system_event_id_t;
+
+typedef union
+  {
+  uint8_t dummy;
+  } system_event_info_t;
+
+typedef struct
+  {
+  system_event_id_t event_id;
+  system_event_info_t event_info;
+  } system_event_t;
+
+#endif //#ifndef __SHIM_ESP_EVENT_H__
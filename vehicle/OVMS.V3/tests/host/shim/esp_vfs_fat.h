@@ -0,0 +1,56 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: ESP-IDF FAT file system
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_ESP_VFS_FAT_H__
+#define __SHIM_ESP_VFS_FAT_H__
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "wear_levelling.h"
+
+typedef struct
+  {
+  bool format_if_mount_failed;
+  int max_files;
+  size_t allocation_unit_size;
+  } esp_vfs_fat_mount_config_t;
+
+typedef esp_vfs_fat_mount_config_t esp_vfs_fat_sdmmc_mount_config_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Host: the partition is a directory below the VFS root, see vfs.cpp
+esp_err_t esp_vfs_fat_spiflash_mount(const char* base_path, const char* partition_label,
+  const esp_vfs_fat_mount_config_t* mount_config, wl_handle_t* wl_handle);
+esp_err_t esp_vfs_fat_spiflash_unmount(const char* base_path, wl_handle_t wl_handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //#ifndef __SHIM_ESP_VFS_FAT_H__
@@ -0,0 +1,797 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: FreeRTOS on POSIX threads
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string>
+#include <list>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+#include "esp_timer.h"
+
+/**
+ * Tasks are detached pthreads. As on the ESP32, tasks created by static
+ *  constructors only start running when the scheduler is started (see
+ *  main.cpp), so all framework singletons are constructed by then. Blocking waits use CLOCK_MONOTONIC
+ *  condition variables and are cancellation points, so a task blocked
+ *  in a queue or notification wait can be deleted by another task
+ *  (vTaskDelete(other) => pthread_cancel()).
+ */
+
+struct shim_task
+  {
+  pthread_t thread;
+  std::string name;
+  TaskFunction_t fn;
+  void* param;
+  uint32_t stack;
+  UBaseType_t priority;
+  BaseType_t core;
+  UBaseType_t number;
+  bool is_thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  uint32_t notify;
+  bool terminated;
+  };
+
+static pthread_mutex_t s_tasks_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Note: shim objects are constructed before the framework singletons
+static std::list<shim_task*> s_tasks __attribute__ ((init_priority (101)));
+static UBaseType_t s_task_number = 0;
+static thread_local shim_task* s_current = NULL;
+static shim_task* s_idle[portNUM_PROCESSORS] = { NULL, NULL };
+static pthread_mutex_t s_critical;
+static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t s_scheduler_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_scheduler_cond = PTHREAD_COND_INITIALIZER;
+static bool s_scheduler_running = false;
+
+static void shim_cond_init(pthread_cond_t* cond)
+  {
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(cond, &attr);
+  pthread_condattr_destroy(&attr);
+  }
+
+static void shim_init()
+  {
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&s_critical, &attr);
+  pthread_mutexattr_destroy(&attr);
+  }
+
+static shim_task* shim_task_new(const char* name, TaskFunction_t fn, void* param,
+  uint32_t stack, UBaseType_t priority, BaseType_t core, bool is_thread)
+  {
+  shim_task* task = new shim_task;
+  task->name = name;
+  task->fn = fn;
+  task->param = param;
+  task->stack = stack;
+  task->priority = priority;
+  task->core = core;
+  task->is_thread = is_thread;
+  pthread_mutex_init(&task->mutex, NULL);
+  shim_cond_init(&task->cond);
+  task->notify = 0;
+  task->terminated = false;
+  pthread_mutex_lock(&s_tasks_mutex);
+  task->number = ++s_task_number;
+  s_tasks.push_back(task);
+  pthread_mutex_unlock(&s_tasks_mutex);
+  return task;
+  }
+
+static void shim_task_remove(shim_task* task)
+  {
+  pthread_mutex_lock(&s_tasks_mutex);
+  s_tasks.remove(task);
+  pthread_mutex_unlock(&s_tasks_mutex);
+  // Note: the task struct is not freed, handles may still be in use
+  //  by other tasks (as on FreeRTOS, where the TCB is freed by the idle task).
+  }
+
+static void shim_task_cleanup(void* arg)
+  {
+  shim_task* task = (shim_task*)arg;
+  shim_task_remove(task);
+  pthread_mutex_lock(&task->mutex);
+  task->terminated = true;
+  pthread_cond_broadcast(&task->cond);
+  pthread_mutex_unlock(&task->mutex);
+  }
+
+static void* shim_task_main(void* arg)
+  {
+  shim_task* task = (shim_task*)arg;
+  s_current = task;
+  pthread_mutex_lock(&s_scheduler_mutex);
+  while (!s_scheduler_running)
+    pthread_cond_wait(&s_scheduler_cond, &s_scheduler_mutex);
+  pthread_mutex_unlock(&s_scheduler_mutex);
+  pthread_cleanup_push(shim_task_cleanup, task);
+  pthread_testcancel();   // deleted before it ran
+  task->fn(task->param);
+  pthread_cleanup_pop(1);
+  return NULL;
+  }
+
+static struct timespec shim_deadline(TickType_t ticks)
+  {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t ns = (uint64_t)ts.tv_nsec + (uint64_t)ticks * (1000000000ULL / configTICK_RATE_HZ);
+  ts.tv_sec += ns / 1000000000ULL;
+  ts.tv_nsec = ns % 1000000000ULL;
+  return ts;
+  }
+
+static void shim_unlock_mutex(void* mutex)
+  {
+  pthread_mutex_unlock((pthread_mutex_t*)mutex);
+  }
+
+// Wait on cond while pred() is false, returns the final pred() result:
+template <typename Pred>
+static bool shim_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, TickType_t ticks, Pred pred)
+  {
+  if (pred()) return true;
+  if (ticks == 0) return false;
+  bool forever = (ticks == portMAX_DELAY);
+  struct timespec deadline;
+  if (!forever) deadline = shim_deadline(ticks);
+  bool res;
+  pthread_cleanup_push(shim_unlock_mutex, mutex);
+  while (!(res = pred()))
+    {
+    if (forever)
+      pthread_cond_wait(cond, mutex);
+    else if (pthread_cond_timedwait(cond, mutex, &deadline) == ETIMEDOUT)
+      {
+      res = pred();
+      break;
+      }
+    }
+  pthread_cleanup_pop(0);
+  return res;
+  }
+
+
+/***************************************************************************
+ * Critical sections & memory
+ */
+
+void vPortCPUInitializeMutex(portMUX_TYPE* mux)
+  {
+  }
+
+void vPortEnterCritical(portMUX_TYPE* mux)
+  {
+  pthread_once(&s_once, shim_init);
+  pthread_mutex_lock(&s_critical);
+  }
+
+void vPortExitCritical(portMUX_TYPE* mux)
+  {
+  pthread_mutex_unlock(&s_critical);
+  }
+
+void* pvPortMalloc(size_t size)
+  {
+  return malloc(size);
+  }
+
+void vPortFree(void* ptr)
+  {
+  free(ptr);
+  }
+
+
+/***************************************************************************
+ * Tasks
+ */
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack,
+  void* param, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core)
+  {
+  shim_task* task = shim_task_new(name, fn, param, stack, priority, core, true);
+  if (handle) *handle = task;
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  // Host stacks need more room than the ESP32 stacks (64 bit, no optimization):
+  pthread_attr_setstacksize(&attr, 256*1024 + stack*4);
+  int err = pthread_create(&task->thread, &attr, shim_task_main, task);
+  pthread_attr_destroy(&attr);
+  if (err)
+    {
+    shim_task_remove(task);
+    if (handle) *handle = NULL;
+    return pdFAIL;
+    }
+  return pdPASS;
+  }
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack,
+  void* param, UBaseType_t priority, TaskHandle_t* handle)
+  {
+  return xTaskCreatePinnedToCore(fn, name, stack, param, priority, handle, tskNO_AFFINITY);
+  }
+
+void vTaskStartScheduler(void)
+  {
+  pthread_mutex_lock(&s_scheduler_mutex);
+  s_scheduler_running = true;
+  pthread_cond_broadcast(&s_scheduler_cond);
+  pthread_mutex_unlock(&s_scheduler_mutex);
+  }
+
+void vTaskDelete(TaskHandle_t task)
+  {
+  shim_task* self = xTaskGetCurrentTaskHandle();
+  if (!task || task == self)
+    {
+    if (self->is_thread)
+      pthread_exit(NULL);
+    return;
+    }
+  if (task->is_thread)
+    {
+    // FreeRTOS removes the task immediately, so wait for the thread to
+    //  reach a cancellation point (any blocking call) and terminate.
+    //  The caller may free the task parameters after this returns.
+    pthread_mutex_lock(&task->mutex);
+    if (!task->terminated)
+      pthread_cancel(task->thread);
+    while (!task->terminated)
+      pthread_cond_wait(&task->cond, &task->mutex);
+    pthread_mutex_unlock(&task->mutex);
+    }
+  }
+
+void vTaskDelay(TickType_t ticks)
+  {
+  struct timespec deadline = shim_deadline(ticks);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {}
+  }
+
+void vTaskSuspendAll(void)
+  {
+  vPortEnterCritical(NULL);
+  }
+
+BaseType_t xTaskResumeAll(void)
+  {
+  vPortExitCritical(NULL);
+  return pdFALSE;
+  }
+
+TickType_t xTaskGetTickCount(void)
+  {
+  return esp_timer_get_time() / (1000000 / configTICK_RATE_HZ);
+  }
+
+TickType_t xTaskGetTickCountFromISR(void)
+  {
+  return xTaskGetTickCount();
+  }
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+  {
+  // Threads not created by xTaskCreate (i.e. main) get a task on first use:
+  if (!s_current)
+    {
+    s_current = shim_task_new("main", NULL, NULL, CONFIG_MAIN_TASK_STACK_SIZE, 1, tskNO_AFFINITY, false);
+    s_current->thread = pthread_self();
+    }
+  return s_current;
+  }
+
+TaskHandle_t xTaskGetHandle(const char* name)
+  {
+  TaskHandle_t found = NULL;
+  pthread_mutex_lock(&s_tasks_mutex);
+  for (shim_task* task : s_tasks)
+    {
+    if (task->name == name)
+      {
+      found = task;
+      break;
+      }
+    }
+  pthread_mutex_unlock(&s_tasks_mutex);
+  return found;
+  }
+
+TaskHandle_t xTaskGetIdleTaskHandleForCPU(UBaseType_t cpu)
+  {
+  if (cpu >= portNUM_PROCESSORS)
+    return NULL;
+  pthread_mutex_lock(&s_tasks_mutex);
+  shim_task* idle = s_idle[cpu];
+  pthread_mutex_unlock(&s_tasks_mutex);
+  if (!idle)
+    {
+    idle = shim_task_new(cpu ? "IDLE1" : "IDLE0", NULL, NULL, configMINIMAL_STACK_SIZE, 0, cpu, false);
+    pthread_mutex_lock(&s_tasks_mutex);
+    s_idle[cpu] = idle;
+    pthread_mutex_unlock(&s_tasks_mutex);
+    }
+  return idle;
+  }
+
+char* pcTaskGetTaskName(TaskHandle_t task)
+  {
+  if (!task) task = xTaskGetCurrentTaskHandle();
+  return (char*)task->name.c_str();
+  }
+
+BaseType_t xTaskGetAffinity(TaskHandle_t task)
+  {
+  if (!task) task = xTaskGetCurrentTaskHandle();
+  return task->core;
+  }
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+  {
+  pthread_mutex_lock(&s_tasks_mutex);
+  UBaseType_t cnt = s_tasks.size();
+  pthread_mutex_unlock(&s_tasks_mutex);
+  return cnt;
+  }
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t* status, UBaseType_t size, uint32_t* runtime)
+  {
+  UBaseType_t cnt = 0;
+  pthread_mutex_lock(&s_tasks_mutex);
+  if (size >= s_tasks.size())
+    {
+    for (shim_task* task : s_tasks)
+      {
+      TaskStatus_t* st = &status[cnt++];
+      memset(st, 0, sizeof(*st));
+      st->xHandle = task;
+      st->pcTaskName = task->name.c_str();
+      st->xTaskNumber = task->number;
+      st->eCurrentState = (task == s_current) ? eRunning : eBlocked;
+      st->uxCurrentPriority = st->uxBasePriority = task->priority;
+      st->usStackHighWaterMark = task->stack;   // not measured on the host
+      st->xCoreID = task->core;
+      // Run time counter: thread CPU time [us]
+      clockid_t clk;
+      struct timespec ts;
+      if (task->is_thread
+        && pthread_getcpuclockid(task->thread, &clk) == 0
+        && clock_gettime(clk, &ts) == 0)
+        st->ulRunTimeCounter = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+      }
+    if (runtime)
+      *runtime = esp_timer_get_time() * portNUM_PROCESSORS;
+    }
+  pthread_mutex_unlock(&s_tasks_mutex);
+  return cnt;
+  }
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+  {
+  if (!task) task = xTaskGetCurrentTaskHandle();
+  return task->stack;
+  }
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+  {
+  if (!task) task = xTaskGetCurrentTaskHandle();
+  return task->priority;
+  }
+
+BaseType_t xPortGetCoreID(void)
+  {
+  return 0;
+  }
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+  {
+  pthread_mutex_lock(&task->mutex);
+  task->notify++;
+  pthread_cond_broadcast(&task->cond);
+  pthread_mutex_unlock(&task->mutex);
+  return pdPASS;
+  }
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken)
+  {
+  xTaskNotifyGive(task);
+  if (woken) *woken = pdFALSE;
+  }
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+  {
+  shim_task* task = xTaskGetCurrentTaskHandle();
+  pthread_mutex_lock(&task->mutex);
+  shim_wait(&task->cond, &task->mutex, ticks, [task]{ return task->notify != 0; });
+  uint32_t value = task->notify;
+  if (value)
+    task->notify = clear ? 0 : value - 1;
+  pthread_mutex_unlock(&task->mutex);
+  return value;
+  }
+
+
+/***************************************************************************
+ * Queues & semaphores
+ */
+
+enum shim_queue_type { QT_QUEUE, QT_MUTEX, QT_RECURSIVE, QT_SEMAPHORE };
+
+struct shim_queue
+  {
+  shim_queue_type type;
+  pthread_mutex_t mutex;
+  pthread_cond_t can_receive;
+  pthread_cond_t can_send;
+  UBaseType_t length;
+  UBaseType_t itemsize;
+  UBaseType_t count;
+  UBaseType_t head;
+  uint8_t* buffer;
+  TaskHandle_t holder;
+  UBaseType_t recursion;
+  };
+
+static shim_queue* shim_queue_new(shim_queue_type type, UBaseType_t length, UBaseType_t itemsize, UBaseType_t count)
+  {
+  shim_queue* q = new shim_queue;
+  q->type = type;
+  pthread_mutex_init(&q->mutex, NULL);
+  shim_cond_init(&q->can_receive);
+  shim_cond_init(&q->can_send);
+  q->length = length;
+  q->itemsize = itemsize;
+  q->count = count;
+  q->head = 0;
+  q->buffer = itemsize ? new uint8_t[length * itemsize] : NULL;
+  q->holder = NULL;
+  q->recursion = 0;
+  return q;
+  }
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemsize)
+  {
+  return shim_queue_new(QT_QUEUE, length, itemsize, 0);
+  }
+
+void vQueueDelete(QueueHandle_t q)
+  {
+  if (!q) return;
+  pthread_mutex_destroy(&q->mutex);
+  pthread_cond_destroy(&q->can_receive);
+  pthread_cond_destroy(&q->can_send);
+  delete [] q->buffer;
+  delete q;
+  }
+
+static BaseType_t shim_queue_send(QueueHandle_t q, const void* item, TickType_t ticks, bool front)
+  {
+  pthread_mutex_lock(&q->mutex);
+  if (q->type == QT_MUTEX)
+    q->holder = NULL;
+  bool ok = shim_wait(&q->can_send, &q->mutex, ticks, [q]{ return q->count < q->length; });
+  if (ok)
+    {
+    if (q->itemsize)
+      {
+      UBaseType_t pos;
+      if (front)
+        pos = q->head = (q->head + q->length - 1) % q->length;
+      else
+        pos = (q->head + q->count) % q->length;
+      memcpy(q->buffer + pos * q->itemsize, item, q->itemsize);
+      }
+    q->count++;
+    pthread_cond_signal(&q->can_receive);
+    }
+  pthread_mutex_unlock(&q->mutex);
+  return ok ? pdPASS : errQUEUE_FULL;
+  }
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks)
+  {
+  return shim_queue_send(q, item, ticks, false);
+  }
+
+BaseType_t xQueueSendToFront(QueueHandle_t q, const void* item, TickType_t ticks)
+  {
+  return shim_queue_send(q, item, ticks, true);
+  }
+
+BaseType_t xQueueSendFromISR(QueueHandle_t q, const void* item, BaseType_t* woken)
+  {
+  if (woken) *woken = pdFALSE;
+  return shim_queue_send(q, item, 0, false);
+  }
+
+static BaseType_t shim_queue_receive(QueueHandle_t q, void* item, TickType_t ticks, bool peek)
+  {
+  pthread_mutex_lock(&q->mutex);
+  bool ok = shim_wait(&q->can_receive, &q->mutex, ticks, [q]{ return q->count > 0; });
+  if (ok)
+    {
+    if (q->itemsize && item)
+      memcpy(item, q->buffer + q->head * q->itemsize, q->itemsize);
+    if (!peek)
+      {
+      if (q->itemsize)
+        q->head = (q->head + 1) % q->length;
+      q->count--;
+      if (q->type == QT_MUTEX)
+        q->holder = xTaskGetCurrentTaskHandle();
+      pthread_cond_signal(&q->can_send);
+      }
+    }
+  pthread_mutex_unlock(&q->mutex);
+  return ok ? pdPASS : errQUEUE_EMPTY;
+  }
+
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t ticks)
+  {
+  return shim_queue_receive(q, item, ticks, false);
+  }
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t q, void* item, BaseType_t* woken)
+  {
+  if (woken) *woken = pdFALSE;
+  return shim_queue_receive(q, item, 0, false);
+  }
+
+BaseType_t xQueuePeek(QueueHandle_t q, void* item, TickType_t ticks)
+  {
+  return shim_queue_receive(q, item, ticks, true);
+  }
+
+BaseType_t xQueueReset(QueueHandle_t q)
+  {
+  pthread_mutex_lock(&q->mutex);
+  q->count = q->head = 0;
+  pthread_cond_broadcast(&q->can_send);
+  pthread_mutex_unlock(&q->mutex);
+  return pdPASS;
+  }
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+  {
+  pthread_mutex_lock(&q->mutex);
+  UBaseType_t cnt = q->count;
+  pthread_mutex_unlock(&q->mutex);
+  return cnt;
+  }
+
+UBaseType_t uxQueueMessagesWaitingFromISR(QueueHandle_t q)
+  {
+  return uxQueueMessagesWaiting(q);
+  }
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q)
+  {
+  pthread_mutex_lock(&q->mutex);
+  UBaseType_t cnt = q->length - q->count;
+  pthread_mutex_unlock(&q->mutex);
+  return cnt;
+  }
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+  {
+  return shim_queue_new(QT_MUTEX, 1, 0, 1);
+  }
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+  {
+  return shim_queue_new(QT_RECURSIVE, 1, 0, 1);
+  }
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+  {
+  return shim_queue_new(QT_SEMAPHORE, 1, 0, 0);
+  }
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial)
+  {
+  return shim_queue_new(QT_SEMAPHORE, max, 0, initial);
+  }
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t q, TickType_t ticks)
+  {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  pthread_mutex_lock(&q->mutex);
+  bool ok = shim_wait(&q->can_receive, &q->mutex, ticks,
+    [q,self]{ return q->count > 0 || q->holder == self; });
+  if (ok)
+    {
+    q->count = 0;
+    q->holder = self;
+    q->recursion++;
+    }
+  pthread_mutex_unlock(&q->mutex);
+  return ok ? pdPASS : pdFAIL;
+  }
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t q)
+  {
+  BaseType_t ok = pdFAIL;
+  pthread_mutex_lock(&q->mutex);
+  if (q->holder == xTaskGetCurrentTaskHandle())
+    {
+    ok = pdPASS;
+    if (--q->recursion == 0)
+      {
+      q->holder = NULL;
+      q->count = 1;
+      pthread_cond_signal(&q->can_receive);
+      }
+    }
+  pthread_mutex_unlock(&q->mutex);
+  return ok;
+  }
+
+
+/***************************************************************************
+ * Software timers: one service thread runs all callbacks
+ */
+
+struct shim_timer
+  {
+  std::string name;
+  TickType_t period;
+  bool autoreload;
+  void* id;
+  TimerCallbackFunction_t callback;
+  bool active;
+  int64_t expiry;                       // [us]
+  };
+
+static std::mutex s_timer_mutex;
+static std::condition_variable s_timer_cond __attribute__ ((init_priority (101)));
+static std::list<shim_timer*> s_timers __attribute__ ((init_priority (101)));
+static bool s_timer_task_running = false;
+
+static void shim_timer_task()
+  {
+  std::unique_lock<std::mutex> lock(s_timer_mutex);
+  while (true)
+    {
+    int64_t now = esp_timer_get_time(), next = INT64_MAX;
+    shim_timer* due = NULL;
+    for (shim_timer* t : s_timers)
+      {
+      if (!t->active) continue;
+      if (t->expiry <= now) { due = t; break; }
+      if (t->expiry < next) next = t->expiry;
+      }
+    if (due)
+      {
+      if (due->autoreload)
+        due->expiry += (int64_t)due->period * (1000000 / configTICK_RATE_HZ);
+      else
+        due->active = false;
+      lock.unlock();
+      due->callback(due);
+      lock.lock();
+      }
+    else if (next == INT64_MAX)
+      s_timer_cond.wait(lock);
+    else
+      s_timer_cond.wait_for(lock, std::chrono::microseconds(next - now));
+    }
+  }
+
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, UBaseType_t autoreload,
+  void* id, TimerCallbackFunction_t callback)
+  {
+  shim_timer* t = new shim_timer;
+  t->name = name;
+  t->period = period;
+  t->autoreload = autoreload;
+  t->id = id;
+  t->callback = callback;
+  t->active = false;
+  t->expiry = 0;
+  std::lock_guard<std::mutex> lock(s_timer_mutex);
+  s_timers.push_back(t);
+  if (!s_timer_task_running)
+    {
+    s_timer_task_running = true;
+    std::thread(shim_timer_task).detach();
+    }
+  return t;
+  }
+
+BaseType_t xTimerStart(TimerHandle_t t, TickType_t ticks)
+  {
+  std::lock_guard<std::mutex> lock(s_timer_mutex);
+  t->active = true;
+  t->expiry = esp_timer_get_time() + (int64_t)t->period * (1000000 / configTICK_RATE_HZ);
+  s_timer_cond.notify_one();
+  return pdPASS;
+  }
+
+BaseType_t xTimerStop(TimerHandle_t t, TickType_t ticks)
+  {
+  std::lock_guard<std::mutex> lock(s_timer_mutex);
+  t->active = false;
+  return pdPASS;
+  }
+
+BaseType_t xTimerReset(TimerHandle_t t, TickType_t ticks)
+  {
+  return xTimerStart(t, ticks);
+  }
+
+BaseType_t xTimerChangePeriod(TimerHandle_t t, TickType_t period, TickType_t ticks)
+  {
+    {
+    std::lock_guard<std::mutex> lock(s_timer_mutex);
+    t->period = period;
+    }
+  return xTimerStart(t, ticks);
+  }
+
+BaseType_t xTimerDelete(TimerHandle_t t, TickType_t ticks)
+  {
+  std::lock_guard<std::mutex> lock(s_timer_mutex);
+  s_timers.remove(t);
+  delete t;
+  return pdPASS;
+  }
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t t)
+  {
+  std::lock_guard<std::mutex> lock(s_timer_mutex);
+  return t->active;
+  }
+
+void* pvTimerGetTimerID(TimerHandle_t t)
+  {
+  return t->id;
+  }
+
+TickType_t xTimerGetPeriod(TimerHandle_t t)
+  {
+  return t->period;
+  }
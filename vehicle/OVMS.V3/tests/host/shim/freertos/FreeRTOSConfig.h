@@ -0,0 +1,38 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: FreeRTOS configuration
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_FREERTOSCONFIG_H__
+#define __SHIM_FREERTOSCONFIG_H__
+
+#define configTICK_RATE_HZ                  100
+#define configMAX_TASK_NAME_LEN             16
+#define configUSE_TRACE_FACILITY            1
+#define configGENERATE_RUN_TIME_STATS       1
+#define configMAX_PRIORITIES                25
+#define configMINIMAL_STACK_SIZE            768
+#define INCLUDE_xTaskGetIdleTaskHandle      1
+
+#endif //#ifndef __SHIM_FREERTOSCONFIG_H__
@@ -0,0 +1,49 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: lwIP PPP API
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_LWIP_PPPAPI_H__
+#define __SHIM_LWIP_PPPAPI_H__
+
+#include "netif/ppp/ppp.h"
+#include "netif/ppp/pppos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ppp_pcb* pppapi_pppos_create(struct netif* pppif, pppos_output_cb_fn output_cb,
+  ppp_link_status_cb_fn link_status_cb, void* ctx_cb);
+err_t pppapi_set_default(ppp_pcb* pcb);
+void pppapi_set_auth(ppp_pcb* pcb, u8_t authtype, const char* user, const char* passwd);
+err_t pppapi_connect(ppp_pcb* pcb, u16_t holdoff);
+err_t pppapi_close(ppp_pcb* pcb, u8_t nocarrier);
+err_t pppapi_free(ppp_pcb* pcb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //#ifndef __SHIM_LWIP_PPPAPI_H__
@@ -0,0 +1,105 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: lwIP PPP
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_NETIF_PPP_PPP_H__
+#define __SHIM_NETIF_PPP_PPP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The host PPP (shim/esp.cpp) runs no PPP session: connect and close have
+ *  no effect, no status callback is issued. The data passed to
+ *  pppos_input_tcpip() is collected in the control block for the tests.
+ */
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+typedef int8_t err_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PPP_IPV4_SUPPORT        1
+
+typedef struct
+  {
+  u32_t addr;
+  } ip_addr_t;
+
+struct netif
+  {
+  ip_addr_t ip_addr;
+  ip_addr_t netmask;
+  ip_addr_t gw;
+  };
+
+char* ipaddr_ntoa(const ip_addr_t* addr);
+
+typedef struct ppp_pcb_s ppp_pcb;
+
+typedef void (*ppp_link_status_cb_fn)(ppp_pcb* pcb, int err_code, void* ctx);
+typedef u32_t (*pppos_output_cb_fn)(ppp_pcb* pcb, u8_t* data, u32_t len, void* ctx);
+
+struct ppp_pcb_s
+  {
+  struct netif* netif;
+  pppos_output_cb_fn output_cb;
+  ppp_link_status_cb_fn link_status_cb;
+  void* ctx_cb;
+  // Host: input data (not parsed)
+  u8_t* input;
+  size_t inputlen;
+  unsigned int inputcalls;
+  };
+
+#define ppp_netif(ppp)          ((ppp)->netif)
+
+#define PPPERR_NONE             0
+#define PPPERR_PARAM            1
+#define PPPERR_OPEN             2
+#define PPPERR_DEVICE           3
+#define PPPERR_ALLOC            4
+#define PPPERR_USER             5
+#define PPPERR_CONNECT          6
+#define PPPERR_AUTHFAIL         7
+#define PPPERR_PROTOCOL         8
+#define PPPERR_PEERDEAD         9
+#define PPPERR_IDLETIMEOUT      10
+#define PPPERR_CONNECTTIME      11
+#define PPPERR_LOOPBACK         12
+
+#define PPPAUTHTYPE_PAP         0x01
+
+err_t ppp_connect(ppp_pcb* pcb, u16_t holdoff);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //#ifndef __SHIM_NETIF_PPP_PPP_H__
@@ -0,0 +1,46 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: lwIP PPPoS
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_NETIF_PPP_PPPOS_H__
+#define __SHIM_NETIF_PPP_PPPOS_H__
+
+#include "netif/ppp/ppp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+err_t pppos_input_tcpip(ppp_pcb* ppp, u8_t* s, int l);
+
+// Host: take (and clear) the input data collected, returns the number of
+//  pppos_input_tcpip() calls it came from. The data is to be freed.
+unsigned int pppos_host_take_input(ppp_pcb* ppp, u8_t** data, size_t* len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //#ifndef __SHIM_NETIF_PPP_PPPOS_H__
@@ -0,0 +1,60 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: ESP32 RTC reset reasons
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_ROM_RTC_H__
+#define __SHIM_ROM_RTC_H__
+
+typedef enum
+  {
+  NO_MEAN = 0,
+  POWERON_RESET = 1,
+  SW_RESET = 3,
+  OWDT_RESET = 4,
+  DEEPSLEEP_RESET = 5,
+  SDIO_RESET = 6,
+  TG0WDT_SYS_RESET = 7,
+  TG1WDT_SYS_RESET = 8,
+  RTCWDT_SYS_RESET = 9,
+  INTRUSION_RESET = 10,
+  TGWDT_CPU_RESET = 11,
+  SW_CPU_RESET = 12,
+  RTCWDT_CPU_RESET = 13,
+  EXT_CPU_RESET = 14,
+  RTCWDT_BROWN_OUT_RESET = 15,
+  RTCWDT_RTC_RESET = 16
+  } RESET_REASON;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+RESET_REASON rtc_get_reset_reason(int cpu_no);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //#ifndef __SHIM_ROM_RTC_H__
@@ -0,0 +1,62 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: build configuration
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_SDKCONFIG_H__
+#define __SHIM_SDKCONFIG_H__
+
+/**
+ * Host build configuration: the framework defaults of the v3.1 hardware
+ *  (support/sdkconfig.default.hw31), without scripting, networking and
+ *  vehicle modules.
+ */
+
+#define CONFIG_OVMS 1
+#define CONFIG_OVMS_VERSION_TAG "host"
+#define CONFIG_OVMS_HW_BASE_3_1 1
+#define CONFIG_OVMS_COMP_OBD2ECU 1
+#define CONFIG_OVMS_COMP_MODEM_SIMCOM 1
+#define CONFIG_OVMS_COMP_CAN_REPLAY 1
+#define CONFIG_OVMS_HW_CONSOLE_QUEUE_SIZE 100
+#define CONFIG_OVMS_HW_ASYNC_QUEUE_SIZE 100
+#define CONFIG_OVMS_HW_EVENT_QUEUE_SIZE 20
+#define CONFIG_OVMS_HW_NETMANAGER_QUEUE_SIZE 10
+#define CONFIG_OVMS_HW_CAN_RX_QUEUE_SIZE 30
+#define CONFIG_OVMS_HW_CAN_TX_QUEUE_SIZE 20
+#define CONFIG_OVMS_HW_CAN_RX_RING_SIZE 32
+#define CONFIG_OVMS_HW_CAN_LISTENER_RING_SIZE 64
+#define CONFIG_OVMS_SYS_COMMAND_STACK_SIZE 6144
+#define CONFIG_OVMS_SYS_LOGFILE_RING_SIZE 8192
+#define CONFIG_OVMS_SYS_LOGRECORDER_SIZE 16384
+#define CONFIG_OVMS_SYS_PROFILER 1
+#define CONFIG_OVMS_SC_JAVASCRIPT_NONE 1
+#define CONFIG_OVMS_VEHICLE_RXTASK_STACK 6144
+
+#define CONFIG_FREERTOS_HZ 100
+#define CONFIG_FREERTOS_UNICORE 0
+#define CONFIG_LOG_DEFAULT_LEVEL 3
+#define CONFIG_MAIN_TASK_STACK_SIZE 7168
+
+#endif //#ifndef __SHIM_SDKCONFIG_H__
@@ -0,0 +1,83 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: SPI bus
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <cstdarg>
+#include "spi.h"
+
+spi::spi(const char* name, int misopin, int mosipin, int clkpin)
+  : pcp(name)
+  {
+  m_mtx = xSemaphoreCreateMutex();
+  memset(&m_buscfg, 0, sizeof(spi_nodma_bus_config_t));
+  m_buscfg.miso_io_num=misopin;
+  m_buscfg.mosi_io_num=mosipin;
+  m_buscfg.sclk_io_num=clkpin;
+  m_buscfg.quadwp_io_num=-1;
+  m_buscfg.quadhd_io_num=-1;
+  }
+
+spi::~spi()
+  {
+  vSemaphoreDelete(m_mtx);
+  }
+
+bool spi::LockBus(TickType_t delay)
+  {
+  return (xSemaphoreTake(m_mtx, delay) == pdTRUE);
+  }
+
+void spi::UnlockBus()
+  {
+  xSemaphoreGive(m_mtx);
+  }
+
+uint8_t* spi::spi_cmd(spi_nodma_device_handle_t spi, uint8_t* buf, int rxlen, int txlen, ...)
+  {
+  va_list args;
+
+  memset(buf,0,rxlen+txlen);
+
+  va_start(args, txlen);
+  for (int k=0; k<txlen; k++)
+    {
+    buf[k] = va_arg(args,int);
+    }
+  va_end(args);
+
+  spi_nodma_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.length=(txlen+rxlen)*8;
+  t.rxlength=(rxlen*8);
+  t.tx_buffer=buf;
+  t.rx_buffer=buf;
+  if (LockBus(portMAX_DELAY))
+    {
+    spi_nodma_device_transmit(spi, &t, portMAX_DELAY);
+    UnlockBus();
+    }
+  return buf + txlen;
+  }
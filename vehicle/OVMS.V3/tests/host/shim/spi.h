@@ -0,0 +1,57 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: SPI bus
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_SPI_H__
+#define __SHIM_SPI_H__
+
+#include <stdint.h>
+#include "pcp.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "spi_master_nodma.h"
+
+// spinodma bus API (components/spinodma/spi.h), the transactions are
+//  passed to simulated devices, see spi_master_nodma.h:
+class spi : public pcp
+  {
+  public:
+    spi(const char* name, int misopin, int mosipin, int clkpin);
+    virtual ~spi();
+
+  public:
+    bool LockBus(TickType_t delay = portMAX_DELAY);
+    void UnlockBus();
+    uint8_t* spi_cmd(spi_nodma_device_handle_t spi, uint8_t* buf, int rxlen, int txlen, ...);
+
+  public:
+    spi_nodma_bus_config_t m_buscfg;
+
+  protected:
+    SemaphoreHandle_t m_mtx;
+  };
+
+#endif //#ifndef __SHIM_SPI_H__
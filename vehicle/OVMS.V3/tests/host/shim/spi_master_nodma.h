@@ -0,0 +1,96 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: SPI master (no DMA) driver
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __SHIM_SPI_MASTER_NODMA_H__
+#define __SHIM_SPI_MASTER_NODMA_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+/**
+ * SPI devices are simulated on the host: a test derives a device from
+ *  spi_nodma_device_t and attaches it to a chip select pin before the
+ *  driver adds the device to the bus. spi_nodma_device_transmit() then
+ *  passes each transaction to the device (see esp.cpp passes each transaction to the device (see esp.cpp). spi.cpp).
+ */
+
+typedef enum
+  {
+  SPI_NODMA_HOST=0,
+  HSPI_NODMA_HOST=1,
+  VSPI_NODMA_HOST=2
+  } spi_nodma_host_device_t;
+
+typedef struct
+  {
+  int mosi_io_num;
+  int miso_io_num;
+  int sclk_io_num;
+  int quadwp_io_num;
+  int quadhd_io_num;
+  } spi_nodma_bus_config_t;
+
+typedef struct
+  {
+  uint8_t command_bits;
+  uint8_t address_bits;
+  uint8_t dummy_bits;
+  uint8_t mode;
+  int clock_speed_hz;
+  int spics_io_num;
+  int queue_size;
+  } spi_nodma_device_interface_config_t;
+
+typedef struct
+  {
+  uint32_t flags;
+  size_t length;                  // total bits, command + response
+  size_t rxlength;                // response bits
+  void* user;
+  const void* tx_buffer;
+  void* rx_buffer;
+  } spi_nodma_transaction_t;
+
+struct spi_nodma_device_t
+  {
+  virtual ~spi_nodma_device_t() {}
+  // Transaction: buf holds txlen command bytes, the device writes the
+  //  rxlen response bytes following them
+  virtual void Transfer(uint8_t* buf, int txlen, int rxlen) = 0;
+  };
+
+typedef spi_nodma_device_t* spi_nodma_device_handle_t;
+
+esp_err_t spi_nodma_bus_add_device(spi_nodma_host_device_t host, spi_nodma_bus_config_t* bus_config,
+                                   spi_nodma_device_interface_config_t* dev_config, spi_nodma_device_handle_t* handle);
+esp_err_t spi_nodma_device_transmit(spi_nodma_device_handle_t handle, spi_nodma_transaction_t* trans_desc, TickType_t ticks_to_wait);
+
+// Host: attach a simulated device to a chip select pin (NULL = detach)
+void spi_nodma_host_attach(int cspin, spi_nodma_device_t* device);
+
+#endif //#ifndef __SHIM_SPI_MASTER_NODMA_H__
@@ -0,0 +1,110 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: framework link stubs
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+/**
+ * Stand-ins for framework parts not included in the host build
+ *  (module task map, peripherals, script engine, time providers, boot &
+ *  restart).
+ */
+
+#include <string>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "ovms_peripherals.h"
+#include "ovms_script.h"
+#include "ovms_time.h"
+#include "ovms_boot.h"
+
+// ovms_module.cpp: task map for "module tasks" (not built)
+void AddTaskToMap(TaskHandle_t task)
+  {
+  }
+
+// ovms_peripherals.cpp: no peripherals, tests create their devices
+Peripherals* MyPeripherals = NULL;
+
+// ovms_script.cpp: no script engine, no /store/events
+OvmsScripts MyScripts __attribute__ ((init_priority (1600)));
+
+OvmsScripts::OvmsScripts()
+  {
+  }
+
+OvmsScripts::~OvmsScripts()
+  {
+  }
+
+void OvmsScripts::EventScript(std::string event, void* data)
+  {
+  }
+
+void OvmsScripts::AllScripts(std::string path)
+  {
+  }
+
+// ovms_time.cpp: no time providers (GPS time from the NMEA parser is ignored)
+OvmsTime MyTime __attribute__ ((init_priority (1500)));
+
+OvmsTime::OvmsTime()
+  {
+  m_current = NULL;
+  }
+
+OvmsTime::~OvmsTime()
+  {
+  }
+
+void OvmsTime::Set(const char* provider, int stratum, bool trusted, time_t tim, suseconds_t timu)
+  {
+  }
+
+// ovms_boot.cpp: no restart (the modem driver reports its shutdown state)
+Boot MyBoot __attribute__ ((init_priority (1100)));
+
+Boot::Boot()
+  {
+  m_restart_timer = 0;
+  m_restart_pending = 0;
+  m_bootreason = BR_PowerOn;
+  m_crash_count_early = 0;
+  }
+
+Boot::~Boot()
+  {
+  }
+
+void Boot::RestartPending(const char* tag)
+  {
+  }
+
+void Boot::RestartReady(const char* tag)
+  {
+  }
+
+bool Boot::IsShuttingDown()
+  {
+  return false;
+  }
@@ -0,0 +1,146 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Host shim: virtual file system
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+/**
+ * The ESP-IDF VFS mount points used by the framework (/store, /sd) are
+ *  mapped to directories below the host VFS root: $OVMS_HOST_VFS, default
+ *  "vfs" next to the executable. The file functions used by the framework
+ *  are wrapped at link time (ld --wrap, see Makefile) to apply the mapping.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <string>
+#include "esp_vfs_fat.h"
+
+static const char* const s_mounts[] = { "/store", "/sd", NULL };
+
+static const std::string& vfs_root()
+  {
+  static std::string root;
+  if (root.empty())
+    {
+    const char* env = getenv("OVMS_HOST_VFS");
+    if (env && *env)
+      root = env;
+    else
+      {
+      char exe[PATH_MAX];
+      ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe)-1);
+      exe[len > 0 ? len : 0] = 0;
+      char* sep = strrchr(exe, '/');
+      root = sep ? std::string(exe, sep - exe) + "/vfs" : "vfs";
+      }
+    }
+  return root;
+  }
+
+static std::string vfs_path(const char* path)
+  {
+  for (const char* const* m = s_mounts; path && *m; m++)
+    {
+    size_t len = strlen(*m);
+    if (strncmp(path, *m, len) == 0 && (path[len] == 0 || path[len] == '/'))
+      return vfs_root() + path;
+    }
+  return path ? path : "";
+  }
+
+static void vfs_mkdirs(const std::string& path)
+  {
+  for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos+1))
+    {
+    mkdir(path.substr(0, pos).c_str(), 0755);
+    if (pos == std::string::npos) break;
+    }
+  }
+
+esp_err_t esp_vfs_fat_spiflash_mount(const char* base_path, const char* partition_label,
+  const esp_vfs_fat_mount_config_t* mount_config, wl_handle_t* wl_handle)
+  {
+  *wl_handle = 0;
+  vfs_mkdirs(vfs_path(base_path));
+  return ESP_OK;
+  }
+
+esp_err_t esp_vfs_fat_spiflash_unmount(const char* base_path, wl_handle_t wl_handle)
+  {
+  return ESP_OK;
+  }
+
+extern "C" {
+
+FILE* __real_fopen(const char* path, const char* mode);
+int __real_stat(const char* path, struct stat* st);
+int __real_mkdir(const char* path, mode_t mode);
+DIR* __real_opendir(const char* path);
+int __real_unlink(const char* path);
+int __real_rmdir(const char* path);
+int __real_rename(const char* from, const char* to);
+
+FILE* __wrap_fopen(const char* path, const char* mode)
+  {
+  return __real_fopen(vfs_path(path).c_str(), mode);
+  }
+
+int __wrap_stat(const char* path, struct stat* st)
+  {
+  return __real_stat(vfs_path(path).c_str(), st);
+  }
+
+int __wrap_mkdir(const char* path, mode_t mode)
+  {
+  // FAT has no permissions, the framework passes 0:
+  return __real_mkdir(vfs_path(path).c_str(), 0755);
+  }
+
+DIR* __wrap_opendir(const char* path)
+  {
+  return __real_opendir(vfs_path(path).c_str());
+  }
+
+int __wrap_unlink(const char* path)
+  {
+  return __real_unlink(vfs_path(path).c_str());
+  }
+
+int __wrap_rmdir(const char* path)
+  {
+  return __real_rmdir(vfs_path(path).c_str());
+  }
+
+int __wrap_rename(const char* from, const char* to)
+  {
+  return __real_rename(vfs_path(from).c_str(), vfs_path(to).c_str());
+  }
+
+} // extern "C"
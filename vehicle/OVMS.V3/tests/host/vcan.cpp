@@ -0,0 +1,115 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Virtual CAN bus driver (host)
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#include "ovms_log.h"
+static const char *TAG = "vcan";
+
+#include <string.h>
+#include "vcan.h"
+
+vcan::vcan(const char* name)
+  : canbus(name)
+  {
+  m_peer = NULL;
+  m_inject_mux = portMUX_INITIALIZER_UNLOCKED;
+  }
+
+vcan::~vcan()
+  {
+  }
+
+esp_err_t vcan::Start(CAN_mode_t mode, CAN_speed_t speed)
+  {
+  m_mode = mode;
+  m_speed = speed;
+  ClearStatus();
+  ESP_LOGD(TAG, "%s started, mode %d speed %d", m_name, mode, speed);
+  return ESP_OK;
+  }
+
+esp_err_t vcan::Stop()
+  {
+  m_mode = CAN_MODE_OFF;
+  return ESP_OK;
+  }
+
+esp_err_t vcan::Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait /*=0*/)
+  {
+  if (m_mode != CAN_MODE_ACTIVE)
+    {
+    ESP_LOGW(TAG, "%s: cannot write in mode %d", m_name, m_mode);
+    return ESP_FAIL;
+    }
+  if (m_peer && m_peer->m_mode != CAN_MODE_OFF)
+    m_peer->Inject(p_frame);
+
+  // stats & logging:
+  return canbus::Write(p_frame, maxqueuewait);
+  }
+
+bool vcan::RxCallback(CAN_frame_t* frame)
+  {
+  return m_rxring.Pop(frame);
+  }
+
+bool vcan::Inject(const CAN_frame_t* p_frame)
+  {
+  portENTER_CRITICAL(&m_inject_mux);
+  m_status.interrupts++;
+  CAN_frame_t* frame = m_rxring.Reserve();
+  if (frame == NULL)
+    {
+    // RX ring full, frame lost:
+    m_status.rxring_overflow++;
+    portEXIT_CRITICAL(&m_inject_mux);
+    return false;
+    }
+  *frame = *p_frame;
+  frame->origin = this;
+  frame->timestamp = CAN_Timestamp();
+  if (m_rxring.Commit())
+    {
+    // Request RxCallback to drain the ring (once per burst):
+    CAN_msg_t msg;
+    msg.type = CAN_rxcallback;
+    msg.body.bus = this;
+    if (xQueueSendFromISR(MyCan.m_rxqueue, &msg, NULL) != pdTRUE)
+      m_rxring.WakeupFailed();
+    }
+  portEXIT_CRITICAL(&m_inject_mux);
+  return true;
+  }
+
+bool vcan::Inject(uint32_t id, uint8_t length, const uint8_t* data, bool extended /*=false*/)
+  {
+  CAN_frame_t frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.FIR.B.DLC = length;
+  frame.FIR.B.FF = extended ? CAN_frame_ext : CAN_frame_std;
+  frame.MsgID = id;
+  memcpy(frame.data.u8, data, length);
+  return Inject(&frame);
+  }
@@ -0,0 +1,71 @@
+/*
+;    Project:       Open Vehicle Monitor System
+;    Module:        Virtual CAN bus driver (host)
+;    Date:          18th October 2026
+;
+;    (C) 2026       Open Vehicle Monitor System contributors
+;
+; Permission is hereby granted, free of charge, to any person obtaining a copy
+; of this software and associated documentation files (the "Software"), to deal
+; in the Software without restriction, including without limitation the rights
+; to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+; copies of the Software, and to permit persons to whom the Software is
+; furnished to do so, subject to the following conditions:
+;
+; The above copyright notice and this permission notice shall be included in
+; all copies or substantial portions of the Software.
+;
+; THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+; IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+; FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+; AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+; LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+; OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+; THE SOFTWARE.
+*/
+
+#ifndef __VCAN_H__
+#define __VCAN_H__
+
+#include "can.h"
+#include "canring.h"
+
+/**
+ * vcan: virtual CAN bus driver for the host build.
+ *
+ *  Inject() takes the place of the esp32can RX interrupt: the frame is
+ *  stored in the driver RX ring and the CAN RX task is requested to
+ *  drain it (once per burst), so received frames take the same path
+ *  through the framework as on the module. Inject() calls are serialized
+ *  per bus (like the interrupt handler), so any task may inject frames.
+ *
+ *  Write() transmits immediately (no TX queue). If the bus is connected
+ *  to a peer (a virtual wire), the peer receives the frame; a frame
+ *  written to an unconnected bus is only counted & logged.
+ */
+class vcan : public canbus
+  {
+  public:
+    vcan(const char* name);
+    ~vcan();
+
+  public:
+    esp_err_t Start(CAN_mode_t mode, CAN_speed_t speed);
+    esp_err_t Stop();
+
+  public:
+    esp_err_t Write(const CAN_frame_t* p_frame, TickType_t maxqueuewait=0);
+    bool RxCallback(CAN_frame_t* frame);
+
+  public:
+    bool Inject(const CAN_frame_t* p_frame);
+    bool Inject(uint32_t id, uint8_t length, const uint8_t* data, bool extended=false);
+    void Connect(vcan* peer) { m_peer = peer; }
+
+  public:
+    vcan* m_peer;
+    portMUX_TYPE m_inject_mux;
+    canring<CAN_frame_t, CONFIG_OVMS_HW_CAN_RX_RING_SIZE> m_rxring;   // Inject → CAN RX task
+  };
+
+#endif //#ifndef __VCAN_H__
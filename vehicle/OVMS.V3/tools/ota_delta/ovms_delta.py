@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+#
+# ovms_delta.py: create / apply / inspect OVMS delta firmware patches
+#
+# Usage:
+#   ovms_delta.py diff <old.bin> <new.bin> <patch.ovd>
+#   ovms_delta.py apply <old.bin> <patch.ovd> <new.bin>
+#   ovms_delta.py info <patch.ovd>
+#
+# The patch is applied on the module by "ota flash delta <file/url>" against
+# the currently running firmware, so <old.bin> must be exactly the image the
+# module runs. See OvmsOTAPatch in components/ovms_ota/src/ovms_ota.h for the
+# format.
+#
+# (C) 2026 Open Vehicle Monitor System contributors
+# MIT license, see ovms_ota.cpp
+
+import hashlib
+import struct
+import sys
+
+MAGIC = b"OVD1"
+OP_END, OP_COPY, OP_DATA = 0x00, 0x01, 0x02
+BLOCK = 16          # source index granularity
+MINMATCH = 24       # minimum COPY length worth a COPY op
+
+
+def varint(n):
+    out = bytearray()
+    while True:
+        b = n & 0x7f
+        n >>= 7
+        if n:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def read_varint(data, pos):
+    n = shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        n |= (b & 0x7f) << shift
+        shift += 7
+        if not b & 0x80:
+            return n, pos
+
+
+def diff(src, dst):
+    index = {}
+    for pos in range(0, len(src) - BLOCK + 1, BLOCK):
+        index.setdefault(src[pos:pos+BLOCK], pos)
+
+    ops = bytearray()
+    literal_start = 0
+
+    def flush_literal(end):
+        if end > literal_start:
+            ops.extend(bytes([OP_DATA]) + varint(end - literal_start))
+            ops.extend(dst[literal_start:end])
+
+    i = 0
+    while i + BLOCK <= len(dst):
+        spos = index.get(dst[i:i+BLOCK])
+        if spos is None:
+            i += 1
+            continue
+        # extend the match backwards into the pending literal & forwards:
+        start, sstart = i, spos
+        while start > literal_start and sstart > 0 and dst[start-1] == src[sstart-1]:
+            start -= 1
+            sstart -= 1
+        end, send = i + BLOCK, spos + BLOCK
+        while end < len(dst) and send < len(src) and dst[end] == src[send]:
+            end += 1
+            send += 1
+        if end - start < MINMATCH:
+            i += 1
+            continue
+        flush_literal(start)
+        ops.extend(bytes([OP_COPY]) + varint(sstart) + varint(end - start))
+        literal_start = i = end
+    flush_literal(len(dst))
+    ops.append(OP_END)
+
+    header = MAGIC
+    header += struct.pack("<I", len(src)) + hashlib.md5(src).digest()
+    header += struct.pack("<I", len(dst)) + hashlib.md5(dst).digest()
+    return header + bytes(ops)
+
+
+def parse_header(patch):
+    if patch[:4] != MAGIC:
+        raise ValueError("not a delta patch")
+    src_size, = struct.unpack_from("<I", patch, 4)
+    dst_size, = struct.unpack_from("<I", patch, 24)
+    return src_size, patch[8:24], dst_size, patch[28:44]
+
+
+def apply(src, patch):
+    src_size, src_md5, dst_size, dst_md5 = parse_header(patch)
+    if len(src) < src_size or hashlib.md5(src[:src_size]).digest() != src_md5:
+        raise ValueError("patch does not match the source image")
+    out = bytearray()
+    pos = 44
+    while True:
+        op = patch[pos]
+        pos += 1
+        if op == OP_END:
+            break
+        elif op == OP_COPY:
+            offset, pos = read_varint(patch, pos)
+            length, pos = read_varint(patch, pos)
+            if offset + length > src_size:
+                raise ValueError("invalid copy range")
+            out += src[offset:offset+length]
+        elif op == OP_DATA:
+            length, pos = read_varint(patch, pos)
+            out += patch[pos:pos+length]
+            pos += length
+        else:
+            raise ValueError("invalid operation 0x%02x" % op)
+    if pos != len(patch):
+        raise ValueError("data after end of patch")
+    if len(out) != dst_size or hashlib.md5(out).digest() != dst_md5:
+        raise ValueError("target mismatch")
+    return bytes(out)
+
+
+def main(argv):
+    if len(argv) == 5 and argv[1] == "diff":
+        src = open(argv[2], "rb").read()
+        dst = open(argv[3], "rb").read()
+        patch = diff(src, dst)
+        apply(src, patch)  # self check
+        open(argv[4], "wb").write(patch)
+        print("%s: %d bytes (%.1f%% of %d)"
+              % (argv[4], len(patch), 100.0 * len(patch) / max(len(dst), 1), len(dst)))
+    elif len(argv) == 5 and argv[1] == "apply":
+        src = open(argv[2], "rb").read()
+        patch = open(argv[3], "rb").read()
+        open(argv[4], "wb").write(apply(src, patch))
+    elif len(argv) == 3 and argv[1] == "info":
+        patch = open(argv[2], "rb").read()
+        src_size, src_md5, dst_size, dst_md5 = parse_header(patch)
+        print("source: %d bytes, MD5 %s" % (src_size, src_md5.hex()))
+        print("target: %d bytes, MD5 %s" % (dst_size, dst_md5.hex()))
+        print("patch:  %d bytes" % len(patch))
+    else:
+        sys.stderr.write("usage: ovms_delta.py diff <old> <new> <patch> | apply <old> <patch> <new> | info <patch>\n")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))